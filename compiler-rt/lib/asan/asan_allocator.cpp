@@ -30,6 +30,10 @@
 #include "sanitizer_common/sanitizer_quarantine.h"
 #include "lsan/lsan_common.h"
 
+#if SANITIZER_LINUX || SANITIZER_NETBSD
+#include "sanitizer_common/sanitizer_posix.h"
+#endif
+
 namespace __asan {
 
 // Valid redzone sizes are 16, 32, 64, ... 2048, so we encode them in 3 bits.
@@ -133,9 +137,11 @@ struct AsanChunk: ChunkBase {
 };
 
 struct QuarantineCallback {
-  QuarantineCallback(AllocatorCache *cache, BufferedStackTrace *stack)
+  QuarantineCallback(AllocatorCache *cache, BufferedStackTrace *stack,
+                     AsanStats *stats = nullptr)
       : cache_(cache),
-        stack_(stack) {
+        stack_(stack),
+        stats_(stats) {
   }
 
   void Recycle(AsanChunk *m) {
@@ -157,7 +163,7 @@ struct QuarantineCallback {
     }
 
     // Statistics.
-    AsanStats &thread_stats = GetCurrentThreadStats();
+    AsanStats &thread_stats = stats_ ? *stats_ : GetCurrentThreadStats();
     thread_stats.real_frees++;
     thread_stats.really_freed += m->UsedSize();
 
@@ -179,6 +185,7 @@ struct QuarantineCallback {
  private:
   AllocatorCache* const cache_;
   BufferedStackTrace* const stack_;
+  AsanStats* const stats_;
 };
 
 typedef Quarantine<QuarantineCallback, AsanChunk> AsanQuarantine;
@@ -244,6 +251,7 @@ struct Allocator {
   AsanQuarantine quarantine;
   StaticSpinMutex fallback_mutex;
   AllocatorCache fallback_allocator_cache;
+  AllocatorCache recycler_allocator_cache;
   QuarantineCache fallback_quarantine_cache;
 
   uptr max_user_defined_malloc_size;
@@ -816,6 +824,22 @@ struct Allocator {
     allocator.ForceReleaseToOS();
   }
 
+  // The loop of the thread recycling the quarantine, with
+  // background_quarantine_recycling=1.
+  void RecycleQuarantineInBackground() {
+    BufferedStackTrace stack;
+    AsanStats stats;
+    quarantine.EnableBackgroundRecycling();
+    while (true) {
+      SleepForMillis(1);
+      if (!quarantine.RecycleRequested())
+        continue;
+      quarantine.RecycleInBackground(
+          QuarantineCallback(&recycler_allocator_cache, &stack, &stats));
+      FlushToDeadThreadStats(&stats);
+    }
+  }
+
   void PrintStats() {
     allocator.PrintStats();
     quarantine.PrintStats();
@@ -1031,6 +1055,23 @@ void AsanSoftRssLimitExceededCallback(bool limit_exceeded) {
   instance.SetRssLimitExceeded(limit_exceeded);
 }
 
+#if SANITIZER_LINUX || SANITIZER_NETBSD
+static void *QuarantineRecyclerThread(void *arg) {
+  instance.RecycleQuarantineInBackground();
+  return nullptr;
+}
+#endif
+
+void MaybeStartQuarantineRecycler() {
+#if SANITIZER_LINUX || SANITIZER_NETBSD
+  if (!flags()->background_quarantine_recycling ||
+      !instance.quarantine.GetSize())
+    return;
+  if (!&real_pthread_create) return;  // Can't spawn the thread anyway.
+  internal_start_thread(QuarantineRecyclerThread, nullptr);
+#endif
+}
+
 } // namespace __asan
 
 // --- Implementation of LSan-specific functions --- {{{1
@@ -225,6 +225,7 @@ void asan_mz_force_unlock();
 
 void PrintInternalAllocatorStats();
 void AsanSoftRssLimitExceededCallback(bool exceeded);
+void MaybeStartQuarantineRecycler();
 
 }  // namespace __asan
 #endif  // ASAN_ALLOCATOR_H
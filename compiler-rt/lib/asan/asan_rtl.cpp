@@ -390,6 +390,7 @@ void PrintAddressSpaceLayout() {
 static bool UNUSED __local_asan_dyninit = [] {
   MaybeStartBackgroudThread();
   SetSoftRssLimitExceededCallback(AsanSoftRssLimitExceededCallback);
+  MaybeStartQuarantineRecycler();
 
   return false;
 }();
@@ -472,6 +473,7 @@ static void AsanInitInternal() {
 #ifdef START_BACKGROUND_THREAD_IN_ASAN_INTERNAL
   MaybeStartBackgroudThread();
   SetSoftRssLimitExceededCallback(AsanSoftRssLimitExceededCallback);
+  MaybeStartQuarantineRecycler();
 #endif
 
   // On Linux AsanThread::ThreadStart() calls malloc() that's why asan_inited
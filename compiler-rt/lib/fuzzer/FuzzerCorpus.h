@@ -365,6 +365,12 @@ public:
     DistributionNeedsUpdate = true;
   }
 
+  // Returns whether AddFeature would add or update the feature.
+  bool IsFeatureNew(size_t Idx, uint32_t NewSize, bool Shrink) const {
+    uint32_t OldSize = InputSizesPerFeature[Idx % kFeatureSetSize];
+    return OldSize == 0 || (Shrink && OldSize > NewSize);
+  }
+
   bool AddFeature(size_t Idx, uint32_t NewSize, bool Shrink) {
     assert(NewSize);
     Idx = Idx % kFeatureSetSize;
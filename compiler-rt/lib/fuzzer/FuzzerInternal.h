@@ -29,6 +29,8 @@ namespace fuzzer {
 
 using namespace std::chrono;
 
+struct FuzzingThread;
+
 class Fuzzer {
 public:
 
@@ -56,7 +58,7 @@ public:
     return Seconds ? TotalNumberOfRuns / Seconds : 0;
   }
 
-  size_t getTotalNumberOfRuns() { return TotalNumberOfRuns; }
+  size_t getTotalNumberOfRuns() { return TotalNumberOfRuns.load(); }
 
   static void StaticAlarmCallback();
   static void StaticCrashSignalCallback();
@@ -72,7 +74,7 @@ public:
   // Merge Corpora[1:] into Corpora[0].
   void Merge(const Vector<std::string> &Corpora);
   void CrashResistantMergeInternalStep(const std::string &ControlFilePath);
-  MutationDispatcher &GetMD() { return MD; }
+  MutationDispatcher &GetMD();
   void PrintFinalStats();
   void SetMaxInputLen(size_t MaxInputLen);
   void SetMaxMutationLen(size_t MaxMutationLen);
@@ -94,9 +96,15 @@ private:
   void CrashOnOverwrittenData();
   void InterruptCallback();
   void MutateAndTestOne();
+  void StartFuzzingThreads();
+  void StopFuzzingThreads();
+  void FuzzingThreadLoop(FuzzingThread &T);
+  void MutateAndTestOneInThread(FuzzingThread &T);
+  bool RunInThread(FuzzingThread &T, size_t Size);
   void PurgeAllocator();
   void ReportNewCoverage(InputInfo *II, const Unit &U);
   void PrintPulseAndReportSlowInput(const uint8_t *Data, size_t Size);
+  void ReportSlowInput(const uint8_t *Data, size_t Size, long TimeOfUnit);
   void WriteUnitToFileWithPrefix(const Unit &U, const char *Prefix);
   void PrintStats(const char *Where, const char *End = "\n", size_t Units = 0,
                   size_t Features = 0);
@@ -105,6 +113,8 @@ private:
 
   static void StaticDeathCallback();
   void DumpCurrentUnit(const char *Prefix);
+  void DumpUnit(MutationDispatcher &MD, const uint8_t *Sha1,
+                const uint8_t *Data, size_t Size, const char *Prefix);
   void DeathCallback();
 
   void AllocateCurrentUnitData();
@@ -114,7 +124,7 @@ private:
 
   bool GracefulExitRequested = false;
 
-  size_t TotalNumberOfRuns = 0;
+  std::atomic<size_t> TotalNumberOfRuns{0};
   size_t NumberOfNewUnitsAdded = 0;
 
   size_t LastCorpusUpdateRun = 0;
@@ -16,10 +16,12 @@
 #include "FuzzerRandom.h"
 #include "FuzzerTracePC.h"
 #include <algorithm>
+#include <condition_variable>
 #include <cstring>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <thread>
 
 #if defined(__has_include)
 #if __has_include(<sanitizer / lsan_interface.h>)
@@ -76,6 +78,97 @@ struct MallocFreeTracer {
 
 static MallocFreeTracer AllocTracer;
 
+// With -threads, the threads run the callback concurrently, and a thread runs
+// it alone when its input looks interesting, to add it to the corpus. A thread
+// waiting to run the callback alone stops the new concurrent runs, so that it
+// is not starved by the other threads.
+class RunLock {
+public:
+  void LockShared() {
+    std::unique_lock<std::mutex> L(M);
+    CV.wait(L, [&] { return !Exclusive && !NumWaitingExclusive; });
+    NumShared++;
+  }
+  void UnlockShared() {
+    std::lock_guard<std::mutex> L(M);
+    if (--NumShared == 0 && NumWaitingExclusive)
+      CV.notify_all();
+  }
+  void Lock() {
+    std::unique_lock<std::mutex> L(M);
+    NumWaitingExclusive++;
+    CV.wait(L, [&] { return !Exclusive && !NumShared; });
+    NumWaitingExclusive--;
+    Exclusive = true;
+  }
+  void Unlock() {
+    std::lock_guard<std::mutex> L(M);
+    Exclusive = false;
+    CV.notify_all();
+  }
+
+private:
+  std::mutex M;
+  std::condition_variable CV;
+  size_t NumShared = 0;
+  size_t NumWaitingExclusive = 0;
+  bool Exclusive = false;
+};
+
+static RunLock TheRunLock;
+
+// Guards the corpus, the statistics and the mutation length limit against the
+// other threads of -threads. The features of the corpus only change when a
+// thread runs the callback alone, they can be read during the concurrent runs.
+static std::mutex CorpusMutex;
+
+// Runs the callback alone, with -threads.
+struct ScopedRunAlone {
+  ScopedRunAlone() {
+    TheRunLock.Lock();
+    CorpusMutex.lock();
+  }
+  ~ScopedRunAlone() {
+    CorpusMutex.unlock();
+    TheRunLock.Unlock();
+  }
+};
+
+// The state of one of the threads of -threads. The main thread is the first
+// one.
+struct FuzzingThread {
+  FuzzingThread(unsigned Seed, const FuzzingOptions &Options,
+                size_t MaxInputLen, const MutationDispatcher &MainMD)
+      : Rand(Seed), MD(Rand, Options), UnitData(new uint8_t[MaxInputLen]),
+        Snapshot(TPC.NumCounterBytes()) {
+    MD.CopyManualDictionary(MainMD);
+  }
+
+  Random Rand;
+  MutationDispatcher MD;
+  std::unique_ptr<uint8_t[]> UnitData;
+  std::atomic<size_t> UnitSize{0};
+  uint8_t BaseSha1[kSHA1NumBytes] = {};
+  // Copies of the corpus data the thread uses outside of the CorpusMutex.
+  Unit CrossOverWith;
+  Vector<uint8_t> Mask;
+  // The inline counters when the current run started.
+  Vector<uint8_t> Snapshot;
+  // The start of the current run in milliseconds since the epoch, 0 between
+  // the runs.
+  std::atomic<uint64_t> RunStartMs{0};
+  std::thread Thread;
+};
+
+static Vector<std::unique_ptr<FuzzingThread>> Threads;
+static std::atomic<bool> StopThreads;
+static thread_local FuzzingThread *CurrentThread;
+
+static uint64_t NowMs() {
+  return duration_cast<milliseconds>(system_clock::now().time_since_epoch())
+      .count();
+}
+
 // Locks printing and avoids nested hooks triggered from mallocs/frees in
 // sanitizer.
 class TraceLock {
@@ -173,19 +266,37 @@ void Fuzzer::StaticDeathCallback() {
   F->DeathCallback();
 }
 
+MutationDispatcher &Fuzzer::GetMD() {
+  return CurrentThread ? CurrentThread->MD : MD;
+}
+
 void Fuzzer::DumpCurrentUnit(const char *Prefix) {
+  if (FuzzingThread *T = CurrentThread)
+    return DumpUnit(T->MD, T->BaseSha1, T->UnitData.get(), T->UnitSize,
+                    Prefix);
+  if (!Threads.empty()) {
+    // Reported from another thread, by the rss limit for instance: any of the
+    // units being run may be the culprit.
+    for (auto &T : Threads)
+      if (size_t UnitSize = T->UnitSize)
+        DumpUnit(T->MD, T->BaseSha1, T->UnitData.get(), UnitSize, Prefix);
+    return;
+  }
   if (!CurrentUnitData)
     return; // Happens when running individual inputs.
+  DumpUnit(MD, BaseSha1, CurrentUnitData, CurrentUnitSize, Prefix);
+}
+
+void Fuzzer::DumpUnit(MutationDispatcher &MD, const uint8_t *Sha1,
+                      const uint8_t *Data, size_t Size, const char *Prefix) {
   ScopedDisableMsanInterceptorChecks S;
   MD.PrintMutationSequence();
-  Printf("; base unit: %s\n", Sha1ToString(BaseSha1).c_str());
-  size_t UnitSize = CurrentUnitSize;
-  if (UnitSize <= kMaxUnitSizeToPrint) {
-    PrintHexArray(CurrentUnitData, UnitSize, "\n");
-    PrintASCII(CurrentUnitData, UnitSize, "\n");
+  Printf("; base unit: %s\n", Sha1ToString(Sha1).c_str());
+  if (Size <= kMaxUnitSizeToPrint) {
+    PrintHexArray(Data, Size, "\n");
+    PrintASCII(Data, Size, "\n");
   }
-  WriteUnitToFileWithPrefix({CurrentUnitData, CurrentUnitData + UnitSize},
-                            Prefix);
+  WriteUnitToFileWithPrefix({Data, Data + Size}, Prefix);
 }
 
 NO_SANITIZE_MEMORY
@@ -282,8 +393,22 @@ void Fuzzer::AlarmCallback() {
 #endif
   if (!RunningUserCallback)
     return; // We have not started running units yet.
-  size_t Seconds =
-      duration_cast<seconds>(system_clock::now() - UnitStartTime).count();
+  size_t Seconds = 0;
+  FuzzingThread *Slowest = nullptr;
+  if (Threads.empty()) {
+    Seconds =
+        duration_cast<seconds>(system_clock::now() - UnitStartTime).count();
+  } else {
+    // Report the thread that has been running its unit for the longest time.
+    uint64_t Now = NowMs();
+    for (auto &T : Threads) {
+      uint64_t Start = T->RunStartMs;
+      if (Start && Start < Now && (Now - Start) / 1000 > Seconds) {
+        Seconds = (Now - Start) / 1000;
+        Slowest = T.get();
+      }
+    }
+  }
   if (Seconds == 0)
     return;
   if (Options.Verbosity >= 2)
@@ -292,6 +417,8 @@ void Fuzzer::AlarmCallback() {
     if (EF->__sanitizer_acquire_crash_state &&
         !EF->__sanitizer_acquire_crash_state())
       return;
+    if (Slowest)
+      CurrentThread = Slowest; // Dump its unit.
     Printf("ALARM: working on the last Unit for %zd seconds\n", Seconds);
     Printf("       and the timeout value is %d (use -timeout=N to change)\n",
            Options.UnitTimeoutSec);
@@ -325,7 +452,7 @@ void Fuzzer::PrintStats(const char *Where, const char *End, size_t Units,
   size_t ExecPerSec = execPerSec();
   if (!Options.Verbosity)
     return;
-  Printf("#%zd\t%s", TotalNumberOfRuns, Where);
+  Printf("#%zd\t%s", TotalNumberOfRuns.load(), Where);
   if (size_t N = TPC.GetTotalPCCoverage())
     Printf(" cov: %zd", N);
   if (size_t N = Features ? Features : Corpus.NumFeatures())
@@ -361,7 +488,7 @@ void Fuzzer::PrintFinalStats() {
   if (!Options.PrintFinalStats)
     return;
   size_t ExecPerSec = execPerSec();
-  Printf("stat::number_of_executed_units: %zd\n", TotalNumberOfRuns);
+  Printf("stat::number_of_executed_units: %zd\n", TotalNumberOfRuns.load());
   Printf("stat::average_exec_per_sec:     %zd\n", ExecPerSec);
   Printf("stat::new_units_added:          %zd\n", NumberOfNewUnitsAdded);
   Printf("stat::slowest_unit_time_sec:    %zd\n", TimeOfLongestUnitInSeconds);
@@ -438,6 +565,11 @@ void Fuzzer::PrintPulseAndReportSlowInput(const uint8_t *Data, size_t Size) {
   if (!(TotalNumberOfRuns & (TotalNumberOfRuns - 1)) &&
       secondsSinceProcessStartUp() >= 2)
     PrintStats("pulse ");
+  ReportSlowInput(Data, Size, TimeOfUnit);
+}
+
+void Fuzzer::ReportSlowInput(const uint8_t *Data, size_t Size,
+                             long TimeOfUnit) {
   if (TimeOfUnit > TimeOfLongestUnitInSeconds * 1.1 &&
       TimeOfUnit >= Options.ReportSlowUnits) {
     TimeOfLongestUnitInSeconds = TimeOfUnit;
@@ -600,14 +732,14 @@ void Fuzzer::PrintStatusForNewUnit(const Unit &U, const char *Text) {
   PrintStats(Text, "");
   if (Options.Verbosity) {
     Printf(" L: %zd/%zd ", U.size(), Corpus.MaxInputSize());
-    MD.PrintMutationSequence();
+    GetMD().PrintMutationSequence();
     Printf("\n");
   }
 }
 
 void Fuzzer::ReportNewCoverage(InputInfo *II, const Unit &U) {
   II->NumSuccessfullMutations++;
-  MD.RecordSuccessfulMutationSequence();
+  GetMD().RecordSuccessfulMutationSequence();
   PrintStatusForNewUnit(U, II->Reduced ? "REDUCE" : "NEW   ");
   WriteToOutputCorpus(U);
   NumberOfNewUnitsAdded++;
@@ -714,6 +846,153 @@ void Fuzzer::MutateAndTestOne() {
   II.NeedsEnergyUpdate = true;
 }
 
+// Runs the callback on the unit of \p T, concurrently with the other threads.
+// Returns whether the run looks like it found new features, the features are
+// told apart from the ones of the concurrent runs only approximately.
+bool Fuzzer::RunInThread(FuzzingThread &T, size_t Size) {
+  const uint8_t *Data = T.UnitData.get();
+  std::unique_ptr<uint8_t[]> DataCopy(new uint8_t[Size]);
+  memcpy(DataCopy.get(), Data, Size);
+  if (EF->__msan_unpoison)
+    EF->__msan_unpoison(DataCopy.get(), Size);
+  if (EF->__msan_unpoison_param)
+    EF->__msan_unpoison_param(2);
+  T.UnitSize = Size;
+  size_t Runs = ++TotalNumberOfRuns;
+  bool MayHaveNewFeatures = false;
+  TheRunLock.LockShared();
+  TPC.CollectCounterFeaturesSince(T.Snapshot.data(), [](size_t) {});
+  auto StartTime = system_clock::now();
+  {
+    ScopedEnableMsanInterceptorChecks S;
+    T.RunStartMs = NowMs();
+    RunningUserCallback = true;
+    int Res = CB(DataCopy.get(), Size);
+    T.RunStartMs = 0;
+    (void)Res;
+    assert(Res == 0);
+  }
+  auto StopTime = system_clock::now();
+  TPC.CollectCounterFeaturesSince(T.Snapshot.data(), [&](size_t Feature) {
+    if (Corpus.IsFeatureNew(Feature, Size, Options.Shrink))
+      MayHaveNewFeatures = true;
+  });
+  TheRunLock.UnlockShared();
+  if (!LooseMemeq(DataCopy.get(), Data, Size))
+    CrashOnOverwrittenData();
+  T.UnitSize = 0;
+
+  long TimeOfUnit = duration_cast<seconds>(StopTime - StartTime).count();
+  if ((!(Runs & (Runs - 1)) && secondsSinceProcessStartUp() >= 2) ||
+      TimeOfUnit >= Options.ReportSlowUnits) {
+    std::lock_guard<std::mutex> Lock(CorpusMutex);
+    if (!(Runs & (Runs - 1)))
+      PrintStats("pulse ");
+    ReportSlowInput(Data, Size, TimeOfUnit);
+  }
+  return MayHaveNewFeatures;
+}
+
+// Like MutateAndTestOne, for one of the threads of -threads. The units that
+// may have new features are run again alone, so that the corpus gets the
+// exact features of the unit.
+void Fuzzer::MutateAndTestOneInThread(FuzzingThread &T) {
+  auto &MD = T.MD;
+  InputInfo *II;
+  size_t Size, CurrentMaxMutationLen;
+  {
+    std::lock_guard<std::mutex> Lock(CorpusMutex);
+    MD.StartMutationSequence();
+    II = &Corpus.ChooseUnitToMutate(MD.GetRand());
+    if (Options.DoCrossOver) {
+      T.CrossOverWith = Corpus.ChooseUnitToMutate(MD.GetRand()).U;
+      MD.SetCrossOverWith(&T.CrossOverWith);
+    }
+    memcpy(T.BaseSha1, II->Sha1, sizeof(T.BaseSha1));
+    Size = II->U.size();
+    assert(Size <= MaxInputLen && "Oversized Unit");
+    memcpy(T.UnitData.get(), II->U.data(), Size);
+    T.Mask.clear();
+    if (II->HasFocusFunction)
+      T.Mask = II->DataFlowTraceForFocusFunction;
+    CurrentMaxMutationLen =
+        Min(MaxMutationLen, Max(Size, TmpMaxMutationLen));
+  }
+  assert(CurrentMaxMutationLen > 0);
+
+  size_t NumExecutedMutations = 0;
+  for (int i = 0; i < Options.MutateDepth; i++) {
+    if (TotalNumberOfRuns >= Options.MaxNumberOfRuns || StopThreads)
+      break;
+    MaybeExitGracefully();
+    size_t NewSize = 0;
+    if (!T.Mask.empty() && Size <= CurrentMaxMutationLen)
+      NewSize = MD.MutateWithMask(T.UnitData.get(), Size, Size, T.Mask);
+    if (!NewSize)
+      NewSize = MD.Mutate(T.UnitData.get(), Size, CurrentMaxMutationLen);
+    assert(NewSize > 0 && "Mutator returned empty unit");
+    assert(NewSize <= CurrentMaxMutationLen && "Mutator return oversized unit");
+    Size = NewSize;
+    NumExecutedMutations++;
+
+    if (!RunInThread(T, Size)) {
+      if (Options.ReduceDepth)
+        break;
+      continue;
+    }
+    bool NewCov;
+    {
+      ScopedRunAlone RunAlone;
+      T.UnitSize = Size;
+      T.RunStartMs = NowMs();
+      NewCov = RunOne(T.UnitData.get(), Size, /*MayDeleteFile=*/true, II);
+      T.RunStartMs = 0;
+      T.UnitSize = 0;
+      if (NewCov)
+        ReportNewCoverage(II, {T.UnitData.get(), T.UnitData.get() + Size});
+    }
+    if (NewCov)
+      break; // We will mutate this input more in the next rounds.
+  }
+
+  std::lock_guard<std::mutex> Lock(CorpusMutex);
+  II->NumExecutedMutations += NumExecutedMutations;
+  while (NumExecutedMutations--)
+    Corpus.IncrementNumExecutedMutations();
+  II->NeedsEnergyUpdate = true;
+}
+
+void Fuzzer::FuzzingThreadLoop(FuzzingThread &T) {
+  IsMyThread = true;
+  CurrentThread = &T;
+  while (!StopThreads && TotalNumberOfRuns < Options.MaxNumberOfRuns &&
+         !TimedOut())
+    MutateAndTestOneInThread(T);
+}
+
+// The main thread is the first of the threads: it keeps doing the periodic
+// work of Loop between its own mutations.
+void Fuzzer::StartFuzzingThreads() {
+  for (int i = 0; i < Options.Threads; i++)
+    Threads.push_back(std::unique_ptr<FuzzingThread>(new FuzzingThread(
+        static_cast<unsigned>(MD.GetRand()()), Options, MaxInputLen, MD)));
+  if (Options.Verbosity)
+    Printf("INFO: fuzzing in %d threads\n", Options.Threads);
+  CurrentThread = Threads[0].get();
+  for (size_t i = 1; i < Threads.size(); i++) {
+    FuzzingThread *T = Threads[i].get();
+    T->Thread = std::thread([this, T] { FuzzingThreadLoop(*T); });
+  }
+}
+
+void Fuzzer::StopFuzzingThreads() {
+  StopThreads = true;
+  for (size_t i = 1; i < Threads.size(); i++)
+    Threads[i]->Thread.join();
+  CurrentThread = nullptr;
+  RunningUserCallback = false;
+}
+
 void Fuzzer::PurgeAllocator() {
   if (Options.PurgeAllocatorIntervalSec < 0 || !EF->__sanitizer_purge_allocator)
     return;
@@ -805,6 +1084,8 @@ void Fuzzer::Loop(Vector<SizedFile> &CorporaFiles) {
 
   TmpMaxMutationLen =
       Min(MaxMutationLen, Max(size_t(4), Corpus.MaxInputSize()));
+  if (Options.Threads > 1)
+    StartFuzzingThreads();
 
   while (true) {
     auto Now = system_clock::now();
@@ -813,6 +1094,7 @@ void Fuzzer::Loop(Vector<SizedFile> &CorporaFiles) {
       break;
     if (duration_cast<seconds>(Now - LastCorpusReload).count() >=
         Options.ReloadIntervalSec) {
+      ScopedRunAlone RunAlone;
       RereadOutputCorpus(MaxInputLen);
       LastCorpusReload = system_clock::now();
     }
@@ -822,6 +1104,9 @@ void Fuzzer::Loop(Vector<SizedFile> &CorporaFiles) {
       break;
 
     // Update TmpMaxMutationLen
+    std::unique_lock<std::mutex> Lock(CorpusMutex, std::defer_lock);
+    if (!Threads.empty())
+      Lock.lock();
     if (Options.LenControl) {
       if (TmpMaxMutationLen < MaxMutationLen &&
           TotalNumberOfRuns - LastCorpusUpdateRun >
@@ -834,12 +1119,23 @@ void Fuzzer::Loop(Vector<SizedFile> &CorporaFiles) {
       TmpMaxMutationLen = MaxMutationLen;
     }
 
+    if (Lock)
+      Lock.unlock();
+
     // Perform several mutations and runs.
-    MutateAndTestOne();
+    if (Threads.empty())
+      MutateAndTestOne();
+    else
+      MutateAndTestOneInThread(*Threads[0]);
 
     PurgeAllocator();
   }
 
+  if (!Threads.empty()) {
+    StopFuzzingThreads();
+    for (auto &T : Threads)
+      T->MD.PrintRecommendedDictionary();
+  }
   PrintStats("DONE  ", "\n");
   MD.PrintRecommendedDictionary();
 }
@@ -559,4 +559,9 @@ void MutationDispatcher::AddWordToManualDictionary(const Word &W) {
       {W, std::numeric_limits<size_t>::max()});
 }
 
+void MutationDispatcher::CopyManualDictionary(const MutationDispatcher &Other) {
+  for (auto &DE : Other.ManualDictionary)
+    AddWordToManualDictionary(DE.GetW());
+}
+
 }  // namespace fuzzer
@@ -86,6 +86,9 @@ public:
 
   void AddWordToManualDictionary(const Word &W);
 
+  /// Adds the words of the manual dictionary of \p Other to this one.
+  void CopyManualDictionary(const MutationDispatcher &Other);
+
   void PrintRecommendedDictionary();
 
   void SetCrossOverWith(const Unit *U) { CrossOverWith = U; }
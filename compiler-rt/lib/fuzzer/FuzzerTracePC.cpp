@@ -387,6 +387,15 @@ void TracePC::ClearInlineCounters() {
   });
 }
 
+size_t TracePC::NumCounterBytes() const {
+  size_t Size = ExtraCountersEnd() - ExtraCountersBegin();
+  for (size_t m = 0; m < NumModules; m++)
+    for (size_t r = 0; r < Modules[m].NumRegions; r++)
+      if (Modules[m].Regions[r].Enabled)
+        Size += Modules[m].Regions[r].Stop - Modules[m].Regions[r].Start;
+  return Size;
+}
+
 ATTRIBUTE_NO_SANITIZE_ALL
 void TracePC::RecordInitialStack() {
   int stack;
@@ -81,6 +81,14 @@ class TracePC {
   void UpdateObservedPCs();
   template <class Callback> void CollectFeatures(Callback CB) const;
 
+  // The threads of -threads run the callback concurrently, without resetting
+  // the counters in between. Each thread keeps a snapshot of the counters, of
+  // NumCounterBytes() bytes, and collects the features of the increments made
+  // since it last updated its snapshot, by itself or by other threads.
+  size_t NumCounterBytes() const;
+  template <class Callback>
+  void CollectCounterFeaturesSince(uint8_t *Snapshot, Callback CB) const;
+
   void ResetMaps() {
     ValueProfileMap.Reset();
     ClearExtraCounters();
@@ -284,6 +292,51 @@ void TracePC::CollectFeatures(Callback HandleFeature) const {
     HandleFeature(FirstFeature + StackDepthStepFunction(MaxStackOffset / 8));
 }
 
+template <class Callback>  // void Callback(size_t Feature)
+ATTRIBUTE_NO_SANITIZE_ALL
+void TracePC::CollectCounterFeaturesSince(uint8_t *Snapshot,
+                                          Callback HandleFeature) const {
+  typedef uintptr_t LargeType;
+  const size_t Step = sizeof(LargeType);
+  // The counters keep changing while they are read: each word is read once,
+  // and what is compared with the snapshot is what is stored in it.
+  auto HandleCounters = [&](const uint8_t *Begin, const uint8_t *End,
+                            size_t FirstFeature) {
+    size_t Size = End - Begin;
+    for (size_t I = 0; I < Size; I += Step) {
+      size_t N = std::min(Step, Size - I);
+      uint8_t Now[Step], Before[Step];
+      memcpy(Now, Begin + I, N);
+      memcpy(Before, Snapshot, N);
+      if (memcmp(Now, Before, N)) {
+        memcpy(Snapshot, Now, N);
+        for (size_t J = 0; J < N; J++) {
+          if (uint8_t Delta = Now[J] - Before[J]) {
+            if (UseCounters)
+              HandleFeature(FirstFeature + (I + J) * 8 +
+                            CounterToFeature(Delta));
+            else
+              HandleFeature(FirstFeature + I + J);
+          }
+        }
+      }
+      Snapshot += N;
+    }
+    return Size;
+  };
+
+  size_t FirstFeature = 0;
+  for (size_t i = 0; i < NumModules; i++) {
+    for (size_t r = 0; r < Modules[i].NumRegions; r++) {
+      if (!Modules[i].Regions[r].Enabled) continue;
+      FirstFeature += 8 * HandleCounters(Modules[i].Regions[r].Start,
+                                         Modules[i].Regions[r].Stop,
+                                         FirstFeature);
+    }
+  }
+  HandleCounters(ExtraCountersBegin(), ExtraCountersEnd(), FirstFeature);
+}
+
 extern TracePC TPC;
 
 }  // namespace fuzzer
@@ -20,6 +20,8 @@
 #define INSTR_PROF_VALUE_PROF_DATA
 #include "profile/InstrProfData.inc"
 
+COMPILER_RT_VISIBILITY void (*MergeThreadCountersHook)(void) = NULL;
+
 COMPILER_RT_VISIBILITY uint64_t __llvm_profile_get_magic(void) {
   return sizeof(void *) == sizeof(uint64_t) ? (INSTR_PROF_RAW_MAGIC_64)
                                             : (INSTR_PROF_RAW_MAGIC_32);
@@ -45,6 +47,10 @@ COMPILER_RT_VISIBILITY void __llvm_profile_reset_counters(void) {
   uint64_t *I = __llvm_profile_begin_counters();
   uint64_t *E = __llvm_profile_end_counters();
 
+  /* Merge the counters of the threads first, so that what they counted so far
+   * is cleared as well. */
+  if (MergeThreadCountersHook)
+    MergeThreadCountersHook();
   memset(I, 0, sizeof(uint64_t) * (E - I));
 
   const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
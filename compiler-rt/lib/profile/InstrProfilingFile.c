@@ -83,11 +83,15 @@ typedef struct lprofFilename {
    * 2 profile data files. %1m is equivalent to %m. Also %m specifier
    * can only appear once at the end of the name pattern. */
   unsigned MergePoolSize;
+  /* When set by the %a specifier along with %m, the profile file is mapped
+   * at startup and the counters are added atomically to the mapping when the
+   * profile is written, instead of merging the profile under the file lock. */
+  unsigned AtomicMerging;
   ProfileNameSpecifier PNS;
 } lprofFilename;
 
 static lprofFilename lprofCurFilename = {0, 0, 0, {0},        {0},
-                                         0, 0, 0, PNS_unknown};
+                                         0, 0, 0, 0, PNS_unknown};
 
 static int ProfileMergeRequested = 0;
 static int isProfileMergeRequested() { return ProfileMergeRequested; }
@@ -324,11 +328,37 @@ static FILE *getFileObject(const char *OutputName) {
   return fopen(OutputName, "ab");
 }
 
+/* With atomic merging, the mapping of the profile file and its counters. */
+static char *SharedProfile = NULL;
+static uint64_t SharedProfileSize = 0;
+static uint64_t *SharedCounters = NULL;
+
+/* Add the counters of the process to the counters of the profile file and
+ * clear them, so that a later dump does not add them again. Value profile
+ * data is not merged in this mode. */
+static int addCountersToSharedProfile(void) {
+  uint64_t *I, *E = __llvm_profile_end_counters();
+  uint64_t *Dst = SharedCounters;
+
+  if (MergeThreadCountersHook)
+    MergeThreadCountersHook();
+  for (I = __llvm_profile_begin_counters(); I < E; ++I, ++Dst) {
+    if (!*I)
+      continue;
+    __sync_fetch_and_add(Dst, *I);
+    *I = 0;
+  }
+  return 0;
+}
+
 /* Write profile data to file \c OutputName.  */
 static int writeFile(const char *OutputName) {
   int RetVal;
   FILE *OutputFile;
 
+  if (SharedCounters)
+    return addCountersToSharedProfile();
+
   int MergeDone = 0;
   VPMergeHook = &lprofMergeValueProfData;
   if (doMerging())
@@ -671,6 +701,112 @@ static void initializeProfileForContinuousMode(void) {
 #endif // defined(__Fuchsia__) || defined(_WIN32)
 }
 
+#if !defined(_WIN32)
+/* Create the profile file \p Filename from the profile of this process,
+ * unless another process creates it first. The profile is written to a
+ * temporary file linked in place, so that the other processes never see a
+ * partial profile and never wait for a lock. Returns -1 on failure. */
+static int createSharedProfile(const char *Filename) {
+  size_t Length = strlen(Filename) + MAX_PID_SIZE + sizeof(".tmp");
+  char *TmpFilename = (char *)COMPILER_RT_ALLOCA(Length + 1);
+  ProfDataWriter fileWriter;
+  FILE *File;
+  int RetVal;
+
+  snprintf(TmpFilename, Length + 1, "%s.%ld.tmp", Filename, (long)getpid());
+  File = fopen(TmpFilename, "wb");
+  if (!File)
+    return -1;
+
+  setupIOBuffer();
+  initFileWriter(&fileWriter, File);
+  RetVal = lprofWriteData(&fileWriter, NULL, 0);
+  if (fclose(File))
+    RetVal = -1;
+  if (!RetVal) {
+    if (!link(TmpFilename, Filename)) {
+      /* The counts of the process so far are in the profile file. */
+      uint64_t *CountersBegin = __llvm_profile_begin_counters();
+      memset(CountersBegin, 0,
+             sizeof(uint64_t) *
+                 (__llvm_profile_end_counters() - CountersBegin));
+    } else if (errno != EEXIST)
+      RetVal = -1;
+  }
+  unlink(TmpFilename);
+  return RetVal;
+}
+#endif
+
+/* Map the profile file for atomic merging, creating it if needed, and check
+ * that it is compatible with the data in this process. On failure, the
+ * profile is merged under the file lock when it is written. */
+static void initializeAtomicMerging(void) {
+  if (SharedProfile) {
+    (void)munmap(SharedProfile, SharedProfileSize);
+    SharedProfile = NULL;
+    SharedCounters = NULL;
+  }
+  if (!lprofCurFilename.AtomicMerging)
+    return;
+
+#if defined(_WIN32)
+  PROF_ERR("%s\n", "Atomic merging not yet supported on Windows.");
+#else
+  int Length = getCurFilenameLength();
+  char *FilenameBuf = (char *)COMPILER_RT_ALLOCA(Length + 1);
+  const char *Filename = getCurFilename(FilenameBuf, 0);
+  if (!Filename)
+    return;
+
+  FILE *File = fopen(Filename, "r+b");
+  if (!File && errno == ENOENT) {
+    if (createSharedProfile(Filename) == -1) {
+      PROF_ERR("Unable to create profile for atomic merging: %s\n",
+               strerror(errno));
+      return;
+    }
+    File = fopen(Filename, "r+b");
+  }
+  if (!File) {
+    PROF_ERR("Unable to open profile for atomic merging: %s\n",
+             strerror(errno));
+    return;
+  }
+
+  uint64_t ProfileFileSize;
+  if (getProfileFileSizeForMerging(File, &ProfileFileSize) == -1 ||
+      !ProfileFileSize) {
+    fclose(File);
+    return;
+  }
+
+  char *Profile = (char *)mmap(NULL, ProfileFileSize, PROT_READ | PROT_WRITE,
+                               MAP_SHARED | MAP_FILE, fileno(File), 0);
+  fclose(File);
+  if (Profile == MAP_FAILED) {
+    PROF_ERR("Unable to mmap profile for atomic merging: %s\n",
+             strerror(errno));
+    return;
+  }
+  if (__llvm_profile_check_compatibility(Profile, ProfileFileSize)) {
+    (void)munmap(Profile, ProfileFileSize);
+    PROF_WARN("Unable to merge profile data atomically: %s\n",
+              "source profile file is not compatible.");
+    return;
+  }
+
+  const __llvm_profile_data *DataBegin = __llvm_profile_begin_data();
+  const __llvm_profile_data *DataEnd = __llvm_profile_end_data();
+  uint64_t DataSize = __llvm_profile_get_data_size(DataBegin, DataEnd);
+  SharedProfile = Profile;
+  SharedProfileSize = ProfileFileSize;
+  SharedCounters =
+      (uint64_t *)(Profile + sizeof(__llvm_profile_header) +
+                   DataSize * sizeof(__llvm_profile_data));
+#endif // defined(_WIN32)
+}
+
 static const char *DefaultProfileName = "default.profraw";
 static void resetFilenameToDefault(void) {
   if (lprofCurFilename.FilenamePat && lprofCurFilename.OwnsFilenamePat) {
@@ -706,7 +842,7 @@ static int parseFilenamePattern(const char *FilenamePat,
   int NumPids = 0, NumHosts = 0, I;
   char *PidChars = &lprofCurFilename.PidChars[0];
   char *Hostname = &lprofCurFilename.Hostname[0];
-  int MergingEnabled = 0;
+  int MergingEnabled = 0, AtomicMerging = 0;
 
   /* Clean up cached prefix and filename.  */
   if (lprofCurFilename.ProfilePathPrefix)
@@ -754,6 +890,8 @@ static int parseFilenamePattern(const char *FilenamePat,
         __llvm_profile_set_page_size(getpagesize());
         __llvm_profile_enable_continuous_mode();
         I++; /* advance to 'c' */
+      } else if (FilenamePat[I] == 'a') {
+        AtomicMerging = 1;
       } else {
         unsigned MergePoolSize = getMergePoolSize(FilenamePat, &I);
         if (!MergePoolSize)
@@ -768,6 +906,15 @@ static int parseFilenamePattern(const char *FilenamePat,
       }
     }
 
+  /* Continuous mode already merges the counters in place. */
+  if (AtomicMerging && !__llvm_profile_is_continuous_mode_enabled()) {
+    if (!MergingEnabled) {
+      PROF_WARN("%%a specifier requires %%m in %s.\n", FilenamePat);
+      return -1;
+    }
+    lprofCurFilename.AtomicMerging = 1;
+  }
+
   lprofCurFilename.NumPids = NumPids;
   lprofCurFilename.NumHosts = NumHosts;
   return 0;
@@ -815,6 +962,7 @@ static void parseAndSetFilename(const char *FilenamePat,
     else
       initializeProfileForContinuousMode();
   }
+  initializeAtomicMerging();
 }
 
 /* Return buffer length that is required to store the current profile
@@ -196,5 +196,8 @@ COMPILER_RT_VISIBILITY extern uint32_t VPMaxNumValsPerSite;
 COMPILER_RT_VISIBILITY extern ValueProfNode *CurrentVNode;
 COMPILER_RT_VISIBILITY extern ValueProfNode *EndVNode;
 extern void (*VPMergeHook)(struct ValueProfData *, __llvm_profile_data *);
+/* Adds the counters of the threads to the counters of the module, set once
+ * a thread allocates its own counters. */
+COMPILER_RT_VISIBILITY extern void (*MergeThreadCountersHook)(void);
 
 #endif
@@ -0,0 +1,157 @@
+/*===- InstrProfilingThread.c - Per-thread profile counters ---------------===*\
+|*
+|* Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+|* See https://llvm.org/LICENSE.txt for license information.
+|* SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+|*
+\*===----------------------------------------------------------------------===*/
+
+/* With -mllvm -instrprof-per-thread-counters, the instrumented code adds
+ * __llvm_profile_thread_counter_bias to the address of the counters, so that
+ * every thread increments its own copy of the counters instead of sharing the
+ * cache lines of the counters with the other threads. The copy is allocated
+ * when the thread first runs instrumented code, and added to the counters of
+ * the module when the thread exits and before the profile is written. */
+
+#if !defined(_WIN32) && !defined(__Fuchsia__)
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#include "InstrProfiling.h"
+#include "InstrProfilingInternal.h"
+
+extern intptr_t __llvm_profile_counter_bias;
+
+typedef struct ThreadCounters {
+  struct ThreadCounters *Prev, *Next;
+  size_t MapSize;
+  /* The values of the counters at the last merge, after Counters. */
+  uint64_t *Merged;
+  uint64_t Counters[];
+} ThreadCounters;
+
+/* The offset from the counters of the module to the counters of the current
+ * thread, 0 until they are allocated. */
+COMPILER_RT_VISIBILITY __thread intptr_t __llvm_profile_thread_counter_bias
+    __attribute__((tls_model("initial-exec")));
+
+/* Set once the counters of the thread have been merged, or could not be
+ * allocated: the instrumented code of the thread then increments the counters
+ * of the module, including the code run by other thread-specific data
+ * destructors. */
+static __thread int UseModuleCounters
+    __attribute__((tls_model("initial-exec")));
+
+static pthread_once_t KeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t Key;
+static int KeyCreated;
+
+/* The counters of the live threads. */
+static pthread_mutex_t Lock = PTHREAD_MUTEX_INITIALIZER;
+static ThreadCounters *Threads;
+
+static uint64_t *getMergeDestination(void) {
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  if (lprofRuntimeCounterRelocation())
+    return (uint64_t *)((char *)CountersBegin + __llvm_profile_counter_bias);
+  return CountersBegin;
+}
+
+/* Add to the counters of the module what the counters of \p T counted since
+ * the last merge. The thread owning \p T may still be running, and its
+ * increments are plain loads and stores: only that thread writes its
+ * counters, so that an increment racing with the merge is added by the next
+ * merge rather than lost or added twice. */
+static void mergeThreadCounters(ThreadCounters *T) {
+  uint64_t *Dst = getMergeDestination();
+  size_t I, N = __llvm_profile_end_counters() - __llvm_profile_begin_counters();
+  for (I = 0; I < N; ++I) {
+    uint64_t Count = __atomic_load_n(&T->Counters[I], __ATOMIC_RELAXED);
+    if (Count == T->Merged[I])
+      continue;
+    __sync_fetch_and_add(&Dst[I], Count - T->Merged[I]);
+    T->Merged[I] = Count;
+  }
+}
+
+static void mergeAllThreadCounters(void) {
+  ThreadCounters *T;
+  pthread_mutex_lock(&Lock);
+  for (T = Threads; T; T = T->Next)
+    mergeThreadCounters(T);
+  pthread_mutex_unlock(&Lock);
+}
+
+static void releaseThreadCounters(void *Arg) {
+  ThreadCounters *T = (ThreadCounters *)Arg;
+  __llvm_profile_thread_counter_bias = 0;
+  UseModuleCounters = 1;
+
+  pthread_mutex_lock(&Lock);
+  mergeThreadCounters(T);
+  if (T->Prev)
+    T->Prev->Next = T->Next;
+  else
+    Threads = T->Next;
+  if (T->Next)
+    T->Next->Prev = T->Prev;
+  pthread_mutex_unlock(&Lock);
+
+  munmap(T, T->MapSize);
+}
+
+static void createKey(void) {
+  KeyCreated = !pthread_key_create(&Key, releaseThreadCounters);
+}
+
+/* Called by the instrumented code when __llvm_profile_thread_counter_bias is
+ * 0. Returns the new bias, or 0 to increment the counters of the module when
+ * the counters of the thread cannot be allocated. */
+COMPILER_RT_VISIBILITY intptr_t __llvm_profile_get_thread_counter_bias(void) {
+  uint64_t *CountersBegin = __llvm_profile_begin_counters();
+  size_t NumCounters = __llvm_profile_end_counters() - CountersBegin;
+  size_t MapSize;
+  ThreadCounters *T;
+
+  if (UseModuleCounters || !NumCounters)
+    return 0;
+  pthread_once(&KeyOnce, createKey);
+  if (!KeyCreated)
+    return 0;
+
+  MapSize = sizeof(ThreadCounters) + 2 * NumCounters * sizeof(uint64_t);
+  T = (ThreadCounters *)mmap(NULL, MapSize, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (T == MAP_FAILED) {
+    PROF_WARN("Unable to allocate the counters of the thread: %s\n",
+              strerror(errno));
+    UseModuleCounters = 1;
+    return 0;
+  }
+  T->MapSize = MapSize;
+  T->Merged = T->Counters + NumCounters;
+  T->Prev = NULL;
+  if (pthread_setspecific(Key, T)) {
+    munmap(T, MapSize);
+    UseModuleCounters = 1;
+    return 0;
+  }
+
+  pthread_mutex_lock(&Lock);
+  T->Next = Threads;
+  if (Threads)
+    Threads->Prev = T;
+  Threads = T;
+  MergeThreadCountersHook = mergeAllThreadCounters;
+  pthread_mutex_unlock(&Lock);
+
+  __llvm_profile_thread_counter_bias =
+      (intptr_t)((char *)T->Counters - (char *)CountersBegin);
+  return __llvm_profile_thread_counter_bias;
+}
+
+#endif
@@ -11,6 +11,11 @@
 // then evicts to global FIFO queue. When the queue reaches specified threshold,
 // oldest memory is recycled.
 //
+// The global queue is sharded, a thread evicts to the shard picked by the
+// address of its cache, so that threads freeing concurrently rarely contend
+// on the same shard. Recycling takes the oldest batches of the shards in
+// turn, and can be left to a background thread.
+//
 //===----------------------------------------------------------------------===//
 
 #ifndef SANITIZER_QUARANTINE_H
@@ -68,6 +73,13 @@ struct QuarantineBatch {
 
 COMPILER_CHECK(sizeof(QuarantineBatch) <= (1 << 13));  // 8Kb.
 
+struct QuarantineStats {
+  uptr batch_count;
+  uptr total_bytes;
+  uptr total_overhead_bytes;
+  uptr total_quarantine_chunks;
+};
+
 // The callback interface is:
 // void Callback::Recycle(Node *ptr);
 // void *cb.Allocate(uptr size);
@@ -77,8 +89,7 @@ class Quarantine {
  public:
   typedef QuarantineCache<Callback> Cache;
 
-  explicit Quarantine(LinkerInitialized)
-      : cache_(LINKER_INITIALIZED) {
+  explicit Quarantine(LinkerInitialized) {
   }
 
   void Init(uptr size, uptr cache_size) {
@@ -90,10 +101,31 @@ class Quarantine {
     atomic_store_relaxed(&min_size_, size / 10 * 9);  // 90% of max size.
     atomic_store_relaxed(&max_cache_size_, cache_size);
 
-    cache_mutex_.Init();
+    for (uptr i = 0; i < kNumShards; i++)
+      shards_[i].mutex.Init();
     recycle_mutex_.Init();
   }
 
+  // Lets a background thread recycle the quarantine: a thread evicting its
+  // cache then only requests the recycling, unless the global queue is
+  // already over its limit by more than the recycling leeway.
+  void EnableBackgroundRecycling() {
+    atomic_store_relaxed(&background_recycling_, 1);
+  }
+
+  bool RecycleRequested() const {
+    return atomic_load_relaxed(&recycle_requested_);
+  }
+
+  // Called by the background thread when RecycleRequested().
+  void NOINLINE RecycleInBackground(Callback cb) {
+    atomic_store_relaxed(&recycle_requested_, 0);
+    if (Size() <= GetSize())
+      return;
+    recycle_mutex_.Lock();
+    Recycle(atomic_load_relaxed(&min_size_), cb);
+  }
+
   uptr GetSize() const { return atomic_load_relaxed(&max_size_); }
   uptr GetCacheSize() const {
     return atomic_load_relaxed(&max_cache_size_);
@@ -113,53 +145,99 @@ class Quarantine {
   }
 
   void NOINLINE Drain(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
+    uptr size = Transfer(c);
+    uptr max_size = GetSize();
+    if (size <= max_size)
+      return;
+    if (atomic_load_relaxed(&background_recycling_) &&
+        size - max_size <= max_size - atomic_load_relaxed(&min_size_)) {
+      if (!RecycleRequested())
+        atomic_store_relaxed(&recycle_requested_, 1);
+      return;
     }
-    if (cache_.Size() > GetSize() && recycle_mutex_.TryLock())
+    if (recycle_mutex_.TryLock())
       Recycle(atomic_load_relaxed(&min_size_), cb);
   }
 
   void NOINLINE DrainAndRecycle(Cache *c, Callback cb) {
-    {
-      SpinMutexLock l(&cache_mutex_);
-      cache_.Transfer(c);
-    }
+    Transfer(c);
     recycle_mutex_.Lock();
     Recycle(0, cb);
   }
 
+  // Total memory in the global queue, including internal accounting.
+  uptr Size() const { return atomic_load_relaxed(&size_); }
+
   void PrintStats() const {
     // It assumes that the world is stopped, just as the allocator's PrintStats.
     Printf("Quarantine limits: global: %zdMb; thread local: %zdKb\n",
            GetSize() >> 20, GetCacheSize() >> 10);
-    cache_.PrintStats();
+    QuarantineStats stats = {};
+    for (uptr i = 0; i < kNumShards; i++)
+      shards_[i].cache.GetStats(&stats);
+    Cache::PrintStats(stats);
   }
 
  private:
+  static const uptr kNumShardsLog = 4;
+  static const uptr kNumShards = 1 << kNumShardsLog;
+
+  struct Shard {
+    Shard() : cache(LINKER_INITIALIZED) {}
+    StaticSpinMutex mutex;
+    Cache cache;
+    char pad[kCacheLineSize];
+  };
+
   // Read-only data.
   char pad0_[kCacheLineSize];
   atomic_uintptr_t max_size_;
   atomic_uintptr_t min_size_;
   atomic_uintptr_t max_cache_size_;
+  atomic_uint8_t background_recycling_;
   char pad1_[kCacheLineSize];
-  StaticSpinMutex cache_mutex_;
-  StaticSpinMutex recycle_mutex_;
-  Cache cache_;
+  atomic_uintptr_t size_;
+  atomic_uint8_t recycle_requested_;
   char pad2_[kCacheLineSize];
+  StaticSpinMutex recycle_mutex_;
+  uptr next_shard_;  // The next shard to recycle, under recycle_mutex_.
+  char pad3_[kCacheLineSize];
+  Shard shards_[kNumShards];
+
+  // The caches are thread-local or otherwise long-lived, their addresses are
+  // hashed, a thread keeps evicting to the same shard.
+  Shard &ShardFor(const Cache *c) {
+    u64 hash = (u64)reinterpret_cast<uptr>(c) * 0x9E3779B97F4A7C15ULL;
+    return shards_[hash >> (64 - kNumShardsLog)];
+  }
+
+  // Moves the content of |c| to the global queue, returns the new size of
+  // the global queue.
+  uptr Transfer(Cache *c) {
+    uptr size = c->Size();
+    Shard &s = ShardFor(c);
+    // Account for the chunks before the recycling can take them.
+    SpinMutexLock l(&s.mutex);
+    s.cache.Transfer(c);
+    return atomic_fetch_add(&size_, size, memory_order_relaxed) + size;
+  }
+
+  void SizeSub(uptr sub) {
+    atomic_fetch_sub(&size_, sub, memory_order_relaxed);
+  }
 
   void NOINLINE Recycle(uptr min_size, Callback cb) {
     Cache tmp;
-    {
-      SpinMutexLock l(&cache_mutex_);
+    for (uptr i = 0; i < kNumShards; i++) {
+      Shard &s = shards_[i];
+      SpinMutexLock l(&s.mutex);
       // Go over the batches and merge partially filled ones to
       // save some memory, otherwise batches themselves (since the memory used
       // by them is counted against quarantine limit) can overcome the actual
       // user's quarantined chunks, which diminishes the purpose of the
       // quarantine.
-      uptr cache_size = cache_.Size();
-      uptr overhead_size = cache_.OverheadSize();
+      uptr cache_size = s.cache.Size();
+      uptr overhead_size = s.cache.OverheadSize();
       CHECK_GE(cache_size, overhead_size);
       // Do the merge only when overhead exceeds this predefined limit (might
       // require some tuning). It saves us merge attempt when the batch list
@@ -168,13 +246,30 @@ class Quarantine {
       if (cache_size > overhead_size &&
           overhead_size * (100 + kOverheadThresholdPercents) >
               cache_size * kOverheadThresholdPercents) {
-        cache_.MergeBatches(&tmp);
+        s.cache.MergeBatches(&tmp);
+        SizeSub(cache_size - s.cache.Size());
+      }
+    }
+    // Extract enough chunks from the quarantine to get below the max
+    // quarantine size and leave some leeway for the newly quarantined chunks.
+    // The oldest batch of every shard is taken in turn, so that the chunks
+    // stay in the quarantine for about as long whatever their shard.
+    for (uptr empty_shards = 0;
+         Size() > min_size && empty_shards < kNumShards;) {
+      Shard &s = shards_[next_shard_];
+      next_shard_ = (next_shard_ + 1) % kNumShards;
+      QuarantineBatch *b;
+      {
+        SpinMutexLock l(&s.mutex);
+        b = s.cache.DequeueBatch();
       }
-      // Extract enough chunks from the quarantine to get below the max
-      // quarantine size and leave some leeway for the newly quarantined chunks.
-      while (cache_.Size() > min_size) {
-        tmp.EnqueueBatch(cache_.DequeueBatch());
+      if (!b) {
+        empty_shards++;
+        continue;
       }
+      empty_shards = 0;
+      SizeSub(b->size);
+      tmp.EnqueueBatch(b);
     }
     recycle_mutex_.Unlock();
     DoRecycle(&tmp, cb);
@@ -273,17 +368,21 @@ class QuarantineCache {
     SizeSub(extracted_size);
   }
 
-  void PrintStats() const {
-    uptr batch_count = 0;
-    uptr total_overhead_bytes = 0;
-    uptr total_bytes = 0;
-    uptr total_quarantine_chunks = 0;
+  // Adds the statistics of the batches of the cache to |stats|.
+  void GetStats(QuarantineStats *stats) const {
     for (List::ConstIterator it = list_.begin(); it != list_.end(); ++it) {
-      batch_count++;
-      total_bytes += (*it).size;
-      total_overhead_bytes += (*it).size - (*it).quarantined_size();
-      total_quarantine_chunks += (*it).count;
+      stats->batch_count++;
+      stats->total_bytes += (*it).size;
+      stats->total_overhead_bytes += (*it).size - (*it).quarantined_size();
+      stats->total_quarantine_chunks += (*it).count;
     }
+  }
+
+  static void PrintStats(const QuarantineStats &stats) {
+    uptr batch_count = stats.batch_count;
+    uptr total_overhead_bytes = stats.total_overhead_bytes;
+    uptr total_bytes = stats.total_bytes;
+    uptr total_quarantine_chunks = stats.total_quarantine_chunks;
     uptr quarantine_chunks_capacity = batch_count * QuarantineBatch::kSize;
     int chunks_usage_percent = quarantine_chunks_capacity == 0 ?
         0 : total_quarantine_chunks * 100 / quarantine_chunks_capacity;
@@ -18,13 +18,73 @@
 
 namespace __sanitizer {
 
+// Stack traces are stored compressed: every frame is stored as its difference
+// to the previous frame, zigzag-encoded so that small negative differences stay
+// small, then varint-encoded. The frames of a trace are usually close to each
+// other, so that most of them take 2 to 4 bytes instead of 8. This is the
+// scheme of gwp_asan's stack_trace_compressor.cpp.
+static uptr ZigzagEncode(uptr value) {
+  return (value << 1) ^ (0 - (value >> (sizeof(uptr) * 8 - 1)));
+}
+
+static uptr ZigzagDecode(uptr value) {
+  return (value >> 1) ^ (0 - (value & 1));
+}
+
+static uptr PackedSize(const uptr *frames, uptr size) {
+  uptr packed_size = 0;
+  uptr prev = 0;
+  for (uptr i = 0; i < size; i++) {
+    uptr value = ZigzagEncode(frames[i] - prev);
+    prev = frames[i];
+    do {
+      packed_size++;
+      value >>= 7;
+    } while (value);
+  }
+  return packed_size;
+}
+
+static void Pack(const uptr *frames, uptr size, u8 *packed) {
+  uptr prev = 0;
+  for (uptr i = 0; i < size; i++) {
+    uptr value = ZigzagEncode(frames[i] - prev);
+    prev = frames[i];
+    for (; value >= 0x80; value >>= 7) *packed++ = (u8)(value | 0x80);
+    *packed++ = (u8)value;
+  }
+}
+
+// Reads the frames of a packed trace in order.
+class FrameUnpacker {
+ public:
+  explicit FrameUnpacker(const u8 *packed) : packed_(packed), prev_(0) {}
+  uptr Next() {
+    uptr value = 0;
+    for (uptr shift = 0;; shift += 7) {
+      u8 byte = *packed_++;
+      value |= (uptr)(byte & 0x7f) << shift;
+      if (!(byte & 0x80)) break;
+    }
+    prev_ += ZigzagDecode(value);
+    return prev_;
+  }
+
+ private:
+  const u8 *packed_;
+  uptr prev_;
+};
+
 struct StackDepotNode {
   StackDepotNode *link;
   u32 id;
   atomic_uint32_t hash_and_use_count; // hash_bits : 12; use_count : 20;
   u32 size;
   u32 tag;
-  uptr stack[1];  // [size]
+  // The unpacked frames, allocated by the first load() of the trace. Only the
+  // traces printed in reports are ever loaded.
+  atomic_uintptr_t frames;
+  u8 packed[1];  // [PackedSize(stack, size)]
 
   static const u32 kTabSizeLog = SANITIZER_ANDROID ? 16 : 20;
   // Lower kTabSizeLog bits are equal for all items in one bucket.
@@ -40,14 +100,16 @@ struct StackDepotNode {
         atomic_load(&hash_and_use_count, memory_order_relaxed) & kHashMask;
     if ((hash & kHashMask) != hash_bits || args.size != size || args.tag != tag)
       return false;
-    uptr i = 0;
-    for (; i < size; i++) {
-      if (stack[i] != args.trace[i]) return false;
+    FrameUnpacker unpacker(packed);
+    for (uptr i = 0; i < size; i++) {
+      if (unpacker.Next() != args.trace[i]) return false;
     }
     return true;
   }
   static uptr storage_size(const args_type &args) {
-    return sizeof(StackDepotNode) + (args.size - 1) * sizeof(uptr);
+    return RoundUpTo(sizeof(StackDepotNode) - 1 +
+                         PackedSize(args.trace, args.size),
+                     sizeof(uptr));
   }
   static u32 hash(const args_type &args) {
     MurMur2HashBuilder H(args.size * sizeof(uptr));
@@ -61,10 +123,25 @@ struct StackDepotNode {
     atomic_store(&hash_and_use_count, hash & kHashMask, memory_order_relaxed);
     size = args.size;
     tag = args.tag;
-    internal_memcpy(stack, args.trace, size * sizeof(uptr));
+    atomic_store(&frames, 0, memory_order_relaxed);
+    Pack(args.trace, size, packed);
   }
-  args_type load() const {
-    return args_type(&stack[0], size, tag);
+  args_type load() {
+    uptr *stack = (uptr *)atomic_load(&frames, memory_order_acquire);
+    if (!stack) {
+      uptr *unpacked = (uptr *)PersistentAlloc(size * sizeof(uptr));
+      FrameUnpacker unpacker(packed);
+      for (uptr i = 0; i < size; i++) unpacked[i] = unpacker.Next();
+      uptr cmp = 0;
+      // The copy of the losing thread is leaked, as the persistent allocator
+      // cannot free memory.
+      if (atomic_compare_exchange_strong(&frames, &cmp, (uptr)unpacked,
+                                         memory_order_acq_rel))
+        stack = unpacked;
+      else
+        stack = (uptr *)cmp;
+    }
+    return args_type(stack, size, tag);
   }
   StackDepotHandle get_handle() { return StackDepotHandle(this); }
 
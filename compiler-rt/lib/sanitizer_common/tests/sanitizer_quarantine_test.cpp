@@ -11,8 +11,10 @@
 //===----------------------------------------------------------------------===//
 #include "sanitizer_common/sanitizer_common.h"
 #include "sanitizer_common/sanitizer_quarantine.h"
+#include "sanitizer_pthread_wrappers.h"
 #include "gtest/gtest.h"
 
+#include <sched.h>
 #include <stdlib.h>
 
 namespace __sanitizer {
@@ -176,4 +178,102 @@ TEST(SanitizerCommon, QuarantineCacheMergeBatchesALotOfBatches) {
   DeallocateCache(&to_deallocate);
 }
 
+static atomic_uintptr_t recycled_chunks;
+
+struct CountingQuarantineCallback {
+  void Recycle(void *m) {
+    atomic_fetch_add(&recycled_chunks, 1, memory_order_relaxed);
+  }
+  void *Allocate(uptr size) {
+    return malloc(size);
+  }
+  void Deallocate(void *p) {
+    free(p);
+  }
+};
+
+typedef Quarantine<CountingQuarantineCallback, void> CountingQuarantine;
+
+static const uptr kQuarantineSize = 1 << 20;
+static const uptr kQuarantineCacheSize = 1 << 14;
+static const uptr kNumQuarantineThreads = 8;
+static const uptr kNumChunksPerThread = 100000;
+
+struct QuarantineTestState {
+  CountingQuarantine *quarantine;
+  atomic_uintptr_t max_size;
+  atomic_uint8_t stop;
+};
+
+static void *QuarantineFreeThread(void *arg) {
+  QuarantineTestState *state = (QuarantineTestState *)arg;
+  CountingQuarantine::Cache cache;
+  CountingQuarantineCallback cb;
+  for (uptr i = 0; i < kNumChunksPerThread; i++) {
+    state->quarantine->Put(&cache, cb, kFakePtr, kBlockSize);
+    uptr size = state->quarantine->Size();
+    uptr max_size = atomic_load_relaxed(&state->max_size);
+    while (size > max_size &&
+           !atomic_compare_exchange_weak(&state->max_size, &max_size, size,
+                                         memory_order_relaxed)) {
+    }
+  }
+  state->quarantine->Drain(&cache, cb);
+  return nullptr;
+}
+
+static void *QuarantineRecycleThread(void *arg) {
+  QuarantineTestState *state = (QuarantineTestState *)arg;
+  while (!atomic_load_relaxed(&state->stop)) {
+    if (state->quarantine->RecycleRequested())
+      state->quarantine->RecycleInBackground(CountingQuarantineCallback());
+    else
+      sched_yield();
+  }
+  return nullptr;
+}
+
+static void TestQuarantineThreads(CountingQuarantine *quarantine,
+                                  bool background) {
+  QuarantineTestState state = {};
+  state.quarantine = quarantine;
+  atomic_store_relaxed(&recycled_chunks, 0);
+  quarantine->Init(kQuarantineSize, kQuarantineCacheSize);
+  pthread_t recycler;
+  if (background) {
+    quarantine->EnableBackgroundRecycling();
+    PTHREAD_CREATE(&recycler, nullptr, QuarantineRecycleThread, &state);
+  }
+  pthread_t threads[kNumQuarantineThreads];
+  for (uptr i = 0; i < kNumQuarantineThreads; i++)
+    PTHREAD_CREATE(&threads[i], nullptr, QuarantineFreeThread, &state);
+  for (uptr i = 0; i < kNumQuarantineThreads; i++)
+    PTHREAD_JOIN(threads[i], nullptr);
+  if (background) {
+    atomic_store_relaxed(&state.stop, 1);
+    PTHREAD_JOIN(recycler, nullptr);
+  }
+
+  // The threads may go over the limit while another one recycles.
+  EXPECT_LE(atomic_load_relaxed(&state.max_size), 2 * kQuarantineSize);
+  EXPECT_GT(atomic_load_relaxed(&recycled_chunks), 0UL);
+
+  CountingQuarantine::Cache empty;
+  quarantine->DrainAndRecycle(&empty, CountingQuarantineCallback());
+  EXPECT_EQ(0UL, quarantine->Size());
+  EXPECT_EQ(kNumQuarantineThreads * kNumChunksPerThread,
+            atomic_load_relaxed(&recycled_chunks));
+}
+
+static CountingQuarantine sharded_quarantine(LINKER_INITIALIZED);
+static CountingQuarantine background_quarantine(LINKER_INITIALIZED);
+
+TEST(SanitizerCommon, QuarantineThreads) {
+  TestQuarantineThreads(&sharded_quarantine, false);
+}
+
+TEST(SanitizerCommon, QuarantineBackgroundRecycling) {
+  TestQuarantineThreads(&background_quarantine, true);
+}
+
 }  // namespace __sanitizer
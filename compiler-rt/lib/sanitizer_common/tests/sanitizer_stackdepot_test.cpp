@@ -64,6 +64,26 @@ TEST(SanitizerCommon, StackDepotSeveral) {
   EXPECT_NE(i1, i2);
 }
 
+TEST(SanitizerCommon, StackDepotPacked) {
+  // Frames far apart, and going up and down, to exercise the packing of large
+  // and negative differences.
+  uptr array[] = {0x401000, 0x7f0000123456, 0x401010, 0x401008, 0,
+                  (uptr)-1, 0x1, 0x7f0000123450};
+  StackTrace s1(array, ARRAY_SIZE(array));
+  u32 i1 = StackDepotPut(s1);
+  StackTrace stack = StackDepotGet(i1);
+  EXPECT_NE(stack.trace, (uptr*)0);
+  EXPECT_EQ(ARRAY_SIZE(array), stack.size);
+  EXPECT_EQ(0, internal_memcmp(stack.trace, array, sizeof(array)));
+  EXPECT_EQ(stack.trace, StackDepotGet(i1).trace);
+
+  array[ARRAY_SIZE(array) - 1]++;
+  StackTrace s2(array, ARRAY_SIZE(array));
+  u32 i2 = StackDepotPut(s2);
+  EXPECT_NE(i1, i2);
+  EXPECT_EQ(i2, StackDepotPut(s2));
+}
+
 TEST(SanitizerCommon, StackDepotReverseMap) {
   uptr array1[] = {1, 2, 3, 4, 5};
   uptr array2[] = {7, 1, 3, 0};
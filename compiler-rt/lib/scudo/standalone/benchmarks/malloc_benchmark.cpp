@@ -9,10 +9,14 @@
 #include "allocator_config.h"
 #include "combined.h"
 #include "common.h"
+#include "tsd_percpu.h"
 
 #include "benchmark/benchmark.h"
 
+#include <algorithm>
 #include <memory>
+#include <random>
+#include <vector>
 
 template <typename Config> static void BM_malloc_free(benchmark::State &State) {
   using AllocatorT = scudo::Allocator<Config>;
@@ -100,4 +104,110 @@ BENCHMARK_TEMPLATE(BM_malloc_free_loop, scudo::FuchsiaConfig)
     ->Range(MinIters, MaxIters);
 #endif
 
+#if SCUDO_CAN_USE_PRIMARY64
+// AndroidConfig with a Primary backed by huge pages.
+struct AndroidHugePagesConfig : scudo::AndroidConfig {
+  typedef scudo::SizeClassAllocator64<SizeClassMap, 28U, 1000, 1000,
+                                      /*MaySupportMemoryTagging=*/true,
+                                      /*UseHugePages=*/true>
+      Primary;
+};
+
+// Links a large number of small chunks in a random cycle and follows it. Most
+// steps touch a new page, the time is dominated by the TLB misses.
+template <typename Config>
+static void BM_pointer_chase(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config>;
+  auto Deleter = [](AllocatorT *A) {
+    A->unmapTestOnly();
+    delete A;
+  };
+  std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                           Deleter);
+  Allocator->reset();
+
+  const size_t NumChunks = State.range(0);
+  std::vector<void **> Chunks(NumChunks);
+  for (void **&Chunk : Chunks)
+    Chunk = reinterpret_cast<void **>(
+        Allocator->allocate(64, scudo::Chunk::Origin::Malloc));
+  std::vector<void **> Order(Chunks);
+  std::shuffle(Order.begin(), Order.end(), std::mt19937(0));
+  for (size_t I = 0; I < NumChunks; I++)
+    *Order[I] = Order[(I + 1) % NumChunks];
+
+  void **P = Order[0];
+  for (auto _ : State) {
+    for (size_t I = 0; I < NumChunks; I++)
+      P = reinterpret_cast<void **>(*P);
+    benchmark::DoNotOptimize(P);
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) * NumChunks);
+  for (void **Chunk : Chunks)
+    Allocator->deallocate(Chunk, scudo::Chunk::Origin::Malloc);
+}
+
+static const size_t MinChunks = 1 << 12;
+static const size_t MaxChunks = 1 << 20;
+
+BENCHMARK_TEMPLATE(BM_pointer_chase, scudo::AndroidConfig)
+    ->Range(MinChunks, MaxChunks);
+BENCHMARK_TEMPLATE(BM_pointer_chase, AndroidHugePagesConfig)
+    ->Range(MinChunks, MaxChunks);
+#endif
+
+// AndroidConfig with its shared TSDs replaced by per-CPU ones.
+struct AndroidPerCPUConfig : scudo::AndroidConfig {
+  template <class A>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<A, 8U, 2U>;
+};
+
+// The allocator is shared by the threads of all the runs of a configuration,
+// and never torn down as threads could still be using it.
+template <typename Config> static scudo::Allocator<Config> *getAllocator() {
+  static scudo::Allocator<Config> *Allocator = [] {
+    auto *A = new scudo::Allocator<Config>;
+    A->reset();
+    return A;
+  }();
+  return Allocator;
+}
+
+// Every thread allocates a batch of small chunks of various sizes and frees
+// them, which mostly exercises the TSD registry and the caches it hands out.
+template <typename Config>
+static void BM_malloc_free_threaded(benchmark::State &State) {
+  scudo::Allocator<Config> *Allocator = getAllocator<Config>();
+  const size_t BatchSize = State.range(0);
+  std::vector<void *> Ptrs(BatchSize);
+
+  for (auto _ : State) {
+    for (size_t I = 0; I < BatchSize; I++) {
+      Ptrs[I] = Allocator->allocate(16 + (I % 16) * 16,
+                                    scudo::Chunk::Origin::Malloc);
+      benchmark::DoNotOptimize(Ptrs[I]);
+    }
+    for (size_t I = 0; I < BatchSize; I++)
+      Allocator->deallocate(Ptrs[I], scudo::Chunk::Origin::Malloc);
+  }
+
+  State.SetItemsProcessed(uint64_t(State.iterations()) * BatchSize);
+}
+
+static const size_t BatchSize = 64;
+
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, scudo::DefaultConfig)
+    ->Arg(BatchSize)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, scudo::AndroidConfig)
+    ->Arg(BatchSize)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+BENCHMARK_TEMPLATE(BM_malloc_free_threaded, AndroidPerCPUConfig)
+    ->Arg(BatchSize)
+    ->ThreadRange(1, 64)
+    ->UseRealTime();
+
 BENCHMARK_MAIN();
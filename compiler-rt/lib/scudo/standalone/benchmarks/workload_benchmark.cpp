@@ -0,0 +1,452 @@
+//===-- workload_benchmark.cpp ----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Multithreaded benchmarks replaying the allocation patterns of real programs.
+// Every iteration runs a workload on a fresh allocator, every thread doing a
+// fixed number of operations (allocations, deallocations and reallocations).
+// Besides the operations per second, each benchmark reports:
+// - p50_ns, p99_ns, p999_ns: percentiles of the latency of one operation in
+//   16, over all the threads;
+// - peak_rss_MiB: the peak growth of the resident memory of the process while
+//   the workload runs;
+// - end_rss_MiB and live_MiB: the growth of the resident memory and the bytes
+//   still allocated when the workload is done, their ratio shows the
+//   fragmentation.
+// The allocator is only used by the threads of the workload so that no thread
+// outlives it, which also allows for benchmarking DefaultConfig.
+
+#include "allocator_config.h"
+#include "combined.h"
+#include "common.h"
+
+#include "benchmark/benchmark.h"
+
+#include <stdio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Origin = scudo::Chunk::Origin;
+
+// A size profile typical of server workloads, dominated by small objects:
+// about half of the allocations are at most 64 bytes and a few in a thousand
+// are large enough to go to the Secondary. Sizes are uniform within a bucket.
+struct SizeBucket {
+  size_t MaxSize;
+  double Weight;
+};
+const SizeBucket SizeBuckets[] = {
+    {16, 14.0},   {32, 20.0},   {48, 9.0},     {64, 8.0},     {96, 9.0},
+    {128, 7.0},   {192, 6.0},   {256, 5.0},    {512, 8.0},    {1024, 6.0},
+    {2048, 3.0},  {4096, 2.5},  {8192, 1.5},   {32768, 0.7},  {131072, 0.2},
+    {524288, 0.08}, {2097152, 0.02}};
+
+class SizeDistribution {
+public:
+  SizeDistribution() {
+    std::vector<double> Weights;
+    for (const SizeBucket &B : SizeBuckets)
+      Weights.push_back(B.Weight);
+    Buckets = std::discrete_distribution<size_t>(Weights.begin(),
+                                                 Weights.end());
+  }
+
+  template <typename RNG> size_t operator()(RNG &Rng) {
+    const size_t I = Buckets(Rng);
+    const size_t Min = I ? SizeBuckets[I - 1].MaxSize + 1 : 8;
+    return Min + Rng() % (SizeBuckets[I].MaxSize - Min + 1);
+  }
+
+private:
+  std::discrete_distribution<size_t> Buckets;
+};
+
+size_t getResidentBytes() {
+  FILE *F = fopen("/proc/self/statm", "r");
+  if (!F)
+    return 0;
+  unsigned long Size = 0, Resident = 0;
+  if (fscanf(F, "%lu %lu", &Size, &Resident) != 2)
+    Resident = 0;
+  fclose(F);
+  return Resident * scudo::getPageSizeCached();
+}
+
+// The state of a thread of a workload: its allocator interface, its random
+// number generator and its statistics.
+template <typename Config> class ThreadContext {
+public:
+  using AllocatorT = scudo::Allocator<Config>;
+
+  ThreadContext(AllocatorT *Allocator, unsigned Seed)
+      : Allocator(Allocator), Rng(Seed) {}
+
+  void *allocate(size_t Size) {
+    void *P = timed(
+        [&] { return Allocator->allocate(Size, Origin::Malloc); });
+    // Fill the object like a program would, the RSS reflects the live bytes.
+    memset(P, 0, Size);
+    LiveBytes += static_cast<scudo::sptr>(Size);
+    return P;
+  }
+
+  void deallocate(void *P, size_t Size) {
+    timed([&] {
+      Allocator->deallocate(P, Origin::Malloc);
+      return nullptr;
+    });
+    LiveBytes -= static_cast<scudo::sptr>(Size);
+  }
+
+  void *reallocate(void *P, size_t OldSize, size_t NewSize) {
+    void *NewP = timed([&] { return Allocator->reallocate(P, NewSize); });
+    memset(reinterpret_cast<char *>(NewP) + OldSize, 0, NewSize - OldSize);
+    LiveBytes += static_cast<scudo::sptr>(NewSize - OldSize);
+    return NewP;
+  }
+
+  size_t getSize() { return Sizes(Rng); }
+  std::mt19937_64 &getRng() { return Rng; }
+
+  uint64_t Ops = 0;
+  scudo::sptr LiveBytes = 0;
+  std::vector<uint32_t> Latencies;
+
+private:
+  static constexpr uint32_t SamplingPeriod = 16;
+
+  template <typename F> void *timed(F Op) {
+    Ops++;
+    if (Ops % SamplingPeriod)
+      return Op();
+    const auto Start = std::chrono::steady_clock::now();
+    void *P = Op();
+    const auto End = std::chrono::steady_clock::now();
+    Latencies.push_back(static_cast<uint32_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(End - Start)
+            .count()));
+    return P;
+  }
+
+  AllocatorT *Allocator;
+  std::mt19937_64 Rng;
+  SizeDistribution Sizes;
+};
+
+constexpr uint64_t OpsPerThread = 1U << 16;
+
+// Pairs of threads: the producer allocates objects and hands them over to the
+// consumer through a ring, the consumer frees them. All the deallocations are
+// remote, the blocks move between the caches of the threads.
+class ProducerConsumer {
+public:
+  explicit ProducerConsumer(unsigned NumThreads)
+      : Rings(std::max(NumThreads / 2, 1U)) {}
+
+  template <typename Context> void run(Context &C, unsigned Thread) {
+    Ring &R = Rings[Thread / 2];
+    if (Thread % 2 == 0) {
+      for (uint64_t I = 0; I < OpsPerThread; I++) {
+        const size_t Size = C.getSize();
+        void *P = C.allocate(Size);
+        *reinterpret_cast<size_t *>(P) = Size;
+        while (!R.push(P))
+          std::this_thread::yield();
+      }
+    } else {
+      for (uint64_t I = 0; I < OpsPerThread; I++) {
+        void *P;
+        while (!(P = R.pop()))
+          std::this_thread::yield();
+        C.deallocate(P, *reinterpret_cast<size_t *>(P));
+      }
+    }
+  }
+
+  template <typename Context> void cleanup(Context &, unsigned) {}
+
+private:
+  // A single producer single consumer ring.
+  class Ring {
+  public:
+    bool push(void *P) {
+      const size_t T = Tail.load(std::memory_order_relaxed);
+      if (T - Head.load(std::memory_order_acquire) == Capacity)
+        return false;
+      Slots[T % Capacity] = P;
+      Tail.store(T + 1, std::memory_order_release);
+      return true;
+    }
+
+    void *pop() {
+      const size_t H = Head.load(std::memory_order_relaxed);
+      if (H == Tail.load(std::memory_order_acquire))
+        return nullptr;
+      void *P = Slots[H % Capacity];
+      Head.store(H + 1, std::memory_order_release);
+      return P;
+    }
+
+  private:
+    static constexpr size_t Capacity = 1024;
+    alignas(SCUDO_CACHE_LINE_SIZE) std::atomic<size_t> Head{0};
+    alignas(SCUDO_CACHE_LINE_SIZE) std::atomic<size_t> Tail{0};
+    void *Slots[Capacity];
+  };
+
+  std::vector<Ring> Rings;
+};
+
+// Most objects die young, within the next few dozens of operations of the
+// thread, while a few live long: they replace a random object of a large
+// long-lived set.
+class LongShortLived {
+public:
+  explicit LongShortLived(unsigned NumThreads) : Threads(NumThreads) {}
+
+  template <typename Context> void run(Context &C, unsigned Thread) {
+    State &S = Threads[Thread];
+    S.LongLived.assign(LongLivedCount, {nullptr, 0});
+    S.ShortLived.assign(ShortLivedCount, {nullptr, 0});
+    for (uint64_t I = 0; I < OpsPerThread; I++) {
+      const bool Long = C.getRng()() % 100 < LongLivedPercent;
+      Object &O = Long ? S.LongLived[C.getRng()() % LongLivedCount]
+                       : S.ShortLived[I % ShortLivedCount];
+      if (O.P)
+        C.deallocate(O.P, O.Size);
+      O.Size = C.getSize();
+      O.P = C.allocate(O.Size);
+    }
+  }
+
+  template <typename Context> void cleanup(Context &C, unsigned Thread) {
+    State &S = Threads[Thread];
+    for (std::vector<Object> *Objects : {&S.LongLived, &S.ShortLived})
+      for (Object &O : *Objects)
+        if (O.P)
+          C.deallocate(O.P, O.Size);
+  }
+
+private:
+  static constexpr size_t LongLivedCount = 4096;
+  static constexpr size_t ShortLivedCount = 32;
+  static constexpr uint64_t LongLivedPercent = 5;
+
+  struct Object {
+    void *P;
+    size_t Size;
+  };
+  struct State {
+    std::vector<Object> LongLived;
+    std::vector<Object> ShortLived;
+  };
+  std::vector<State> Threads;
+};
+
+// Buffers growing by reallocations, like strings or vectors being filled up,
+// from 16 bytes to between 256 bytes and 64KB by steps of 50%. The last few
+// buffers are kept around.
+class ReallocChains {
+public:
+  explicit ReallocChains(unsigned NumThreads) : Threads(NumThreads) {}
+
+  template <typename Context> void run(Context &C, unsigned Thread) {
+    std::vector<Buffer> &Kept = Threads[Thread];
+    Kept.assign(KeptCount, {nullptr, 0});
+    uint64_t Ops = 0;
+    for (size_t Chain = 0; Ops < OpsPerThread; Chain++) {
+      const size_t MaxSize = size_t(1) << (8 + C.getRng()() % 9);
+      size_t Size = 16;
+      void *P = C.allocate(Size);
+      for (Ops++; Size < MaxSize && Ops < OpsPerThread; Ops++) {
+        const size_t NewSize = Size + Size / 2;
+        P = C.reallocate(P, Size, NewSize);
+        Size = NewSize;
+      }
+      Buffer &B = Kept[Chain % KeptCount];
+      if (B.P)
+        C.deallocate(B.P, B.Size);
+      B = {P, Size};
+    }
+  }
+
+  template <typename Context> void cleanup(Context &C, unsigned Thread) {
+    for (Buffer &B : Threads[Thread])
+      if (B.P)
+        C.deallocate(B.P, B.Size);
+  }
+
+private:
+  static constexpr size_t KeptCount = 8;
+
+  struct Buffer {
+    void *P;
+    size_t Size;
+  };
+  std::vector<std::vector<Buffer>> Threads;
+};
+
+// Rounds of allocations of which a random tenth survives, with the sizes
+// doubling from one round to the next: the survivors pin down pages that the
+// following rounds cannot reuse.
+class Fragmentation {
+public:
+  explicit Fragmentation(unsigned NumThreads) : Threads(NumThreads) {}
+
+  template <typename Context> void run(Context &C, unsigned Thread) {
+    std::vector<Object> &Survivors = Threads[Thread];
+    std::vector<Object> Round(OpsPerThread / Rounds / 2);
+    for (unsigned R = 0; R < Rounds; R++) {
+      for (Object &O : Round) {
+        O.Size = std::min(C.getSize() << (R % 4), static_cast<size_t>(1) << 20);
+        O.P = C.allocate(O.Size);
+      }
+      for (Object &O : Round) {
+        if (C.getRng()() % 10 == 0)
+          Survivors.push_back(O);
+        else
+          C.deallocate(O.P, O.Size);
+      }
+    }
+  }
+
+  template <typename Context> void cleanup(Context &C, unsigned Thread) {
+    for (Object &O : Threads[Thread])
+      C.deallocate(O.P, O.Size);
+  }
+
+private:
+  static constexpr unsigned Rounds = 8;
+
+  struct Object {
+    void *P;
+    size_t Size;
+  };
+  std::vector<std::vector<Object>> Threads;
+};
+
+uint32_t getPercentile(const std::vector<uint32_t> &Sorted, double P) {
+  if (Sorted.empty())
+    return 0;
+  const double Index = P * static_cast<double>(Sorted.size() - 1);
+  return Sorted[static_cast<size_t>(Index)];
+}
+
+template <typename Config, typename Workload>
+void BM_workload(benchmark::State &State) {
+  using AllocatorT = scudo::Allocator<Config>;
+  const unsigned NumThreads = static_cast<unsigned>(State.range(0));
+  std::vector<uint32_t> Latencies;
+  uint64_t Ops = 0;
+  double PeakRss = 0, EndRss = 0, Live = 0;
+
+  for (auto _ : State) {
+    State.PauseTiming();
+    auto Deleter = [](AllocatorT *A) {
+      A->unmapTestOnly();
+      delete A;
+    };
+    std::unique_ptr<AllocatorT, decltype(Deleter)> Allocator(new AllocatorT,
+                                                             Deleter);
+    Allocator->reset();
+    Workload W(NumThreads);
+    std::vector<ThreadContext<Config>> Contexts;
+    for (unsigned I = 0; I < NumThreads; I++)
+      Contexts.emplace_back(Allocator.get(), I + 1);
+    const size_t BaseRss = getResidentBytes();
+    std::atomic<unsigned> Done{0};
+    std::atomic<bool> Measured{false};
+    State.ResumeTiming();
+
+    std::vector<std::thread> Threads;
+    for (unsigned I = 0; I < NumThreads; I++) {
+      Threads.emplace_back([&, I] {
+        W.run(Contexts[I], I);
+        Done.fetch_add(1);
+        // Keep the remaining objects alive until the RSS is measured.
+        while (!Measured.load())
+          std::this_thread::yield();
+        W.cleanup(Contexts[I], I);
+      });
+    }
+    size_t Peak = BaseRss;
+    while (Done.load() < NumThreads) {
+      Peak = std::max(Peak, getResidentBytes());
+      usleep(1000);
+    }
+
+    State.PauseTiming();
+    const size_t End = getResidentBytes();
+    Peak = std::max(Peak, End);
+    scudo::sptr LiveBytes = 0;
+    for (const ThreadContext<Config> &C : Contexts)
+      LiveBytes += C.LiveBytes;
+    Measured.store(true);
+    for (std::thread &T : Threads)
+      T.join();
+    for (const ThreadContext<Config> &C : Contexts) {
+      Ops += C.Ops;
+      Latencies.insert(Latencies.end(), C.Latencies.begin(),
+                       C.Latencies.end());
+    }
+    PeakRss += static_cast<double>(Peak - BaseRss);
+    EndRss += static_cast<double>(End > BaseRss ? End - BaseRss : 0);
+    Live += static_cast<double>(LiveBytes);
+    State.ResumeTiming();
+  }
+
+  std::sort(Latencies.begin(), Latencies.end());
+  const double Iterations = static_cast<double>(State.iterations());
+  const double MiB = static_cast<double>(1 << 20);
+  State.SetItemsProcessed(static_cast<int64_t>(Ops));
+  State.counters["p50_ns"] = getPercentile(Latencies, 0.5);
+  State.counters["p99_ns"] = getPercentile(Latencies, 0.99);
+  State.counters["p999_ns"] = getPercentile(Latencies, 0.999);
+  State.counters["peak_rss_MiB"] = PeakRss / Iterations / MiB;
+  State.counters["end_rss_MiB"] = EndRss / Iterations / MiB;
+  State.counters["live_MiB"] = Live / Iterations / MiB;
+}
+
+} // namespace
+
+// A single thread, then enough threads to contend on the shared structures.
+static void applyThreadCounts(benchmark::internal::Benchmark *B) {
+  B->ArgName("threads")->Arg(1)->Arg(4)->Arg(16);
+}
+
+// Threads go by producer and consumer pairs.
+static void applyThreadPairCounts(benchmark::internal::Benchmark *B) {
+  B->ArgName("threads")->Arg(2)->Arg(4)->Arg(16);
+}
+
+#define WORKLOAD_BENCHMARK(Workload, ThreadCounts)                             \
+  BENCHMARK_TEMPLATE2(BM_workload, scudo::DefaultConfig, Workload)             \
+      ->Apply(ThreadCounts)                                                    \
+      ->UseRealTime()                                                          \
+      ->Unit(benchmark::kMillisecond);                                         \
+  BENCHMARK_TEMPLATE2(BM_workload, scudo::AndroidConfig, Workload)             \
+      ->Apply(ThreadCounts)                                                    \
+      ->UseRealTime()                                                          \
+      ->Unit(benchmark::kMillisecond);                                         \
+  BENCHMARK_TEMPLATE2(BM_workload, scudo::AndroidSvelteConfig, Workload)       \
+      ->Apply(ThreadCounts)                                                    \
+      ->UseRealTime()                                                          \
+      ->Unit(benchmark::kMillisecond)
+
+WORKLOAD_BENCHMARK(ProducerConsumer, applyThreadPairCounts);
+WORKLOAD_BENCHMARK(LongShortLived, applyThreadCounts);
+WORKLOAD_BENCHMARK(ReallocChains, applyThreadCounts);
+WORKLOAD_BENCHMARK(Fragmentation, applyThreadCounts);
@@ -18,6 +18,7 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <linux/futex.h>
+#include <pthread.h>
 #include <sched.h>
 #include <stdlib.h>
 #include <string.h>
@@ -70,6 +71,11 @@ void *map(void *Addr, uptr Size, UNUSED const char *Name, uptr Flags,
       dieOnMapUnmapError(errno == ENOMEM);
     return nullptr;
   }
+#if defined(MADV_HUGEPAGE)
+  // Transparent huge pages may be disabled or unsupported, which is fine.
+  if (Flags & MAP_HUGEPAGE)
+    madvise(P, Size, MADV_HUGEPAGE);
+#endif
 #if SCUDO_ANDROID
   if (!(Flags & MAP_NOACCESS))
     prctl(ANDROID_PR_SET_VMA, ANDROID_PR_SET_VMA_ANON_NAME, P, Size, Name);
@@ -147,6 +153,82 @@ u32 getThreadID() {
 #endif
 }
 
+// glibc registers an rseq area for every thread since 2.35 and exports its
+// location, the kernel only accepts one area per thread.
+extern "C" WEAK const sptr __rseq_offset;
+extern "C" WEAK const unsigned int __rseq_size;
+
+#if defined(SYS_rseq)
+namespace {
+
+// Layout of the original 32-byte struct rseq from <linux/rseq.h>.
+struct alignas(32) RseqArea {
+  u32 CPUIdStart;
+  u32 CPUId;
+  u64 CriticalSection;
+  u32 Flags;
+};
+
+// Only used in the abort handlers of critical sections, which we do not have.
+constexpr u32 RseqSignature = 0x53053053;
+constexpr int RseqFlagUnregister = 1;
+
+THREADLOCAL RseqArea ThreadRseqArea;
+pthread_key_t RseqKey;
+bool RseqKeyCreated;
+
+// The kernel writes to the area until it is unregistered, which must happen
+// before the thread local storage is released.
+void unregisterRseq(UNUSED void *Ptr) {
+  syscall(SYS_rseq, &ThreadRseqArea, sizeof(RseqArea), RseqFlagUnregister,
+          RseqSignature);
+}
+
+void createRseqKey() {
+  RseqKeyCreated = pthread_key_create(&RseqKey, unregisterRseq) == 0;
+}
+
+ALWAYS_INLINE uptr getThreadPointer() {
+#if defined(__x86_64__)
+  uptr TP;
+  __asm__("mov %%fs:0, %0" : "=r"(TP));
+  return TP;
+#elif defined(__i386__)
+  uptr TP;
+  __asm__("movl %%gs:0, %0" : "=r"(TP));
+  return TP;
+#else
+  return reinterpret_cast<uptr>(__builtin_thread_pointer());
+#endif
+}
+
+} // namespace
+#endif // defined(SYS_rseq)
+
+const volatile u32 *getRseqCPUIdAddress() {
+#if defined(SYS_rseq)
+  if (&__rseq_size && &__rseq_offset && __rseq_size != 0) {
+    const uptr Area = getThreadPointer() + __rseq_offset;
+    return &reinterpret_cast<volatile RseqArea *>(Area)->CPUId;
+  }
+  static pthread_once_t RseqKeyOnce = PTHREAD_ONCE_INIT;
+  pthread_once(&RseqKeyOnce, createRseqKey);
+  // The value of the key only matters for its destructor to be called.
+  if (!RseqKeyCreated || pthread_setspecific(RseqKey, &ThreadRseqArea) != 0)
+    return nullptr;
+  // EBUSY means that the area was already registered for this thread.
+  if (syscall(SYS_rseq, &ThreadRseqArea, sizeof(RseqArea), 0,
+              RseqSignature) != 0 &&
+      errno != EBUSY) {
+    pthread_setspecific(RseqKey, nullptr);
+    return nullptr;
+  }
+  return &ThreadRseqArea.CPUId;
+#else
+  return nullptr;
+#endif // defined(SYS_rseq)
+}
+
 // Blocking is possibly unused if the getrandom block is not compiled in.
 bool getRandom(void *Buffer, uptr Length, UNUSED bool Blocking) {
   if (!Buffer || !Length || Length > MaxRandomLength)
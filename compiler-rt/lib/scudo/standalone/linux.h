@@ -18,6 +18,12 @@ namespace scudo {
 // MapPlatformData is unused on Linux, define it as a minimally sized structure.
 struct MapPlatformData {};
 
+// Returns the address of the cpu_id field of the restartable sequences (rseq)
+// area of the calling thread, which the kernel keeps up to date with the CPU
+// the thread runs on. The area is registered for the thread if the C library
+// did not already do it. Returns nullptr if rseq is not available.
+const volatile u32 *getRseqCPUIdAddress();
+
 #if SCUDO_ANDROID
 
 #if defined(__aarch64__)
@@ -38,17 +38,24 @@ namespace scudo {
 //
 // The memory used by this allocator is never unmapped, but can be partially
 // released if the platform allows for it.
+//
+// With UseHugePages, the Regions are aligned on huge pages, the user memory is
+// mapped by whole huge pages and the platform is asked to back it with huge
+// pages, which reduces the TLB misses for large heaps. Memory is then only
+// released by whole huge pages, to avoid splitting those still in use. This
+// comes at the cost of a higher RSS: every size class in use holds at least a
+// huge page.
 
 template <class SizeClassMapT, uptr RegionSizeLog,
           s32 MinReleaseToOsIntervalMs = INT32_MIN,
           s32 MaxReleaseToOsIntervalMs = INT32_MAX,
-          bool MaySupportMemoryTagging = false>
+          bool MaySupportMemoryTagging = false, bool UseHugePages = false>
 class SizeClassAllocator64 {
 public:
   typedef SizeClassMapT SizeClassMap;
   typedef SizeClassAllocator64<
       SizeClassMap, RegionSizeLog, MinReleaseToOsIntervalMs,
-      MaxReleaseToOsIntervalMs, MaySupportMemoryTagging>
+      MaxReleaseToOsIntervalMs, MaySupportMemoryTagging, UseHugePages>
       ThisT;
   typedef SizeClassAllocatorLocalCache<ThisT> CacheT;
   typedef typename CacheT::TransferBatch TransferBatch;
@@ -64,9 +71,12 @@ public:
   static bool canAllocate(uptr Size) { return Size <= SizeClassMap::MaxSize; }
 
   void initLinkerInitialized(s32 ReleaseToOsInterval) {
-    // Reserve the space required for the Primary.
-    PrimaryBase = reinterpret_cast<uptr>(
-        map(nullptr, PrimarySize, "scudo:primary", MAP_NOACCESS, &Data));
+    // Reserve the space required for the Primary, with some extra room to
+    // align it on a huge page if needed.
+    ReservedBase = reinterpret_cast<uptr>(
+        map(nullptr, ReservedSize, "scudo:primary", MAP_NOACCESS, &Data));
+    PrimaryBase = UseHugePages ? roundUpTo(ReservedBase, HugePageSize)
+                               : ReservedBase;
 
     u32 Seed;
     const u64 Time = getMonotonicTime();
@@ -102,7 +112,8 @@ public:
   }
 
   void unmapTestOnly() {
-    unmap(reinterpret_cast<void *>(PrimaryBase), PrimarySize, UNMAP_ALL, &Data);
+    unmap(reinterpret_cast<void *>(ReservedBase), ReservedSize, UNMAP_ALL,
+          &Data);
   }
 
   TransferBatch *popBatch(CacheT *C, uptr ClassId) {
@@ -267,8 +278,15 @@ private:
   static const uptr NumClasses = SizeClassMap::NumClasses;
   static const uptr PrimarySize = RegionSize * NumClasses;
 
+  // 2MB, the size of the huge pages on x86_64, and on AArch64 with 4KB pages.
+  static const uptr HugePageSize = 1UL << 21;
+  static_assert(!UseHugePages || RegionSize >= HugePageSize,
+                "Regions must hold at least one huge page");
+  static const uptr ReservedSize =
+      PrimarySize + (UseHugePages ? HugePageSize : 0);
+
   // Call map for user memory with at least this size.
-  static const uptr MapSizeIncrement = 1UL << 18;
+  static const uptr MapSizeIncrement = UseHugePages ? HugePageSize : 1UL << 18;
   // Fill at most this number of batches from the newly map'd memory.
   static const u32 MaxNumBatches = SCUDO_ANDROID ? 4U : 8U;
 
@@ -304,6 +322,7 @@ private:
   static_assert(sizeof(RegionInfo) % SCUDO_CACHE_LINE_SIZE == 0, "");
 
   uptr PrimaryBase;
+  uptr ReservedBase;
   MapPlatformData Data;
   atomic_s32 ReleaseToOsIntervalMs;
   bool UseMemoryTagging;
@@ -352,9 +371,15 @@ private:
     const uptr TotalUserBytes = Region->AllocatedUser + MaxCount * Size;
     // Map more space for blocks, if necessary.
     if (TotalUserBytes > MappedUser) {
-      // Do the mmap for the user memory.
-      const uptr UserMapSize =
+      // Do the mmap for the user memory. With huge pages, the mapping ends on
+      // a huge page boundary so that the huge pages are entirely mapped, except
+      // for the first one of the Region.
+      uptr UserMapSize =
           roundUpTo(TotalUserBytes - MappedUser, MapSizeIncrement);
+      if (UseHugePages)
+        UserMapSize = roundUpTo(RegionBeg + MappedUser + UserMapSize,
+                                HugePageSize) -
+                      (RegionBeg + MappedUser);
       const uptr RegionBase = RegionBeg - getRegionBaseByClassId(ClassId);
       if (UNLIKELY(RegionBase + MappedUser + UserMapSize > RegionSize)) {
         if (!Region->Exhausted) {
@@ -373,7 +398,8 @@ private:
       if (UNLIKELY(!map(reinterpret_cast<void *>(RegionBeg + MappedUser),
                         UserMapSize, "scudo:primary",
                         MAP_ALLOWNOMEM | MAP_RESIZABLE |
-                            (useMemoryTagging() ? MAP_MEMTAG : 0),
+                            (useMemoryTagging() ? MAP_MEMTAG : 0) |
+                            (UseHugePages ? MAP_HUGEPAGE : 0),
                         &Region->Data)))
         return nullptr;
       Region->MappedUser += UserMapSize;
@@ -442,12 +468,13 @@ private:
                                  bool Force = false) {
     const uptr BlockSize = getSizeByClassId(ClassId);
     const uptr PageSize = getPageSizeCached();
+    const uptr ReleaseGranularity = UseHugePages ? HugePageSize : PageSize;
 
     CHECK_GE(Region->Stats.PoppedBlocks, Region->Stats.PushedBlocks);
     const uptr BytesInFreeList =
         Region->AllocatedUser -
         (Region->Stats.PoppedBlocks - Region->Stats.PushedBlocks) * BlockSize;
-    if (BytesInFreeList < PageSize)
+    if (BytesInFreeList < ReleaseGranularity)
       return 0; // No chance to release anything.
     const uptr BytesPushed = (Region->Stats.PushedBlocks -
                               Region->ReleaseInfo.PushedBlocksAtLastRelease) *
@@ -479,7 +506,8 @@ private:
       }
     }
 
-    ReleaseRecorder Recorder(Region->RegionBeg, &Region->Data);
+    ReleaseRecorder Recorder(Region->RegionBeg, &Region->Data,
+                             UseHugePages ? HugePageSize : 0);
     releaseFreeMemoryToOS(Region->FreeList, Region->RegionBeg,
                           Region->AllocatedUser, 1U, BlockSize, &Recorder);
 
@@ -17,8 +17,12 @@ namespace scudo {
 
 class ReleaseRecorder {
 public:
-  ReleaseRecorder(uptr BaseAddress, MapPlatformData *Data = nullptr)
-      : BaseAddress(BaseAddress), Data(Data) {}
+  // If Granularity is not 0, only the Granularity aligned blocks of memory that
+  // are entirely free are released. This keeps huge pages in use from being
+  // split.
+  ReleaseRecorder(uptr BaseAddress, MapPlatformData *Data = nullptr,
+                  uptr Granularity = 0)
+      : BaseAddress(BaseAddress), Data(Data), Granularity(Granularity) {}
 
   uptr getReleasedRangesCount() const { return ReleasedRangesCount; }
 
@@ -26,6 +30,14 @@ public:
 
   // Releases [From, To) range of pages back to OS.
   void releasePageRangeToOS(uptr From, uptr To) {
+    if (Granularity) {
+      const uptr Beg = roundUpTo(BaseAddress + From, Granularity);
+      const uptr End = roundDownTo(BaseAddress + To, Granularity);
+      if (Beg >= End)
+        return;
+      From = Beg - BaseAddress;
+      To = End - BaseAddress;
+    }
     const uptr Size = To - From;
     releasePagesToOS(BaseAddress, From, Size, Data);
     ReleasedRangesCount++;
@@ -37,6 +49,7 @@ private:
   uptr ReleasedBytes = 0;
   uptr BaseAddress = 0;
   MapPlatformData *Data = nullptr;
+  uptr Granularity = 0;
 };
 
 // A packed array of Counters. Each counter occupies 2^N bits, enough to store
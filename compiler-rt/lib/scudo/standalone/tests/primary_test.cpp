@@ -59,6 +59,8 @@ TEST(ScudoPrimaryTest, BasicPrimary) {
 #endif
   testPrimary<scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
   testPrimary<scudo::SizeClassAllocator64<SizeClassMap, 24U, true>>();
+  testPrimary<scudo::SizeClassAllocator64<SizeClassMap, 24U, INT32_MIN,
+                                          INT32_MAX, false, true>>();
 }
 
 // The 64-bit SizeClassAllocator can be easily OOM'd with small region sizes.
@@ -238,3 +240,33 @@ TEST(ScudoPrimaryTest, ReleaseToOS) {
   testReleaseToOS<scudo::SizeClassAllocator64<SizeClassMap, 24U>>();
   testReleaseToOS<scudo::SizeClassAllocator64<SizeClassMap, 24U, true>>();
 }
+
+// With huge pages, only whole huge pages are released.
+TEST(ScudoPrimaryTest, ReleaseToOSHugePages) {
+  using Primary =
+      scudo::SizeClassAllocator64<scudo::DefaultSizeClassMap, 24U, INT32_MIN,
+                                  INT32_MAX, false, /*UseHugePages=*/true>;
+  auto Deleter = [](Primary *P) {
+    P->unmapTestOnly();
+    delete P;
+  };
+  std::unique_ptr<Primary, decltype(Deleter)> Allocator(new Primary, Deleter);
+  Allocator->init(/*ReleaseToOsInterval=*/-1);
+  typename Primary::CacheT Cache;
+  Cache.init(nullptr, Allocator.get());
+  const scudo::uptr Size = 1U << 12;
+  const scudo::uptr ClassId = Primary::SizeClassMap::getClassIdBySize(Size);
+  std::vector<void *> Pointers;
+  for (scudo::uptr I = 0; I < (8U << 20) / Size; I++) {
+    void *P = Cache.allocate(ClassId);
+    EXPECT_NE(P, nullptr);
+    memset(P, 'C', Size);
+    Pointers.push_back(P);
+  }
+  for (void *P : Pointers)
+    Cache.deallocate(ClassId, P);
+  Cache.destroy(nullptr);
+  const scudo::uptr Released = Allocator->releaseToOS();
+  EXPECT_GT(Released, 0U);
+  EXPECT_EQ(Released % (1U << 21), 0U);
+}
@@ -262,6 +262,30 @@ template <class SizeClassMap> void testReleaseFreeMemoryToOS() {
   }
 }
 
+TEST(ScudoReleaseTest, ReleaseRecorderGranularity) {
+  const scudo::uptr PageSize = scudo::getPageSizeCached();
+  const scudo::uptr Granularity = 1UL << 21;
+  const scudo::uptr Size = 8 * Granularity;
+  void *P = scudo::map(nullptr, Size, "test");
+  ASSERT_NE(P, nullptr);
+  // Start the recorder one page past a Granularity boundary.
+  const scudo::uptr Base =
+      scudo::roundUpTo(reinterpret_cast<scudo::uptr>(P), Granularity) +
+      PageSize;
+  scudo::ReleaseRecorder Recorder(Base, nullptr, Granularity);
+  // The range does not contain a whole Granularity block.
+  Recorder.releasePageRangeToOS(0, Granularity);
+  EXPECT_EQ(Recorder.getReleasedRangesCount(), 0U);
+  EXPECT_EQ(Recorder.getReleasedBytes(), 0U);
+  // Only [2 * Granularity, 4 * Granularity) from the base of the blocks is
+  // entirely free.
+  Recorder.releasePageRangeToOS(Granularity - PageSize,
+                                4 * Granularity - 2 * PageSize);
+  EXPECT_EQ(Recorder.getReleasedRangesCount(), 1U);
+  EXPECT_EQ(Recorder.getReleasedBytes(), 2 * Granularity);
+  scudo::unmap(P, Size);
+}
+
 TEST(ScudoReleaseTest, ReleaseFreeMemoryToOSDefault) {
   testReleaseFreeMemoryToOS<scudo::DefaultSizeClassMap>();
 }
@@ -9,6 +9,7 @@
 #include "tests/scudo_unit_test.h"
 
 #include "tsd_exclusive.h"
+#include "tsd_percpu.h"
 #include "tsd_shared.h"
 
 #include <condition_variable>
@@ -56,6 +57,11 @@ struct SharedCaches {
   using TSDRegistryT = scudo::TSDRegistrySharedT<Allocator, 16U, 8U>;
 };
 
+struct PerCPUCaches {
+  template <class Allocator>
+  using TSDRegistryT = scudo::TSDRegistryPerCPUT<Allocator, 4U, 2U>;
+};
+
 struct ExclusiveCaches {
   template <class Allocator>
   using TSDRegistryT = scudo::TSDRegistryExT<Allocator>;
@@ -110,6 +116,7 @@ template <class AllocatorT> static void testRegistry() {
 TEST(ScudoTSDTest, TSDRegistryBasic) {
   testRegistry<MockAllocator<OneCache>>();
   testRegistry<MockAllocator<SharedCaches>>();
+  testRegistry<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistry<MockAllocator<ExclusiveCaches>>();
 #endif
@@ -169,11 +176,29 @@ template <class AllocatorT> static void testRegistryThreaded() {
 TEST(ScudoTSDTest, TSDRegistryThreaded) {
   testRegistryThreaded<MockAllocator<OneCache>>();
   testRegistryThreaded<MockAllocator<SharedCaches>>();
+  testRegistryThreaded<MockAllocator<PerCPUCaches>>();
 #if !SCUDO_FUCHSIA
   testRegistryThreaded<MockAllocator<ExclusiveCaches>>();
 #endif
 }
 
+#if SCUDO_LINUX
+TEST(ScudoTSDTest, RseqCPUId) {
+  const volatile scudo::u32 *CPUId = scudo::getRseqCPUIdAddress();
+  // Kernels older than 4.18 do not support rseq.
+  if (!CPUId)
+    return;
+  // Registering the area again is fine.
+  EXPECT_EQ(scudo::getRseqCPUIdAddress(), CPUId);
+  std::thread([] {
+    const volatile scudo::u32 *CPUId = scudo::getRseqCPUIdAddress();
+    EXPECT_NE(CPUId, nullptr);
+    EXPECT_LT(*CPUId, static_cast<scudo::u32>(sysconf(_SC_NPROCESSORS_CONF)));
+  }).join();
+  EXPECT_LT(*CPUId, static_cast<scudo::u32>(sysconf(_SC_NPROCESSORS_CONF)));
+}
+#endif
+
 static std::set<void *> Pointers;
 
 static void stressSharedRegistry(MockAllocator<SharedCaches> *Allocator) {
@@ -0,0 +1,139 @@
+//===-- tsd_percpu.h --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SCUDO_TSD_PERCPU_H_
+#define SCUDO_TSD_PERCPU_H_
+
+#include "linux.h" // for getRseqCPUIdAddress()
+#include "tsd.h"
+#include "tsd_shared.h"
+
+#include <unistd.h> // for sysconf()
+
+namespace scudo {
+
+#if SCUDO_LINUX && !_BIONIC
+
+// A registry with one TSD per CPU. The CPU a thread runs on is read from its
+// restartable sequences (rseq) area, a plain load, and selects the TSD. A
+// thread is rarely preempted while holding a TSD, so that the tryLock of the
+// fast path almost never fails, and the TSD a thread uses stays hot in the
+// caches of the CPU. When rseq is not available, or when the TSD of the CPU is
+// busy, the thread uses the shared registry instead.
+template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount>
+struct TSDRegistryPerCPUT {
+  void initLinkerInitialized(Allocator *Instance) {
+    Fallback.initLinkerInitialized(Instance);
+    // The CPU numbers span the configured CPUs, not only the ones available to
+    // this process.
+    const long N = sysconf(_SC_NPROCESSORS_CONF);
+    NumberOfCPUs = (N <= 0) ? 0 : static_cast<u32>(N);
+    if (NumberOfCPUs) {
+      TSDsSize = roundUpTo(NumberOfCPUs * sizeof(TSD<Allocator>),
+                           getPageSizeCached());
+      TSDs = reinterpret_cast<TSD<Allocator> *>(
+          map(nullptr, TSDsSize, "scudo:tsd"));
+      for (u32 I = 0; I < NumberOfCPUs; I++)
+        TSDs[I].initLinkerInitialized(Instance);
+    }
+    Initialized = true;
+  }
+  void init(Allocator *Instance) {
+    memset(this, 0, sizeof(*this));
+    initLinkerInitialized(Instance);
+  }
+
+  void unmapTestOnly() {
+    Fallback.unmapTestOnly();
+    ThreadCPUId = nullptr;
+    if (TSDs)
+      unmap(reinterpret_cast<void *>(TSDs), TSDsSize);
+    TSDs = nullptr;
+    NumberOfCPUs = 0;
+  }
+
+  ALWAYS_INLINE void initThreadMaybe(Allocator *Instance, bool MinimalInit) {
+    if (LIKELY(ThreadCPUId))
+      return;
+    initThread(Instance, MinimalInit);
+  }
+
+  ALWAYS_INLINE TSD<Allocator> *getTSDAndLock(bool *UnlockRequired) {
+    // The thread can migrate right after the load, the TSD is still valid but
+    // belongs to another CPU: the lock is what guarantees exclusive access.
+    const u32 CPU = *ThreadCPUId;
+    if (LIKELY(CPU < NumberOfCPUs) && TSDs[CPU].tryLock()) {
+      *UnlockRequired = true;
+      return &TSDs[CPU];
+    }
+    return Fallback.getTSDAndLock(UnlockRequired);
+  }
+
+  void disable() {
+    Mutex.lock();
+    Fallback.disable();
+    for (u32 I = 0; I < NumberOfCPUs; I++)
+      TSDs[I].lock();
+  }
+
+  void enable() {
+    for (s32 I = static_cast<s32>(NumberOfCPUs) - 1; I >= 0; I--)
+      TSDs[I].unlock();
+    Fallback.enable();
+    Mutex.unlock();
+  }
+
+  bool setOption(Option O, sptr Value) { return Fallback.setOption(O, Value); }
+
+private:
+  void initOnceMaybe(Allocator *Instance) {
+    ScopedLock L(Mutex);
+    if (LIKELY(Initialized))
+      return;
+    initLinkerInitialized(Instance); // Sets Initialized.
+  }
+
+  NOINLINE void initThread(Allocator *Instance, bool MinimalInit) {
+    initOnceMaybe(Instance);
+    Fallback.initThreadMaybe(Instance, MinimalInit);
+    const volatile u32 *CPUId = getRseqCPUIdAddress();
+    ThreadCPUId = CPUId ? CPUId : &UnknownCPU;
+  }
+
+  // Never a valid CPU number: threads without rseq always go to the fallback
+  // registry.
+  static constexpr u32 UnknownCPU = ~0U;
+
+  TSD<Allocator> *TSDs;
+  uptr TSDsSize;
+  u32 NumberOfCPUs;
+  bool Initialized;
+  HybridMutex Mutex;
+  TSDRegistrySharedT<Allocator, TSDsArraySize, DefaultTSDCount> Fallback;
+  static THREADLOCAL const volatile u32 *ThreadCPUId;
+};
+
+template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount>
+constexpr u32
+    TSDRegistryPerCPUT<Allocator, TSDsArraySize, DefaultTSDCount>::UnknownCPU;
+template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount>
+THREADLOCAL const volatile u32
+    *TSDRegistryPerCPUT<Allocator, TSDsArraySize, DefaultTSDCount>::ThreadCPUId;
+
+#else
+
+// Without rseq, or without ELF TLS, this is the shared registry.
+template <class Allocator, u32 TSDsArraySize, u32 DefaultTSDCount>
+using TSDRegistryPerCPUT =
+    TSDRegistrySharedT<Allocator, TSDsArraySize, DefaultTSDCount>;
+
+#endif // SCUDO_LINUX && !_BIONIC
+
+} // namespace scudo
+
+#endif // SCUDO_TSD_PERCPU_H_
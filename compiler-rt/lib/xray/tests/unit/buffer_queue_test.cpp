@@ -230,5 +230,93 @@ TEST(BufferQueueTest, GenerationalSupportAcrossThreads) {
   ASSERT_EQ(Counter.load(std::memory_order_acquire), 0);
 }
 
+TEST(BufferQueueTest, StreamingKeepsFullBuffers) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 2, Success);
+  ASSERT_TRUE(Success);
+  ASSERT_EQ(Buffers.finalize(), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.init(kSize, 2, /*Stream=*/true),
+            BufferQueue::ErrorCode::Ok);
+  ASSERT_TRUE(Buffers.streaming());
+
+  BufferQueue::Buffer Full;
+  EXPECT_EQ(Buffers.getFullBuffer(Full), BufferQueue::ErrorCode::NoFullBuffers);
+
+  // Fill both buffers: the queue does not hand them out again until they have
+  // been written, and counts the records that cannot be written.
+  void *Data[2];
+  for (auto &D : Data) {
+    BufferQueue::Buffer B;
+    ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+    D = B.Data;
+    atomic_store(B.Extents, 1, memory_order_release);
+    ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+  }
+  BufferQueue::Buffer B;
+  EXPECT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::NotEnoughMemory);
+  EXPECT_EQ(Buffers.dropped(), 1u);
+
+  // The writer gets the buffers in the order they were released.
+  ASSERT_EQ(Buffers.getFullBuffer(Full), BufferQueue::ErrorCode::Ok);
+  EXPECT_EQ(Full.Data, Data[0]);
+  EXPECT_EQ(atomic_load(Full.Extents, memory_order_acquire), 1u);
+  ASSERT_EQ(Buffers.releaseFullBuffer(Full), BufferQueue::ErrorCode::Ok);
+  EXPECT_EQ(Full.Data, nullptr);
+
+  // Only the buffer that was not written is left for a flush.
+  auto Count = 0;
+  Buffers.apply([&](const BufferQueue::Buffer &B) {
+    EXPECT_EQ(B.Data, Data[1]);
+    ++Count;
+  });
+  EXPECT_EQ(Count, 1);
+
+  ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+  EXPECT_EQ(B.Data, Data[0]);
+  ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+  for (auto &D : {Data[1], Data[0]}) {
+    ASSERT_EQ(Buffers.getFullBuffer(Full), BufferQueue::ErrorCode::Ok);
+    EXPECT_EQ(Full.Data, D);
+    ASSERT_EQ(Buffers.releaseFullBuffer(Full), BufferQueue::ErrorCode::Ok);
+  }
+  EXPECT_EQ(Buffers.getFullBuffer(Full), BufferQueue::ErrorCode::NoFullBuffers);
+}
+
+TEST(BufferQueueTest, StreamingBackpressure) {
+  bool Success = false;
+  BufferQueue Buffers(kSize, 2, Success);
+  ASSERT_TRUE(Success);
+  ASSERT_EQ(Buffers.finalize(), BufferQueue::ErrorCode::Ok);
+  ASSERT_EQ(Buffers.init(kSize, 2, /*Stream=*/true,
+                         /*BackpressureUs=*/10000000),
+            BufferQueue::ErrorCode::Ok);
+
+  // With a writer and a long enough wait, no record is dropped even though
+  // there are many more buffers released than there are in the queue.
+  static constexpr int kBuffers = 1000;
+  std::atomic<int> Written{0};
+  std::thread Writer([&] {
+    BufferQueue::Buffer Full;
+    while (Written.load(std::memory_order_acquire) != kBuffers) {
+      if (Buffers.getFullBuffer(Full) != BufferQueue::ErrorCode::Ok) {
+        std::this_thread::yield();
+        continue;
+      }
+      EXPECT_EQ(atomic_load(Full.Extents, memory_order_acquire),
+                static_cast<uint64_t>(Written.load() + 1));
+      Buffers.releaseFullBuffer(Full);
+      Written.fetch_add(1, std::memory_order_acq_rel);
+    }
+  });
+  for (int I = 0; I < kBuffers; ++I) {
+    BufferQueue::Buffer B;
+    ASSERT_EQ(Buffers.getBuffer(B), BufferQueue::ErrorCode::Ok);
+    atomic_store(B.Extents, I + 1, memory_order_release);
+    ASSERT_EQ(Buffers.releaseBuffer(B), BufferQueue::ErrorCode::Ok);
+  }
+  Writer.join();
+  EXPECT_EQ(Buffers.dropped(), 0u);
+}
+
 } // namespace
 } // namespace __xray
@@ -0,0 +1,106 @@
+//===-- sampler_test.cpp --------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a function call tracing system.
+//
+//===----------------------------------------------------------------------===//
+#include "xray_sampler.h"
+#include "gtest/gtest.h"
+#include <cstdint>
+
+namespace __xray {
+namespace {
+
+auto NoTSC = []() -> uint64_t {
+  ADD_FAILURE() << "The TSC is only read in window sampling mode.";
+  return 0;
+};
+
+TEST(CallSamplerTest, RecordsAllCallsByDefault) {
+  SamplingOptions O;
+  EXPECT_FALSE(O.enabled());
+  CallSampler S;
+  for (int I = 0; I < 100; ++I) {
+    ASSERT_TRUE(S.enter(O, NoTSC));
+    ASSERT_TRUE(S.exit());
+  }
+  EXPECT_FALSE(S.sampling());
+}
+
+TEST(CallSamplerTest, SamplesAboutOneCallInPeriod) {
+  SamplingOptions O;
+  O.Period = 100;
+  ASSERT_TRUE(O.enabled());
+  CallSampler S;
+  int Sampled = 0;
+  for (int I = 0; I < 100000; ++I) {
+    bool Entered = S.enter(O, NoTSC);
+    ASSERT_EQ(S.exit(), Entered);
+    Sampled += Entered;
+  }
+  EXPECT_GT(Sampled, 900);
+  EXPECT_LT(Sampled, 1100);
+}
+
+TEST(CallSamplerTest, SamplesCallsWithTheirCallees) {
+  SamplingOptions O;
+  O.Period = 1000;
+  CallSampler S;
+  // The first candidate call starts a sample.
+  ASSERT_TRUE(S.enter(O, NoTSC));
+  ASSERT_TRUE(S.enter(O, NoTSC));
+  ASSERT_TRUE(S.enter(O, NoTSC));
+  ASSERT_TRUE(S.exit());
+  ASSERT_TRUE(S.exit());
+  EXPECT_TRUE(S.sampling());
+  ASSERT_TRUE(S.exit());
+  EXPECT_FALSE(S.sampling());
+
+  // The following calls are mostly skipped, along with their exits. The
+  // countdown is random and may be 0, so no single call is known to be.
+  int Skipped = 0;
+  for (int I = 0; I < 10000; ++I) {
+    bool Entered = S.enter(O, NoTSC);
+    ASSERT_EQ(S.exit(), Entered);
+    Skipped += !Entered;
+  }
+  EXPECT_GT(Skipped, 9900);
+
+  // Exits of calls entered before a reset are not recorded.
+  while (!S.enter(O, NoTSC))
+    EXPECT_FALSE(S.exit());
+  S.reset();
+  EXPECT_FALSE(S.exit());
+}
+
+TEST(CallSamplerTest, SamplesCallsInWindows) {
+  SamplingOptions O;
+  O.IntervalTicks = 100;
+  O.WindowTicks = 10;
+  ASSERT_TRUE(O.enabled());
+  CallSampler S;
+  uint64_t TSC = 0;
+  auto ReadTSC = [&] { return TSC; };
+  for (TSC = 1000; TSC < 1300; ++TSC) {
+    bool Entered = S.enter(O, ReadTSC);
+    EXPECT_EQ(Entered, TSC % 100 < 10) << TSC;
+    EXPECT_EQ(S.exit(), Entered);
+  }
+
+  // A call sampled at the end of a window is recorded until it exits.
+  TSC = 1309;
+  ASSERT_TRUE(S.enter(O, ReadTSC));
+  TSC = 1350;
+  EXPECT_TRUE(S.enter(O, ReadTSC));
+  EXPECT_TRUE(S.exit());
+  EXPECT_TRUE(S.exit());
+  EXPECT_FALSE(S.enter(O, ReadTSC));
+}
+
+} // namespace
+} // namespace __xray
@@ -67,7 +67,8 @@ constexpr size_t kExtentsSize = sizeof(ExtentsPadded);
 
 } // namespace
 
-BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
+BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC, bool Stream,
+                                         uint64_t BackpressureUs) {
   SpinMutexLock Guard(&Mutex);
 
   if (!finalizing())
@@ -137,6 +138,11 @@ BufferQueue::ErrorCode BufferQueue::init(size_t BS, size_t BC) {
   Next = Buffers;
   First = Buffers;
   LiveBuffers = 0;
+  Flushed = Buffers;
+  PendingBuffers = 0;
+  Streaming = Stream;
+  BackpressureNanos = Stream ? BackpressureUs * 1000 : 0;
+  atomic_store(&Dropped, 0, memory_order_relaxed);
   atomic_store(&Finalizing, 0, memory_order_release);
   Success = true;
   return BufferQueue::ErrorCode::Ok;
@@ -154,6 +160,11 @@ BufferQueue::BufferQueue(size_t B, size_t N,
       Next(Buffers),
       First(Buffers),
       LiveBuffers(0),
+      Flushed(Buffers),
+      PendingBuffers(0),
+      Streaming(false),
+      BackpressureNanos(0),
+      Dropped{0},
       Generation{0} {
   Success = init(B, N) == BufferQueue::ErrorCode::Ok;
 }
@@ -163,14 +174,29 @@ BufferQueue::ErrorCode BufferQueue::getBuffer(Buffer &Buf) {
     return ErrorCode::QueueFinalizing;
 
   BufferRep *B = nullptr;
-  {
-    SpinMutexLock Guard(&Mutex);
-    if (LiveBuffers == BufferCount)
+  uint64_t Deadline = 0;
+  while (true) {
+    {
+      SpinMutexLock Guard(&Mutex);
+      if (LiveBuffers + PendingBuffers != BufferCount) {
+        B = Next++;
+        if (Next == (Buffers + BufferCount))
+          Next = Buffers;
+        ++LiveBuffers;
+        break;
+      }
+    }
+
+    // All the other buffers are full: give the writer some time to drain them
+    // before dropping the records.
+    const uint64_t Now = BackpressureNanos ? NanoTime() : 0;
+    if (Deadline == 0)
+      Deadline = Now + BackpressureNanos;
+    if (Now >= Deadline || atomic_load(&Finalizing, memory_order_acquire)) {
+      atomic_fetch_add(&Dropped, 1, memory_order_relaxed);
       return ErrorCode::NotEnoughMemory;
-    B = Next++;
-    if (Next == (Buffers + BufferCount))
-      Next = Buffers;
-    ++LiveBuffers;
+    }
+    internal_sched_yield();
   }
 
   incRefCount(BackingStore);
@@ -202,15 +228,53 @@ BufferQueue::ErrorCode BufferQueue::releaseBuffer(Buffer &Buf) {
     B = First++;
     if (First == (Buffers + BufferCount))
       First = Buffers;
+
+    // Now that the buffer has been released, we mark it as "used". This
+    // happens under the lock so that the writer never sees a full buffer
+    // before it is recorded here.
+    B->Buff = Buf;
+    B->Used = true;
+    atomic_store(B->Buff.Extents,
+                 atomic_load(Buf.Extents, memory_order_acquire),
+                 memory_order_release);
+    if (Streaming)
+      ++PendingBuffers;
+  }
+
+  decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
+  decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
+  Buf = {};
+  return ErrorCode::Ok;
+}
+
+BufferQueue::ErrorCode BufferQueue::getFullBuffer(Buffer &Buf) {
+  SpinMutexLock Guard(&Mutex);
+  if (PendingBuffers == 0)
+    return ErrorCode::NoFullBuffers;
+
+  incRefCount(BackingStore);
+  incRefCount(ExtentsBackingStore);
+  Buf = Flushed->Buff;
+  return ErrorCode::Ok;
+}
+
+BufferQueue::ErrorCode BufferQueue::releaseFullBuffer(Buffer &Buf) {
+  {
+    SpinMutexLock Guard(&Mutex);
+    if (Buf.Generation == generation() && PendingBuffers != 0) {
+      DCHECK_EQ(Buf.Data, Flushed->Buff.Data);
+      // The buffer was written: it must not be written again when the queue
+      // is flushed, and its slot is free for 'getBuffer'.
+      Flushed->Used = false;
+      atomic_store(Flushed->Buff.Extents, 0, memory_order_release);
+      if (++Flushed == (Buffers + BufferCount))
+        Flushed = Buffers;
+      --PendingBuffers;
+    }
   }
 
-  // Now that the buffer has been released, we mark it as "used".
-  B->Buff = Buf;
-  B->Used = true;
   decRefCount(Buf.BackingStore, Buf.Size, Buf.Count);
   decRefCount(Buf.ExtentsBackingStore, kExtentsSize, Buf.Count);
-  atomic_store(B->Buff.Extents, atomic_load(Buf.Extents, memory_order_acquire),
-               memory_order_release);
   Buf = {};
   return ErrorCode::Ok;
 }
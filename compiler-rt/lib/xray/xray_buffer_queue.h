@@ -28,6 +28,12 @@ namespace __xray {
 /// get from or return buffers to the queue. This is one key component of the
 /// "flight data recorder" (FDR) mode to support ongoing XRay function call
 /// trace collection.
+///
+/// In streaming mode, the buffers released by the threads are not handed out
+/// again until a writer has consumed them with getFullBuffer(...) and
+/// releaseFullBuffer(...), so that no records are overwritten. Threads that
+/// find no free buffer wait for the writer for a bounded time, and their
+/// records are dropped and counted after that.
 class BufferQueue {
 public:
   /// ControlBlock represents the memory layout of how we interpret the backing
@@ -159,6 +165,23 @@ private:
   // Count of buffers that have been handed out through 'getBuffer'.
   size_t LiveBuffers;
 
+  // In streaming mode, pointer to the oldest released buffer that the writer
+  // has not consumed yet. The buffers from 'Flushed' to 'First' are full.
+  BufferRep *Flushed;
+
+  // Count of released buffers waiting for the writer, always 0 when not
+  // streaming.
+  size_t PendingBuffers;
+
+  bool Streaming;
+
+  // How long 'getBuffer' waits for the writer to free a buffer, in streaming
+  // mode.
+  uint64_t BackpressureNanos;
+
+  // Count of 'getBuffer' calls that failed because no buffer was free.
+  atomic_uint64_t Dropped;
+
   // We use a generation number to identify buffers and which generation they're
   // associated with.
   atomic_uint64_t Generation;
@@ -174,6 +197,7 @@ public:
     UnrecognizedBuffer,
     AlreadyFinalized,
     AlreadyInitialized,
+    NoFullBuffers,
   };
 
   static const char *getErrorString(ErrorCode E) {
@@ -190,6 +214,8 @@ public:
       return "queue already finalized";
     case ErrorCode::AlreadyInitialized:
       return "queue already initialized";
+    case ErrorCode::NoFullBuffers:
+      return "no full buffers to write in the queue";
     }
     return "unknown error";
   }
@@ -205,6 +231,9 @@ public:
   /// Requirements:
   ///   - BufferQueue is not finalising.
   ///
+  /// In streaming mode, waits for the writer to release a full buffer when
+  /// there are none free, for up to the backpressure time given to init(...).
+  ///
   /// Returns:
   ///   - ErrorCode::NotEnoughMemory on exceeding MaxSize.
   ///   - ErrorCode::Ok when we find a Buffer.
@@ -220,14 +249,34 @@ public:
   ///     the buffer being released.
   ErrorCode releaseBuffer(Buffer &Buf);
 
+  /// Updates |Buf| to the oldest buffer released since the last call to
+  /// releaseFullBuffer(...), in streaming mode. The buffer is not handed out
+  /// by getBuffer(...) until it is given back with releaseFullBuffer(...).
+  /// There must be at most one writer calling these two functions.
+  ///
+  /// Returns:
+  ///   - ErrorCode::Ok when we find a full Buffer.
+  ///   - ErrorCode::NoFullBuffers when there are none, or when the queue is
+  ///     not streaming.
+  ErrorCode getFullBuffer(Buffer &Buf);
+
+  /// Gives back the buffer obtained from getFullBuffer(...) once its contents
+  /// have been written, and makes it available to getBuffer(...) again.
+  /// Updates |Buf| to point to nullptr, with size 0.
+  ErrorCode releaseFullBuffer(Buffer &Buf);
+
   /// Initializes the buffer queue, starting a new generation. We can re-set the
-  /// size of buffers with |BS| along with the buffer count with |BC|.
+  /// size of buffers with |BS| along with the buffer count with |BC|. When
+  /// |Stream| is true, released buffers are kept until a writer consumes them
+  /// and getBuffer(...) waits up to |BackpressureUs| microseconds for a free
+  /// buffer.
   ///
   /// Returns:
   ///   - ErrorCode::Ok when we successfully initialize the buffer. This
   ///   requires that the buffer queue is previously finalized.
   ///   - ErrorCode::AlreadyInitialized when the buffer queue is not finalized.
-  ErrorCode init(size_t BS, size_t BC);
+  ErrorCode init(size_t BS, size_t BC, bool Stream = false,
+                 uint64_t BackpressureUs = 0);
 
   bool finalizing() const {
     return atomic_load(&Finalizing, memory_order_acquire);
@@ -237,6 +286,15 @@ public:
     return atomic_load(&Generation, memory_order_acquire);
   }
 
+  bool streaming() const { return Streaming; }
+
+  /// Returns the number of getBuffer(...) calls that failed because all the
+  /// buffers were live or waiting for the writer, since the last init(...).
+  /// Each failure drops the record that a thread was about to write.
+  uint64_t dropped() const {
+    return atomic_load(&Dropped, memory_order_relaxed);
+  }
+
   /// Returns the configured size of the buffers in the buffer queue.
   size_t ConfiguredBufferSize() const { return BufferSize; }
 
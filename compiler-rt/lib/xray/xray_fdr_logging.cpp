@@ -89,6 +89,12 @@ static atomic_uint64_t TicksPerSec{0};
 static atomic_sint32_t LogFlushStatus = {
     XRayLogFlushStatus::XRAY_LOG_NOT_FLUSHING};
 
+// In streaming mode, the log being written by the writer thread, from the
+// initialization to the flush of the log.
+static LogWriter *StreamLW = nullptr;
+static pthread_t StreamThread;
+static atomic_uint8_t StreamStop{0};
+
 // This function will initialize the thread-local data structure used by the FDR
 // logging implementation and return a reference to it. The implementation
 // details require a bit of care to maintain.
@@ -275,6 +281,95 @@ XRayBuffer fdrIterator(const XRayBuffer B) {
   return Result;
 }
 
+static void writeFileHeader(LogWriter *LW) XRAY_NEVER_INSTRUMENT {
+  XRayFileHeader Header = fdrCommonHeaderInfo();
+  Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
+  LW->WriteAll(reinterpret_cast<char *>(&Header),
+               reinterpret_cast<char *>(&Header) + sizeof(Header));
+}
+
+static void writeBuffer(LogWriter *LW,
+                        const BufferQueue::Buffer &B) XRAY_NEVER_INSTRUMENT {
+  // Starting at version 2 of the FDR logging implementation, we only write
+  // the records identified by the extents of the buffer. We use the Extents
+  // from the Buffer and write that out as the first record in the buffer.  We
+  // still use a Metadata record, but fill in the extents instead for the
+  // data.
+  MetadataRecord ExtentsRecord;
+  auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
+  DCHECK(BufferExtents <= B.Size);
+  ExtentsRecord.Type = uint8_t(RecordType::Metadata);
+  ExtentsRecord.RecordKind =
+      uint8_t(MetadataRecord::RecordKinds::BufferExtents);
+  internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
+  if (BufferExtents > 0) {
+    LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
+                 reinterpret_cast<char *>(&ExtentsRecord) +
+                     sizeof(MetadataRecord));
+    LW->WriteAll(reinterpret_cast<char *>(B.Data),
+                 reinterpret_cast<char *>(B.Data) + BufferExtents);
+  }
+}
+
+// Writes the buffers released by the threads to the streamed log, oldest
+// first, and hands them back to the buffer queue.
+static void drainFullBuffers() XRAY_NEVER_INSTRUMENT {
+  BufferQueue::Buffer B;
+  while (BQ->getFullBuffer(B) == BufferQueue::ErrorCode::Ok) {
+    writeBuffer(StreamLW, B);
+    BQ->releaseFullBuffer(B);
+  }
+}
+
+static void *streamBuffers(void *) XRAY_NEVER_INSTRUMENT {
+  while (!atomic_load(&StreamStop, memory_order_acquire)) {
+    drainFullBuffers();
+    SleepForMillis(fdrFlags()->stream_interval_ms);
+  }
+  return nullptr;
+}
+
+static LogWriter *openStreamLog() XRAY_NEVER_INSTRUMENT {
+#if !SANITIZER_FUCHSIA
+  if (fdrFlags()->stream_fd >= 0) {
+    LogWriter *LW = allocate<LogWriter>();
+    new (LW) LogWriter(fdrFlags()->stream_fd);
+    return LW;
+  }
+#endif
+  return LogWriter::Open();
+}
+
+// Opens the log and starts the writer thread. The buffer queue must be
+// initialized in streaming mode.
+static bool startStreaming() XRAY_NEVER_INSTRUMENT {
+  StreamLW = openStreamLog();
+  if (StreamLW == nullptr)
+    return false;
+  writeFileHeader(StreamLW);
+  atomic_store(&StreamStop, 0, memory_order_release);
+  if (pthread_create(&StreamThread, nullptr, streamBuffers, nullptr) != 0) {
+    LogWriter::Close(StreamLW);
+    StreamLW = nullptr;
+    return false;
+  }
+  return true;
+}
+
+// Stops the writer thread, writes the buffers that are left and closes the
+// log. Buffers that threads still hold are not written.
+static void stopStreaming() XRAY_NEVER_INSTRUMENT {
+  atomic_store(&StreamStop, 1, memory_order_release);
+  pthread_join(StreamThread, nullptr);
+  drainFullBuffers();
+  if (auto Dropped = BQ->dropped())
+    Report("XRay FDR: %llu records dropped, the writer did not keep up; "
+           "consider increasing buffer_max or stream_backpressure_us.\n",
+           static_cast<unsigned long long>(Dropped));
+  LogWriter::Close(StreamLW);
+  StreamLW = nullptr;
+}
+
 // Must finalize before flushing.
 XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (atomic_load(&LoggingStatus, memory_order_acquire) !=
@@ -320,6 +415,18 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
       TLD.Controller->flush();
   });
 
+  // When streaming, most of the log has already been written and the rest
+  // goes to the same log.
+  if (BQ->streaming()) {
+    auto &TLD = getThreadLocalData();
+    if (TLD.Controller != nullptr)
+      TLD.Controller->flush();
+    stopStreaming();
+    atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
+                 memory_order_release);
+    return XRayLogFlushStatus::XRAY_LOG_FLUSHED;
+  }
+
   if (fdrFlags()->no_file_flush) {
     if (Verbosity())
       Report("XRay FDR: Not flushing to file, 'no_file_flush=true'.\n");
@@ -345,10 +452,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
     return Result;
   }
 
-  XRayFileHeader Header = fdrCommonHeaderInfo();
-  Header.FdrData = FdrAdditionalHeaderData{BQ->ConfiguredBufferSize()};
-  LW->WriteAll(reinterpret_cast<char *>(&Header),
-               reinterpret_cast<char *>(&Header) + sizeof(Header));
+  writeFileHeader(LW);
 
   // Release the current thread's buffer before we attempt to write out all the
   // buffers. This ensures that in case we had only a single thread going, that
@@ -357,27 +461,7 @@ XRayLogFlushStatus fdrLoggingFlush() XRAY_NEVER_INSTRUMENT {
   if (TLD.Controller != nullptr)
     TLD.Controller->flush();
 
-  BQ->apply([&](const BufferQueue::Buffer &B) {
-    // Starting at version 2 of the FDR logging implementation, we only write
-    // the records identified by the extents of the buffer. We use the Extents
-    // from the Buffer and write that out as the first record in the buffer.  We
-    // still use a Metadata record, but fill in the extents instead for the
-    // data.
-    MetadataRecord ExtentsRecord;
-    auto BufferExtents = atomic_load(B.Extents, memory_order_acquire);
-    DCHECK(BufferExtents <= B.Size);
-    ExtentsRecord.Type = uint8_t(RecordType::Metadata);
-    ExtentsRecord.RecordKind =
-        uint8_t(MetadataRecord::RecordKinds::BufferExtents);
-    internal_memcpy(ExtentsRecord.Data, &BufferExtents, sizeof(BufferExtents));
-    if (BufferExtents > 0) {
-      LW->WriteAll(reinterpret_cast<char *>(&ExtentsRecord),
-                   reinterpret_cast<char *>(&ExtentsRecord) +
-                       sizeof(MetadataRecord));
-      LW->WriteAll(reinterpret_cast<char *>(B.Data),
-                   reinterpret_cast<char *>(B.Data) + BufferExtents);
-    }
-  });
+  BQ->apply([&](const BufferQueue::Buffer &B) { writeBuffer(LW, B); });
 
   atomic_store(&LogFlushStatus, XRayLogFlushStatus::XRAY_LOG_FLUSHED,
                memory_order_release);
@@ -660,7 +744,10 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
   *fdrFlags() = FDRFlags;
   auto BufferSize = FDRFlags.buffer_size;
   auto BufferMax = FDRFlags.buffer_max;
+  // Streaming writes the log, which 'no_file_flush' disables.
+  bool Stream = FDRFlags.stream && !FDRFlags.no_file_flush;
 
+  bool NeedsInit = true;
   if (BQ == nullptr) {
     bool Success = false;
     BQ = reinterpret_cast<BufferQueue *>(&BufferQueueStorage);
@@ -669,12 +756,26 @@ XRayLogInitStatus fdrLoggingInit(size_t, size_t, void *Options,
       Report("BufferQueue init failed.\n");
       return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
     }
-  } else {
-    if (BQ->init(BufferSize, BufferMax) != BufferQueue::ErrorCode::Ok) {
-      if (Verbosity())
-        Report("Failed to re-initialize global buffer queue. Init failed.\n");
-      return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
-    }
+    // The constructor sets up a queue that does not stream.
+    NeedsInit = Stream;
+    if (Stream)
+      BQ->finalize();
+  }
+  if (NeedsInit &&
+      BQ->init(BufferSize, BufferMax, Stream,
+               Max(FDRFlags.stream_backpressure_us, 0)) !=
+          BufferQueue::ErrorCode::Ok) {
+    if (Verbosity())
+      Report("Failed to re-initialize global buffer queue. Init failed.\n");
+    return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
+  }
+
+  if (Stream && !startStreaming()) {
+    Report("XRay FDR: cannot start streaming the log. Init failed.\n");
+    BQ->finalize();
+    atomic_store(&LoggingStatus, XRayLogInitStatus::XRAY_LOG_UNINITIALIZED,
+                 memory_order_release);
+    return XRayLogInitStatus::XRAY_LOG_UNINITIALIZED;
   }
 
   static pthread_once_t OnceInit = PTHREAD_ONCE_INIT;
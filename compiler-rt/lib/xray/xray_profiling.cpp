@@ -23,6 +23,7 @@
 #include "xray_profile_collector.h"
 #include "xray_profiling_flags.h"
 #include "xray_recursion_guard.h"
+#include "xray_sampler.h"
 #include "xray_tsc.h"
 #include "xray_utils.h"
 #include <pthread.h>
@@ -71,6 +72,11 @@ thread_local atomic_uint8_t TLDInitGuard{0};
 // non-essential work should be ignored (things like recording events, etc.).
 thread_local atomic_uint8_t ThreadExitingLatch{0};
 
+// The calls to record when sampling, set at initialisation, and the sampling
+// state of the thread.
+static SamplingOptions Sampling;
+thread_local CallSampler Sampler;
+
 static ProfilingData *getThreadLocalData() XRAY_NEVER_INSTRUMENT {
   thread_local auto ThreadOnce = []() XRAY_NEVER_INSTRUMENT {
     pthread_setspecific(ProfilingKey, &TLD);
@@ -192,6 +198,25 @@ static void postCurrentThreadFCT(ProfilingData &T) XRAY_NEVER_INSTRUMENT {
 
   // Re-initialize the ThreadBuffers object to a known "default" state.
   ThreadBuffers = FunctionCallTrie::Allocators::Buffers{};
+
+  // The exits of the calls sampled so far must not go to the next profile.
+  Sampler.reset();
+}
+
+static bool isSampled(XRayEntryType Entry) XRAY_NEVER_INSTRUMENT {
+  switch (Entry) {
+  case XRayEntryType::ENTRY:
+  case XRayEntryType::LOG_ARGS_ENTRY:
+    return Sampler.enter(Sampling, []() XRAY_NEVER_INSTRUMENT {
+      unsigned char CPU;
+      return readTSC(CPU);
+    });
+  case XRayEntryType::EXIT:
+  case XRayEntryType::TAIL:
+    return Sampler.exit();
+  default:
+    return false;
+  }
 }
 
 } // namespace
@@ -270,6 +295,11 @@ XRayLogFlushStatus profilingFlush() XRAY_NEVER_INSTRUMENT {
 
 void profilingHandleArg0(int32_t FuncId,
                          XRayEntryType Entry) XRAY_NEVER_INSTRUMENT {
+  // Sampling is checked first, so that the calls that are not sampled cost as
+  // little as possible.
+  if (Sampling.enabled() && !isSampled(Entry))
+    return;
+
   unsigned char CPU;
   auto TSC = readTSC(CPU);
   RecursionGuard G(ReentranceGuard);
@@ -384,6 +414,27 @@ profilingLoggingInit(size_t, size_t, void *Options,
     *profilingFlags() = Flags;
   }
 
+  Sampling = {};
+  if (profilingFlags()->sampling_period > 1)
+    Sampling.Period = profilingFlags()->sampling_period;
+  if (profilingFlags()->sampling_window_us > 0 &&
+      profilingFlags()->sampling_interval_ms > 0) {
+    uint64_t TicksPerSec = probeRequiredCPUFeatures()
+                               ? getTSCFrequency()
+                               : NanosecondsPerSecond;
+    Sampling.IntervalTicks =
+        TicksPerSec * profilingFlags()->sampling_interval_ms / 1000;
+    Sampling.WindowTicks = Min<uint64_t>(
+        TicksPerSec * profilingFlags()->sampling_window_us / 1000000,
+        Sampling.IntervalTicks);
+  }
+  if (Verbosity() && Sampling.Period > 1)
+    Report("XRay Profiling: sampling one call in %u.\n", Sampling.Period);
+  if (Verbosity() && Sampling.WindowTicks != 0)
+    Report("XRay Profiling: sampling calls for %d us every %d ms.\n",
+           profilingFlags()->sampling_window_us,
+           profilingFlags()->sampling_interval_ms);
+
   // We need to reset the profile data collection implementation now.
   profileCollectorService::reset();
 
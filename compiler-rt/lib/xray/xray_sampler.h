@@ -0,0 +1,132 @@
+//===-- xray_sampler.h ------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This file is a part of XRay, a dynamic runtime instrumentation system.
+//
+// Selects the calls that a handler records when sampling.
+//
+//===----------------------------------------------------------------------===//
+#ifndef XRAY_XRAY_SAMPLER_H
+#define XRAY_XRAY_SAMPLER_H
+
+#include "xray_defs.h"
+#include <cstdint>
+
+namespace __xray {
+
+/// Which calls to sample. A call is sampled when it passes both criteria.
+struct SamplingOptions {
+  /// Sample about one call in |Period|, chosen at random so that the samples
+  /// do not follow the period of a loop in the program. All the calls pass
+  /// when |Period| is 0 or 1.
+  uint32_t Period = 0;
+
+  /// Sample the calls entered in the first |WindowTicks| of every
+  /// |IntervalTicks|. The windows start at multiples of |IntervalTicks|, so
+  /// that all the threads sample the same windows. All the calls pass when
+  /// |WindowTicks| is 0.
+  uint64_t WindowTicks = 0;
+  uint64_t IntervalTicks = 0;
+
+  bool enabled() const XRAY_NEVER_INSTRUMENT {
+    return Period > 1 || WindowTicks != 0;
+  }
+};
+
+/// The CallSampler keeps the sampling state of a thread. A sample is a call
+/// along with all the calls it makes: once a call is sampled, every entry and
+/// exit is recorded until that call exits, so that the recorded entries and
+/// exits always pair up. The calls made within a sample are not candidates to
+/// start another one.
+///
+/// The checks only touch the state of the thread, the CallSampler is meant to
+/// be a thread_local consulted before any other work in a handler:
+///
+///   thread_local CallSampler Sampler;
+///
+///   void handleArg0(int32_t F, XRayEntryType T) {
+///     if (T == XRayEntryType::ENTRY ? !Sampler.enter(Options, ReadTSC)
+///                                   : !Sampler.exit())
+///       return;
+///     ...
+///   }
+///
+class CallSampler {
+  // Number of calls of the sample in progress that have not exited yet, 0
+  // outside of a sample.
+  uint32_t Depth = 0;
+
+  // Number of candidate calls to skip before sampling one.
+  uint32_t Countdown = 0;
+  uint32_t RandomState = 0;
+
+  // The start of the interval holding the latest candidate call.
+  uint64_t IntervalBegin = 0;
+
+  uint32_t nextRandom() XRAY_NEVER_INSTRUMENT {
+    uint32_t X = RandomState;
+    if (X == 0)
+      X = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(this)) | 1;
+    // xorshift32
+    X ^= X << 13;
+    X ^= X >> 17;
+    X ^= X << 5;
+    RandomState = X;
+    return X;
+  }
+
+  bool inWindow(const SamplingOptions &O, uint64_t TSC) XRAY_NEVER_INSTRUMENT {
+    // Only the first call of every interval pays for a division.
+    if (TSC - IntervalBegin >= O.IntervalTicks)
+      IntervalBegin = TSC - TSC % O.IntervalTicks;
+    return TSC - IntervalBegin < O.WindowTicks;
+  }
+
+public:
+  /// Returns whether the entry of a call must be recorded. |ReadTSC| returns
+  /// the current TSC, it is only called in window sampling mode for the calls
+  /// that are candidates to start a sample.
+  template <class TSCReader>
+  bool enter(const SamplingOptions &O,
+             TSCReader ReadTSC) XRAY_NEVER_INSTRUMENT {
+    if (Depth != 0) {
+      ++Depth;
+      return true;
+    }
+    if (O.WindowTicks != 0 && !inWindow(O, ReadTSC()))
+      return false;
+    if (O.Period > 1) {
+      if (Countdown != 0) {
+        --Countdown;
+        return false;
+      }
+      Countdown = nextRandom() % (2 * O.Period - 1);
+    }
+    Depth = 1;
+    return true;
+  }
+
+  /// Returns whether the exit of a call must be recorded, that is whether its
+  /// entry was.
+  bool exit() XRAY_NEVER_INSTRUMENT {
+    if (Depth == 0)
+      return false;
+    --Depth;
+    return true;
+  }
+
+  /// Returns whether a sample is in progress.
+  bool sampling() const XRAY_NEVER_INSTRUMENT { return Depth != 0; }
+
+  /// Forgets the sample in progress, the exits of its calls are not recorded.
+  void reset() XRAY_NEVER_INSTRUMENT { Depth = 0; }
+};
+
+} // namespace __xray
+
+#endif // XRAY_XRAY_SAMPLER_H
@@ -0,0 +1,35 @@
+// Test the atomic merging mode (%a with %m): the processes add their counters
+// to the profile file concurrently, without locking it.
+//
+// RUN: rm -rf %t.dir && mkdir -p %t.dir
+// RUN: %clang_profgen -o %t -O2 %s
+// RUN: env LLVM_PROFILE_FILE="%t.dir/%a%m.profraw" %run %t
+// RUN: env LLVM_PROFILE_FILE="%t.dir/%a%m.profraw" %run %t
+// RUN: llvm-profdata merge -o %t.profdata %t.dir
+// RUN: llvm-profdata show --counts --function=work %t.profdata | FileCheck %s
+//
+// Each run forks 16 processes, on top of the parent, and every process calls
+// work 1000 times.
+// CHECK: Function count: 34000
+
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define NUM_PROCESSES 16
+#define NUM_CALLS 1000
+
+volatile int Sum;
+
+__attribute__((noinline)) void work(int I) { Sum += I; }
+
+int main() {
+  for (int P = 0; P < NUM_PROCESSES; ++P)
+    if (fork() == 0)
+      break;
+  for (int I = 0; I < NUM_CALLS; ++I)
+    work(I);
+  while (wait(NULL) > 0)
+    ;
+  return 0;
+}
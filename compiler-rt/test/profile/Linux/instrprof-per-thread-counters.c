@@ -0,0 +1,36 @@
+// RUN: %clang_profgen -mllvm -instrprof-per-thread-counters -o %t -O2 %s -pthread
+// RUN: env LLVM_PROFILE_FILE=%t.profraw %run %t
+// RUN: llvm-profdata show --counts --function=work %t.profraw | FileCheck %s
+
+#include <pthread.h>
+
+#define NUM_THREADS 8
+#define NUM_CALLS 10000
+
+// The counts of the threads that exited are added when they exit, the counts
+// of the main thread when the profile is written.
+// CHECK: Function count: 90000
+// CHECK: Block counts: [45000]
+__attribute__((noinline)) int work(int I) {
+  if (I % 2)
+    return I;
+  return -I;
+}
+
+volatile int Sum;
+
+void *run(void *Arg) {
+  for (int I = 0; I < NUM_CALLS; ++I)
+    Sum += work(I);
+  return 0;
+}
+
+int main() {
+  pthread_t Threads[NUM_THREADS];
+  for (int I = 0; I < NUM_THREADS; ++I)
+    pthread_create(&Threads[I], 0, run, 0);
+  for (int I = 0; I < NUM_THREADS; ++I)
+    pthread_join(Threads[I], 0);
+  run(0);
+  return 0;
+}
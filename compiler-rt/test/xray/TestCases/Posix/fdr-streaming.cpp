@@ -0,0 +1,42 @@
+// RUN: %clangxx_xray -g -std=c++11 %s -o %t
+// RUN: rm -f fdr-streaming-*
+// RUN: XRAY_OPTIONS="patch_premain=false xray_logfile_base=fdr-streaming- \
+// RUN:     verbosity=1" %run %t 2>&1
+// RUN: %llvm_xray convert --output-format=yaml --symbolize --instr_map=%t \
+// RUN:   "`ls fdr-streaming-* | head -n1`" | FileCheck %s
+// RUN: rm fdr-streaming-*
+//
+// REQUIRES: x86_64-target-arch
+
+// Two buffers hold a few dozen records only: all the others are written to the
+// log by the writer thread while the program runs.
+
+#include "xray/xray_log_interface.h"
+#include <cassert>
+
+[[clang::xray_always_instrument]] void __attribute__((noinline)) fn(int) {}
+
+int main(int argc, char *argv[]) {
+  auto status = __xray_log_init_mode(
+      "xray-fdr", "buffer_size=512:buffer_max=2:func_duration_threshold_us=0:"
+                  "stream=true:stream_interval_ms=1:"
+                  "stream_backpressure_us=10000000");
+  assert(status == XRayLogInitStatus::XRAY_LOG_INITIALIZED);
+
+  __xray_patch();
+  for (int i = 0; i < 1000; ++i)
+    fn(i);
+  __xray_unpatch();
+  assert(__xray_log_finalize() == XRAY_LOG_FINALIZED);
+  assert(__xray_log_flushLog() == XRAY_LOG_FLUSHED);
+  return 0;
+}
+
+// The first and the last calls are both in the log.
+// CHECK: records:
+// CHECK-NEXT: - { type: 0, func-id: [[FID:[0-9]+]], function: {{.*fn.*}}, cpu: {{.*}}, thread: {{[0-9]+}}, process: {{[0-9]+}}, kind: function-enter, tsc: {{[0-9]+}}, data: '' }
+// CHECK-NEXT: - { type: 0, func-id: [[FID]], function: {{.*fn.*}}, cpu: {{.*}}, thread: {{[0-9]+}}, process: {{[0-9]+}}, kind: function-exit, tsc: {{[0-9]+}}, data: '' }
+// CHECK-COUNT-998: kind: function-enter
+// CHECK: kind: function-enter
+// CHECK-NEXT: kind: function-exit
+// CHECK-NOT: kind
@@ -68,6 +68,24 @@ static Error fromJson(const json::Value &V, int &Out) {
   return intFromJsonTemplate(V, Out);
 }
 
+static Error fromJson(const json::Value &V, uint64_t &Out) {
+  if (const auto &MaybeInt64 = V.getAsInteger()) {
+    if (*MaybeInt64 < 0)
+      return createStringError(errc::io_error, "Out of bound Integer");
+    Out = *MaybeInt64;
+    return Error::success();
+  }
+  return createStringError(errc::io_error, "Can't parse Integer");
+}
+
+static Error fromJson(const json::Value &V, bool &Out) {
+  if (auto B = V.getAsBoolean()) {
+    Out = *B;
+    return Error::success();
+  }
+  return createStringError(errc::io_error, "Can't parse Boolean");
+}
+
 static Error fromJson(const json::Value &V, libc_benchmarks::Duration &D) {
   if (V.kind() != json::Value::Kind::Number)
     return createStringError(errc::io_error, "Can't parse Duration");
@@ -203,6 +221,25 @@ static Error fromJson(const json::Value &V,
   O.map("AddressAlignment", Out.AddressAlignment);
   O.map("MemsetValue", Out.MemsetValue);
   O.map("MemcmpMismatchAt", Out.MemcmpMismatchAt);
+  O.map("Distribution", Out.Distribution);
+  return O.takeError();
+}
+
+static Error fromJson(const json::Value &V, libc_benchmarks::CallSample &Out) {
+  JsonObjectMapper O(V);
+  O.map("Size", Out.Size);
+  O.map("SrcAlignment", Out.SrcAlignment);
+  O.map("DstAlignment", Out.DstAlignment);
+  O.map("Overlap", Out.Overlap);
+  O.map("Count", Out.Count);
+  return O.takeError();
+}
+
+static Error fromJson(const json::Value &V,
+                      libc_benchmarks::CallHistogram &Out) {
+  JsonObjectMapper O(V);
+  O.map("Function", Out.Function);
+  O.map("Samples", Out.Samples);
   return O.takeError();
 }
 
@@ -265,6 +302,16 @@ Expected<Study> ParseJsonStudy(StringRef Content) {
   return S;
 }
 
+Expected<CallHistogram> ParseJsonCallHistogram(StringRef Content) {
+  Expected<json::Value> EV = json::parse(Content);
+  if (!EV)
+    return EV.takeError();
+  CallHistogram H;
+  if (Error E = fromJson(*EV, H))
+    return std::move(E);
+  return H;
+}
+
 static StringRef Serialize(const BenchmarkLog &L) {
   switch (L) {
   case BenchmarkLog::None:
@@ -325,6 +372,8 @@ static void Serialize(const StudyConfiguration &SC, json::OStream &JOS) {
                     static_cast<int64_t>(SC.AddressAlignment->value()));
     JOS.attribute("MemsetValue", SC.MemsetValue);
     JOS.attribute("MemcmpMismatchAt", SC.MemcmpMismatchAt);
+    if (!SC.Distribution.empty())
+      JOS.attribute("Distribution", SC.Distribution);
   });
 }
 
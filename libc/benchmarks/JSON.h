@@ -19,6 +19,9 @@ namespace libc_benchmarks {
 // Parses a Study from a json string.
 Expected<Study> ParseJsonStudy(StringRef Content);
 
+// Parses a CallHistogram from a json string.
+Expected<CallHistogram> ParseJsonCallHistogram(StringRef Content);
+
 // Serialize a Study as json.
 void SerializeToJson(const Study &S, llvm::json::OStream &JOS);
 
@@ -29,7 +29,8 @@ Study getStudy() {
           "CpuName", 123, {CacheInfo{"A", 1, 2, 3}, CacheInfo{"B", 4, 5, 6}}},
       BenchmarkOptions{std::chrono::seconds(1), std::chrono::seconds(2), 10,
                        100, 6, 100, 0.1, 2, BenchmarkLog::Full},
-      StudyConfiguration{2, 3, SizeRange{4, 5, 6}, Align(8), 9, 10},
+      StudyConfiguration{2, 3, SizeRange{4, 5, 6}, Align(8), 9, 10,
+                         "calls.json"},
       {FunctionMeasurements{"A",
                             {Measurement{3, std::chrono::seconds(3)},
                              Measurement{3, std::chrono::seconds(4)}}},
@@ -86,7 +87,8 @@ auto Equals(const StudyConfiguration &SC) -> auto {
       Field(&StudyConfiguration::Size, Equals(SC.Size)),
       Field(&StudyConfiguration::AddressAlignment, SC.AddressAlignment),
       Field(&StudyConfiguration::MemsetValue, SC.MemsetValue),
-      Field(&StudyConfiguration::MemcmpMismatchAt, SC.MemcmpMismatchAt));
+      Field(&StudyConfiguration::MemcmpMismatchAt, SC.MemcmpMismatchAt),
+      Field(&StudyConfiguration::Distribution, SC.Distribution));
 }
 
 MATCHER(EqualsMeasurement, "") {
@@ -193,6 +195,38 @@ TEST(JsonTest, InvalidBenchmarkLog) {
             "Can't parse BenchmarkLog, invalid value 'Unknown'");
 }
 
+TEST(JsonTest, CallHistogram) {
+  auto HistogramOrError = ParseJsonCallHistogram(R"({
+      "Function": "memcpy",
+      "Samples": [
+        {"Size": 16, "SrcAlignment": 8, "DstAlignment": 0, "Overlap": false,
+         "Count": 5000000000},
+        {"Size": 3, "SrcAlignment": 63, "DstAlignment": 1, "Overlap": true,
+         "Count": 2}
+      ]
+    }
+  )");
+  if (auto Err = HistogramOrError.takeError())
+    EXPECT_FALSE(Err) << "Unexpected error";
+  const CallHistogram &H = *HistogramOrError;
+  EXPECT_EQ(H.Function, "memcpy");
+  ASSERT_EQ(H.Samples.size(), 2U);
+  EXPECT_EQ(H.Samples[0].Size, 16U);
+  EXPECT_EQ(H.Samples[0].SrcAlignment, 8U);
+  EXPECT_EQ(H.Samples[0].DstAlignment, 0U);
+  EXPECT_FALSE(H.Samples[0].Overlap);
+  EXPECT_EQ(H.Samples[0].Count, 5000000000U);
+  EXPECT_TRUE(H.Samples[1].Overlap);
+}
+
+TEST(JsonTest, InvalidCallCount) {
+  auto Failure = ParseJsonCallHistogram(R"({
+      "Samples": [{"Count": -1}]
+    }
+  )");
+  EXPECT_EQ(toString(Failure.takeError()), "Out of bound Integer");
+}
+
 } // namespace
 } // namespace libc_benchmarks
 } // namespace llvm
@@ -7,10 +7,12 @@
 //===----------------------------------------------------------------------===//
 
 #include "LibcMemoryBenchmark.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/MathExtras.h"
 #include <algorithm>
+#include <limits>
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -58,5 +60,82 @@ MismatchOffsetDistribution::MismatchOffsetDistribution(
       std::uniform_int_distribution<size_t>(0, MismatchIndices.size() - 1);
 }
 
+// Precomputes sentinel positions so that any offset returned by the
+// distribution is followed by exactly `Size` non-sentinel bytes.
+SentinelOffsetDistribution::SentinelOffsetDistribution(
+    const StudyConfiguration &Conf) {
+  const auto ToSize = Conf.Size.To;
+  for (size_t I = ToSize; I < Conf.BufferSize; I += ToSize + 1)
+    SentinelIndices.push_back(I);
+  if (SentinelIndices.empty())
+    llvm::report_fatal_error(
+        "BufferSize too small to exercise specified Size configuration");
+  SentinelIndexSelector =
+      std::uniform_int_distribution<size_t>(0, SentinelIndices.size() - 1);
+}
+
+static std::discrete_distribution<size_t>
+GetSampleSelector(ArrayRef<CallSample> Samples) {
+  std::vector<double> Weights;
+  Weights.reserve(Samples.size());
+  for (const auto &Sample : Samples)
+    Weights.push_back(Sample.Count);
+  return std::discrete_distribution<size_t>(Weights.begin(), Weights.end());
+}
+
+CallSampler::CallSampler(const CallHistogram &Histogram, uint32_t BufferSize)
+    : Samples(Histogram.Samples), SampleSelector(GetSampleSelector(Samples)),
+      BufferSize(BufferSize) {
+  if (llvm::none_of(Samples, [](const CallSample &S) { return S.Count; }))
+    report_fatal_error("The call histogram is empty");
+  for (const auto &Sample : Samples)
+    if (Sample.SrcAlignment >= CallSample::kAlignment ||
+        Sample.DstAlignment >= CallSample::kAlignment)
+      report_fatal_error("Call alignments must be less than 64");
+  if (BufferSize < getMinBufferSize(Histogram))
+    report_fatal_error("BufferSize too small to replay the call histogram");
+}
+
+uint32_t CallSampler::getMinBufferSize(const CallHistogram &Histogram) {
+  uint64_t MaxSize = 0;
+  for (const auto &Sample : Histogram.Samples)
+    MaxSize = std::max<uint64_t>(MaxSize, Sample.Size);
+  // Room for the largest misalignment.
+  const uint64_t MinBufferSize =
+      alignTo(MaxSize + CallSample::kAlignment, AlignedBuffer::Alignment);
+  if (MinBufferSize > std::numeric_limits<uint32_t>::max())
+    report_fatal_error("Calls are too large to be replayed");
+  return MinBufferSize;
+}
+
+double CallSampler::getMeanSize() const {
+  double TotalSize = 0;
+  double TotalCount = 0;
+  for (const auto &Sample : Samples) {
+    TotalSize += double(Sample.Size) * Sample.Count;
+    TotalCount += Sample.Count;
+  }
+  return TotalSize / TotalCount;
+}
+
+void CallSampler::Randomize(MutableArrayRef<ParameterType> Parameters) {
+  for (auto &P : Parameters) {
+    const CallSample &Sample = Samples[SampleSelector(Gen)];
+    // The cache lines where the buffers can start, `kAlignment` more bytes
+    // are needed to apply the misalignment.
+    const uint32_t Lines =
+        (BufferSize - Sample.Size - CallSample::kAlignment) /
+            CallSample::kAlignment +
+        1;
+    std::uniform_int_distribution<uint32_t> LineSelector(0, Lines - 1);
+    const uint32_t SrcLine = LineSelector(Gen);
+    const uint32_t DstLine = Sample.Overlap ? SrcLine : LineSelector(Gen);
+    P.Size = Sample.Size;
+    P.SrcOffset = SrcLine * CallSample::kAlignment + Sample.SrcAlignment;
+    P.DstOffset = DstLine * CallSample::kAlignment + Sample.DstAlignment;
+    P.Overlap = Sample.Overlap;
+  }
+}
+
 } // namespace libc_benchmarks
 } // namespace llvm
@@ -18,6 +18,8 @@
 #include "llvm/Support/Alignment.h"
 #include <cstdint>
 #include <random>
+#include <string>
+#include <vector>
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -59,6 +61,39 @@ struct StudyConfiguration {
   // The mismatch position for memcmp.
   uint32_t MemcmpMismatchAt = 0; //  0 : Buffer compare equal,
                                  // >0 : Buffer compare different at byte N-1.
+
+  // The file holding the `CallHistogram` to replay. When set, each run
+  // measures the average time of calls drawn from the histogram instead of
+  // exercising the `Size` range.
+  std::string Distribution;
+};
+
+//---------------
+// Recorded calls
+//---------------
+
+// A bucket of the histogram of the calls made by an application.
+struct CallSample {
+  // The addresses are recorded modulo `kAlignment`, a cache line.
+  static constexpr uint32_t kAlignment = 64;
+
+  uint32_t Size = 0;
+  // The alignment of the source (memcpy) or of the second buffer (memcmp).
+  uint32_t SrcAlignment = 0;
+  // The alignment of the destination (memcpy, memset) or of the first buffer
+  // (memcmp).
+  uint32_t DstAlignment = 0;
+  // Whether the two buffers overlap.
+  bool Overlap = false;
+  // The number of calls falling into this bucket.
+  uint64_t Count = 0;
+};
+
+// The calls to a memory function recorded from an application, for instance
+// by the `libc-memory-sampler` library.
+struct CallHistogram {
+  std::string Function;
+  std::vector<CallSample> Samples;
 };
 
 //--------
@@ -136,6 +171,42 @@ public:
   }
 };
 
+// The parameters of a call replayed from a `CallHistogram`.
+struct CallParameters {
+  uint32_t Size = 0;
+  uint32_t SrcOffset = 0;
+  uint32_t DstOffset = 0;
+  bool Overlap = false;
+};
+
+// Draws calls from a `CallHistogram`, each bucket with a probability
+// proportional to its count. Offsets are relative to an `AlignedBuffer` and
+// keep the recorded alignments. The buffers of overlapping calls start in the
+// same cache line, the benchmark has to use a single buffer for both.
+class CallSampler {
+  std::default_random_engine Gen;
+  std::vector<CallSample> Samples;
+  std::discrete_distribution<size_t> SampleSelector;
+  uint32_t BufferSize;
+
+public:
+  using ParameterType = CallParameters;
+
+  // Precondition: `BufferSize >= getMinBufferSize(Histogram)`.
+  CallSampler(const CallHistogram &Histogram, uint32_t BufferSize);
+
+  // The smallest buffer that can hold the largest call of `Histogram`.
+  static uint32_t getMinBufferSize(const CallHistogram &Histogram);
+
+  // The average size of the calls.
+  double getMeanSize() const;
+
+  // Needed by the ParameterProvider to update the current batch of parameter.
+  void Randomize(MutableArrayRef<ParameterType> Parameters);
+};
+
+using CallParameterProvider = SmallParameterProvider<CallSampler>;
+
 // Helper to generate random buffer offsets that satisfy the configuration
 // constraints.
 class OffsetDistribution {
@@ -177,6 +248,27 @@ public:
   }
 };
 
+// Helper to generate random buffer offsets that satisfy the configuration
+// constraints. It is specifically designed to benchmark string functions where
+// we want a sentinel (e.g. the null terminator or the searched character) to
+// be exactly `Size` bytes after the offset.
+class SentinelOffsetDistribution {
+  std::uniform_int_distribution<size_t> SentinelIndexSelector;
+  llvm::SmallVector<uint32_t, 16> SentinelIndices;
+
+public:
+  explicit SentinelOffsetDistribution(const StudyConfiguration &Conf);
+
+  // The positions in the buffer where the sentinel must be written.
+  const llvm::SmallVectorImpl<uint32_t> &getSentinelIndices() const {
+    return SentinelIndices;
+  }
+
+  template <class Generator> uint32_t operator()(Generator &G, uint32_t Size) {
+    return SentinelIndices[SentinelIndexSelector(G)] - Size;
+  }
+};
+
 } // namespace libc_benchmarks
 } // namespace llvm
 
@@ -10,6 +10,7 @@
 #include "JSON.h"
 #include "LibcBenchmark.h"
 #include "LibcMemoryBenchmark.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/ErrorHandling.h"
 #include "llvm/Support/FileSystem.h"
@@ -17,6 +18,8 @@
 #include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
+#include <algorithm>
+#include <cmath>
 #include <string>
 
 namespace llvm {
@@ -29,32 +32,17 @@ static cl::opt<std::string>
 static cl::opt<std::string> Output("o", cl::desc("Specify output filename"),
                                    cl::value_desc("filename"), cl::init("-"));
 
+static cl::opt<std::string>
+    Distribution("distribution",
+                 cl::desc("Replay the calls recorded in this histogram file "
+                          "instead of exercising a range of sizes"),
+                 cl::value_desc("filename"), cl::init(""));
+
 extern std::unique_ptr<BenchmarkRunner>
 getRunner(const StudyConfiguration &Conf);
 
-void Main() {
-#ifndef NDEBUG
-  static_assert(
-      false,
-      "For reproducibility benchmarks should not be compiled in DEBUG mode.");
-#endif
-  checkRequirements();
-  ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
-      MemoryBuffer::getFileOrSTDIN(Configuration);
-  if (!MB)
-    report_fatal_error(
-        Twine("Could not open configuration file: ").concat(Configuration));
-  auto ErrorOrStudy = ParseJsonStudy((*MB)->getBuffer());
-  if (!ErrorOrStudy)
-    report_fatal_error(ErrorOrStudy.takeError());
-
-  const auto StudyPrototype = *ErrorOrStudy;
-
-  Study S;
-  S.Host = HostState::get();
-  S.Options = StudyPrototype.Options;
-  S.Configuration = StudyPrototype.Configuration;
-
+// Measures every function for each size of the configured range.
+static void SweepSizes(Study &S) {
   const auto Runs = S.Configuration.Runs;
   const auto &SR = S.Configuration.Size;
   std::unique_ptr<BenchmarkRunner> Runner = getRunner(S.Configuration);
@@ -80,6 +68,81 @@ void Main() {
     }
     S.Functions.push_back(std::move(FM));
   }
+}
+
+// Measures every function with calls drawn from the recorded histogram, there
+// is one measurement per run. Its size is the average size of the calls.
+static void ReplayCalls(Study &S) {
+  const auto &Filename = S.Configuration.Distribution;
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB = MemoryBuffer::getFile(Filename);
+  if (!MB)
+    report_fatal_error(
+        Twine("Could not open histogram file: ").concat(Filename));
+  auto ErrorOrHistogram = ParseJsonCallHistogram((*MB)->getBuffer());
+  if (!ErrorOrHistogram)
+    report_fatal_error(ErrorOrHistogram.takeError());
+  const CallHistogram &Histogram = *ErrorOrHistogram;
+
+  // The buffers grow to fit the largest recorded call.
+  S.Configuration.BufferSize = std::max(
+      S.Configuration.BufferSize, CallSampler::getMinBufferSize(Histogram));
+  const auto Runs = S.Configuration.Runs;
+  std::unique_ptr<BenchmarkRunner> Runner = getRunner(S.Configuration);
+  if (!is_contained(Runner->getFunctionNames(), Histogram.Function))
+    report_fatal_error(Twine("This benchmark cannot replay calls to ")
+                           .concat(Histogram.Function));
+  CallSampler Sampler(Histogram, S.Configuration.BufferSize);
+  CallParameterProvider Calls(Sampler);
+  const size_t TotalSteps = Runner->getFunctionNames().size() * Runs;
+  size_t Steps = 0;
+  for (auto FunctionName : Runner->getFunctionNames()) {
+    FunctionMeasurements FM;
+    FM.Name = std::string(FunctionName);
+    for (size_t Run = 0; Run < Runs; ++Run) {
+      const auto Result = Runner->replay(S.Options, FunctionName, Calls);
+      Measurement Measurement;
+      Measurement.Runtime = Result.BestGuess;
+      Measurement.Size = std::lround(Sampler.getMeanSize());
+      FM.Measurements.push_back(Measurement);
+      outs() << format("%3d%% run: %2d / %2d ", (Steps * 100 / TotalSteps), Run,
+                       Runs)
+             << FunctionName
+             << "                                                  \r";
+      ++Steps;
+    }
+    S.Functions.push_back(std::move(FM));
+  }
+}
+
+void Main() {
+#ifndef NDEBUG
+  static_assert(
+      false,
+      "For reproducibility benchmarks should not be compiled in DEBUG mode.");
+#endif
+  checkRequirements();
+  ErrorOr<std::unique_ptr<MemoryBuffer>> MB =
+      MemoryBuffer::getFileOrSTDIN(Configuration);
+  if (!MB)
+    report_fatal_error(
+        Twine("Could not open configuration file: ").concat(Configuration));
+  auto ErrorOrStudy = ParseJsonStudy((*MB)->getBuffer());
+  if (!ErrorOrStudy)
+    report_fatal_error(ErrorOrStudy.takeError());
+
+  const auto StudyPrototype = *ErrorOrStudy;
+
+  Study S;
+  S.Host = HostState::get();
+  S.Options = StudyPrototype.Options;
+  S.Configuration = StudyPrototype.Configuration;
+  if (!Distribution.empty())
+    S.Configuration.Distribution = Distribution;
+
+  if (S.Configuration.Distribution.empty())
+    SweepSizes(S);
+  else
+    ReplayCalls(S);
 
   std::error_code EC;
   raw_fd_ostream FOS(Output, EC);
@@ -10,8 +10,10 @@
 #define LLVM_LIBC_UTILS_BENCHMARK_MEMORY_BENCHMARK_MAIN_H
 
 #include "LibcBenchmark.h"
+#include "LibcMemoryBenchmark.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/StringRef.h"
+#include "llvm/Support/ErrorHandling.h"
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -28,6 +30,14 @@ public:
   // Performs the benchmarking for a particular FunctionName and Size.
   virtual BenchmarkResult benchmark(const BenchmarkOptions &Options,
                                     StringRef FunctionName, size_t Size) = 0;
+
+  // Performs the benchmarking for a particular FunctionName with calls drawn
+  // from a recorded histogram. Only the memory functions support it.
+  virtual BenchmarkResult replay(const BenchmarkOptions &Options,
+                                 StringRef FunctionName,
+                                 CallParameterProvider &Calls) {
+    report_fatal_error("This benchmark cannot replay recorded calls");
+  }
 };
 
 } // namespace libc_benchmarks
@@ -114,6 +114,63 @@ TEST(MismatchOffsetDistribution, MismatchAt2) {
   }
 }
 
+TEST(SentinelOffsetDistribution, SentinelIsSizeBytesAfterOffset) {
+  const uint32_t ToSize = 4;
+  StudyConfiguration Conf;
+  Conf.BufferSize = 16;
+  Conf.Size.To = ToSize;
+
+  SentinelOffsetDistribution SOD(Conf);
+  // Spans of 4 non sentinel bytes separated by one sentinel.
+  EXPECT_THAT(SOD.getSentinelIndices(), ElementsAre(4, 9, 14));
+  std::default_random_engine Gen;
+  for (size_t Iterations = 0; Iterations <= 10; ++Iterations)
+    for (size_t Size = Conf.Size.From; Size <= ToSize; ++Size)
+      EXPECT_THAT(SOD(Gen, Size), AnyOf(4 - Size, 9 - Size, 14 - Size));
+}
+
+CallHistogram getCallHistogram() {
+  CallHistogram H;
+  H.Function = "memcpy";
+  H.Samples = {CallSample{100, 3, 17, false, 10},
+               CallSample{20, 60, 0, true, 10},
+               CallSample{1000, 0, 0, false, 0}};
+  return H;
+}
+
+TEST(CallSampler, MinBufferSize) {
+  // The sample that is never drawn still needs to fit.
+  EXPECT_EQ(CallSampler::getMinBufferSize(getCallHistogram()), 2048U);
+}
+
+TEST(CallSampler, MeanSize) {
+  CallSampler Sampler(getCallHistogram(), 2048);
+  EXPECT_EQ(Sampler.getMeanSize(), 60);
+}
+
+TEST(CallSampler, KeepsAlignmentsInBounds) {
+  const uint32_t BufferSize = 2048;
+  CallSampler Sampler(getCallHistogram(), BufferSize);
+  std::vector<CallParameters> Calls(1000);
+  Sampler.Randomize(Calls);
+  for (const auto &P : Calls) {
+    EXPECT_THAT(P.Size, AnyOf(100U, 20U));
+    EXPECT_THAT(P.SrcOffset + P.Size, Le(BufferSize));
+    EXPECT_THAT(P.DstOffset + P.Size, Le(BufferSize));
+    if (P.Size == 100) {
+      EXPECT_EQ(P.SrcOffset % CallSample::kAlignment, 3U);
+      EXPECT_EQ(P.DstOffset % CallSample::kAlignment, 17U);
+      EXPECT_FALSE(P.Overlap);
+    } else {
+      EXPECT_EQ(P.SrcOffset % CallSample::kAlignment, 60U);
+      EXPECT_EQ(P.DstOffset % CallSample::kAlignment, 0U);
+      // Overlapping buffers start in the same cache line.
+      EXPECT_TRUE(P.Overlap);
+      EXPECT_EQ(P.SrcOffset - 60, P.DstOffset);
+    }
+  }
+}
+
 } // namespace
 } // namespace libc_benchmarks
 } // namespace llvm
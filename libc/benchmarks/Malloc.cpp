@@ -0,0 +1,36 @@
+//===-- Benchmark the llvm-libc allocator ---------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "MallocBenchmark.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/malloc.h"
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+const AllocatorFunctions LlvmLibcAllocator = {__llvm_libc::malloc,
+                                              __llvm_libc::free};
+
+void BM_LlvmLibcProducerConsumer(benchmark::State &State) {
+  producerConsumer(State, LlvmLibcAllocator);
+}
+BENCHMARK(BM_LlvmLibcProducerConsumer)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->UseRealTime();
+
+void BM_LlvmLibcFragmentation(benchmark::State &State) {
+  fragmentation(State, LlvmLibcAllocator);
+}
+BENCHMARK(BM_LlvmLibcFragmentation)->Iterations(1 << 22);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
@@ -0,0 +1,146 @@
+//===-- Workloads of the malloc benchmarks ----------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The workloads are shared by the llvm-libc and the system libc benchmarks,
+// which live in different translation units to keep the llvm-libc and the
+// system `stdlib.h` headers apart.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_BENCHMARKS_MALLOC_BENCHMARK_H
+#define LLVM_LIBC_BENCHMARKS_MALLOC_BENCHMARK_H
+
+#include "benchmark/benchmark.h"
+#include <atomic>
+#include <fstream>
+#include <memory>
+#include <stddef.h>
+#include <stdint.h>
+#include <thread>
+#include <unistd.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+
+struct AllocatorFunctions {
+  void *(*Malloc)(size_t);
+  void (*Free)(void *);
+};
+
+// A deterministic xorshift generator, the workloads must be the same for all
+// allocators.
+class Xorshift {
+  uint64_t State;
+
+public:
+  explicit Xorshift(uint64_t Seed) : State(Seed) {}
+  uint64_t next() {
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return State;
+  }
+};
+
+// Objects are allocated by the benchmark thread and freed by a consumer
+// thread, as in a pipeline. Memory freed by the consumer has to flow back to
+// the producer through the allocator.
+inline void producerConsumer(benchmark::State &State,
+                             const AllocatorFunctions &Allocator) {
+  const size_t Size = State.range(0);
+  constexpr size_t kRingSize = 1024;
+  std::unique_ptr<std::atomic<void *>[]> Ring(
+      new std::atomic<void *>[kRingSize]);
+  for (size_t I = 0; I < kRingSize; ++I)
+    Ring[I].store(nullptr, std::memory_order_relaxed);
+  std::atomic<bool> Done(false);
+
+  std::thread Consumer([&] {
+    size_t Index = 0;
+    for (;;) {
+      void *Ptr = Ring[Index].exchange(nullptr, std::memory_order_acquire);
+      if (Ptr == nullptr) {
+        if (Done.load(std::memory_order_acquire) &&
+            Ring[Index].load(std::memory_order_acquire) == nullptr)
+          return;
+        std::this_thread::yield();
+        continue;
+      }
+      Allocator.Free(Ptr);
+      Index = (Index + 1) % kRingSize;
+    }
+  });
+
+  size_t Index = 0;
+  for (auto _ : State) {
+    void *Ptr = Allocator.Malloc(Size);
+    benchmark::DoNotOptimize(Ptr);
+    // Wait for the consumer when the ring is full.
+    while (Ring[Index].load(std::memory_order_relaxed) != nullptr)
+      std::this_thread::yield();
+    Ring[Index].store(Ptr, std::memory_order_release);
+    Index = (Index + 1) % kRingSize;
+  }
+  Done.store(true, std::memory_order_release);
+  Consumer.join();
+  State.SetItemsProcessed(State.iterations());
+}
+
+inline size_t residentBytes() {
+  size_t Pages = 0, Resident = 0;
+  std::ifstream("/proc/self/statm") >> Pages >> Resident;
+  return Resident * sysconf(_SC_PAGESIZE);
+}
+
+// A long running workload: a fixed number of live objects is constantly
+// replaced by objects of random sizes. The size distribution changes from one
+// phase to the next so that memory freed in one phase has to be reused for
+// different sizes in the next one. Reports the resident memory growth against
+// the bytes actually live at the end.
+inline void fragmentation(benchmark::State &State,
+                          const AllocatorFunctions &Allocator) {
+  constexpr size_t kLiveObjects = 1 << 14;
+  constexpr size_t kPhaseLength = 1 << 16;
+  constexpr size_t kMaxSizeLog2[] = {6, 10, 8, 14, 7, 12};
+  constexpr size_t kNumPhases = sizeof(kMaxSizeLog2) / sizeof(size_t);
+  std::unique_ptr<void *[]> Objects(new void *[kLiveObjects]());
+  std::unique_ptr<size_t[]> Sizes(new size_t[kLiveObjects]());
+  Xorshift Random(0x9E3779B97F4A7C15ULL);
+  const size_t ResidentBefore = residentBytes();
+
+  size_t Step = 0;
+  for (auto _ : State) {
+    const size_t Phase = (Step++ / kPhaseLength) % kNumPhases;
+    const uint64_t Draw = Random.next();
+    const size_t Slot = Draw % kLiveObjects;
+    // Sizes are log-uniform so that small objects dominate.
+    const size_t SizeLog2 = (Draw >> 32) % (kMaxSizeLog2[Phase] + 1);
+    const size_t Size = (size_t(1) << SizeLog2) + (Draw >> 48) % 16;
+    Allocator.Free(Objects[Slot]);
+    Objects[Slot] = Allocator.Malloc(Size);
+    // Touch the object like a real program would.
+    static_cast<char *>(Objects[Slot])[0] = 1;
+    Sizes[Slot] = Size;
+  }
+
+  size_t LiveBytes = 0;
+  for (size_t I = 0; I < kLiveObjects; ++I)
+    LiveBytes += Sizes[I];
+  const size_t ResidentAfter = residentBytes();
+  for (size_t I = 0; I < kLiveObjects; ++I)
+    Allocator.Free(Objects[I]);
+  State.SetItemsProcessed(State.iterations());
+  State.counters["live_bytes"] = LiveBytes;
+  State.counters["resident_growth"] =
+      ResidentAfter > ResidentBefore ? ResidentAfter - ResidentBefore : 0;
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
+
+#endif // LLVM_LIBC_BENCHMARKS_MALLOC_BENCHMARK_H
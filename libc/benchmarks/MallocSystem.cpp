@@ -0,0 +1,42 @@
+//===-- Benchmark the system libc allocator -------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The reference for the llvm-libc allocator benchmarks in Malloc.cpp, both are
+// linked in the same executable.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MallocBenchmark.h"
+
+#include <stdlib.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+const AllocatorFunctions SystemAllocator = {::malloc, ::free};
+
+void BM_SystemProducerConsumer(benchmark::State &State) {
+  producerConsumer(State, SystemAllocator);
+}
+BENCHMARK(BM_SystemProducerConsumer)
+    ->Arg(16)
+    ->Arg(256)
+    ->Arg(4096)
+    ->UseRealTime();
+
+void BM_SystemFragmentation(benchmark::State &State) {
+  fragmentation(State, SystemAllocator);
+}
+BENCHMARK(BM_SystemFragmentation)->Iterations(1 << 22);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
+
+BENCHMARK_MAIN();
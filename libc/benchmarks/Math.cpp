@@ -0,0 +1,89 @@
+//===-- Benchmark the llvm-libc math functions ----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "MathBenchmark.h"
+#include "src/math/cosf.h"
+#include "src/math/exp2f.h"
+#include "src/math/expf.h"
+#include "src/math/log2f.h"
+#include "src/math/logf.h"
+#include "src/math/powf.h"
+#include "src/math/sinf.h"
+#include "src/math/tanf.h"
+#if defined(__x86_64__)
+#include "src/math/x86/vector_math.h"
+#endif
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+#define UNARY_BENCHMARK(Name, Range)                                          \
+  void BM_LlvmLibc_##Name(benchmark::State &State) {                          \
+    unaryThroughput(State, Range, __llvm_libc::Name);                         \
+  }                                                                           \
+  BENCHMARK(BM_LlvmLibc_##Name);
+
+UNARY_BENCHMARK(expf, kExpRange)
+UNARY_BENCHMARK(exp2f, kExpRange)
+UNARY_BENCHMARK(logf, kLogRange)
+UNARY_BENCHMARK(log2f, kLogRange)
+UNARY_BENCHMARK(sinf, kTrigRange)
+UNARY_BENCHMARK(cosf, kTrigRange)
+UNARY_BENCHMARK(tanf, kTrigRange)
+#undef UNARY_BENCHMARK
+
+void BM_LlvmLibc_powf(benchmark::State &State) {
+  binaryThroughput(State, kPowRange, __llvm_libc::powf);
+}
+BENCHMARK(BM_LlvmLibc_powf);
+
+#if defined(__x86_64__)
+using __llvm_libc::VectorFloat4;
+using __llvm_libc::VectorFloat8;
+
+bool hasSse4() { return __builtin_cpu_supports("sse4.1"); }
+bool hasAvx2() {
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+
+// Every benchmark is compiled for the instruction set of the function it
+// calls and is skipped when the CPU does not support it.
+#define VECTOR_BENCHMARK(Name, Kind, Vector, Target, Check, Range)            \
+  __attribute__((target(Target))) void BM_LlvmLibc_##Name(                    \
+      benchmark::State &State) {                                              \
+    if (!Check()) {                                                           \
+      State.SkipWithError("not supported by the CPU");                        \
+      return;                                                                 \
+    }                                                                         \
+    Kind<Vector>(State, Range, __llvm_libc::Name);                            \
+  }                                                                           \
+  BENCHMARK(BM_LlvmLibc_##Name);
+
+VECTOR_BENCHMARK(_ZGVbN4v_logf, vectorUnaryThroughput, VectorFloat4, "sse4.1",
+                 hasSse4, kLogRange)
+VECTOR_BENCHMARK(_ZGVbN4v_log2f, vectorUnaryThroughput, VectorFloat4, "sse4.1",
+                 hasSse4, kLogRange)
+VECTOR_BENCHMARK(_ZGVbN4v_tanf, vectorUnaryThroughput, VectorFloat4, "sse4.1",
+                 hasSse4, kTrigRange)
+VECTOR_BENCHMARK(_ZGVbN4vv_powf, vectorBinaryThroughput, VectorFloat4,
+                 "sse4.1", hasSse4, kPowRange)
+VECTOR_BENCHMARK(_ZGVdN8v_logf, vectorUnaryThroughput, VectorFloat8,
+                 "avx2,fma", hasAvx2, kLogRange)
+VECTOR_BENCHMARK(_ZGVdN8v_log2f, vectorUnaryThroughput, VectorFloat8,
+                 "avx2,fma", hasAvx2, kLogRange)
+VECTOR_BENCHMARK(_ZGVdN8v_tanf, vectorUnaryThroughput, VectorFloat8,
+                 "avx2,fma", hasAvx2, kTrigRange)
+VECTOR_BENCHMARK(_ZGVdN8vv_powf, vectorBinaryThroughput, VectorFloat8,
+                 "avx2,fma", hasAvx2, kPowRange)
+#undef VECTOR_BENCHMARK
+#endif
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
@@ -0,0 +1,137 @@
+//===-- Workloads of the math benchmarks ------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The workloads are shared by the llvm-libc and the system libc benchmarks,
+// which live in different translation units to keep the llvm-libc and the
+// system `math.h` headers apart.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_BENCHMARKS_MATH_BENCHMARK_H
+#define LLVM_LIBC_BENCHMARKS_MATH_BENCHMARK_H
+
+#include "benchmark/benchmark.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// The inputs fit in the L1 cache so that the benchmarks measure the functions
+// and not the memory subsystem.
+constexpr size_t kMathInputs = 4096;
+
+// The range of the inputs of a function, the exponents of `powf` are in
+// [-YRange, YRange].
+struct MathInputRange {
+  float Low;
+  float High;
+  float YRange;
+};
+
+constexpr MathInputRange kExpRange = {-80.0f, 80.0f, 0};
+constexpr MathInputRange kLogRange = {0x1p-20f, 0x1p20f, 0};
+constexpr MathInputRange kTrigRange = {-100.0f, 100.0f, 0};
+constexpr MathInputRange kPowRange = {0.01f, 100.0f, 16.0f};
+
+// Fills `X` and `Y` with deterministic inputs in `Range`. The inputs are
+// spread randomly so that the branches of the functions are not predictable
+// from one call to the next.
+inline void fillMathInputs(const MathInputRange &Range, float *X, float *Y) {
+  uint64_t State = 0x9E3779B97F4A7C15ULL;
+  for (size_t I = 0; I < kMathInputs; ++I) {
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    const float Unit = static_cast<float>(State >> 40) * 0x1p-24f;
+    X[I] = Range.Low + (Range.High - Range.Low) * Unit;
+    const float Unit2 = static_cast<float>(State & 0xFFFFFF) * 0x1p-24f;
+    Y[I] = Range.YRange * (2.0f * Unit2 - 1.0f);
+  }
+}
+
+// Measures the throughput of a unary function: the calls are independent so
+// that the processor can overlap them.
+template <typename Function>
+void unaryThroughput(benchmark::State &State, const MathInputRange &Range,
+                     Function Fn) {
+  alignas(64) float X[kMathInputs], Y[kMathInputs], Result[kMathInputs];
+  fillMathInputs(Range, X, Y);
+  for (auto _ : State) {
+    for (size_t I = 0; I < kMathInputs; ++I)
+      Result[I] = Fn(X[I]);
+    benchmark::DoNotOptimize(Result);
+    benchmark::ClobberMemory();
+  }
+  State.SetItemsProcessed(State.iterations() * kMathInputs);
+}
+
+template <typename Function>
+void binaryThroughput(benchmark::State &State, const MathInputRange &Range,
+                      Function Fn) {
+  alignas(64) float X[kMathInputs], Y[kMathInputs], Result[kMathInputs];
+  fillMathInputs(Range, X, Y);
+  for (auto _ : State) {
+    for (size_t I = 0; I < kMathInputs; ++I)
+      Result[I] = Fn(X[I], Y[I]);
+    benchmark::DoNotOptimize(Result);
+    benchmark::ClobberMemory();
+  }
+  State.SetItemsProcessed(State.iterations() * kMathInputs);
+}
+
+// The same for the vector variants, `Vector` is a vector of floats. Items
+// are floats, not vectors, to compare with the scalar functions. The vector
+// benchmarks are compiled for the instruction set of the functions they call,
+// these helpers are inlined in them so that vectors are passed in registers.
+template <typename Vector, typename Function>
+__attribute__((always_inline)) inline void
+vectorUnaryThroughput(benchmark::State &State, const MathInputRange &Range,
+                      Function Fn) {
+  constexpr size_t kLanes = sizeof(Vector) / sizeof(float);
+  alignas(64) float X[kMathInputs], Y[kMathInputs], Result[kMathInputs];
+  fillMathInputs(Range, X, Y);
+  for (auto _ : State) {
+    for (size_t I = 0; I < kMathInputs; I += kLanes) {
+      Vector V;
+      memcpy(&V, X + I, sizeof(Vector));
+      V = Fn(V);
+      memcpy(Result + I, &V, sizeof(Vector));
+    }
+    benchmark::DoNotOptimize(Result);
+    benchmark::ClobberMemory();
+  }
+  State.SetItemsProcessed(State.iterations() * kMathInputs);
+}
+
+template <typename Vector, typename Function>
+__attribute__((always_inline)) inline void
+vectorBinaryThroughput(benchmark::State &State, const MathInputRange &Range,
+                       Function Fn) {
+  constexpr size_t kLanes = sizeof(Vector) / sizeof(float);
+  alignas(64) float X[kMathInputs], Y[kMathInputs], Result[kMathInputs];
+  fillMathInputs(Range, X, Y);
+  for (auto _ : State) {
+    for (size_t I = 0; I < kMathInputs; I += kLanes) {
+      Vector V, W;
+      memcpy(&V, X + I, sizeof(Vector));
+      memcpy(&W, Y + I, sizeof(Vector));
+      V = Fn(V, W);
+      memcpy(Result + I, &V, sizeof(Vector));
+    }
+    benchmark::DoNotOptimize(Result);
+    benchmark::ClobberMemory();
+  }
+  State.SetItemsProcessed(State.iterations() * kMathInputs);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
+
+#endif // LLVM_LIBC_BENCHMARKS_MATH_BENCHMARK_H
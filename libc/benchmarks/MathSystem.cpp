@@ -0,0 +1,46 @@
+//===-- Benchmark the system libc math functions --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The reference for the llvm-libc math benchmarks in Math.cpp, both are
+// linked in the same executable.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MathBenchmark.h"
+
+#include <math.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+#define UNARY_BENCHMARK(Name, Range)                                          \
+  void BM_System_##Name(benchmark::State &State) {                            \
+    unaryThroughput(State, Range, ::Name);                                    \
+  }                                                                           \
+  BENCHMARK(BM_System_##Name);
+
+UNARY_BENCHMARK(expf, kExpRange)
+UNARY_BENCHMARK(exp2f, kExpRange)
+UNARY_BENCHMARK(logf, kLogRange)
+UNARY_BENCHMARK(log2f, kLogRange)
+UNARY_BENCHMARK(sinf, kTrigRange)
+UNARY_BENCHMARK(cosf, kTrigRange)
+UNARY_BENCHMARK(tanf, kTrigRange)
+#undef UNARY_BENCHMARK
+
+void BM_System_powf(benchmark::State &State) {
+  binaryThroughput(State, kPowRange, ::powf);
+}
+BENCHMARK(BM_System_powf);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
+
+BENCHMARK_MAIN();
@@ -0,0 +1,72 @@
+//===-- Benchmark memchr implementation -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibcBenchmark.h"
+#include "LibcMemoryBenchmark.h"
+#include "LibcMemoryBenchmarkMain.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace __llvm_libc {
+void *memchr(const void *, int, size_t);
+void *memrchr(const void *, int, size_t);
+} // namespace __llvm_libc
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// The context encapsulates the buffers, parameters and the measure.
+// The searched character is not part of the buffer so all `Size` bytes have to
+// be scanned.
+struct MemchrContext : public BenchmarkRunner {
+  using FunctionPrototype = void *(*)(const void *, int, size_t);
+
+  struct ParameterType {
+    uint16_t Offset = 0;
+  };
+
+  explicit MemchrContext(const StudyConfiguration &Conf)
+      : OD(Conf), Buffer(Conf.BufferSize), PP(*this) {
+    ::memset(Buffer.begin(), 'a', Conf.BufferSize);
+  }
+
+  // Needed by the ParameterProvider to update the current batch of parameter.
+  void Randomize(MutableArrayRef<ParameterType> Parameters) {
+    for (auto &P : Parameters)
+      P.Offset = OD(Gen);
+  }
+
+  ArrayRef<StringRef> getFunctionNames() const override {
+    static std::array<StringRef, 2> kFunctionNames = {"memchr", "memrchr"};
+    return kFunctionNames;
+  }
+
+  BenchmarkResult benchmark(const BenchmarkOptions &Options,
+                            StringRef FunctionName, size_t Size) override {
+    FunctionPrototype Function = StringSwitch<FunctionPrototype>(FunctionName)
+                                     .Case("memchr", &__llvm_libc::memchr)
+                                     .Case("memrchr", &__llvm_libc::memrchr);
+    return llvm::libc_benchmarks::benchmark(
+        Options, PP, [this, Function, Size](ParameterType p) {
+          return Function(Buffer + p.Offset, 'b', Size);
+        });
+  }
+
+private:
+  std::default_random_engine Gen;
+  OffsetDistribution OD;
+  AlignedBuffer Buffer;
+  SmallParameterProvider<MemchrContext> PP;
+};
+
+std::unique_ptr<BenchmarkRunner> getRunner(const StudyConfiguration &Conf) {
+  return std::make_unique<MemchrContext>(Conf);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
@@ -11,6 +11,14 @@
 #include "LibcMemoryBenchmarkMain.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/raw_ostream.h"
+#include <algorithm>
+#include <cstring>
+#include <strings.h>
+
+namespace __llvm_libc {
+int memcmp(const void *, const void *, size_t);
+int bcmp(const void *, const void *, size_t);
+} // namespace __llvm_libc
 
 namespace llvm {
 namespace libc_benchmarks {
@@ -26,6 +34,14 @@ struct MemcmpContext : public BenchmarkRunner {
   explicit MemcmpContext(const StudyConfiguration &Conf)
       : MOD(Conf), OD(Conf), ABuffer(Conf.BufferSize), BBuffer(Conf.BufferSize),
         PP(*this) {
+    // Replayed calls compare buffers at different offsets, they only compare
+    // equal if all the bytes are the same. The histogram does not record where
+    // the first difference was, the whole buffers are compared.
+    if (!Conf.Distribution.empty()) {
+      std::fill(ABuffer.begin(), ABuffer.end(), 0);
+      std::fill(BBuffer.begin(), BBuffer.end(), 0);
+      return;
+    }
     std::uniform_int_distribution<char> Dis;
     // Generate random buffer A.
     for (size_t I = 0; I < Conf.BufferSize; ++I)
@@ -53,23 +69,41 @@ struct MemcmpContext : public BenchmarkRunner {
   }
 
   ArrayRef<StringRef> getFunctionNames() const override {
-    static std::array<StringRef, 1> kFunctionNames = {"memcmp"};
+    static std::array<StringRef, 4> kFunctionNames = {
+        "memcmp", "bcmp", "system_memcmp", "system_bcmp"};
     return kFunctionNames;
   }
 
   BenchmarkResult benchmark(const BenchmarkOptions &Options,
                             StringRef FunctionName, size_t Size) override {
     CurrentSize = Size;
-    // FIXME: Add `bcmp` once we're guaranteed that the function is provided.
-    FunctionPrototype Function =
-        StringSwitch<FunctionPrototype>(FunctionName).Case("memcmp", &::memcmp);
+    FunctionPrototype Function = getFunction(FunctionName);
     return llvm::libc_benchmarks::benchmark(
         Options, PP, [this, Function, Size](ParameterType p) {
           return Function(ABuffer + p.Offset, BBuffer + p.Offset, Size);
         });
   }
 
+  // The buffers never overlap, `Overlap` is ignored.
+  BenchmarkResult replay(const BenchmarkOptions &Options,
+                         StringRef FunctionName,
+                         CallParameterProvider &Calls) override {
+    FunctionPrototype Function = getFunction(FunctionName);
+    return llvm::libc_benchmarks::benchmark(
+        Options, Calls, [this, Function](CallParameters p) {
+          return Function(ABuffer + p.DstOffset, BBuffer + p.SrcOffset, p.Size);
+        });
+  }
+
 private:
+  static FunctionPrototype getFunction(StringRef FunctionName) {
+    return StringSwitch<FunctionPrototype>(FunctionName)
+        .Case("memcmp", &__llvm_libc::memcmp)
+        .Case("bcmp", &__llvm_libc::bcmp)
+        .Case("system_memcmp", &::memcmp)
+        .Case("system_bcmp", &::bcmp);
+  }
+
   std::default_random_engine Gen;
   MismatchOffsetDistribution MOD;
   OffsetDistribution OD;
@@ -11,6 +11,7 @@
 #include "LibcMemoryBenchmarkMain.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cstring>
 #include <memory>
 
 namespace __llvm_libc {
@@ -42,14 +43,14 @@ struct MemcpyContext : public BenchmarkRunner {
   }
 
   ArrayRef<StringRef> getFunctionNames() const override {
-    static std::array<StringRef, 1> kFunctionNames = {"memcpy"};
+    static std::array<StringRef, 2> kFunctionNames = {"memcpy",
+                                                      "system_memcpy"};
     return kFunctionNames;
   }
 
   BenchmarkResult benchmark(const BenchmarkOptions &Options,
                             StringRef FunctionName, size_t Size) override {
-    FunctionPrototype Function =
-        StringSwitch<FunctionPrototype>(FunctionName).Case("memcpy", &::memcpy);
+    FunctionPrototype Function = getFunction(FunctionName);
     return llvm::libc_benchmarks::benchmark(
         Options, PP, [this, Function, Size](ParameterType p) {
           Function(DstBuffer + p.DstOffset, SrcBuffer + p.SrcOffset, Size);
@@ -57,7 +58,27 @@ struct MemcpyContext : public BenchmarkRunner {
         });
   }
 
+  BenchmarkResult replay(const BenchmarkOptions &Options,
+                         StringRef FunctionName,
+                         CallParameterProvider &Calls) override {
+    FunctionPrototype Function = getFunction(FunctionName);
+    return llvm::libc_benchmarks::benchmark(
+        Options, Calls, [this, Function](CallParameters p) {
+          // Overlapping copies stay within the source buffer, the copied bytes
+          // do not matter.
+          char *Dst = (p.Overlap ? SrcBuffer : DstBuffer) + p.DstOffset;
+          Function(Dst, SrcBuffer + p.SrcOffset, p.Size);
+          return Dst;
+        });
+  }
+
 private:
+  static FunctionPrototype getFunction(StringRef FunctionName) {
+    return StringSwitch<FunctionPrototype>(FunctionName)
+        .Case("memcpy", &__llvm_libc::memcpy)
+        .Case("system_memcpy", &::memcpy);
+  }
+
   std::default_random_engine Gen;
   OffsetDistribution OD;
   AlignedBuffer SrcBuffer;
@@ -0,0 +1,253 @@
+//===-- Records the memory function calls of an application ---------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// This library is preloaded into an application to record the sizes and the
+// alignments of its calls to memcpy, memset, memcmp and bcmp:
+//
+//   LD_PRELOAD=libc-memory-sampler.so MEMORY_SAMPLER_OUTPUT=/tmp/app ./app
+//
+// On average one call in MEMORY_SAMPLER_PERIOD (100 by default) is recorded.
+// When the application exits, the histograms are written as json files named
+// `/tmp/app.memcpy.json`, `/tmp/app.memset.json` and `/tmp/app.memcmp.json`,
+// bcmp calls are recorded with memcmp calls. The memory benchmarks replay them
+// with `--distribution`, see `CallHistogram` in LibcMemoryBenchmark.h.
+//
+// The library only depends on the C library, it must not use memory functions
+// in its own hooks.
+
+#include <atomic>
+#include <dlfcn.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+namespace {
+
+enum Function : uint64_t { F_Memcpy, F_Memset, F_Memcmp, F_NumFunctions };
+
+const char *const kFunctionNames[F_NumFunctions] = {"memcpy", "memset",
+                                                    "memcmp"};
+
+using MemcpyFunction = void *(*)(void *, const void *, size_t);
+using MemsetFunction = void *(*)(void *, int, size_t);
+using MemcmpFunction = int (*)(const void *, const void *, size_t);
+
+// The functions of the C library, resolved when the library is loaded. Calls
+// made before, by dlsym for instance, use byte loops.
+MemcpyFunction RealMemcpy;
+MemsetFunction RealMemset;
+MemcmpFunction RealMemcmp;
+MemcmpFunction RealBcmp;
+
+// Same as `CallSample::kAlignment`.
+constexpr uint64_t kAlignment = 64;
+
+// Sizes up to `kExactSizeLimit` are recorded exactly, larger sizes keep their
+// `kSignificantBits` most significant bits. This bounds the number of buckets
+// and the error on the size of large calls stays below 4%.
+constexpr uint64_t kExactSizeLimit = 1024;
+constexpr unsigned kSignificantBits = 6;
+
+// The histogram is an open addressing hash table. A key packs the parameters
+// of a call, from the most significant bits: a bit set in all used buckets,
+// the function (2 bits), the overlap (1 bit), the source and destination
+// alignments (6 bits each) and the size (32 bits).
+constexpr size_t kNumBucketsLog2 = 16;
+constexpr size_t kNumBuckets = size_t(1) << kNumBucketsLog2;
+constexpr size_t kMaxProbes = 64;
+
+struct Bucket {
+  std::atomic<uint64_t> Key;
+  std::atomic<uint64_t> Count;
+};
+
+Bucket Buckets[kNumBuckets];
+std::atomic<uint64_t> DroppedCalls;
+
+std::atomic<bool> Enabled;
+uint32_t Period = 100;
+
+// Calls to skip before recording the next one and the state of the random
+// generator choosing this number. The initial-exec model keeps the accesses
+// free of calls.
+__thread uint32_t Countdown __attribute__((tls_model("initial-exec")));
+__thread uint32_t RandomState __attribute__((tls_model("initial-exec")));
+
+// Skips a random number of calls, in [0, 2 * Period), so that the samples do
+// not follow the period of a loop in the application.
+bool shouldRecord() {
+  if (!Enabled.load(std::memory_order_relaxed))
+    return false;
+  if (Countdown > 0) {
+    --Countdown;
+    return false;
+  }
+  uint32_t X = RandomState;
+  if (X == 0)
+    X = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&X)) | 1;
+  // xorshift32
+  X ^= X << 13;
+  X ^= X >> 17;
+  X ^= X << 5;
+  RandomState = X;
+  Countdown = X % (2 * Period);
+  return true;
+}
+
+uint64_t roundSize(uint64_t Size) {
+  if (Size > UINT32_MAX)
+    return UINT32_MAX;
+  if (Size <= kExactSizeLimit)
+    return Size;
+  const unsigned Shift = 64 - __builtin_clzll(Size) - kSignificantBits;
+  return (Size >> Shift) << Shift;
+}
+
+bool overlaps(const void *A, const void *B, size_t Size) {
+  const uintptr_t X = reinterpret_cast<uintptr_t>(A);
+  const uintptr_t Y = reinterpret_cast<uintptr_t>(B);
+  return X < Y + Size && Y < X + Size;
+}
+
+void record(Function F, size_t Size, const void *Src, const void *Dst,
+            bool Overlap) {
+  const uint64_t SrcAlignment = reinterpret_cast<uintptr_t>(Src) % kAlignment;
+  const uint64_t DstAlignment = reinterpret_cast<uintptr_t>(Dst) % kAlignment;
+  const uint64_t Key = (uint64_t(1) << 63) | (uint64_t(F) << 45) |
+                       (uint64_t(Overlap) << 44) | (SrcAlignment << 38) |
+                       (DstAlignment << 32) | roundSize(Size);
+  size_t Index = (Key * 0x9E3779B97F4A7C15ULL) >> (64 - kNumBucketsLog2);
+  for (size_t Probe = 0; Probe < kMaxProbes; ++Probe) {
+    Bucket &B = Buckets[Index];
+    uint64_t Current = B.Key.load(std::memory_order_relaxed);
+    if (Current == 0 &&
+        B.Key.compare_exchange_strong(Current, Key, std::memory_order_relaxed))
+      Current = Key;
+    if (Current == Key) {
+      B.Count.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+    Index = (Index + 1) % kNumBuckets;
+  }
+  DroppedCalls.fetch_add(1, std::memory_order_relaxed);
+}
+
+__attribute__((constructor)) void initialize() {
+  RealMemcpy = reinterpret_cast<MemcpyFunction>(dlsym(RTLD_NEXT, "memcpy"));
+  RealMemset = reinterpret_cast<MemsetFunction>(dlsym(RTLD_NEXT, "memset"));
+  RealMemcmp = reinterpret_cast<MemcmpFunction>(dlsym(RTLD_NEXT, "memcmp"));
+  RealBcmp = reinterpret_cast<MemcmpFunction>(dlsym(RTLD_NEXT, "bcmp"));
+  if (const char *Value = getenv("MEMORY_SAMPLER_PERIOD"))
+    Period = strtoul(Value, nullptr, 10);
+  if (Period == 0)
+    Period = 1;
+  Enabled.store(true, std::memory_order_relaxed);
+}
+
+void writeHistogram(Function F, const char *Prefix) {
+  char Path[4096];
+  snprintf(Path, sizeof(Path), "%s.%s.json", Prefix, kFunctionNames[F]);
+  FILE *File = nullptr;
+  const char *Separator = "";
+  for (const Bucket &B : Buckets) {
+    const uint64_t Key = B.Key.load(std::memory_order_relaxed);
+    if (Key == 0 || ((Key >> 45) & 3) != F)
+      continue;
+    if (File == nullptr) {
+      File = fopen(Path, "w");
+      if (File == nullptr) {
+        fprintf(stderr, "memory sampler: cannot write %s\n", Path);
+        return;
+      }
+      fprintf(File, "{\n  \"Function\": \"%s\",\n  \"Samples\": [",
+              kFunctionNames[F]);
+    }
+    fprintf(File,
+            "%s\n    {\"Size\": %llu, \"SrcAlignment\": %llu, "
+            "\"DstAlignment\": %llu, \"Overlap\": %s, \"Count\": %llu}",
+            Separator, static_cast<unsigned long long>(Key & UINT32_MAX),
+            static_cast<unsigned long long>((Key >> 38) % kAlignment),
+            static_cast<unsigned long long>((Key >> 32) % kAlignment),
+            (Key >> 44) & 1 ? "true" : "false",
+            static_cast<unsigned long long>(
+                B.Count.load(std::memory_order_relaxed)));
+    Separator = ",";
+  }
+  if (File == nullptr)
+    return;
+  fprintf(File, "\n  ]\n}\n");
+  fclose(File);
+}
+
+__attribute__((destructor)) void finalize() {
+  // Writing the files calls the hooked functions.
+  Enabled.store(false, std::memory_order_relaxed);
+  char DefaultPrefix[64];
+  const char *Prefix = getenv("MEMORY_SAMPLER_OUTPUT");
+  if (Prefix == nullptr) {
+    snprintf(DefaultPrefix, sizeof(DefaultPrefix), "/tmp/memory-sampler.%d",
+             static_cast<int>(getpid()));
+    Prefix = DefaultPrefix;
+  }
+  for (uint64_t F = 0; F < F_NumFunctions; ++F)
+    writeHistogram(static_cast<Function>(F), Prefix);
+  if (const uint64_t Dropped = DroppedCalls.load(std::memory_order_relaxed))
+    fprintf(stderr,
+            "memory sampler: %llu calls dropped, the histogram is full\n",
+            static_cast<unsigned long long>(Dropped));
+}
+
+} // namespace
+
+// The byte loops use volatile accesses so that the compiler does not turn
+// them back into calls to the hooks.
+extern "C" void *memcpy(void *Dst, const void *Src, size_t Size) {
+  if (shouldRecord())
+    record(F_Memcpy, Size, Src, Dst, overlaps(Src, Dst, Size));
+  if (RealMemcpy)
+    return RealMemcpy(Dst, Src, Size);
+  volatile char *D = static_cast<char *>(Dst);
+  const volatile char *S = static_cast<const char *>(Src);
+  for (size_t I = 0; I < Size; ++I)
+    D[I] = S[I];
+  return Dst;
+}
+
+extern "C" void *memset(void *Dst, int Value, size_t Size) {
+  if (shouldRecord())
+    record(F_Memset, Size, Dst, Dst, false);
+  if (RealMemset)
+    return RealMemset(Dst, Value, Size);
+  volatile char *D = static_cast<char *>(Dst);
+  for (size_t I = 0; I < Size; ++I)
+    D[I] = static_cast<char>(Value);
+  return Dst;
+}
+
+static int compareBytes(const void *A, const void *B, size_t Size) {
+  const volatile unsigned char *X = static_cast<const unsigned char *>(A);
+  const volatile unsigned char *Y = static_cast<const unsigned char *>(B);
+  for (size_t I = 0; I < Size; ++I)
+    if (X[I] != Y[I])
+      return X[I] - Y[I];
+  return 0;
+}
+
+extern "C" int memcmp(const void *A, const void *B, size_t Size) {
+  if (shouldRecord())
+    record(F_Memcmp, Size, B, A, overlaps(A, B, Size));
+  return RealMemcmp ? RealMemcmp(A, B, Size) : compareBytes(A, B, Size);
+}
+
+extern "C" int bcmp(const void *A, const void *B, size_t Size) {
+  if (shouldRecord())
+    record(F_Memcmp, Size, B, A, overlaps(A, B, Size));
+  return RealBcmp ? RealBcmp(A, B, Size) : compareBytes(A, B, Size);
+}
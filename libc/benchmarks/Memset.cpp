@@ -11,6 +11,7 @@
 #include "LibcMemoryBenchmarkMain.h"
 #include "llvm/ADT/StringSwitch.h"
 #include "llvm/Support/raw_ostream.h"
+#include <cstring>
 
 namespace __llvm_libc {
 void *memset(void *, int, size_t);
@@ -39,14 +40,14 @@ struct MemsetContext : public BenchmarkRunner {
   }
 
   ArrayRef<StringRef> getFunctionNames() const override {
-    static std::array<StringRef, 1> kFunctionNames = {"memset"};
+    static std::array<StringRef, 2> kFunctionNames = {"memset",
+                                                      "system_memset"};
     return kFunctionNames;
   }
 
   BenchmarkResult benchmark(const BenchmarkOptions &Options,
                             StringRef FunctionName, size_t Size) override {
-    FunctionPrototype Function = StringSwitch<FunctionPrototype>(FunctionName)
-                                     .Case("memset", &__llvm_libc::memset);
+    FunctionPrototype Function = getFunction(FunctionName);
     return llvm::libc_benchmarks::benchmark(
         Options, PP, [this, Function, Size](ParameterType p) {
           Function(DstBuffer + p.DstOffset, MemsetValue, Size);
@@ -54,7 +55,24 @@ struct MemsetContext : public BenchmarkRunner {
         });
   }
 
+  BenchmarkResult replay(const BenchmarkOptions &Options,
+                         StringRef FunctionName,
+                         CallParameterProvider &Calls) override {
+    FunctionPrototype Function = getFunction(FunctionName);
+    return llvm::libc_benchmarks::benchmark(
+        Options, Calls, [this, Function](CallParameters p) {
+          Function(DstBuffer + p.DstOffset, MemsetValue, p.Size);
+          return DstBuffer + p.DstOffset;
+        });
+  }
+
 private:
+  static FunctionPrototype getFunction(StringRef FunctionName) {
+    return StringSwitch<FunctionPrototype>(FunctionName)
+        .Case("memset", &__llvm_libc::memset)
+        .Case("system_memset", &::memset);
+  }
+
   std::default_random_engine Gen;
   OffsetDistribution OD;
   AlignedBuffer DstBuffer;
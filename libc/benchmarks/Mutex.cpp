@@ -0,0 +1,41 @@
+//===-- Benchmark llvm-libc mutexes under contention ----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "MutexBenchmark.h"
+#include "include/threads.h"
+#include "src/threads/mtx_init.h"
+#include "src/threads/mtx_lock.h"
+#include "src/threads/mtx_unlock.h"
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+struct LlvmLibcMutex {
+  mtx_t Mutex;
+  size_t Counter = 0;
+
+  LlvmLibcMutex() { __llvm_libc::mtx_init(&Mutex, mtx_plain); }
+};
+
+LlvmLibcMutex Shared;
+
+void BM_LlvmLibcMutex(benchmark::State &State) {
+  const size_t Length = State.range(0);
+  for (auto _ : State) {
+    __llvm_libc::mtx_lock(&Shared.Mutex);
+    criticalSection(Length, Shared.Counter);
+    __llvm_libc::mtx_unlock(&Shared.Mutex);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_LlvmLibcMutex)->Apply(mutexContention);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
@@ -0,0 +1,45 @@
+//===-- Common parameters of the mutex benchmarks ---------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The llvm-libc and the system libc benchmarks live in different translation
+// units as the llvm-libc `threads.h` and the system `pthread.h` headers define
+// conflicting `struct timespec` types.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_BENCHMARKS_MUTEX_BENCHMARK_H
+#define LLVM_LIBC_BENCHMARKS_MUTEX_BENCHMARK_H
+
+#include "benchmark/benchmark.h"
+#include <stddef.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// Each benchmark runs with 1 to 8 threads contending for a single mutex. The
+// argument is the length of the critical section, the number of dependent
+// increments done while holding the mutex.
+inline void mutexContention(benchmark::internal::Benchmark *Benchmark) {
+  for (int Length : {0, 64, 1024})
+    Benchmark->Arg(Length);
+  Benchmark->ThreadRange(1, 8)->UseRealTime();
+}
+
+// The work done while holding the mutex.
+inline void criticalSection(size_t Length, size_t &Counter) {
+  for (size_t I = 0; I < Length; ++I) {
+    ++Counter;
+    benchmark::ClobberMemory();
+  }
+  ++Counter;
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
+
+#endif // LLVM_LIBC_BENCHMARKS_MUTEX_BENCHMARK_H
@@ -0,0 +1,40 @@
+//===-- Benchmark system libc mutexes under contention --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The reference for the llvm-libc mutex benchmarks in Mutex.cpp, both are
+// linked in the same executable.
+//
+//===----------------------------------------------------------------------===//
+
+#include "MutexBenchmark.h"
+
+#include <pthread.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+pthread_mutex_t SharedMutex = PTHREAD_MUTEX_INITIALIZER;
+size_t SharedCounter = 0;
+
+void BM_SystemMutex(benchmark::State &State) {
+  const size_t Length = State.range(0);
+  for (auto _ : State) {
+    ::pthread_mutex_lock(&SharedMutex);
+    criticalSection(Length, SharedCounter);
+    ::pthread_mutex_unlock(&SharedMutex);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+BENCHMARK(BM_SystemMutex)->Apply(mutexContention);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
+
+BENCHMARK_MAIN();
@@ -0,0 +1,65 @@
+//===-- Benchmark llvm-libc stdio buffered writes -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "StdioBenchmark.h"
+#include "src/stdio/FILE.h"
+#include "src/stdio/fflush.h"
+#include "src/stdio/fputc.h"
+#include "src/stdio/fwrite.h"
+#include "src/stdio/setvbuf.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+// An llvm-libc stream writing to a file descriptor.
+struct FdFile : __llvm_libc::FILE {
+  int Fd;
+  char Buffer[kStdioBufferSize];
+
+  explicit FdFile(const char *Path) : Fd(::open(Path, O_WRONLY)) {
+    write = +[](__llvm_libc::FILE *File, const char *Ptr, size_t Size) {
+      const ssize_t Written = ::write(static_cast<FdFile *>(File)->Fd, Ptr,
+                                      Size);
+      return Written < 0 ? size_t(0) : size_t(Written);
+    };
+    __llvm_libc::setvbuf(this, Buffer, _IOFBF, sizeof(Buffer));
+  }
+
+  ~FdFile() {
+    __llvm_libc::fflush(this);
+    ::close(Fd);
+  }
+};
+
+void BM_LlvmLibcFWrite(benchmark::State &State) {
+  const size_t WriteSize = State.range(0);
+  const char Data[kStdioMaxWriteSize] = {};
+  FdFile File(kStdioDevice);
+  for (auto _ : State)
+    for (size_t I = 0; I < kStdioCallsPerIteration; ++I)
+      benchmark::DoNotOptimize(__llvm_libc::fwrite(Data, 1, WriteSize, &File));
+  setStdioCounters(State, WriteSize);
+}
+BENCHMARK(BM_LlvmLibcFWrite)->Apply(stdioWriteSizes);
+
+void BM_LlvmLibcFPutc(benchmark::State &State) {
+  FdFile File(kStdioDevice);
+  for (auto _ : State)
+    for (size_t I = 0; I < kStdioCallsPerIteration; ++I)
+      benchmark::DoNotOptimize(__llvm_libc::fputc('a', &File));
+  setStdioCounters(State, 1);
+}
+BENCHMARK(BM_LlvmLibcFPutc);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
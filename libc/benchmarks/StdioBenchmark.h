@@ -0,0 +1,46 @@
+//===-- Common parameters of the stdio benchmarks ---------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The llvm-libc and the system libc benchmarks live in different translation
+// units as their `stdio.h` headers define conflicting `FILE` types.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_BENCHMARKS_STDIO_BENCHMARK_H
+#define LLVM_LIBC_BENCHMARKS_STDIO_BENCHMARK_H
+
+#include "benchmark/benchmark.h"
+#include <stddef.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// Streams are fully buffered and backed by `/dev/null`.
+constexpr size_t kStdioBufferSize = 4096;
+constexpr const char *kStdioDevice = "/dev/null";
+
+// Number of calls per benchmark iteration.
+constexpr size_t kStdioCallsPerIteration = 1024;
+
+// The write sizes to benchmark for `fwrite`.
+constexpr size_t kStdioMaxWriteSize = 64;
+inline void stdioWriteSizes(benchmark::internal::Benchmark *Benchmark) {
+  for (size_t Size = 1; Size <= kStdioMaxWriteSize; Size *= 8)
+    Benchmark->Arg(Size);
+}
+
+inline void setStdioCounters(benchmark::State &State, size_t CallSize) {
+  State.SetItemsProcessed(State.iterations() * kStdioCallsPerIteration);
+  State.SetBytesProcessed(State.iterations() * kStdioCallsPerIteration *
+                          CallSize);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
+
+#endif // LLVM_LIBC_BENCHMARKS_STDIO_BENCHMARK_H
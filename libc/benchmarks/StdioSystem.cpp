@@ -0,0 +1,58 @@
+//===-- Benchmark system libc stdio buffered writes -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// The reference for the llvm-libc stdio benchmarks in Stdio.cpp, both are
+// linked in the same executable.
+//
+//===----------------------------------------------------------------------===//
+
+#include "StdioBenchmark.h"
+
+#include <stdio.h>
+
+namespace llvm {
+namespace libc_benchmarks {
+namespace {
+
+// Opens a system libc stream with the same buffering as the llvm-libc one.
+struct SystemFile {
+  char Buffer[kStdioBufferSize];
+  FILE *File;
+
+  SystemFile() : File(::fopen(kStdioDevice, "w")) {
+    ::setvbuf(File, Buffer, _IOFBF, sizeof(Buffer));
+  }
+
+  ~SystemFile() { ::fclose(File); }
+};
+
+void BM_SystemFWrite(benchmark::State &State) {
+  const size_t WriteSize = State.range(0);
+  const char Data[kStdioMaxWriteSize] = {};
+  SystemFile Stream;
+  for (auto _ : State)
+    for (size_t I = 0; I < kStdioCallsPerIteration; ++I)
+      benchmark::DoNotOptimize(::fwrite(Data, 1, WriteSize, Stream.File));
+  setStdioCounters(State, WriteSize);
+}
+BENCHMARK(BM_SystemFWrite)->Apply(stdioWriteSizes);
+
+void BM_SystemFPutc(benchmark::State &State) {
+  SystemFile Stream;
+  for (auto _ : State)
+    for (size_t I = 0; I < kStdioCallsPerIteration; ++I)
+      benchmark::DoNotOptimize(::fputc('a', Stream.File));
+  setStdioCounters(State, 1);
+}
+BENCHMARK(BM_SystemFPutc);
+
+} // namespace
+} // namespace libc_benchmarks
+} // namespace llvm
+
+BENCHMARK_MAIN();
@@ -0,0 +1,77 @@
+//===-- Benchmark strcmp implementation -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibcBenchmark.h"
+#include "LibcMemoryBenchmark.h"
+#include "LibcMemoryBenchmarkMain.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace __llvm_libc {
+int strcmp(const char *, const char *);
+} // namespace __llvm_libc
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// The context encapsulates the buffers, parameters and the measure.
+// Both strings are equal and `Size` bytes long, this is the worst case as all
+// bytes have to be compared.
+struct StrcmpContext : public BenchmarkRunner {
+  using FunctionPrototype = int (*)(const char *, const char *);
+
+  struct ParameterType {
+    uint16_t Offset = 0;
+  };
+
+  explicit StrcmpContext(const StudyConfiguration &Conf)
+      : SOD(Conf), ABuffer(Conf.BufferSize), BBuffer(Conf.BufferSize),
+        PP(*this) {
+    ::memset(ABuffer.begin(), 'a', Conf.BufferSize);
+    for (const auto I : SOD.getSentinelIndices())
+      ABuffer[I] = '\0';
+    ::memcpy(BBuffer.begin(), ABuffer.begin(), Conf.BufferSize);
+  }
+
+  // Needed by the ParameterProvider to update the current batch of parameter.
+  void Randomize(MutableArrayRef<ParameterType> Parameters) {
+    for (auto &P : Parameters)
+      P.Offset = SOD(Gen, CurrentSize);
+  }
+
+  ArrayRef<StringRef> getFunctionNames() const override {
+    static std::array<StringRef, 1> kFunctionNames = {"strcmp"};
+    return kFunctionNames;
+  }
+
+  BenchmarkResult benchmark(const BenchmarkOptions &Options,
+                            StringRef FunctionName, size_t Size) override {
+    CurrentSize = Size;
+    FunctionPrototype Function = StringSwitch<FunctionPrototype>(FunctionName)
+                                     .Case("strcmp", &__llvm_libc::strcmp);
+    return llvm::libc_benchmarks::benchmark(
+        Options, PP, [this, Function](ParameterType p) {
+          return Function(ABuffer + p.Offset, BBuffer + p.Offset);
+        });
+  }
+
+private:
+  std::default_random_engine Gen;
+  SentinelOffsetDistribution SOD;
+  size_t CurrentSize = 0;
+  AlignedBuffer ABuffer;
+  AlignedBuffer BBuffer;
+  SmallParameterProvider<StrcmpContext> PP;
+};
+
+std::unique_ptr<BenchmarkRunner> getRunner(const StudyConfiguration &Conf) {
+  return std::make_unique<StrcmpContext>(Conf);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
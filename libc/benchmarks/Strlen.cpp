@@ -0,0 +1,73 @@
+//===-- Benchmark strlen implementation -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibcBenchmark.h"
+#include "LibcMemoryBenchmark.h"
+#include "LibcMemoryBenchmarkMain.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace __llvm_libc {
+size_t strlen(const char *);
+} // namespace __llvm_libc
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// The context encapsulates the buffers, parameters and the measure.
+struct StrlenContext : public BenchmarkRunner {
+  using FunctionPrototype = size_t (*)(const char *);
+
+  struct ParameterType {
+    uint16_t Offset = 0;
+  };
+
+  explicit StrlenContext(const StudyConfiguration &Conf)
+      : SOD(Conf), Buffer(Conf.BufferSize), PP(*this) {
+    // Null terminators are placed so that strings are `Size` bytes long.
+    ::memset(Buffer.begin(), 'a', Conf.BufferSize);
+    for (const auto I : SOD.getSentinelIndices())
+      Buffer[I] = '\0';
+  }
+
+  // Needed by the ParameterProvider to update the current batch of parameter.
+  void Randomize(MutableArrayRef<ParameterType> Parameters) {
+    for (auto &P : Parameters)
+      P.Offset = SOD(Gen, CurrentSize);
+  }
+
+  ArrayRef<StringRef> getFunctionNames() const override {
+    static std::array<StringRef, 1> kFunctionNames = {"strlen"};
+    return kFunctionNames;
+  }
+
+  BenchmarkResult benchmark(const BenchmarkOptions &Options,
+                            StringRef FunctionName, size_t Size) override {
+    CurrentSize = Size;
+    FunctionPrototype Function = StringSwitch<FunctionPrototype>(FunctionName)
+                                     .Case("strlen", &__llvm_libc::strlen);
+    return llvm::libc_benchmarks::benchmark(
+        Options, PP, [this, Function](ParameterType p) {
+          return Function(Buffer + p.Offset);
+        });
+  }
+
+private:
+  std::default_random_engine Gen;
+  SentinelOffsetDistribution SOD;
+  size_t CurrentSize = 0;
+  AlignedBuffer Buffer;
+  SmallParameterProvider<StrlenContext> PP;
+};
+
+std::unique_ptr<BenchmarkRunner> getRunner(const StudyConfiguration &Conf) {
+  return std::make_unique<StrlenContext>(Conf);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
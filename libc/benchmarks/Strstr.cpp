@@ -0,0 +1,80 @@
+//===-- Benchmark strstr implementation -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "LibcBenchmark.h"
+#include "LibcMemoryBenchmark.h"
+#include "LibcMemoryBenchmarkMain.h"
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace __llvm_libc {
+char *strstr(const char *, const char *);
+} // namespace __llvm_libc
+
+namespace llvm {
+namespace libc_benchmarks {
+
+// The context encapsulates the buffers, parameters and the measure.
+// Haystacks are `Size` bytes of 'a' and the needles are never found so the
+// whole haystack has to be scanned. Needles are made of 'a' followed by a
+// single 'b', which is the worst case for a naive search.
+struct StrstrContext : public BenchmarkRunner {
+  using FunctionPrototype = char *(*)(const char *, const char *);
+
+  struct ParameterType {
+    uint16_t Offset = 0;
+  };
+
+  explicit StrstrContext(const StudyConfiguration &Conf)
+      : SOD(Conf), Buffer(Conf.BufferSize), PP(*this) {
+    ::memset(Buffer.begin(), 'a', Conf.BufferSize);
+    for (const auto I : SOD.getSentinelIndices())
+      Buffer[I] = '\0';
+  }
+
+  // Needed by the ParameterProvider to update the current batch of parameter.
+  void Randomize(MutableArrayRef<ParameterType> Parameters) {
+    for (auto &P : Parameters)
+      P.Offset = SOD(Gen, CurrentSize);
+  }
+
+  ArrayRef<StringRef> getFunctionNames() const override {
+    static std::array<StringRef, 3> kFunctionNames = {
+        "strstr_short_needle", "strstr_medium_needle", "strstr_long_needle"};
+    return kFunctionNames;
+  }
+
+  BenchmarkResult benchmark(const BenchmarkOptions &Options,
+                            StringRef FunctionName, size_t Size) override {
+    CurrentSize = Size;
+    const char *Needle =
+        StringSwitch<const char *>(FunctionName)
+            .Case("strstr_short_needle", "aab")
+            .Case("strstr_medium_needle", "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaab")
+            .Case("strstr_long_needle",
+                  "aaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaaab");
+    return llvm::libc_benchmarks::benchmark(
+        Options, PP, [this, Needle](ParameterType p) {
+          return __llvm_libc::strstr(Buffer + p.Offset, Needle);
+        });
+  }
+
+private:
+  std::default_random_engine Gen;
+  SentinelOffsetDistribution SOD;
+  size_t CurrentSize = 0;
+  AlignedBuffer Buffer;
+  SmallParameterProvider<StrstrContext> PP;
+};
+
+std::unique_ptr<BenchmarkRunner> getRunner(const StudyConfiguration &Conf) {
+  return std::make_unique<StrstrContext>(Conf);
+}
+
+} // namespace libc_benchmarks
+} // namespace llvm
@@ -0,0 +1,81 @@
+//===-- Implementation of log and friends' utils --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "log_utils.h"
+
+#include "math_utils.h"
+
+namespace __llvm_libc {
+
+const LogfDataTable logf_data = {
+    // tab[i] = {1/c, log(c)}
+    {
+        {as_double(0x3ff661ec79f8f3be), as_double(0xbfd57bf7808caade)},
+        {as_double(0x3ff571ed4aaf883d), as_double(0xbfd2bef0a7c06ddb)},
+        {as_double(0x3ff49539f0f010b0), as_double(0xbfd01eae7f513a67)},
+        {as_double(0x3ff3c995b0b80385), as_double(0xbfcb31d8a68224e9)},
+        {as_double(0x3ff30d190c8864a5), as_double(0xbfc6574f0ac07758)},
+        {as_double(0x3ff25e227b0b8ea0), as_double(0xbfc1aa2bc79c8100)},
+        {as_double(0x3ff1bb4a4a1a343f), as_double(0xbfba4e76ce8c0e5e)},
+        {as_double(0x3ff12358f08ae5ba), as_double(0xbfb1973c5a611ccc)},
+        {as_double(0x3ff0953f419900a7), as_double(0xbfa252f438e10c1e)},
+        {as_double(0x3ff0000000000000), as_double(0x0000000000000000)},
+        {as_double(0x3fee608cfd9a47ac), as_double(0x3faaa5aa5df25984)},
+        {as_double(0x3feca4b31f026aa0), as_double(0x3fbc5e53aa362eb4)},
+        {as_double(0x3feb2036576afce6), as_double(0x3fc526e57720db08)},
+        {as_double(0x3fe9c2d163a1aa2d), as_double(0x3fcbc2860d224770)},
+        {as_double(0x3fe886e6037841ed), as_double(0x3fd1058bc8a07ee1)},
+        {as_double(0x3fe767dcf5534862), as_double(0x3fd4043057b6ee09)},
+    },
+    as_double(0x3fe62e42fefa39ef), // ln2
+    {
+        // poly, relative error: 1.957 * 2^-26 before rounding.
+        as_double(0xbfd00ea348b88334),
+        as_double(0x3fd5575b0be00b6a),
+        as_double(0xbfdffffef20a4123),
+    },
+};
+
+const Log2fDataTable log2f_data = {
+    // tab[i] = {1/c, log2(c)}
+    {
+        {as_double(0x3ff661ec79f8f3be), as_double(0xbfdefec65b963019)},
+        {as_double(0x3ff571ed4aaf883d), as_double(0xbfdb0b6832d4fca4)},
+        {as_double(0x3ff49539f0f010b0), as_double(0xbfd7418b0a1fb77b)},
+        {as_double(0x3ff3c995b0b80385), as_double(0xbfd39de91a6dcf7b)},
+        {as_double(0x3ff30d190c8864a5), as_double(0xbfd01d9bf3f2b631)},
+        {as_double(0x3ff25e227b0b8ea0), as_double(0xbfc97c1d1b3b7af0)},
+        {as_double(0x3ff1bb4a4a1a343f), as_double(0xbfc2f9e393af3c9f)},
+        {as_double(0x3ff12358f08ae5ba), as_double(0xbfb960cbbf788d5c)},
+        {as_double(0x3ff0953f419900a7), as_double(0xbfaa6f9db6475fce)},
+        {as_double(0x3ff0000000000000), as_double(0x0000000000000000)},
+        {as_double(0x3fee608cfd9a47ac), as_double(0x3fb338ca9f24f53d)},
+        {as_double(0x3feca4b31f026aa0), as_double(0x3fc476a9543891ba)},
+        {as_double(0x3feb2036576afce6), as_double(0x3fce840b4ac4e4d2)},
+        {as_double(0x3fe9c2d163a1aa2d), as_double(0x3fd40645f0c6651c)},
+        {as_double(0x3fe886e6037841ed), as_double(0x3fd88e9c2c1b9ff8)},
+        {as_double(0x3fe767dcf5534862), as_double(0x3fdce0a44eb17bcc)},
+    },
+    {
+        // poly, relative error: 1.9 * 2^-26 before rounding.
+        as_double(0xbfd712b6f70a7e4d),
+        as_double(0x3fdecabf496832e0),
+        as_double(0xbfe715479ffae3de),
+        as_double(0x3ff715475f35c8b8),
+    },
+    {
+        // powf_poly, relative error: 1.83 * 2^-33.
+        as_double(0x3fd27616c9496e0b),
+        as_double(0xbfd71969a075c67a),
+        as_double(0x3fdec70a6ca7badd),
+        as_double(0xbfe7154748bef6c8),
+        as_double(0x3ff71547652ab82b),
+    },
+};
+
+} // namespace __llvm_libc
@@ -0,0 +1,50 @@
+//===-- Collection of utils for log and friends -----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_LOG_UTILS_H
+#define LLVM_LIBC_SRC_MATH_LOG_UTILS_H
+
+#include <stdint.h>
+
+#define LOGF_TABLE_BITS 4
+#define LOGF_POLY_ORDER 4
+#define LOG2F_TABLE_BITS 4
+#define LOG2F_POLY_ORDER 4
+#define POWF_LOG2_POLY_ORDER 5
+
+// The argument is reduced to z in [OFF, 2 * OFF] with x = 2^k * z. This range
+// is split into 2^TABLE_BITS subintervals, c is near the center of the one
+// containing z and log(x) = k * log(2) + log(c) + log1p(z / c - 1).
+#define LOGF_OFF 0x3f330000
+
+namespace __llvm_libc {
+
+struct LogfDataTable {
+  struct {
+    double invc, logc;
+  } tab[1 << LOGF_TABLE_BITS];
+  double ln2;
+  double poly[LOGF_POLY_ORDER - 1]; // First order coefficient is 1.
+};
+
+struct Log2fDataTable {
+  struct {
+    double invc, logc;
+  } tab[1 << LOG2F_TABLE_BITS];
+  double poly[LOG2F_POLY_ORDER];
+  // powf needs a more accurate log2, it uses the same table with a higher
+  // order polynomial.
+  double powf_poly[POWF_LOG2_POLY_ORDER];
+};
+
+extern const LogfDataTable logf_data;
+extern const Log2fDataTable log2f_data;
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_LOG_UTILS_H
@@ -0,0 +1,69 @@
+//===-- Single-precision log function -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "log_utils.h"
+#include "math_utils.h"
+
+#include "include/math.h"
+#include "src/__support/common.h"
+
+#include <stdint.h>
+
+#define N (1 << LOGF_TABLE_BITS)
+#define T logf_data.tab
+#define A logf_data.poly
+#define Ln2 logf_data.ln2
+
+namespace __llvm_libc {
+
+// ULP error: 0.818 (nearest rounding.)
+// Relative error: 1.957 * 2^-26 (before rounding.)
+float LLVM_LIBC_ENTRYPOINT(logf)(float x) {
+  // double_t for better performance on targets with FLT_EVAL_METHOD == 2.
+  double_t z, r, r2, y, y0, invc, logc;
+  uint32_t ix, iz, tmp;
+  int k, i;
+
+  ix = as_uint32_bits(x);
+  if (unlikely(ix - 0x00800000 >= 0x7f800000 - 0x00800000)) {
+    // x < 0x1p-126 or inf or nan.
+    if (ix * 2 == 0)
+      return divzero<float>(1);
+    if (ix == 0x7f800000) // log(inf) == inf.
+      return x;
+    if ((ix & 0x80000000) || ix * 2 >= 0xff000000)
+      return invalid(x);
+    // x is subnormal, normalize it.
+    ix = as_uint32_bits(x * as_float(0x4b000000)); // x * 2^23
+    ix -= 23 << 23;
+  }
+
+  // x = 2^k z; where z is in range [OFF, 2 * OFF] and exact.
+  // The range is split into N subintervals.
+  // The ith subinterval contains z and c is near its center.
+  tmp = ix - LOGF_OFF;
+  i = (tmp >> (23 - LOGF_TABLE_BITS)) % N;
+  k = static_cast<int32_t>(tmp) >> 23; // Arithmetic shift.
+  iz = ix - (tmp & 0x1ff << 23);
+  invc = T[i].invc;
+  logc = T[i].logc;
+  z = static_cast<double_t>(as_float(iz));
+
+  // log(x) = log1p(z / c - 1) + log(c) + k * Ln2
+  r = z * invc - 1;
+  y0 = logc + static_cast<double_t>(k) * Ln2;
+
+  // Pipelined polynomial evaluation to approximate log1p(r).
+  r2 = r * r;
+  y = A[1] * r + A[2];
+  y = A[0] * r2 + y;
+  y = y * r2 + (y0 + r);
+  return static_cast<float>(y);
+}
+
+} // namespace __llvm_libc
@@ -98,6 +98,12 @@ T may_underflow(uint32_t sign) {
   return xflow(sign, XFlowValues<T>::may_underflow_value);
 }
 
+// Returns an infinity of sign `sign` for a pole error.
+template <typename T, EnableIfFloatOrDouble<T> = 0> T divzero(uint32_t sign) {
+  T y = opt_barrier(sign ? T(-1.0) : T(1.0)) / T(0.0);
+  return with_errno(y, ERANGE);
+}
+
 template <typename T, EnableIfFloatOrDouble<T> = 0>
 static inline constexpr float invalid(T x) {
   T y = (x - x) / (x - x);
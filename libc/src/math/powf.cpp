@@ -0,0 +1,191 @@
+//===-- Single-precision x^y function -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "exp_utils.h"
+#include "log_utils.h"
+#include "math_utils.h"
+
+#include "include/math.h"
+#include "src/__support/common.h"
+
+#include <stdint.h>
+
+#define TLOG log2f_data.tab
+#define A log2f_data.powf_poly
+#define TEXP exp2f_data.tab
+#define C exp2f_data.poly
+#define SHIFT exp2f_data.shift_scaled
+#define SIGN_BIAS (1 << (EXP2F_TABLE_BITS + 11))
+
+namespace __llvm_libc {
+
+// ULP error: 0.82 (~ 0.5 + relerr * 2^24)
+// relerr: 1.27 * 2^-26 (Relative error ~= 128 * Ln2 * relerr_log2 +
+//                       relerr_exp2)
+// relerr_log2: 1.83 * 2^-33 (Relative error of logx.)
+// relerr_exp2: 1.69 * 2^-34 (Relative error of exp2(ylogx).)
+
+// Subnormal input is normalized so ix has negative biased exponent.
+static inline double_t log2_inline(uint32_t ix) {
+  // double_t for better performance on targets with FLT_EVAL_METHOD == 2.
+  double_t z, r, r2, r4, p, q, y, y0, invc, logc;
+  uint32_t iz, top, tmp;
+  int k, i;
+
+  // x = 2^k z; where z is in range [OFF, 2 * OFF] and exact.
+  // The range is split into N subintervals.
+  // The ith subinterval contains z and c is near its center.
+  tmp = ix - LOGF_OFF;
+  i = (tmp >> (23 - LOG2F_TABLE_BITS)) % (1 << LOG2F_TABLE_BITS);
+  top = tmp & 0xff800000;
+  iz = ix - top;
+  k = static_cast<int32_t>(top) >> 23; // Arithmetic shift.
+  invc = TLOG[i].invc;
+  logc = TLOG[i].logc;
+  z = static_cast<double_t>(as_float(iz));
+
+  // log2(x) = log1p(z / c - 1) / ln2 + log2(c) + k
+  r = z * invc - 1;
+  y0 = logc + static_cast<double_t>(k);
+
+  // Pipelined polynomial evaluation to approximate log1p(r) / ln2.
+  r2 = r * r;
+  y = A[0] * r + A[1];
+  p = A[2] * r + A[3];
+  r4 = r2 * r2;
+  q = A[4] * r + y0;
+  q = p * r2 + q;
+  y = y * r4 + q;
+  return y;
+}
+
+// The input of exp2 must be in [-1021, 1023], sign_bias sets the sign of the
+// result.
+static inline float exp2_inline(double_t xd, uint32_t sign_bias) {
+  uint64_t ki, ski, t;
+  // double_t for better performance on targets with FLT_EVAL_METHOD == 2.
+  double_t kd, z, r, r2, y, s;
+
+  // x = k/N + r with r in [-1/(2N), 1/(2N)]
+  kd = static_cast<double>(xd + SHIFT);
+  ki = as_uint64_bits(kd);
+  kd -= SHIFT; // k/N
+  r = xd - kd;
+
+  // exp2(x) = 2^(k/N) * 2^r ~= s * (C0*r^3 + C1*r^2 + C2*r + 1)
+  t = TEXP[ki % N];
+  ski = ki + sign_bias;
+  t += ski << (52 - EXP2F_TABLE_BITS);
+  s = as_double(t);
+  z = C[0] * r + C[1];
+  r2 = r * r;
+  y = C[2] * r + 1;
+  y = z * r2 + y;
+  y = y * s;
+  return static_cast<float>(y);
+}
+
+// Returns 0 if not int, 1 if odd int, 2 if even int. The argument is the bit
+// representation of a non-zero finite floating-point value.
+static inline int checkint(uint32_t iy) {
+  int e = iy >> 23 & 0xff;
+  if (e < 0x7f)
+    return 0;
+  if (e > 0x7f + 23)
+    return 2;
+  if (iy & ((1 << (0x7f + 23 - e)) - 1))
+    return 0;
+  if (iy & (1 << (0x7f + 23 - e)))
+    return 1;
+  return 2;
+}
+
+// Returns true if the argument is the representation of 0, inf or nan.
+static inline bool zeroinfnan(uint32_t ix) {
+  return 2 * ix - 1 >= 2u * 0x7f800000 - 1;
+}
+
+static inline bool issignaling(uint32_t ix) {
+  return 2 * (ix ^ 0x00400000) > 2u * 0x7fc00000;
+}
+
+float LLVM_LIBC_ENTRYPOINT(powf)(float x, float y) {
+  uint32_t sign_bias = 0;
+  uint32_t ix, iy;
+
+  ix = as_uint32_bits(x);
+  iy = as_uint32_bits(y);
+  if (unlikely(ix - 0x00800000 >= 0x7f800000 - 0x00800000 || zeroinfnan(iy))) {
+    // Either (x < 0x1p-126 or inf or nan) or (y is 0 or inf or nan).
+    if (unlikely(zeroinfnan(iy))) {
+      if (2 * iy == 0)
+        return issignaling(ix) ? x + y : 1.0f;
+      if (ix == 0x3f800000)
+        return issignaling(iy) ? x + y : 1.0f;
+      if (2 * ix > 2u * 0x7f800000 || 2 * iy > 2u * 0x7f800000)
+        return x + y;
+      if (2 * ix == 2 * 0x3f800000)
+        return 1.0f;
+      if ((2 * ix < 2 * 0x3f800000) == !(iy & 0x80000000))
+        return 0.0f; // |x| < 1 && y == inf or |x| > 1 && y == -inf.
+      return y * y;
+    }
+    if (unlikely(zeroinfnan(ix))) {
+      float_t x2 = x * x;
+      if (ix & 0x80000000 && checkint(iy) == 1) {
+        x2 = -x2;
+        sign_bias = 1;
+      }
+      if (2 * ix == 0 && iy & 0x80000000)
+        return divzero<float>(sign_bias);
+      return iy & 0x80000000 ? opt_barrier<float>(1 / x2) : x2;
+    }
+    // x and y are non-zero finite.
+    if (ix & 0x80000000) {
+      // Finite x < 0.
+      int yint = checkint(iy);
+      if (yint == 0)
+        return invalid(x);
+      if (yint == 1)
+        sign_bias = SIGN_BIAS;
+      ix &= 0x7fffffff;
+    }
+    if (ix < 0x00800000) {
+      // Normalize subnormal x so exponent becomes negative.
+      ix = as_uint32_bits(x * as_float(0x4b000000)); // x * 2^23
+      ix &= 0x7fffffff;
+      ix -= 23 << 23;
+    }
+  }
+  double_t logx = log2_inline(ix);
+  // Cannot overflow, y is single precision.
+  double_t ylogx = y * logx;
+  if (unlikely((as_uint64_bits(ylogx) >> 47 & 0xffff) >=
+               as_uint64_bits(126.0) >> 47)) {
+    // |y * log(x)| >= 126.
+    if (ylogx > as_double(0x405fffffffd1d571)) // |x^y| > 0x1.ffffffp127.
+      return overflow<float>(sign_bias);
+    if (ylogx > as_double(0x405fffffffa3aae2)) {
+      // |x^y| > 0x1.fffffep127, check if we round away from 0.
+      if ((!sign_bias &&
+           static_cast<float>(1.0f + opt_barrier(as_float(0x33000000))) !=
+               1.0f) ||
+          (sign_bias &&
+           static_cast<float>(-1.0f - opt_barrier(as_float(0x33000000))) !=
+               -1.0f))
+        return overflow<float>(sign_bias);
+    }
+    if (ylogx <= -150.0)
+      return underflow<float>(sign_bias);
+    if (ylogx < -149.0)
+      return may_underflow<float>(sign_bias);
+  }
+  return exp2_inline(ylogx, sign_bias);
+}
+
+} // namespace __llvm_libc
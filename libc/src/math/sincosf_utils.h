@@ -93,6 +93,28 @@ static inline float sinf_poly(double x, double x2, const sincos_t *p, int n) {
   }
 }
 
+// Return the tangent of inputs X and X2 (X squared) using the polynomials P.
+// N is the quadrant, and if odd the result is -cot(X) = tan(X + PI/2). The
+// quotient is computed in double precision so that the errors of the sine
+// and cosine polynomials only add up.
+static inline float tanf_poly(double x, double x2, const sincos_t *p, int n) {
+  double x3, x4, x5, x6, s, c, c1, c2, s1;
+
+  x3 = x2 * x;
+  x4 = x2 * x2;
+  x5 = x3 * x2;
+  x6 = x4 * x2;
+
+  s1 = p->s2 + x2 * p->s3;
+  s = x + x3 * p->s1 + x5 * s1;
+
+  c1 = p->c0 + x2 * p->c1;
+  c2 = p->c3 + x2 * p->c4;
+  c = c1 + x4 * p->c2 + x6 * c2;
+
+  return (n & 1) ? -c / s : s / c;
+}
+
 // Fast range reduction using single multiply-subtract. Return the modulo of
 // X as a value between -PI/4 and PI/4 and store the quadrant in NP.
 // The values for PI/2 and 2/PI are accessed via P. Since PI/2 as a double
@@ -0,0 +1,56 @@
+//===-- Single-precision tan function -------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "math_utils.h"
+#include "sincosf_utils.h"
+
+#include "include/math.h"
+#include "src/__support/common.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+// Fast tanf implementation built on the sinf/cosf polynomials and range
+// reductions: the argument is reduced to [-PI/4, PI/4] and the quotient of
+// the sine and cosine of the reduced argument is computed in double
+// precision. Small values use a single-step range reduction, large inputs
+// have their range reduced using fast integer arithmetic.
+float LLVM_LIBC_ENTRYPOINT(tanf)(float y) {
+  double x = y;
+  int n;
+  const sincos_t *p = &__sincosf_table[0];
+
+  if (abstop12(y) < abstop12(pio4)) {
+    if (unlikely(abstop12(y) < abstop12(as_float(0x39800000)))) {
+      if (unlikely(abstop12(y) < abstop12(as_float(0x800000))))
+        // Force underflow for tiny y.
+        force_eval<float>(x * x);
+      return y;
+    }
+
+    return tanf_poly(x, x * x, p, 0);
+  } else if (likely(abstop12(y) < abstop12(120.0f))) {
+    x = reduce_fast(x, p, &n);
+    return tanf_poly(x, x * x, p, n);
+  } else if (abstop12(y) < abstop12(INFINITY)) {
+    uint32_t xi = as_uint32_bits(y);
+    int sign = xi >> 31;
+
+    // The reduction ignores the sign, tan is odd.
+    x = reduce_large(xi, &n);
+    if (sign)
+      x = -x;
+
+    return tanf_poly(x, x * x, p, n);
+  }
+
+  return invalid(y);
+}
+
+} // namespace __llvm_libc
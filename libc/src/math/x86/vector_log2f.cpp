@@ -0,0 +1,62 @@
+//===-- Single-precision vector log2 function -----------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/x86/vector_math.h"
+#include "src/math/x86/vector_math_utils.h"
+
+#include "src/math/log_utils.h"
+#include "src/math/log2f.h"
+
+#include <stdint.h>
+
+#define N (1 << LOG2F_TABLE_BITS)
+#define T log2f_data.tab
+#define A log2f_data.poly
+
+namespace __llvm_libc {
+
+using namespace vector;
+
+__attribute__((noinline)) static Float specialcase(Float x, Float y,
+                                                   Int32 special) {
+  return call_scalar(__llvm_libc::log2f, x, y, special);
+}
+
+// The algorithm of log2f applied lane by lane, with the same error bounds.
+// Lanes with x < 0x1p-126, inf or nan are computed by log2f.
+Float LLVM_LIBC_ENTRYPOINT(LLVM_LIBC_VECTOR_NAME(v, log2f))(Float x) {
+  const UInt32 ix = bit_cast<UInt32>(x);
+  const Int32 special = ix - 0x00800000 >= 0x7f800000 - 0x00800000;
+
+  // x = 2^k z; where z is in range [OFF, 2 * OFF] and exact.
+  const UInt32 tmp = ix - LOGF_OFF;
+  const UInt32 i = (tmp >> (23 - LOG2F_TABLE_BITS)) % N;
+  const Int32 k = bit_cast<Int32>(tmp) >> 23; // Arithmetic shift.
+  const UInt32 iz = ix - (tmp & 0xff800000);
+  // T is an array of {invc, logc} pairs.
+  const Double invc = gather<2>(&T[0].invc, i);
+  const Double logc = gather<2>(&T[0].logc, i);
+  const Double z = convert<Double>(bit_cast<Float>(iz));
+
+  // log2(x) = log1p(z / c - 1) / ln2 + log2(c) + k
+  const Double r = z * invc - 1;
+  const Double y0 = logc + convert<Double>(k);
+
+  const Double r2 = r * r;
+  Double y = A[1] * r + A[2];
+  y = A[0] * r2 + y;
+  const Double p = A[3] * r + y0;
+  y = y * r2 + p;
+  const Float result = convert<Float>(y);
+
+  if (unlikely(any_lane(special)))
+    return specialcase(x, result, special);
+  return result;
+}
+
+} // namespace __llvm_libc
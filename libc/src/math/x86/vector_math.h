@@ -0,0 +1,33 @@
+//===-- Implementation header for the x86 vector math functions -*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_X86_VECTOR_MATH_H
+#define LLVM_LIBC_SRC_MATH_X86_VECTOR_MATH_H
+
+namespace __llvm_libc {
+
+// The SSE variants, they require SSE4.1.
+typedef float VectorFloat4 __attribute__((vector_size(16)));
+
+VectorFloat4 _ZGVbN4v_logf(VectorFloat4 x);
+VectorFloat4 _ZGVbN4v_log2f(VectorFloat4 x);
+VectorFloat4 _ZGVbN4vv_powf(VectorFloat4 x, VectorFloat4 y);
+VectorFloat4 _ZGVbN4v_tanf(VectorFloat4 x);
+
+// The AVX2 variants, they require AVX2 and FMA. They can only be called from
+// code compiled with AVX enabled.
+typedef float VectorFloat8 __attribute__((vector_size(32)));
+
+VectorFloat8 _ZGVdN8v_logf(VectorFloat8 x);
+VectorFloat8 _ZGVdN8v_log2f(VectorFloat8 x);
+VectorFloat8 _ZGVdN8vv_powf(VectorFloat8 x, VectorFloat8 y);
+VectorFloat8 _ZGVdN8v_tanf(VectorFloat8 x);
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_X86_VECTOR_MATH_H
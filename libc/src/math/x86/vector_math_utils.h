@@ -0,0 +1,183 @@
+//===-- Utils for the x86 vector math functions -----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_X86_VECTOR_MATH_UTILS_H
+#define LLVM_LIBC_SRC_MATH_X86_VECTOR_MATH_UTILS_H
+
+#include "src/__support/common.h"
+
+#include <immintrin.h>
+#include <stdint.h>
+
+// The vector functions follow the x86_64 vector function ABI so that the
+// compiler can call them from vectorized loops: `_ZGV<isa>N<lanes><params>_f`
+// where <isa> is `b` for SSE and `d` for AVX2 and <params> has one `v` per
+// vector parameter. Each source file is compiled once per instruction set and
+// this header picks the vector width and the name of the function from the
+// target features.
+#if defined(__AVX2__)
+#define LLVM_LIBC_VECTOR_LANES 8
+#define LLVM_LIBC_VECTOR_NAME(params, name) _ZGVdN8##params##_##name
+#elif defined(__SSE4_1__)
+#define LLVM_LIBC_VECTOR_LANES 4
+#define LLVM_LIBC_VECTOR_NAME(params, name) _ZGVbN4##params##_##name
+#else
+#error "The vector math functions require SSE4.1 or AVX2."
+#endif
+
+namespace __llvm_libc {
+namespace vector {
+
+constexpr unsigned kLanes = LLVM_LIBC_VECTOR_LANES;
+
+typedef float Float __attribute__((vector_size(4 * kLanes)));
+typedef uint32_t UInt32 __attribute__((vector_size(4 * kLanes)));
+typedef int32_t Int32 __attribute__((vector_size(4 * kLanes)));
+
+// Single-precision functions are evaluated in double precision, like their
+// scalar counterparts, on vectors of the same number of lanes.
+typedef double Double __attribute__((vector_size(8 * kLanes)));
+typedef uint64_t UInt64 __attribute__((vector_size(8 * kLanes)));
+typedef int64_t Int64 __attribute__((vector_size(8 * kLanes)));
+
+// Reinterprets the bits of a vector as another vector type of the same size.
+template <typename To, typename From> static inline To bit_cast(From from) {
+  static_assert(sizeof(To) == sizeof(From), "Vector sizes must match.");
+  To to;
+  __builtin_memcpy(&to, &from, sizeof(To));
+  return to;
+}
+
+// Converts the lanes of a vector to another element type.
+template <typename To, typename From> static inline To convert(From from) {
+  return __builtin_convertvector(from, To);
+}
+
+// Returns the lanes of `a` where `mask` is set and the lanes of `b` elsewhere.
+static inline Double select(Int64 mask, Double a, Double b) {
+  return bit_cast<Double>((mask & bit_cast<Int64>(a)) |
+                          (~mask & bit_cast<Int64>(b)));
+}
+
+// Returns whether any lane of the comparison result `mask` is set.
+static inline bool any_lane(Int32 mask) {
+#if defined(__AVX2__)
+  return _mm256_movemask_ps(bit_cast<__m256>(mask)) != 0;
+#else
+  return _mm_movemask_ps(bit_cast<__m128>(mask)) != 0;
+#endif
+}
+
+// Returns the lanes of `a` rounded to the nearest integer, ties to even.
+static inline Double round_to_int(Double a) {
+#if defined(__AVX2__)
+  __m256d low, high;
+  __builtin_memcpy(&low, &a, sizeof(low));
+  __builtin_memcpy(&high, reinterpret_cast<char *>(&a) + sizeof(low),
+                   sizeof(high));
+  low = _mm256_round_pd(low, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  high = _mm256_round_pd(high, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#else
+  __m128d low, high;
+  __builtin_memcpy(&low, &a, sizeof(low));
+  __builtin_memcpy(&high, reinterpret_cast<char *>(&a) + sizeof(low),
+                   sizeof(high));
+  low = _mm_round_pd(low, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+  high = _mm_round_pd(high, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+#endif
+  Double result;
+  __builtin_memcpy(&result, &low, sizeof(low));
+  __builtin_memcpy(reinterpret_cast<char *>(&result) + sizeof(low), &high,
+                   sizeof(high));
+  return result;
+}
+
+// Returns the lanes where `a >= b` as a mask of 32-bit lanes, which can be
+// combined with the comparisons of Float vectors. Comparisons of Double
+// vectors are spelled with intrinsics, compilers do not always lower them to
+// vector instructions when Double is wider than a register.
+static inline Int32 greater_equal(Double a, double b) {
+#if defined(__AVX2__)
+  __m256d low, high;
+  __builtin_memcpy(&low, &a, sizeof(low));
+  __builtin_memcpy(&high, reinterpret_cast<char *>(&a) + sizeof(low),
+                   sizeof(high));
+  const __m256d threshold = _mm256_set1_pd(b);
+  // Moves the low halves of the 64-bit masks to the low 128 bits.
+  const __m256i even_first = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+  const __m256 low_mask = _mm256_permutevar8x32_ps(
+      _mm256_castpd_ps(_mm256_cmp_pd(low, threshold, _CMP_GE_OQ)), even_first);
+  const __m256 high_mask = _mm256_permutevar8x32_ps(
+      _mm256_castpd_ps(_mm256_cmp_pd(high, threshold, _CMP_GE_OQ)),
+      even_first);
+  return bit_cast<Int32>(_mm256_permute2f128_ps(low_mask, high_mask, 0x20));
+#else
+  __m128d low, high;
+  __builtin_memcpy(&low, &a, sizeof(low));
+  __builtin_memcpy(&high, reinterpret_cast<char *>(&a) + sizeof(low),
+                   sizeof(high));
+  const __m128d threshold = _mm_set1_pd(b);
+  return bit_cast<Int32>(
+      _mm_shuffle_ps(_mm_castpd_ps(_mm_cmpge_pd(low, threshold)),
+                     _mm_castpd_ps(_mm_cmpge_pd(high, threshold)),
+                     _MM_SHUFFLE(2, 0, 2, 0)));
+#endif
+}
+
+// Returns a vector holding `table[index[i] * stride]` in lane i, used to look
+// up tables. A stride of 2 reads one field of a table of pairs of doubles.
+template <unsigned stride = 1>
+static inline Double gather(const double *table, UInt32 index) {
+  const Int32 offset = bit_cast<Int32>(index * stride);
+#if defined(__AVX2__)
+  const __m256i offsets = bit_cast<__m256i>(offset);
+  const __m256d low =
+      _mm256_i32gather_pd(table, _mm256_castsi256_si128(offsets), 8);
+  const __m256d high =
+      _mm256_i32gather_pd(table, _mm256_extracti128_si256(offsets, 1), 8);
+#else
+  const __m128d low = _mm_loadh_pd(_mm_load_sd(table + offset[0]),
+                                   table + offset[1]);
+  const __m128d high = _mm_loadh_pd(_mm_load_sd(table + offset[2]),
+                                    table + offset[3]);
+#endif
+  Double result;
+  __builtin_memcpy(&result, &low, sizeof(low));
+  __builtin_memcpy(reinterpret_cast<char *>(&result) + sizeof(low), &high,
+                   sizeof(high));
+  return result;
+}
+
+static inline UInt64 gather(const uint64_t *table, UInt32 index) {
+  return bit_cast<UInt64>(
+      gather(reinterpret_cast<const double *>(table), index));
+}
+
+// Recomputes the lanes of `result` where `special` is set with the scalar
+// function `f`, which handles all the special cases and sets errno.
+template <typename F>
+static inline Float call_scalar(F f, Float x, Float result, Int32 special) {
+  for (unsigned lane = 0; lane < kLanes; ++lane)
+    if (special[lane])
+      result[lane] = f(x[lane]);
+  return result;
+}
+
+template <typename F>
+static inline Float call_scalar(F f, Float x, Float y, Float result,
+                                Int32 special) {
+  for (unsigned lane = 0; lane < kLanes; ++lane)
+    if (special[lane])
+      result[lane] = f(x[lane], y[lane]);
+  return result;
+}
+
+} // namespace vector
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_X86_VECTOR_MATH_UTILS_H
@@ -0,0 +1,96 @@
+//===-- Single-precision vector x^y function ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/x86/vector_math.h"
+#include "src/math/x86/vector_math_utils.h"
+
+#include "src/math/exp_utils.h"
+#include "src/math/log_utils.h"
+#include "src/math/math_utils.h"
+#include "src/math/powf.h"
+
+#include <stdint.h>
+
+#define TLOG log2f_data.tab
+#define A log2f_data.powf_poly
+#define TEXP exp2f_data.tab
+#define C exp2f_data.poly
+
+namespace __llvm_libc {
+
+using namespace vector;
+
+__attribute__((noinline)) static Float specialcase(Float x, Float y,
+                                                   Float result,
+                                                   Int32 special) {
+  return call_scalar(__llvm_libc::powf, x, y, result, special);
+}
+
+// The algorithm of powf applied lane by lane, with the same error bounds.
+// Lanes with x <= 0x1p-126, inf or nan, with y zero, inf or nan or with
+// |y * log2(x)| >= 126 are computed by powf. This includes all the lanes with
+// a negative x, they are rare enough not to be worth the check for an
+// integer y.
+Float LLVM_LIBC_ENTRYPOINT(LLVM_LIBC_VECTOR_NAME(vv, powf))(Float x,
+                                                            Float y) {
+  const UInt32 ix = bit_cast<UInt32>(x);
+  const UInt32 iy = bit_cast<UInt32>(y);
+  Int32 special = (ix - 0x00800000 >= 0x7f800000 - 0x00800000) |
+                  (2 * iy - 1 >= 2u * 0x7f800000 - 1);
+
+  // log2(x) = log1p(z / c - 1) / ln2 + log2(c) + k, see logf.
+  const UInt32 tmp = ix - LOGF_OFF;
+  const UInt32 i = (tmp >> (23 - LOG2F_TABLE_BITS)) % (1 << LOG2F_TABLE_BITS);
+  const UInt32 top = tmp & 0xff800000;
+  const UInt32 iz = ix - top;
+  const Int32 k = bit_cast<Int32>(top) >> 23; // Arithmetic shift.
+  // TLOG is an array of {invc, logc} pairs.
+  const Double invc = gather<2>(&TLOG[0].invc, i);
+  const Double logc = gather<2>(&TLOG[0].logc, i);
+  const Double z = convert<Double>(bit_cast<Float>(iz));
+
+  Double r = z * invc - 1;
+  const Double y0 = logc + convert<Double>(k);
+
+  const Double r2 = r * r;
+  const Double r4 = r2 * r2;
+  Double logx = A[0] * r + A[1];
+  const Double p = A[2] * r + A[3];
+  Double q = A[4] * r + y0;
+  q = p * r2 + q;
+  logx = logx * r4 + q;
+
+  // Cannot overflow, y is single precision.
+  const Double ylogx = convert<Double>(y) * logx;
+  const Double abs_ylogx =
+      bit_cast<Double>(bit_cast<UInt64>(ylogx) & 0x7fffffffffffffff);
+  special |= greater_equal(abs_ylogx, 126.0);
+
+  // x^y = 2^(y * log2(x)) = 2^(k/N) * 2^r with r in [-1/(2N), 1/(2N)].
+  // powf rounds with `ylogx + SHIFT - SHIFT`, SSE4.1 has an instruction for
+  // it. The conversion of k is exact in the lanes which are not special.
+  const Double kn = round_to_int(ylogx * N);
+  const Double kd = kn * (1.0 / N);
+  r = ylogx - kd;
+  const Int32 ki = convert<Int32>(kn);
+
+  // 2^(k/N) * 2^r ~= s * (C0*r^3 + C1*r^2 + C2*r + 1)
+  UInt64 t = gather(TEXP, bit_cast<UInt32>(ki) % N);
+  t += bit_cast<UInt64>(convert<Int64>(ki)) << (52 - EXP2F_TABLE_BITS);
+  const Double s = bit_cast<Double>(t);
+  const Double c = C[0] * r + C[1];
+  Double result = C[2] * r + 1;
+  result = c * (r * r) + result;
+  result = result * s;
+
+  if (unlikely(any_lane(special)))
+    return specialcase(x, y, convert<Float>(result), special);
+  return convert<Float>(result);
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,60 @@
+//===-- Single-precision vector tan function ------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/x86/vector_math.h"
+#include "src/math/x86/vector_math_utils.h"
+
+#include "src/math/sincosf_utils.h"
+#include "src/math/tanf.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+using namespace vector;
+
+__attribute__((noinline)) static Float specialcase(Float x, Float y,
+                                                   Int32 special) {
+  return call_scalar(__llvm_libc::tanf, x, y, special);
+}
+
+// The algorithm of tanf applied lane by lane. The single-step range reduction
+// of tanf is used for all the lanes, it is exact for small values. Lanes with
+// |x| >= 120, inf or nan are computed by tanf.
+Float LLVM_LIBC_ENTRYPOINT(LLVM_LIBC_VECTOR_NAME(v, tanf))(Float y) {
+  const sincos_t *p = &__sincosf_table[0];
+  const UInt32 top = (bit_cast<UInt32>(y) >> 20) & 0x7ff;
+  const Int32 special = top >= abstop12(120.0f);
+
+  // Reduce x to [-PI/4, PI/4], n is the quadrant, see reduce_fast.
+  Double x = convert<Double>(y);
+  const Int32 n = (convert<Int32>(x * p->hpi_inv) + 0x800000) >> 24;
+  x = x - convert<Double>(n) * p->hpi;
+
+  // The sine and cosine polynomials, see tanf_poly.
+  const Double x2 = x * x;
+  const Double x3 = x2 * x;
+  const Double x4 = x2 * x2;
+  const Double x5 = x3 * x2;
+  const Double x6 = x4 * x2;
+  const Double s1 = p->s2 + x2 * p->s3;
+  const Double s = x + x3 * p->s1 + x5 * s1;
+  const Double c1 = p->c0 + x2 * p->c1;
+  const Double c2 = p->c3 + x2 * p->c4;
+  const Double c = c1 + x4 * p->c2 + x6 * c2;
+
+  // tan(x) = s / c in even quadrants and -c / s in odd ones.
+  const Int64 odd = convert<Int64>(n & 1) != 0;
+  const Float result = convert<Float>(select(odd, -c, s) / select(odd, s, c));
+
+  if (unlikely(any_lane(special)))
+    return specialcase(y, result, special);
+  return result;
+}
+
+} // namespace __llvm_libc
@@ -9,17 +9,73 @@
 #ifndef LLVM_LIBC_SRC_STDIO_FILE_H
 #define LLVM_LIBC_SRC_STDIO_FILE_H
 
+#include "include/stdio.h"
 #include "include/threads.h"
+#include "src/threads/mtx_lock.h"
+#include "src/threads/mtx_unlock.h"
+#include "src/threads/multithreading.h"
 #include <stddef.h>
 
 namespace __llvm_libc {
 
 struct FILE {
-  mtx_t lock;
+  mtx_t lock = {};
 
   using write_function_t = size_t(FILE *, const char *, size_t);
+  using read_function_t = size_t(FILE *, char *, size_t);
 
-  write_function_t *write;
+  // The functions moving data to and from the underlying device. They return
+  // the number of bytes transferred, a short count means an error or the end
+  // of the file.
+  write_function_t *write = nullptr;
+  read_function_t *read = nullptr;
+
+  // Buffering mode, one of _IOFBF, _IOLBF or _IONBF. Streams are unbuffered
+  // until `setvbuf` is called.
+  int buffer_mode = _IONBF;
+  char *buffer = nullptr;
+  size_t buffer_size = 0;
+
+  // When writing, `buffer[0, pos)` holds the bytes not yet written to the
+  // device. When reading, `buffer[pos, end)` holds the bytes not yet returned
+  // to the user.
+  size_t pos = 0;
+  size_t end = 0;
+
+  // The buffer holds either pending writes or read ahead data, never both.
+  enum class Direction { None, Read, Write };
+  Direction direction = Direction::None;
+
+  bool error = false;
+  bool eof = false;
+
+  // Used by `setvbuf` when the user does not provide a buffer.
+  static constexpr size_t kDefaultBufferSize = BUFSIZ;
+  char default_buffer[kDefaultBufferSize];
+};
+
+// Holds the lock of `stream` for the lifetime of the object. The lock is not
+// taken when the process runs a single thread as no one else can access the
+// stream, this makes stdio functions as cheap as their unlocked counterparts
+// in single threaded programs.
+class FileLock {
+  FILE *stream;
+  bool locked;
+
+public:
+  explicit FileLock(FILE *stream)
+      : stream(stream), locked(is_multithreaded()) {
+    if (locked)
+      __llvm_libc::mtx_lock(&stream->lock);
+  }
+
+  ~FileLock() {
+    if (locked)
+      __llvm_libc::mtx_unlock(&stream->lock);
+  }
+
+  FileLock(const FileLock &) = delete;
+  FileLock &operator=(const FileLock &) = delete;
 };
 
 } // namespace __llvm_libc
@@ -0,0 +1,52 @@
+//===-- Implementation of fflush and fflush_unlocked ------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/fflush.h"
+#include "include/errno.h" // For E* macros.
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdio/FILE.h"
+
+namespace __llvm_libc {
+
+int fflush_unlocked(__llvm_libc::FILE *stream) {
+  if (stream->direction == FILE::Direction::Read) {
+    // Read ahead data is dropped.
+    stream->pos = stream->end = 0;
+    stream->direction = FILE::Direction::None;
+    return 0;
+  }
+  if (stream->direction != FILE::Direction::Write)
+    return 0;
+  const size_t pending = stream->pos;
+  const size_t written = stream->write(stream, stream->buffer, pending);
+  if (written < pending) {
+    // Keep the bytes that could not be written for a later attempt.
+    for (size_t i = written; i < pending; ++i)
+      stream->buffer[i - written] = stream->buffer[i];
+    stream->pos = pending - written;
+    stream->error = true;
+    return EOF;
+  }
+  stream->pos = 0;
+  stream->direction = FILE::Direction::None;
+  return 0;
+}
+
+int LLVM_LIBC_ENTRYPOINT(fflush)(__llvm_libc::FILE *stream) {
+  // Streams are created by their users and not registered anywhere, so
+  // there is no list of open streams to flush.
+  if (stream == nullptr) {
+    llvmlibc_errno = EINVAL;
+    return EOF;
+  }
+  FileLock lock(stream);
+  return fflush_unlocked(stream);
+}
+
+} // namespace __llvm_libc
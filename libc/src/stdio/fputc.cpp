@@ -0,0 +1,35 @@
+//===-- Implementation of fputc and fputc_unlocked --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/fputc.h"
+#include "src/__support/common.h"
+#include "src/stdio/FILE.h"
+#include "src/stdio/fwrite.h"
+
+namespace __llvm_libc {
+
+int fputc_unlocked(int c, __llvm_libc::FILE *stream) {
+  const unsigned char value = static_cast<unsigned char>(c);
+  // Fast path: the character fits in the buffer and does not trigger a flush.
+  if (stream->direction == FILE::Direction::Write &&
+      stream->pos < stream->buffer_size &&
+      (stream->buffer_mode != _IOLBF || value != '\n')) {
+    stream->buffer[stream->pos++] = static_cast<char>(value);
+    return value;
+  }
+  if (fwrite_unlocked(&value, 1, 1, stream) != 1)
+    return EOF;
+  return value;
+}
+
+int LLVM_LIBC_ENTRYPOINT(fputc)(int c, __llvm_libc::FILE *stream) {
+  FileLock lock(stream);
+  return fputc_unlocked(c, stream);
+}
+
+} // namespace __llvm_libc
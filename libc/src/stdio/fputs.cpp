@@ -0,0 +1,31 @@
+//===-- Implementation of fputs and fputs_unlocked --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/fputs.h"
+#include "src/__support/common.h"
+#include "src/stdio/FILE.h"
+#include "src/stdio/fwrite.h"
+#include "src/string/strlen.h"
+
+namespace __llvm_libc {
+
+int fputs_unlocked(const char *__restrict str,
+                   __llvm_libc::FILE *__restrict stream) {
+  const size_t size = __llvm_libc::strlen(str);
+  if (fwrite_unlocked(str, 1, size, stream) != size)
+    return EOF;
+  return 0;
+}
+
+int LLVM_LIBC_ENTRYPOINT(fputs)(const char *__restrict str,
+                                __llvm_libc::FILE *__restrict stream) {
+  FileLock lock(stream);
+  return fputs_unlocked(str, stream);
+}
+
+} // namespace __llvm_libc
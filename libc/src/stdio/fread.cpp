@@ -0,0 +1,79 @@
+//===-- Implementation of fread and fread_unlocked --------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/fread.h"
+#include "include/errno.h" // For E* macros.
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdio/FILE.h"
+#include "src/stdio/fflush.h"
+#include "src/string/memcpy.h"
+
+namespace __llvm_libc {
+
+// Copies up to `size` bytes of read ahead data to `dst`.
+static size_t take_buffered(__llvm_libc::FILE *stream, char *dst, size_t size) {
+  const size_t available = stream->end - stream->pos;
+  const size_t count = size < available ? size : available;
+  __llvm_libc::memcpy(dst, stream->buffer + stream->pos, count);
+  stream->pos += count;
+  return count;
+}
+
+size_t fread_unlocked(void *__restrict ptr, size_t size, size_t nmeb,
+                      __llvm_libc::FILE *__restrict stream) {
+  size_t total;
+  if (__builtin_mul_overflow(size, nmeb, &total)) {
+    llvmlibc_errno = EOVERFLOW;
+    return 0;
+  }
+  if (total == 0)
+    return 0;
+  if (stream->read == nullptr) {
+    stream->error = true;
+    return 0;
+  }
+  if (stream->direction == FILE::Direction::Write &&
+      fflush_unlocked(stream) != 0)
+    return 0;
+  char *dst = reinterpret_cast<char *>(ptr);
+  size_t copied = 0;
+  if (stream->direction == FILE::Direction::Read)
+    copied = take_buffered(stream, dst, total);
+  while (copied < total && !stream->eof) {
+    const size_t remaining = total - copied;
+    // Large reads go straight to the destination.
+    if (stream->buffer_mode == _IONBF || remaining >= stream->buffer_size) {
+      const size_t count = stream->read(stream, dst + copied, remaining);
+      if (count == 0)
+        stream->eof = true;
+      copied += count;
+      continue;
+    }
+    const size_t count = stream->read(stream, stream->buffer,
+                                      stream->buffer_size);
+    if (count == 0) {
+      stream->eof = true;
+      continue;
+    }
+    stream->direction = FILE::Direction::Read;
+    stream->pos = 0;
+    stream->end = count;
+    copied += take_buffered(stream, dst + copied, remaining);
+  }
+  return copied / size;
+}
+
+size_t LLVM_LIBC_ENTRYPOINT(fread)(void *__restrict ptr, size_t size,
+                                   size_t nmeb,
+                                   __llvm_libc::FILE *__restrict stream) {
+  FileLock lock(stream);
+  return fread_unlocked(ptr, size, nmeb, stream);
+}
+
+} // namespace __llvm_libc
@@ -7,24 +7,71 @@
 //===----------------------------------------------------------------------===//
 
 #include "src/stdio/fwrite.h"
+#include "include/errno.h" // For E* macros.
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
 #include "src/stdio/FILE.h"
-#include "src/threads/mtx_lock.h"
-#include "src/threads/mtx_unlock.h"
+#include "src/stdio/fflush.h"
+#include "src/string/memcpy.h"
+#include "src/string/memrchr.h"
 
 namespace __llvm_libc {
 
+// Writes `size` bytes straight to the device.
+static size_t write_through(__llvm_libc::FILE *stream, const char *data,
+                            size_t size) {
+  const size_t written = stream->write(stream, data, size);
+  if (written < size)
+    stream->error = true;
+  return written;
+}
+
+// Accumulates small writes in the stream buffer so that many small writes
+// result in few calls to the device.
+static size_t write_buffered(__llvm_libc::FILE *stream, const char *data,
+                             size_t size) {
+  if (stream->pos + size > stream->buffer_size) {
+    if (fflush_unlocked(stream) != 0)
+      return 0;
+    // Large writes bypass the buffer, they would not be coalesced anyway.
+    if (size >= stream->buffer_size)
+      return write_through(stream, data, size);
+  }
+  __llvm_libc::memcpy(stream->buffer + stream->pos, data, size);
+  stream->pos += size;
+  stream->direction = FILE::Direction::Write;
+  // The data is part of the buffer whether or not the flush succeeds, a
+  // failure is reported through the error indicator.
+  if (stream->buffer_mode == _IOLBF &&
+      __llvm_libc::memrchr(data, '\n', size) != nullptr)
+    fflush_unlocked(stream);
+  return size;
+}
+
 size_t fwrite_unlocked(const void *__restrict ptr, size_t size, size_t nmeb,
                        __llvm_libc::FILE *__restrict stream) {
-  return stream->write(stream, reinterpret_cast<const char *>(ptr),
-                       size * nmeb);
+  size_t total;
+  if (__builtin_mul_overflow(size, nmeb, &total)) {
+    llvmlibc_errno = EOVERFLOW;
+    return 0;
+  }
+  if (total == 0)
+    return 0;
+  // Drop read ahead data before writing.
+  if (stream->direction == FILE::Direction::Read)
+    fflush_unlocked(stream);
+  const char *data = reinterpret_cast<const char *>(ptr);
+  const size_t written = stream->buffer_mode == _IONBF
+                             ? write_through(stream, data, total)
+                             : write_buffered(stream, data, total);
+  return written / size;
 }
 
-size_t fwrite(const void *__restrict ptr, size_t size, size_t nmeb,
-              __llvm_libc::FILE *__restrict stream) {
-  __llvm_libc::mtx_lock(&stream->lock);
-  size_t written = fwrite_unlocked(ptr, size, nmeb, stream);
-  __llvm_libc::mtx_unlock(&stream->lock);
-  return written;
+size_t LLVM_LIBC_ENTRYPOINT(fwrite)(const void *__restrict ptr, size_t size,
+                                    size_t nmeb,
+                                    __llvm_libc::FILE *__restrict stream) {
+  FileLock lock(stream);
+  return fwrite_unlocked(ptr, size, nmeb, stream);
 }
 
 } // namespace __llvm_libc
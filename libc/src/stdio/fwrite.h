@@ -17,6 +17,9 @@ namespace __llvm_libc {
 size_t fwrite(const void *__restrict ptr, size_t size, size_t nmeb,
               __llvm_libc::FILE *__restrict stream);
 
+size_t fwrite_unlocked(const void *__restrict ptr, size_t size, size_t nmeb,
+                       __llvm_libc::FILE *__restrict stream);
+
 } // namespace __llvm_libc
 
 #endif // LLVM_LIBC_SRC_STDIO_FWRITE_H
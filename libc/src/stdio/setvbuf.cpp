@@ -0,0 +1,40 @@
+//===-- Implementation of setvbuf -------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/setvbuf.h"
+#include "src/__support/common.h"
+#include "src/stdio/FILE.h"
+#include "src/stdio/fflush.h"
+
+namespace __llvm_libc {
+
+int LLVM_LIBC_ENTRYPOINT(setvbuf)(__llvm_libc::FILE *__restrict stream,
+                                  char *__restrict buf, int mode,
+                                  size_t size) {
+  if (mode != _IOFBF && mode != _IOLBF && mode != _IONBF)
+    return EOF;
+  FileLock lock(stream);
+  // The standard only allows `setvbuf` before any other operation on the
+  // stream, pending data is flushed to be on the safe side.
+  if (fflush_unlocked(stream) != 0)
+    return EOF;
+  stream->buffer_mode = mode;
+  if (mode == _IONBF) {
+    stream->buffer = nullptr;
+    stream->buffer_size = 0;
+  } else if (buf != nullptr && size != 0) {
+    stream->buffer = buf;
+    stream->buffer_size = size;
+  } else {
+    stream->buffer = stream->default_buffer;
+    stream->buffer_size = FILE::kDefaultBufferSize;
+  }
+  return 0;
+}
+
+} // namespace __llvm_libc
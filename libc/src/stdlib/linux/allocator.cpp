@@ -0,0 +1,339 @@
+//===-- Implementation of the llvm-libc allocator -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/linux/allocator.h"
+
+#include "include/errno.h"
+#include "include/sys/mman.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/sys/mman/mmap.h"
+#include "src/sys/mman/munmap.h"
+#include "src/threads/linux/mutex_utils.h"
+
+#include <linux/param.h> // For EXEC_PAGESIZE.
+
+namespace __llvm_libc {
+namespace allocator {
+
+// Design
+// ======
+//
+// - Small objects live in slabs holding objects of a single size class. Free
+//   objects are kept in singly linked lists threaded through the objects.
+// - Caches hold a few free objects of every size class. Most calls only touch
+//   a cache: an uncontended lock, a pop or a push and an unlock.
+// - Central free lists, one per size class, exchange batches of objects with
+//   the caches and carve new objects out of slabs. They are the slow path and
+//   are protected by futex based locks.
+// - Large allocations are mapped and unmapped individually.
+//
+// llvm-libc threads do not have thread local storage yet. Instead of one cache
+// per thread there is a fixed number of caches and a thread picks one from the
+// address of its stack, which is stable for a given thread and differs between
+// threads. Caches are protected by a lock and a thread falls back to another
+// cache when the one it picked is busy.
+
+static constexpr size_t kPageSize = EXEC_PAGESIZE;
+static constexpr unsigned kNumCachesLog2 = 4;
+static constexpr unsigned kNumCaches = 1U << kNumCachesLog2;
+
+// Free objects are linked together. Full batches in the central free lists
+// are linked through their first object.
+struct FreeObject {
+  FreeObject *next;
+  FreeObject *next_batch;
+};
+
+static_assert(sizeof(FreeObject) <= kMinAlignment,
+              "A free object must fit in the smallest size class.");
+
+enum ChunkKind : uint32_t {
+  CK_Slab = 0x51AB51AB,
+  CK_Mapping = 0x3A993A99,
+};
+
+// Lives at the start of every slab and of every large mapping, at the address
+// of the object rounded down to a multiple of `kSlabSize`.
+struct ChunkHeader {
+  uint32_t kind;
+  uint32_t size_class;
+  size_t object_size;
+  // `offset * reciprocal >> 40` is `offset / object_size` for any offset
+  // within a slab, this avoids a division when freeing.
+  uint64_t reciprocal;
+  // The mapping to release for large allocations.
+  char *map_base;
+  size_t map_size;
+};
+
+static_assert(sizeof(ChunkHeader) <= kSlabHeaderSize,
+              "The chunk header does not fit in the space reserved for it.");
+
+class Lock {
+  FutexData futex_word;
+
+public:
+  bool try_lock() { return try_acquire(&futex_word); }
+  void lock() { acquire_futex(&futex_word, nullptr); }
+  void unlock() { release_futex(&futex_word); }
+};
+
+struct FreeList {
+  FreeObject *head;
+  uint32_t count;
+};
+
+struct alignas(64) Cache {
+  Lock lock;
+  FreeList lists[kNumSizeClasses];
+};
+
+struct alignas(64) CentralFreeList {
+  Lock lock;
+  FreeObject *batches;
+  // Objects are carved from [carve_pos, carve_end) on demand so that pages of
+  // a new slab are only touched when they are used.
+  char *carve_pos;
+  char *carve_end;
+};
+
+// Zero initialized: all the locks are free and all the lists empty.
+static Cache caches[kNumCaches];
+static CentralFreeList central_free_lists[kNumSizeClasses];
+
+static inline uintptr_t align_up(uintptr_t value, size_t alignment) {
+  return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static inline ChunkHeader *get_header(const void *ptr) {
+  // Objects never start at the beginning of a chunk, `ptr - 1` keeps pointers
+  // at the end of a chunk in the right one.
+  return reinterpret_cast<ChunkHeader *>(
+      (reinterpret_cast<uintptr_t>(ptr) - 1) & ~(kSlabSize - 1));
+}
+
+static inline char *get_object_start(ChunkHeader *header, const void *ptr) {
+  char *data = reinterpret_cast<char *>(header) + kSlabHeaderSize;
+  const uint64_t offset = static_cast<const char *>(ptr) - data;
+  return data + ((offset * header->reciprocal) >> 40) * header->object_size;
+}
+
+static void *map_pages(size_t size) {
+  void *ptr = __llvm_libc::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+// Returns the pages of [begin, end) to the operating system.
+static void unmap_range(uintptr_t begin, uintptr_t end) {
+  if (begin != end)
+    __llvm_libc::munmap(reinterpret_cast<void *>(begin), end - begin);
+}
+
+// Maps a new slab for `size_class`.
+static ChunkHeader *map_slab(unsigned size_class) {
+  // Map twice the size to find an aligned slab and trim the rest.
+  char *raw = static_cast<char *>(map_pages(2 * kSlabSize));
+  if (raw == nullptr)
+    return nullptr;
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+  const uintptr_t slab = align_up(begin, kSlabSize);
+  unmap_range(begin, slab);
+  unmap_range(slab + kSlabSize, begin + 2 * kSlabSize);
+
+  ChunkHeader *header = reinterpret_cast<ChunkHeader *>(slab);
+  header->kind = CK_Slab;
+  header->size_class = size_class;
+  header->object_size = get_class_size(size_class);
+  header->reciprocal = ((uint64_t(1) << 40) + header->object_size - 1) /
+                       header->object_size;
+  return header;
+}
+
+// Fills `list` with free objects of `size_class` from the central free list.
+// Returns false when out of memory.
+static bool refill(FreeList &list, unsigned size_class) {
+  CentralFreeList &central = central_free_lists[size_class];
+  const unsigned batch_size = get_batch_size(size_class);
+  central.lock.lock();
+  if (FreeObject *batch = central.batches) {
+    central.batches = batch->next_batch;
+    central.lock.unlock();
+    list.head = batch;
+    list.count = batch_size;
+    return true;
+  }
+
+  const size_t object_size = get_class_size(size_class);
+  if (size_t(central.carve_end - central.carve_pos) < object_size) {
+    ChunkHeader *slab = map_slab(size_class);
+    if (slab == nullptr) {
+      central.lock.unlock();
+      return false;
+    }
+    central.carve_pos = reinterpret_cast<char *>(slab) + kSlabHeaderSize;
+    central.carve_end = reinterpret_cast<char *>(slab) + kSlabSize;
+  }
+  FreeObject *head = nullptr;
+  unsigned count = 0;
+  while (count < batch_size &&
+         size_t(central.carve_end - central.carve_pos) >= object_size) {
+    FreeObject *object = reinterpret_cast<FreeObject *>(central.carve_pos);
+    object->next = head;
+    head = object;
+    central.carve_pos += object_size;
+    ++count;
+  }
+  central.lock.unlock();
+  list.head = head;
+  list.count = count;
+  return true;
+}
+
+// Moves a batch of objects from `list` to the central free list.
+// Precondition: `list` holds more than a batch of objects.
+static void flush(FreeList &list, unsigned size_class) {
+  const unsigned batch_size = get_batch_size(size_class);
+  FreeObject *batch = list.head;
+  FreeObject *last = batch;
+  for (unsigned i = 1; i < batch_size; ++i)
+    last = last->next;
+  list.head = last->next;
+  list.count -= batch_size;
+  last->next = nullptr;
+
+  CentralFreeList &central = central_free_lists[size_class];
+  central.lock.lock();
+  batch->next_batch = central.batches;
+  central.batches = batch;
+  central.lock.unlock();
+}
+
+// Locks and returns the cache of the calling thread, or another free cache
+// if that one is in use.
+static Cache &lock_cache() {
+  // Threads created by llvm-libc have stacks of 64 KiB, larger granules would
+  // make neighbouring threads share a cache.
+  const uint64_t stack =
+      reinterpret_cast<uintptr_t>(__builtin_frame_address(0)) >> 16;
+  const unsigned first =
+      static_cast<unsigned>((stack * 0x9E3779B97F4A7C15ULL) >>
+                            (64 - kNumCachesLog2));
+  for (unsigned i = 0; i < kNumCaches; ++i) {
+    Cache &cache = caches[(first + i) % kNumCaches];
+    if (cache.lock.try_lock())
+      return cache;
+  }
+  caches[first].lock.lock();
+  return caches[first];
+}
+
+static void *allocate_small(unsigned size_class) {
+  Cache &cache = lock_cache();
+  FreeList &list = cache.lists[size_class];
+  if (list.head == nullptr && !refill(list, size_class)) {
+    cache.lock.unlock();
+    llvmlibc_errno = ENOMEM;
+    return nullptr;
+  }
+  FreeObject *object = list.head;
+  list.head = object->next;
+  --list.count;
+  cache.lock.unlock();
+  return object;
+}
+
+static void deallocate_small(unsigned size_class, void *ptr) {
+  FreeObject *object = static_cast<FreeObject *>(ptr);
+  Cache &cache = lock_cache();
+  FreeList &list = cache.lists[size_class];
+  object->next = list.head;
+  list.head = object;
+  // Keeping up to two batches lets a thread alternate between allocating and
+  // freeing without going to the central free list each time.
+  if (++list.count > 2 * get_batch_size(size_class))
+    flush(list, size_class);
+  cache.lock.unlock();
+}
+
+// Large allocations get their own mapping. The header is placed at the
+// address of the object rounded down to a multiple of `kSlabSize`, the
+// mapping is over-sized to make room for it and trimmed afterwards.
+static void *allocate_large(size_t size, size_t alignment) {
+  if (size > (SIZE_MAX >> 2) || alignment > (SIZE_MAX >> 2)) {
+    llvmlibc_errno = ENOMEM;
+    return nullptr;
+  }
+  if (alignment < kSlabHeaderSize)
+    alignment = kSlabHeaderSize;
+  const size_t reserved =
+      align_up(size + alignment + kSlabSize + kSlabHeaderSize, kPageSize);
+  char *raw = static_cast<char *>(map_pages(reserved));
+  if (raw == nullptr)
+    return nullptr;
+
+  const uintptr_t begin = reinterpret_cast<uintptr_t>(raw);
+  const uintptr_t user =
+      align_up(align_up(begin, kSlabSize) + kSlabHeaderSize, alignment);
+  ChunkHeader *header = get_header(reinterpret_cast<void *>(user));
+  const uintptr_t header_begin = reinterpret_cast<uintptr_t>(header);
+  const uintptr_t end = align_up(user + size, kPageSize);
+  unmap_range(begin, header_begin);
+  unmap_range(end, begin + reserved);
+
+  header->kind = CK_Mapping;
+  header->map_base = reinterpret_cast<char *>(header);
+  header->map_size = end - header_begin;
+  return reinterpret_cast<void *>(user);
+}
+
+void *allocate(size_t size, size_t alignment) {
+  if (size == 0)
+    size = 1;
+  if (alignment <= kMinAlignment && size <= kMaxSmallSize)
+    return allocate_small(get_size_class(size));
+  // Over-aligned small objects are carved from a larger object, `deallocate`
+  // finds the start of the object from any address within it.
+  if (alignment <= kPageSize && size <= kMaxSmallSize &&
+      size + alignment - kMinAlignment <= kMaxSmallSize) {
+    const size_t padded_size = size + alignment - kMinAlignment;
+    void *ptr = allocate_small(get_size_class(padded_size));
+    if (ptr == nullptr)
+      return nullptr;
+    return reinterpret_cast<void *>(
+        align_up(reinterpret_cast<uintptr_t>(ptr), alignment));
+  }
+  return allocate_large(size, alignment);
+}
+
+void deallocate(void *ptr) {
+  if (ptr == nullptr)
+    return;
+  ChunkHeader *header = get_header(ptr);
+  if (header->kind == CK_Mapping) {
+    __llvm_libc::munmap(header->map_base, header->map_size);
+    return;
+  }
+  deallocate_small(header->size_class, get_object_start(header, ptr));
+}
+
+size_t usable_size(const void *ptr) {
+  ChunkHeader *header = get_header(ptr);
+  const char *end =
+      header->kind == CK_Mapping
+          ? header->map_base + header->map_size
+          : get_object_start(header, ptr) + header->object_size;
+  return end - static_cast<const char *>(ptr);
+}
+
+bool is_fresh_mapping(const void *ptr) {
+  return get_header(ptr)->kind == CK_Mapping;
+}
+
+} // namespace allocator
+} // namespace __llvm_libc
@@ -0,0 +1,86 @@
+//===-- Internal interface of the llvm-libc allocator -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_STDLIB_LINUX_ALLOCATOR_H
+#define LLVM_LIBC_SRC_STDLIB_LINUX_ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace __llvm_libc {
+namespace allocator {
+
+// Small allocations are served from slabs of `kSlabSize` bytes dedicated to a
+// single size class. Slabs are aligned to their size so that the header of the
+// slab owning an object is found by masking the address of the object.
+constexpr size_t kSlabSize = size_t(1) << 18; // 256 KiB
+constexpr size_t kSlabHeaderSize = 64;
+
+// All allocations are aligned to at least `kMinAlignment`. This is also the
+// size of the smallest size class, enough to hold the links of a free object.
+constexpr size_t kMinAlignment = 16;
+
+// Allocations larger than `kMaxSmallSize` get their own mapping.
+constexpr size_t kMaxSmallSize = size_t(1) << 15; // 32 KiB
+
+// Size classes are multiples of 16 bytes up to 128 bytes, then there are 4
+// classes per power of two up to `kMaxSmallSize`. The waste is at most 25%.
+constexpr unsigned kTinyClasses = 8;
+constexpr unsigned kClassesPerDoubling = 4;
+constexpr unsigned kTinyLimitLog2 = 7; // 128 bytes.
+constexpr unsigned kMaxSmallSizeLog2 = 15;
+constexpr unsigned kNumSizeClasses =
+    kTinyClasses + (kMaxSmallSizeLog2 - kTinyLimitLog2) * kClassesPerDoubling;
+
+// Returns the size class of an allocation of `size` bytes.
+// Precondition: `0 < size <= kMaxSmallSize`.
+static inline unsigned get_size_class(size_t size) {
+  if (size <= (size_t(1) << kTinyLimitLog2))
+    return static_cast<unsigned>((size - 1) / kMinAlignment);
+  // `size - 1` lies in [2^log2, 2^(log2 + 1)).
+  const unsigned log2 = 63 - __builtin_clzll(size - 1);
+  const unsigned step_log2 = log2 - 2;
+  const unsigned index = static_cast<unsigned>((size - 1) >> step_log2) & 3;
+  return kTinyClasses + (log2 - kTinyLimitLog2) * kClassesPerDoubling + index;
+}
+
+// Returns the size of the objects of `size_class`.
+static inline size_t get_class_size(unsigned size_class) {
+  if (size_class < kTinyClasses)
+    return (size_class + 1) * kMinAlignment;
+  const unsigned log2 =
+      kTinyLimitLog2 + (size_class - kTinyClasses) / kClassesPerDoubling;
+  const size_t index = (size_class - kTinyClasses) % kClassesPerDoubling;
+  return (size_t(1) << log2) + (index + 1) * (size_t(1) << (log2 - 2));
+}
+
+// Number of objects moved at once between a cache and the central free lists.
+// Small objects move by larger batches to amortize the locking.
+static inline unsigned get_batch_size(unsigned size_class) {
+  const size_t batch = (size_t(1) << 13) / get_class_size(size_class);
+  return batch < 2 ? 2 : batch > 32 ? 32 : static_cast<unsigned>(batch);
+}
+
+// Allocates `size` bytes aligned to `alignment`, a power of two. Returns
+// nullptr and sets errno to ENOMEM on failure.
+void *allocate(size_t size, size_t alignment);
+
+// Returns the memory of an allocation to the allocator. `ptr` may be null.
+void deallocate(void *ptr);
+
+// Returns the number of bytes usable from `ptr`, at least the requested size.
+size_t usable_size(const void *ptr);
+
+// Returns whether the memory at `ptr` comes straight from the operating system
+// and is therefore known to be zero.
+bool is_fresh_mapping(const void *ptr);
+
+} // namespace allocator
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_STDLIB_LINUX_ALLOCATOR_H
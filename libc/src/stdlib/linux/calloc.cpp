@@ -0,0 +1,33 @@
+//===-- Linux implementation of calloc ------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/calloc.h"
+
+#include "include/errno.h"
+#include "src/__support/common.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/linux/allocator.h"
+#include "src/string/memset.h"
+
+namespace __llvm_libc {
+
+void *LLVM_LIBC_ENTRYPOINT(calloc)(size_t num, size_t size) {
+  size_t total;
+  if (__builtin_mul_overflow(num, size, &total)) {
+    llvmlibc_errno = ENOMEM;
+    return nullptr;
+  }
+  void *ptr = allocator::allocate(total, allocator::kMinAlignment);
+  // Large allocations are freshly mapped and already zeroed, clearing them
+  // would only commit their pages early.
+  if (ptr != nullptr && !allocator::is_fresh_mapping(ptr))
+    __llvm_libc::memset(ptr, 0, total);
+  return ptr;
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,37 @@
+//===-- Linux implementation of realloc -----------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/realloc.h"
+
+#include "src/__support/common.h"
+#include "src/stdlib/linux/allocator.h"
+#include "src/string/memcpy.h"
+
+namespace __llvm_libc {
+
+void *LLVM_LIBC_ENTRYPOINT(realloc)(void *ptr, size_t size) {
+  if (ptr == nullptr)
+    return allocator::allocate(size, allocator::kMinAlignment);
+  if (size == 0) {
+    allocator::deallocate(ptr);
+    return nullptr;
+  }
+  // Keep the allocation when it is large enough and does not waste more than
+  // half of its space.
+  const size_t usable = allocator::usable_size(ptr);
+  if (size <= usable && size >= usable / 2)
+    return ptr;
+  void *new_ptr = allocator::allocate(size, allocator::kMinAlignment);
+  if (new_ptr == nullptr)
+    return nullptr;
+  __llvm_libc::memcpy(new_ptr, ptr, size < usable ? size : usable);
+  allocator::deallocate(ptr);
+  return new_ptr;
+}
+
+} // namespace __llvm_libc
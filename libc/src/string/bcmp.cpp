@@ -0,0 +1,51 @@
+//===-- Implementation of bcmp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/bcmp.h"
+#include "src/__support/common.h"
+#include "src/string/memory_utils/memcmp_utils.h"
+
+namespace __llvm_libc {
+
+// `bcmp` only reports whether the buffers are equal. Contrary to `memcmp`
+// there is no need to locate the first mismatching byte, the differences of
+// the two overlapping blocks are simply combined without branching.
+static uint64_t bcmp_impl(const char *a, const char *b, size_t count) {
+  if (count == 0)
+    return 0;
+  if (count == 1)
+    return DiffersBlock<1>(a, b);
+  if (count == 2)
+    return DiffersBlock<2>(a, b);
+  if (count == 3)
+    return DiffersBlockOverlap<2>(a, b, count);
+  if (count == 4)
+    return DiffersBlock<4>(a, b);
+  if (count < 8)
+    return DiffersBlockOverlap<4>(a, b, count);
+  if (count == 8)
+    return DiffersBlock<8>(a, b);
+  if (count < 16)
+    return DiffersBlockOverlap<8>(a, b, count);
+  if (count == 16)
+    return DiffersBlock<16>(a, b);
+  if (count < 32)
+    return DiffersBlockOverlap<16>(a, b, count);
+  if (count < 64)
+    return DiffersBlockOverlap<32>(a, b, count);
+  return DiffersAlignedBlocks<kLoopBlockSize>(a, b, count);
+}
+
+int LLVM_LIBC_ENTRYPOINT(bcmp)(const void *lhs, const void *rhs,
+                               size_t count) {
+  // The difference does not fit an `int`, only report whether it is zero.
+  return bcmp_impl(reinterpret_cast<const char *>(lhs),
+                   reinterpret_cast<const char *>(rhs), count) != 0;
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,60 @@
+//===-- Implementation of memcmp ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memcmp.h"
+#include "src/__support/common.h"
+#include "src/string/memory_utils/memcmp_utils.h"
+
+namespace __llvm_libc {
+
+// Design rationale
+// ================
+//
+// This follows the same size class dispatch as `memcpy`: most calls compare a
+// small number of bytes so the tests for `count` are in ascending order and
+// small sizes are handled with at most two overlapping loads per buffer.
+//
+// Blocks up to 8 bytes are loaded as integers and compared in big endian
+// order. Larger blocks use vector comparisons when available and the position
+// of the first mismatch is extracted from the comparison mask.
+//
+// Large buffers are compared by blocks of `kLoopBlockSize` bytes and the loop
+// exits on the first mismatching block.
+static int memcmp_impl(const char *a, const char *b, size_t count) {
+  if (count == 0)
+    return 0;
+  if (count == 1)
+    return CompareBlock<1>(a, b);
+  if (count == 2)
+    return CompareBlock<2>(a, b);
+  if (count == 3)
+    return CompareBlockOverlap<2>(a, b, count);
+  if (count == 4)
+    return CompareBlock<4>(a, b);
+  if (count < 8)
+    return CompareBlockOverlap<4>(a, b, count);
+  if (count == 8)
+    return CompareBlock<8>(a, b);
+  if (count < 16)
+    return CompareBlockOverlap<8>(a, b, count);
+  if (count == 16)
+    return CompareBlock<16>(a, b);
+  if (count < 32)
+    return CompareBlockOverlap<16>(a, b, count);
+  if (count < 64)
+    return CompareBlockOverlap<32>(a, b, count);
+  return CompareAlignedBlocks<kLoopBlockSize>(a, b, count);
+}
+
+int LLVM_LIBC_ENTRYPOINT(memcmp)(const void *lhs, const void *rhs,
+                                 size_t count) {
+  return memcmp_impl(reinterpret_cast<const char *>(lhs),
+                     reinterpret_cast<const char *>(rhs), count);
+}
+
+} // namespace __llvm_libc
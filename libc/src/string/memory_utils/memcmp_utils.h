@@ -0,0 +1,238 @@
+//===-- Memcmp utils --------------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIBC_SRC_STRING_MEMORY_UTILS_MEMCMP_UTILS_H
+#define LIBC_SRC_STRING_MEMORY_UTILS_MEMCMP_UTILS_H
+
+#include "src/string/memory_utils/utils.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uint16_t, uint32_t, uint64_t
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace __llvm_libc {
+
+// Loads a `T` from possibly unaligned memory.
+template <typename T> static T LoadUnaligned(const char *ptr) {
+  T value;
+  __builtin_memcpy(&value, ptr, sizeof(T));
+  return value;
+}
+
+// Converts a loaded value so that comparing two values as integers gives the
+// same result as comparing their bytes lexicographically.
+static inline uint16_t ToBigEndian(uint16_t value) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return __builtin_bswap16(value);
+#else
+  return value;
+#endif
+}
+static inline uint32_t ToBigEndian(uint32_t value) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return __builtin_bswap32(value);
+#else
+  return value;
+#endif
+}
+static inline uint64_t ToBigEndian(uint64_t value) {
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+  return __builtin_bswap64(value);
+#else
+  return value;
+#endif
+}
+
+// Returns the difference between the bytes at `index` in `a` and `b`.
+static inline int ByteDifference(const char *a, const char *b, size_t index) {
+  return static_cast<int>(static_cast<unsigned char>(a[index])) -
+         static_cast<int>(static_cast<unsigned char>(b[index]));
+}
+
+// Compares blocks of `kBlockSize` bytes.
+// - `Differs` returns zero if the blocks are equal and a non-zero value
+//   otherwise, it is used by `bcmp`.
+// - `Compare` returns a negative, zero or positive value depending on the
+//   lexicographic order of the blocks, it is used by `memcmp`.
+//
+// Blocks that are larger than the largest native type are compared half by
+// half.
+template <size_t kBlockSize> struct BlockComparator {
+  static_assert(is_power2(kBlockSize), "kBlockSize must be a power of 2");
+  static constexpr size_t kHalf = kBlockSize / 2;
+  using Half = BlockComparator<kHalf>;
+
+  static uint64_t Differs(const char *a, const char *b) {
+    // Not branchy, the equality case is the one that needs to be fast.
+    return Half::Differs(a, b) | Half::Differs(a + kHalf, b + kHalf);
+  }
+
+  static int Compare(const char *a, const char *b) {
+    if (const int result = Half::Compare(a, b))
+      return result;
+    return Half::Compare(a + kHalf, b + kHalf);
+  }
+};
+
+// Blocks that fit a scalar register.
+template <typename T> struct ScalarComparator {
+  static uint64_t Differs(const char *a, const char *b) {
+    return LoadUnaligned<T>(a) ^ LoadUnaligned<T>(b);
+  }
+
+  static int Compare(const char *a, const char *b) {
+    const T x = ToBigEndian(LoadUnaligned<T>(a));
+    const T y = ToBigEndian(LoadUnaligned<T>(b));
+    return (x > y) - (x < y);
+  }
+};
+
+template <> struct BlockComparator<1> {
+  static uint64_t Differs(const char *a, const char *b) {
+    return LoadUnaligned<uint8_t>(a) ^ LoadUnaligned<uint8_t>(b);
+  }
+
+  static int Compare(const char *a, const char *b) {
+    return ByteDifference(a, b, 0);
+  }
+};
+template <> struct BlockComparator<2> : ScalarComparator<uint16_t> {};
+template <> struct BlockComparator<4> : ScalarComparator<uint32_t> {};
+template <> struct BlockComparator<8> : ScalarComparator<uint64_t> {};
+
+// Blocks that fit a vector register, `MismatchMask` returns a mask of the
+// bytes that differ: bit `i` is set when `a[i] != b[i]`.
+template <typename Vector> struct VectorComparator {
+  static uint64_t Differs(const char *a, const char *b) {
+    return Vector::MismatchMask(a, b);
+  }
+
+  static int Compare(const char *a, const char *b) {
+    const uint32_t mask = Vector::MismatchMask(a, b);
+    return mask ? ByteDifference(a, b, __builtin_ctz(mask)) : 0;
+  }
+};
+
+#if defined(__SSE2__)
+struct Sse2Vector {
+  static uint32_t MismatchMask(const char *a, const char *b) {
+    const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i *>(a));
+    const __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i *>(b));
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) ^ 0xFFFFU;
+  }
+};
+template <> struct BlockComparator<16> : VectorComparator<Sse2Vector> {};
+#endif
+
+#if defined(__AVX2__)
+struct Avx2Vector {
+  static uint32_t MismatchMask(const char *a, const char *b) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(a));
+    const __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(b));
+    return ~static_cast<uint32_t>(
+        _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)));
+  }
+};
+template <> struct BlockComparator<32> : VectorComparator<Avx2Vector> {};
+#endif
+
+// The block size used when comparing large buffers.
+#if defined(__AVX2__)
+static constexpr size_t kLoopBlockSize = 32;
+#else
+static constexpr size_t kLoopBlockSize = 16;
+#endif
+
+// Compares `kBlockSize` bytes at `a` and `b`.
+template <size_t kBlockSize>
+static uint64_t DiffersBlock(const char *a, const char *b) {
+  return BlockComparator<kBlockSize>::Differs(a, b);
+}
+
+template <size_t kBlockSize>
+static int CompareBlock(const char *a, const char *b) {
+  return BlockComparator<kBlockSize>::Compare(a, b);
+}
+
+// Compares `kBlockSize` bytes from `a + count - kBlockSize` and
+// `b + count - kBlockSize`.
+// Precondition: `count >= kBlockSize`.
+template <size_t kBlockSize>
+static uint64_t DiffersLastBlock(const char *a, const char *b, size_t count) {
+  const size_t offset = count - kBlockSize;
+  return DiffersBlock<kBlockSize>(a + offset, b + offset);
+}
+
+template <size_t kBlockSize>
+static int CompareLastBlock(const char *a, const char *b, size_t count) {
+  const size_t offset = count - kBlockSize;
+  return CompareBlock<kBlockSize>(a + offset, b + offset);
+}
+
+// Compares `kBlockSize` bytes twice with an overlap between the two.
+//
+// [1234567812345678123]
+// [__XXXXXXXXXXXXXX___]
+// [__XXXXXXXX_________]
+// [________XXXXXXXX___]
+//
+// The overlapping bytes are known to be equal when the second block is
+// compared so the first mismatch of the second block is the first mismatch of
+// the whole range.
+//
+// Precondition: `count >= kBlockSize && count <= 2 * kBlockSize`.
+template <size_t kBlockSize>
+static uint64_t DiffersBlockOverlap(const char *a, const char *b,
+                                    size_t count) {
+  return DiffersBlock<kBlockSize>(a, b) |
+         DiffersLastBlock<kBlockSize>(a, b, count);
+}
+
+template <size_t kBlockSize>
+static int CompareBlockOverlap(const char *a, const char *b, size_t count) {
+  if (const int result = CompareBlock<kBlockSize>(a, b))
+    return result;
+  return CompareLastBlock<kBlockSize>(a, b, count);
+}
+
+// Compares `count` bytes by blocks of `kBlockSize` bytes and exits on the
+// first mismatching block.
+// Loads at the start and end of the buffer are unaligned.
+// Loads in the middle of the buffer are aligned to `kBlockSize` for `a`.
+//
+// Precondition: `count > 2 * kBlockSize` for efficiency.
+//               `count >= kBlockSize` for correctness.
+template <size_t kBlockSize>
+static uint64_t DiffersAlignedBlocks(const char *a, const char *b,
+                                     size_t count) {
+  if (const uint64_t result = DiffersBlock<kBlockSize>(a, b))
+    return result;
+  size_t offset = kBlockSize - offset_from_last_aligned<kBlockSize>(a);
+  for (; offset + kBlockSize < count; offset += kBlockSize)
+    if (const uint64_t result = DiffersBlock<kBlockSize>(a + offset, b + offset))
+      return result;
+  return DiffersLastBlock<kBlockSize>(a, b, count);
+}
+
+template <size_t kBlockSize>
+static int CompareAlignedBlocks(const char *a, const char *b, size_t count) {
+  if (const int result = CompareBlock<kBlockSize>(a, b))
+    return result;
+  size_t offset = kBlockSize - offset_from_last_aligned<kBlockSize>(a);
+  for (; offset + kBlockSize < count; offset += kBlockSize)
+    if (const int result = CompareBlock<kBlockSize>(a + offset, b + offset))
+      return result;
+  return CompareLastBlock<kBlockSize>(a, b, count);
+}
+
+} // namespace __llvm_libc
+
+#endif //  LIBC_SRC_STRING_MEMORY_UTILS_MEMCMP_UTILS_H
@@ -0,0 +1,428 @@
+//===-- String scanning utils -----------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LIBC_SRC_STRING_MEMORY_UTILS_SCAN_UTILS_H
+#define LIBC_SRC_STRING_MEMORY_UTILS_SCAN_UTILS_H
+
+#include "src/string/memory_utils/utils.h"
+
+#include <stddef.h> // size_t
+#include <stdint.h> // uintptr_t
+
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+namespace __llvm_libc {
+
+// Design rationale
+// ================
+//
+// The functions in this file look for a byte (or a null terminator) by
+// processing `Scanner::kSize` bytes at a time. A `Scanner` knows how to load a
+// block, how to compare it and how to turn the comparison into a `Mask`: a
+// bitfield with `kMaskBitsPerByte` bits per byte where the highest bit of each
+// group is set when the corresponding byte matches.
+//
+// String functions don't know the size of their input in advance so they may
+// read past the end of the string. This is safe as long as the read does not
+// cross a page boundary: memory protection works at page granularity, so a
+// block that contains at least one valid byte and that does not cross a page
+// is fully readable. This is achieved by only loading blocks aligned to
+// `Scanner::kSize`, and by discarding the bytes outside of the input from the
+// resulting mask. `strcmp` can't align both of its inputs at the same time, so
+// it explicitly checks that an unaligned block does not cross a page.
+//
+// Such out of bounds reads are invisible to the program but they will be
+// reported by memory sanitizers.
+
+// The smallest page size of all supported architectures.
+static constexpr size_t kScanPageSize = 4096;
+
+// A set of bytes stored as a 256 bits bitmap. The bitmap is laid out so that
+// vector scanners can look it up with byte shuffles: row `n` of `low_rows`
+// (resp. `high_rows`) holds the bytes whose low nibble is `n`, bit `b` of the
+// row being set when byte `b << 4 | n` (resp. `(b + 8) << 4 | n`) is present.
+struct ByteSet {
+  alignas(16) uint8_t low_rows[16] = {0};
+  alignas(16) uint8_t high_rows[16] = {0};
+
+  // Builds the set of bytes of the null terminated string `bytes`.
+  explicit ByteSet(const char *bytes) {
+    for (; *bytes; ++bytes)
+      set(*bytes);
+  }
+
+  void set(unsigned char value) {
+    uint8_t *const rows = value < 0x80 ? low_rows : high_rows;
+    rows[value & 0xF] |= uint8_t(1) << ((value >> 4) & 7);
+  }
+
+  bool test(unsigned char value) const {
+    const uint8_t *const rows = value < 0x80 ? low_rows : high_rows;
+    return rows[value & 0xF] & (uint8_t(1) << ((value >> 4) & 7));
+  }
+};
+
+// Word-at-a-time scanner, also known as SIMD Within A Register (SWAR).
+// Available on all architectures.
+struct WordScanner {
+  using Type = uintptr_t;
+  using Mask = uintptr_t;
+  static constexpr size_t kSize = sizeof(Type);
+  static constexpr size_t kMaskBitsPerByte = 8;
+
+  static constexpr Type kLowBits = ~Type(0) / 0xFF; // 0x0101...01
+  static constexpr Type kHighBits = kLowBits << 7;  // 0x8080...80
+  static constexpr Mask kAllBytes = kHighBits;
+
+  // Bytes are reordered so that the first byte in memory is always the least
+  // significant one.
+  static Type load(const char *src) {
+    Type value;
+    __builtin_memcpy(&value, src, kSize);
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    if (kSize == 8)
+      value = __builtin_bswap64(value);
+    else
+      value = __builtin_bswap32(value);
+#endif
+    return value;
+  }
+
+  static Type splat(unsigned char value) { return kLowBits * value; }
+
+  // Sets the high bit of each zero byte in `value`. Contrary to the usual
+  // `(value - kLowBits) & ~value & kHighBits` trick, this version can't carry
+  // from one byte to the next and is exact for all bytes.
+  static Mask zeros(Type value) {
+    const Type kLow7Bits = ~kHighBits;
+    return ~(((value & kLow7Bits) + kLow7Bits) | value | kLow7Bits);
+  }
+
+  static Mask equals(Type a, Type b) { return zeros(a ^ b); }
+};
+
+#if defined(__SSE2__)
+// 16 Bytes at a time scanner using SSE2 instructions.
+struct Sse2Scanner {
+  using Type = __m128i;
+  using Mask = uint32_t;
+  static constexpr size_t kSize = 16;
+  static constexpr size_t kMaskBitsPerByte = 1;
+  static constexpr Mask kAllBytes = 0xFFFF;
+
+  static Type load(const char *src) {
+    return _mm_loadu_si128(reinterpret_cast<const Type *>(src));
+  }
+
+  static Type splat(unsigned char value) {
+    return _mm_set1_epi8(static_cast<char>(value));
+  }
+
+  static Mask equals(Type a, Type b) {
+    return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b));
+  }
+
+  static Mask zeros(Type value) { return equals(value, _mm_setzero_si128()); }
+
+#if defined(__SSSE3__)
+  // Sets the bits of the bytes of `value` that belong to `set`.
+  static Mask in_set(Type value, const ByteSet &set) {
+    const Type low_rows = load(reinterpret_cast<const char *>(set.low_rows));
+    const Type high_rows = load(reinterpret_cast<const char *>(set.high_rows));
+    // `pshufb` yields zero for indices with the high bit set, so each byte
+    // picks its row from either `low_rows` or `high_rows`.
+    const Type rows = _mm_or_si128(
+        _mm_shuffle_epi8(low_rows, value),
+        _mm_shuffle_epi8(high_rows, _mm_xor_si128(value, splat(0x80))));
+    const Type high_nibbles =
+        _mm_and_si128(_mm_srli_epi16(value, 4), splat(0x0F));
+    const Type bits = _mm_shuffle_epi8(
+        _mm_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64,
+                      -128),
+        high_nibbles);
+    return equals(_mm_and_si128(rows, bits), bits);
+  }
+#endif // __SSSE3__
+};
+#endif // __SSE2__
+
+#if defined(__AVX2__)
+// 32 Bytes at a time scanner using AVX2 instructions.
+struct Avx2Scanner {
+  using Type = __m256i;
+  using Mask = uint32_t;
+  static constexpr size_t kSize = 32;
+  static constexpr size_t kMaskBitsPerByte = 1;
+  static constexpr Mask kAllBytes = 0xFFFFFFFF;
+
+  static Type load(const char *src) {
+    return _mm256_loadu_si256(reinterpret_cast<const Type *>(src));
+  }
+
+  static Type splat(unsigned char value) {
+    return _mm256_set1_epi8(static_cast<char>(value));
+  }
+
+  static Mask equals(Type a, Type b) {
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b));
+  }
+
+  static Mask zeros(Type value) {
+    return equals(value, _mm256_setzero_si256());
+  }
+
+  // Sets the bits of the bytes of `value` that belong to `set`.
+  // See `Sse2Scanner::in_set` for details, `vpshufb` operates on each 16 Bytes
+  // lane independently so the rows are duplicated.
+  static Mask in_set(Type value, const ByteSet &set) {
+    const Type low_rows = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(set.low_rows)));
+    const Type high_rows = _mm256_broadcastsi128_si256(
+        _mm_load_si128(reinterpret_cast<const __m128i *>(set.high_rows)));
+    const Type rows = _mm256_or_si256(
+        _mm256_shuffle_epi8(low_rows, value),
+        _mm256_shuffle_epi8(high_rows, _mm256_xor_si256(value, splat(0x80))));
+    const Type high_nibbles =
+        _mm256_and_si256(_mm256_srli_epi16(value, 4), splat(0x0F));
+    const Type bits = _mm256_shuffle_epi8(
+        _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64,
+                         -128, 1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16,
+                         32, 64, -128),
+        high_nibbles);
+    return equals(_mm256_and_si256(rows, bits), bits);
+  }
+};
+#endif // __AVX2__
+
+// The widest scanner available for the current compilation flags.
+#if defined(__AVX2__)
+using NativeScanner = Avx2Scanner;
+#elif defined(__SSE2__)
+using NativeScanner = Sse2Scanner;
+#else
+using NativeScanner = WordScanner;
+#endif
+
+// The widest scanner able to look up a `ByteSet`, if any.
+#if defined(__AVX2__)
+#define LLVM_LIBC_HAS_SET_SCANNER
+using SetScanner = Avx2Scanner;
+#elif defined(__SSSE3__)
+#define LLVM_LIBC_HAS_SET_SCANNER
+using SetScanner = Sse2Scanner;
+#endif
+
+// Returns the index of the first matching byte in `mask`.
+// Precondition: `mask != 0`.
+template <typename Scanner>
+static inline size_t first_index(typename Scanner::Mask mask) {
+  return __builtin_ctzll(mask) / Scanner::kMaskBitsPerByte;
+}
+
+// Returns the index of the last matching byte in `mask`.
+// Precondition: `mask != 0`.
+template <typename Scanner>
+static inline size_t last_index(typename Scanner::Mask mask) {
+  return (63 - __builtin_clzll(mask)) / Scanner::kMaskBitsPerByte;
+}
+
+// Clears the first `count` bytes of `mask`.
+// Precondition: `count < Scanner::kSize`.
+template <typename Scanner>
+static inline typename Scanner::Mask drop_leading(typename Scanner::Mask mask,
+                                                  size_t count) {
+  using Mask = typename Scanner::Mask;
+  return mask & (~Mask(0) << (count * Scanner::kMaskBitsPerByte));
+}
+
+// Keeps only the first `count` bytes of `mask`.
+// Precondition: `count <= Scanner::kSize`.
+template <typename Scanner>
+static inline typename Scanner::Mask keep_leading(typename Scanner::Mask mask,
+                                                  size_t count) {
+  using Mask = typename Scanner::Mask;
+  if (count == Scanner::kSize)
+    return mask;
+  return mask & ~(~Mask(0) << (count * Scanner::kMaskBitsPerByte));
+}
+
+// Returns the `Scanner::kSize` aligned block containing `ptr`.
+template <typename Scanner>
+static inline const char *block_containing(const char *ptr) {
+  return ptr - offset_from_last_aligned<Scanner::kSize>(ptr);
+}
+
+// Returns whether reading `Scanner::kSize` bytes from `ptr` crosses a page.
+template <typename Scanner> static inline bool crosses_page(const char *ptr) {
+  return static_cast<size_t>(offset_from_last_aligned<kScanPageSize>(ptr)) >
+         kScanPageSize - Scanner::kSize;
+}
+
+// Returns the length of the null terminated string `src`.
+template <typename Scanner> static inline size_t string_length(const char *src) {
+  const char *block = block_containing<Scanner>(src);
+  auto mask = drop_leading<Scanner>(Scanner::zeros(Scanner::load(block)),
+                                    src - block);
+  while (!mask) {
+    block += Scanner::kSize;
+    mask = Scanner::zeros(Scanner::load(block));
+  }
+  return block + first_index<Scanner>(mask) - src;
+}
+
+// Returns a pointer to the first occurrence of `value` in the `count` first
+// bytes of `src` or nullptr if there is none.
+template <typename Scanner>
+static inline const char *find_first_byte(const char *src, unsigned char value,
+                                          size_t count) {
+  if (count == 0)
+    return nullptr;
+  const auto needle = Scanner::splat(value);
+  const char *block = block_containing<Scanner>(src);
+  const size_t offset = src - block;
+  // Number of bytes left to scan, counted from the start of `block`. Callers
+  // may pass SIZE_MAX for unbounded searches so we saturate.
+  size_t remaining = count > SIZE_MAX - offset ? SIZE_MAX : count + offset;
+  auto mask = drop_leading<Scanner>(
+      Scanner::equals(Scanner::load(block), needle), offset);
+  for (;;) {
+    if (remaining <= Scanner::kSize) {
+      mask = keep_leading<Scanner>(mask, remaining);
+      return mask ? block + first_index<Scanner>(mask) : nullptr;
+    }
+    if (mask)
+      return block + first_index<Scanner>(mask);
+    block += Scanner::kSize;
+    remaining -= Scanner::kSize;
+    mask = Scanner::equals(Scanner::load(block), needle);
+  }
+}
+
+// Returns a pointer to the last occurrence of `value` in the `count` first
+// bytes of `src` or nullptr if there is none.
+template <typename Scanner>
+static inline const char *find_last_byte(const char *src, unsigned char value,
+                                         size_t count) {
+  if (count == 0)
+    return nullptr;
+  const auto needle = Scanner::splat(value);
+  const char *last = src + count - 1;
+  const char *block = block_containing<Scanner>(last);
+  auto mask = keep_leading<Scanner>(
+      Scanner::equals(Scanner::load(block), needle), last - block + 1);
+  for (;;) {
+    if (block <= src) {
+      mask = drop_leading<Scanner>(mask, src - block);
+      return mask ? block + last_index<Scanner>(mask) : nullptr;
+    }
+    if (mask)
+      return block + last_index<Scanner>(mask);
+    block -= Scanner::kSize;
+    mask = Scanner::equals(Scanner::load(block), needle);
+  }
+}
+
+// Returns a pointer to the first occurrence of `value` in the null terminated
+// string `src` or nullptr if there is none. The null terminator is considered
+// part of the string.
+template <typename Scanner>
+static inline const char *find_first_char(const char *src,
+                                          unsigned char value) {
+  const auto needle = Scanner::splat(value);
+  const char *block = block_containing<Scanner>(src);
+  auto data = Scanner::load(block);
+  auto mask = drop_leading<Scanner>(
+      Scanner::zeros(data) | Scanner::equals(data, needle), src - block);
+  while (!mask) {
+    block += Scanner::kSize;
+    data = Scanner::load(block);
+    mask = Scanner::zeros(data) | Scanner::equals(data, needle);
+  }
+  const char *found = block + first_index<Scanner>(mask);
+  return static_cast<unsigned char>(*found) == value ? found : nullptr;
+}
+
+// Returns a pointer to the last occurrence of `value` in the null terminated
+// string `src` or nullptr if there is none. The null terminator is considered
+// part of the string.
+template <typename Scanner>
+static inline const char *find_last_char(const char *src, unsigned char value) {
+  const auto needle = Scanner::splat(value);
+  const char *block = block_containing<Scanner>(src);
+  const char *found = nullptr;
+  auto data = Scanner::load(block);
+  auto zeros = drop_leading<Scanner>(Scanner::zeros(data), src - block);
+  auto matches =
+      drop_leading<Scanner>(Scanner::equals(data, needle), src - block);
+  while (!zeros) {
+    if (matches)
+      found = block + last_index<Scanner>(matches);
+    block += Scanner::kSize;
+    data = Scanner::load(block);
+    zeros = Scanner::zeros(data);
+    matches = Scanner::equals(data, needle);
+  }
+  // Only consider matches up to and including the null terminator.
+  matches = keep_leading<Scanner>(matches, first_index<Scanner>(zeros) + 1);
+  return matches ? block + last_index<Scanner>(matches) : found;
+}
+
+// Returns a pointer to the first byte of the null terminated string `src` that
+// is in `set` (resp. not in `set` when `complement` is true). Returns a pointer
+// to the null terminator if there is none.
+// Precondition: `set` does not contain the null terminator.
+template <typename Scanner>
+static inline const char *find_first_of_set(const char *src, const ByteSet &set,
+                                            bool complement) {
+  const typename Scanner::Mask flip = complement ? Scanner::kAllBytes : 0;
+  const char *block = block_containing<Scanner>(src);
+  auto data = Scanner::load(block);
+  // The null terminator is never part of `set` so in the complement case it is
+  // already selected by the flipped mask.
+  auto mask = drop_leading<Scanner>(
+      Scanner::zeros(data) | (Scanner::in_set(data, set) ^ flip), src - block);
+  while (!mask) {
+    block += Scanner::kSize;
+    data = Scanner::load(block);
+    mask = Scanner::zeros(data) | (Scanner::in_set(data, set) ^ flip);
+  }
+  return block + first_index<Scanner>(mask);
+}
+
+// Lexicographically compares the null terminated strings `left` and `right`.
+template <typename Scanner>
+static inline int compare_strings(const char *left, const char *right) {
+  for (;;) {
+    if (crosses_page<Scanner>(left) || crosses_page<Scanner>(right)) {
+      // Compare the next block byte per byte, this moves both pointers past
+      // the page boundary.
+      for (size_t i = 0; i < Scanner::kSize; ++i, ++left, ++right)
+        if (*left == '\0' || *left != *right)
+          return static_cast<unsigned char>(*left) -
+                 static_cast<unsigned char>(*right);
+      continue;
+    }
+    const auto a = Scanner::load(left);
+    const auto b = Scanner::load(right);
+    const auto mask =
+        Scanner::zeros(a) | (Scanner::equals(a, b) ^ Scanner::kAllBytes);
+    if (mask) {
+      const size_t index = first_index<Scanner>(mask);
+      return static_cast<unsigned char>(left[index]) -
+             static_cast<unsigned char>(right[index]);
+    }
+    left += Scanner::kSize;
+    right += Scanner::kSize;
+  }
+}
+
+} // namespace __llvm_libc
+
+#endif //  LIBC_SRC_STRING_MEMORY_UTILS_SCAN_UTILS_H
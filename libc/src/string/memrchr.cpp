@@ -8,19 +8,14 @@
 
 #include "src/string/memrchr.h"
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 #include <stddef.h>
 
 namespace __llvm_libc {
 
 void *LLVM_LIBC_ENTRYPOINT(memrchr)(const void *src, int c, size_t n) {
-  const unsigned char *str = reinterpret_cast<const unsigned char *>(src);
-  const unsigned char ch = c;
-  for (; n != 0; --n) {
-    const unsigned char *s = str + n - 1;
-    if (*s == ch)
-      return const_cast<unsigned char *>(s);
-  }
-  return nullptr;
+  return const_cast<char *>(find_last_byte<NativeScanner>(
+      reinterpret_cast<const char *>(src), c, n));
 }
 
 } // namespace __llvm_libc
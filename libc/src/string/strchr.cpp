@@ -9,17 +9,12 @@
 #include "src/string/strchr.h"
 
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 
 namespace __llvm_libc {
 
-// TODO: Look at performance benefits of comparing words.
 char *LLVM_LIBC_ENTRYPOINT(strchr)(const char *src, int c) {
-  unsigned char *str =
-      const_cast<unsigned char *>(reinterpret_cast<const unsigned char *>(src));
-  const unsigned char ch = c;
-  for (; *str && *str != ch; ++str)
-    ;
-  return *str == ch ? reinterpret_cast<char *>(str) : nullptr;
+  return const_cast<char *>(find_first_char<NativeScanner>(src, c));
 }
 
 } // namespace __llvm_libc
@@ -9,25 +9,37 @@
 #ifndef LIBC_SRC_STRING_STRING_UTILS_H
 #define LIBC_SRC_STRING_STRING_UTILS_H
 
-#include "src/string/memory_utils/utils.h"
+#include "src/string/memory_utils/scan_utils.h"
 
-#include "utils/CPP/Bitset.h"
 #include <stddef.h> // size_t
 
 namespace __llvm_libc {
 namespace internal {
 
+// Returns the length of the initial part of 'src' that has no byte in 'set'
+// (resp. in the complement of 'set' when 'complement' is true).
+static inline size_t set_span(const char *src, const ByteSet &set,
+                              bool complement) {
+#if defined(LLVM_LIBC_HAS_SET_SCANNER)
+  return find_first_of_set<SetScanner>(src, set, complement) - src;
+#else
+  const char *initial = src;
+  for (; *src && set.test(*src) == complement; ++src)
+    ;
+  return src - initial;
+#endif
+}
+
 // Returns the maximum length span that contains only characters not found in
 // 'segment'. If no characters are found, returns the length of 'src'.
 static inline size_t complementary_span(const char *src, const char *segment) {
-  const char *initial = src;
-  cpp::Bitset<256> bitset;
+  return set_span(src, ByteSet(segment), /*complement=*/false);
+}
 
-  for (; *segment; ++segment)
-    bitset.set(*segment);
-  for (; *src && !bitset.test(*src); ++src)
-    ;
-  return src - initial;
+// Returns the maximum length span that contains only characters found in
+// 'segment'.
+static inline size_t span(const char *src, const char *segment) {
+  return set_span(src, ByteSet(segment), /*complement=*/true);
 }
 
 } // namespace internal
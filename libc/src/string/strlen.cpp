@@ -9,16 +9,12 @@
 #include "src/string/strlen.h"
 
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 
 namespace __llvm_libc {
 
-// TODO: investigate the performance of this function.
-// There might be potential for compiler optimization.
 size_t LLVM_LIBC_ENTRYPOINT(strlen)(const char *src) {
-  const char *end = src;
-  while (*end != '\0')
-    ++end;
-  return end - src;
+  return string_length<NativeScanner>(src);
 }
 
 } // namespace __llvm_libc
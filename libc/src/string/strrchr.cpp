@@ -9,17 +9,12 @@
 #include "src/string/strrchr.h"
 
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 
 namespace __llvm_libc {
 
 char *LLVM_LIBC_ENTRYPOINT(strrchr)(const char *src, int c) {
-  const char ch = c;
-  char *last_occurrence = nullptr;
-  do {
-    if (*src == ch)
-      last_occurrence = const_cast<char *>(src);
-  } while (*src++);
-  return last_occurrence;
+  return const_cast<char *>(find_last_char<NativeScanner>(src, c));
 }
 
 } // namespace __llvm_libc
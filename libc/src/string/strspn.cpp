@@ -9,20 +9,12 @@
 #include "src/string/strspn.h"
 
 #include "src/__support/common.h"
-#include "utils/CPP/Bitset.h"
-#include <stddef.h>
+#include "src/string/string_utils.h"
 
 namespace __llvm_libc {
 
 size_t LLVM_LIBC_ENTRYPOINT(strspn)(const char *src, const char *segment) {
-  const char *initial = src;
-  cpp::Bitset<256> bitset;
-
-  for (; *segment; ++segment)
-    bitset.set(*segment);
-  for (; *src && bitset.test(*src); ++src)
-    ;
-  return src - initial;
+  return internal::span(src, segment);
 }
 
 } // namespace __llvm_libc
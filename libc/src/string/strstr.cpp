@@ -9,21 +9,206 @@
 #include "src/string/strstr.h"
 
 #include "src/__support/common.h"
+#include "src/string/memory_utils/scan_utils.h"
 #include <stddef.h>
 
 namespace __llvm_libc {
 
-// TODO: This is a simple brute force implementation. This can be
-// improved upon using well known string matching algorithms.
-char *LLVM_LIBC_ENTRYPOINT(strstr)(const char *haystack, const char *needle) {
-  for (size_t i = 0; haystack[i]; ++i) {
-    size_t j;
-    for (j = 0; haystack[i + j] && haystack[i + j] == needle[j]; ++j)
-      ;
-    if (!needle[j])
-      return const_cast<char *>(haystack + i);
+// Design rationale
+// ================
+//
+// - Needles of a single character are delegated to the `strchr` kernel.
+// - Short needles go through a vectorized filter: for a whole block of
+//   candidate positions we check at once that the first and the last byte of
+//   the needle match, and only the surviving positions are fully compared. A
+//   comparison costs at most `kMaxFilteredNeedleSize` bytes so the search is
+//   linear even for adversarial inputs.
+// - Longer needles use the Two-Way algorithm (Crochemore M., Perrin D.
+//   "Two-way string-matching", Journal of the ACM 38(3):651-675, 1991) which
+//   runs in linear time and constant space. A bad character table allows
+//   skipping most of the haystack on typical inputs.
+//
+// The end of the haystack is discovered lazily so that finding the needle
+// near the start of a long haystack does not pay for a full `strlen`.
+
+static constexpr size_t kMaxFilteredNeedleSize = 32;
+
+// Keeps track of the part of the haystack that is known to be free of null
+// terminator.
+class HaystackEnd {
+  const char *end;         // [haystack, end) contains no null terminator.
+  bool terminated = false; // Whether `end` points to the null terminator.
+
+public:
+  explicit HaystackEnd(const char *haystack) : end(haystack) {}
+
+  // Returns whether [haystack, limit) is part of the haystack.
+  bool reaches(const char *limit) {
+    if (limit <= end)
+      return true;
+    if (terminated)
+      return false;
+    // Look further than strictly needed to amortize the calls.
+    const size_t grow = (limit - end) | 255;
+    const char *zero = find_first_byte<NativeScanner>(end, '\0', grow);
+    if (!zero) {
+      end += grow;
+      return true;
+    }
+    end = zero;
+    terminated = true;
+    return limit <= end;
   }
+};
+
+static inline bool equal_bytes(const char *a, const char *b, size_t count) {
+  for (size_t i = 0; i < count; ++i)
+    if (a[i] != b[i])
+      return false;
+  return true;
+}
+
+// Precondition: `2 <= needle_size <= kMaxFilteredNeedleSize`.
+template <typename Scanner>
+static const char *find_short_needle(const char *haystack, const char *needle,
+                                     size_t needle_size) {
+  const auto first = Scanner::splat(needle[0]);
+  const auto last = Scanner::splat(needle[needle_size - 1]);
+  HaystackEnd haystack_end(haystack);
+  const char *pos = haystack;
+  // Candidates [pos, pos + kSize) need bytes up to `pos + needle_size - 1 +
+  // kSize` to be readable.
+  while (haystack_end.reaches(pos + needle_size - 1 + Scanner::kSize)) {
+    auto mask = Scanner::equals(Scanner::load(pos), first) &
+                Scanner::equals(Scanner::load(pos + needle_size - 1), last);
+    while (mask) {
+      const char *candidate = pos + first_index<Scanner>(mask);
+      if (equal_bytes(candidate + 1, needle + 1, needle_size - 2))
+        return candidate;
+      mask &= mask - 1; // Clears the lowest set bit.
+    }
+    pos += Scanner::kSize;
+  }
+  // Less than `kSize` candidates remain.
+  for (; haystack_end.reaches(pos + needle_size); ++pos)
+    if (equal_bytes(pos, needle, needle_size))
+      return pos;
   return nullptr;
 }
 
+// Returns the position preceding the maximal suffix of `needle` for the byte
+// order, or the reversed byte order when `reversed` is true. This is SIZE_MAX
+// when the maximal suffix is the whole needle. `period` receives the period of
+// the maximal suffix.
+static size_t maximal_suffix(const unsigned char *needle, size_t needle_size,
+                             bool reversed, size_t &period) {
+  size_t suffix = SIZE_MAX;
+  size_t candidate = 0;
+  size_t offset = 1;
+  period = 1;
+  while (candidate + offset < needle_size) {
+    const unsigned char a = needle[suffix + offset];
+    const unsigned char b = needle[candidate + offset];
+    if (a == b) {
+      if (offset == period) {
+        candidate += period;
+        offset = 1;
+      } else {
+        ++offset;
+      }
+    } else if (reversed ? a < b : a > b) {
+      candidate += offset;
+      offset = 1;
+      period = candidate - suffix;
+    } else {
+      suffix = candidate++;
+      offset = period = 1;
+    }
+  }
+  return suffix;
+}
+
+static const char *two_way_search(const char *haystack, const char *needle_str,
+                                  size_t needle_size) {
+  const unsigned char *needle =
+      reinterpret_cast<const unsigned char *>(needle_str);
+
+  // Bad character table: `needle_size - shift[c]` is the distance between the
+  // last occurrence of `c` in the needle and the end of the needle, or the
+  // size of the needle if `c` does not occur.
+  size_t shift[256] = {0};
+  for (size_t i = 0; i < needle_size; ++i)
+    shift[needle[i]] = i + 1;
+
+  // Critical factorization: the needle is split after position `split`.
+  size_t period;
+  size_t reversed_period;
+  size_t split = maximal_suffix(needle, needle_size, false, period);
+  const size_t reversed_split =
+      maximal_suffix(needle, needle_size, true, reversed_period);
+  if (reversed_split + 1 > split + 1) {
+    split = reversed_split;
+    period = reversed_period;
+  }
+
+  // When the needle is periodic, a shift by `period` after a match of the
+  // right half keeps `needle_size - period` bytes known to match.
+  size_t memory_after_shift;
+  if (equal_bytes(needle_str, needle_str + period, split + 1)) {
+    memory_after_shift = needle_size - period;
+  } else {
+    memory_after_shift = 0;
+    const size_t right_size = needle_size - split - 1;
+    period = (split > right_size ? split : right_size) + 1;
+  }
+
+  HaystackEnd haystack_end(haystack);
+  size_t memory = 0;
+  for (;;) {
+    if (!haystack_end.reaches(haystack + needle_size))
+      return nullptr;
+
+    // Check the last byte first and skip on mismatch.
+    const unsigned char last = haystack[needle_size - 1];
+    const size_t skip = needle_size - shift[last];
+    if (skip) {
+      haystack += skip < memory ? memory : skip;
+      memory = 0;
+      continue;
+    }
+
+    // Compare the right half.
+    size_t i = split + 1 > memory ? split + 1 : memory;
+    while (i < needle_size && needle_str[i] == haystack[i])
+      ++i;
+    if (i < needle_size) {
+      haystack += i - split;
+      memory = 0;
+      continue;
+    }
+
+    // Compare the left half.
+    i = split + 1;
+    while (i > memory && needle_str[i - 1] == haystack[i - 1])
+      --i;
+    if (i <= memory)
+      return haystack;
+    haystack += period;
+    memory = memory_after_shift;
+  }
+}
+
+char *LLVM_LIBC_ENTRYPOINT(strstr)(const char *haystack, const char *needle) {
+  if (needle[0] == '\0')
+    return const_cast<char *>(haystack);
+  if (needle[1] == '\0')
+    return const_cast<char *>(
+        find_first_char<NativeScanner>(haystack, needle[0]));
+  const size_t needle_size = string_length<NativeScanner>(needle);
+  if (needle_size <= kMaxFilteredNeedleSize)
+    return const_cast<char *>(
+        find_short_needle<NativeScanner>(haystack, needle, needle_size));
+  return const_cast<char *>(two_way_search(haystack, needle, needle_size));
+}
+
 } // namespace __llvm_libc
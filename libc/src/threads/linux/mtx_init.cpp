@@ -15,6 +15,8 @@ namespace __llvm_libc {
 int LLVM_LIBC_ENTRYPOINT(mtx_init)(mtx_t *mutex, int type) {
   *(reinterpret_cast<uint32_t *>(mutex->__internal_data)) = MS_Free;
   mutex->__mtx_type = type;
+  mutex->__owner = 0;
+  mutex->__count = 0;
   return thrd_success;
 }
 
@@ -0,0 +1,23 @@
+//===-- Linux implementation of the mtx_timedlock function ----------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/threads.h" // For mtx_t definition.
+#include "src/__support/common.h"
+#include "src/threads/linux/mutex_utils.h"
+
+namespace __llvm_libc {
+
+int LLVM_LIBC_ENTRYPOINT(mtx_timedlock)(
+    mtx_t *__restrict mutex, const struct timespec *__restrict time_point) {
+  // The kernel rejects invalid time points only when it has to sleep.
+  if (time_point->tv_nsec < 0 || time_point->tv_nsec >= 1000000000)
+    return thrd_error;
+  return lock_mutex(mutex, time_point);
+}
+
+} // namespace __llvm_libc
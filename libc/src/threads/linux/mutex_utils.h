@@ -0,0 +1,167 @@
+//===-- Linux futex based mutex implementation ------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_THREADS_LINUX_MUTEX_UTILS_H
+#define LLVM_LIBC_SRC_THREADS_LINUX_MUTEX_UTILS_H
+
+#include "config/linux/syscall.h" // For syscall functions.
+#include "include/errno.h"        // For E* error values.
+#include "include/sys/syscall.h"  // For syscall numbers.
+#include "include/threads.h"      // For mtx_t definition.
+#include "src/threads/linux/thread_utils.h"
+
+#include <linux/futex.h> // For futex operations.
+#include <stdatomic.h>   // For atomic operations.
+#include <stdint.h>
+
+namespace __llvm_libc {
+
+// The futex word of a mutex goes through the states of `MutexStatus`:
+// - MS_Free: nobody holds the mutex.
+// - MS_Locked: the mutex is held and nobody sleeps on it.
+// - MS_Waiting: the mutex is held and threads may sleep on it, the owner has
+//   to wake one of them when unlocking.
+//
+// A contended `mtx_lock` first spins for a short while hoping that the owner
+// releases the mutex soon: a critical section is usually much shorter than the
+// two syscalls needed to sleep and to be woken up. The spin uses an
+// exponential backoff to limit the traffic on the cache line of the mutex and
+// stops as soon as other threads sleep, spinning would then only delay the
+// handoff to them.
+
+// The spin phase waits at most 1 + 2 + ... + kMaxSpinBackoff pause
+// instructions, in the order of a microsecond on current hardware.
+static constexpr unsigned kMaxSpinBackoff = 128;
+
+// Hints the processor that we are in a spin loop.
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield" ::: "memory");
+#else
+  asm volatile("" ::: "memory");
+#endif
+}
+
+static inline FutexData *get_futex_word(mtx_t *mutex) {
+  return reinterpret_cast<FutexData *>(mutex->__internal_data);
+}
+
+static inline bool try_acquire(FutexData *futex_word) {
+  uint32_t expected = MS_Free;
+  return atomic_compare_exchange_strong(futex_word, &expected, MS_Locked);
+}
+
+// Spins while the mutex is held by a running thread. Returns true if the
+// mutex was acquired.
+static inline bool spin_acquire(FutexData *futex_word) {
+  for (unsigned backoff = 1; backoff <= kMaxSpinBackoff; backoff *= 2) {
+    for (unsigned i = 0; i < backoff; ++i)
+      cpu_relax();
+    // Read before attempting the CAS so that waiting does not steal the cache
+    // line from the owner.
+    const uint32_t status =
+        atomic_load_explicit(futex_word, memory_order_relaxed);
+    if (status == MS_Waiting)
+      return false;
+    if (status == MS_Free && try_acquire(futex_word))
+      return true;
+  }
+  return false;
+}
+
+// Acquires the futex word of a mutex. If `abs_time` is not null, gives up when
+// the realtime clock reaches this absolute time. Returns thrd_success,
+// thrd_timedout or thrd_error.
+static inline int acquire_futex(FutexData *futex_word,
+                                const struct timespec *abs_time) {
+  if (try_acquire(futex_word) || spin_acquire(futex_word))
+    return thrd_success;
+
+  // The mutex is marked as waited for even when we end up acquiring it: we
+  // cannot know whether other threads still sleep on it, an unneeded wake up
+  // is the price to pay to never miss a needed one.
+  while (atomic_exchange(futex_word, MS_Waiting) != MS_Free) {
+    // The futex syscall blocks only if the futex word is still `MS_Waiting`.
+    long result;
+    if (abs_time == nullptr) {
+      result = __llvm_libc::syscall(SYS_futex, futex_word, FUTEX_WAIT_PRIVATE,
+                                    MS_Waiting, 0, 0, 0);
+    } else {
+      result = __llvm_libc::syscall(
+          SYS_futex, futex_word,
+          FUTEX_WAIT_BITSET_PRIVATE | FUTEX_CLOCK_REALTIME, MS_Waiting,
+          abs_time, 0, FUTEX_BITSET_MATCH_ANY);
+    }
+    if (result == -ETIMEDOUT)
+      return thrd_timedout;
+    if (result == -EINVAL)
+      return thrd_error;
+  }
+  return thrd_success;
+}
+
+// Releases the futex word of a mutex and wakes up a sleeping thread if any.
+// Returns thrd_error if the mutex was not locked.
+static inline int release_futex(FutexData *futex_word) {
+  const uint32_t status = atomic_exchange(futex_word, MS_Free);
+  if (status == MS_Waiting) {
+    __llvm_libc::syscall(SYS_futex, futex_word, FUTEX_WAKE_PRIVATE, 1, 0, 0,
+                         0);
+  }
+  return status == MS_Free ? thrd_error : thrd_success;
+}
+
+// Recursive mutexes record their owner so that it can lock them again.
+static inline int get_thread_id() {
+  return static_cast<int>(__llvm_libc::syscall(SYS_gettid));
+}
+
+static inline bool is_recursive(const mtx_t *mutex) {
+  return mutex->__mtx_type & mtx_recursive;
+}
+
+// Threads other than the owner may read the owner concurrently.
+static inline atomic_int *get_owner(mtx_t *mutex) {
+  return reinterpret_cast<atomic_int *>(&mutex->__owner);
+}
+
+// Locks `mutex`, see `acquire_futex` for `abs_time`.
+static inline int lock_mutex(mtx_t *mutex, const struct timespec *abs_time) {
+  if (!is_recursive(mutex))
+    return acquire_futex(get_futex_word(mutex), abs_time);
+  const int self = get_thread_id();
+  // Only the owner can observe its own id here.
+  if (atomic_load_explicit(get_owner(mutex), memory_order_relaxed) == self) {
+    ++mutex->__count;
+    return thrd_success;
+  }
+  const int result = acquire_futex(get_futex_word(mutex), abs_time);
+  if (result != thrd_success)
+    return result;
+  atomic_store_explicit(get_owner(mutex), self, memory_order_relaxed);
+  mutex->__count = 1;
+  return thrd_success;
+}
+
+static inline int unlock_mutex(mtx_t *mutex) {
+  if (is_recursive(mutex)) {
+    if (atomic_load_explicit(get_owner(mutex), memory_order_relaxed) !=
+        get_thread_id())
+      return thrd_error;
+    if (--mutex->__count != 0)
+      return thrd_success;
+    atomic_store_explicit(get_owner(mutex), 0, memory_order_relaxed);
+  }
+  return release_futex(get_futex_word(mutex));
+}
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_THREADS_LINUX_MUTEX_UTILS_H
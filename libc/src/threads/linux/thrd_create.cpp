@@ -16,6 +16,7 @@
 #include "src/sys/mman/mmap.h"
 #include "src/sys/mman/munmap.h"
 #include "src/threads/linux/thread_utils.h"
+#include "src/threads/multithreading.h"
 
 #include <linux/futex.h> // For futex operations.
 #include <linux/sched.h> // For CLONE_* flags.
@@ -23,6 +24,8 @@
 
 namespace __llvm_libc {
 
+bool process_is_multithreaded = false;
+
 struct StartArgs {
   thrd_t *thread;
   thrd_start_t func;
@@ -57,6 +60,10 @@ int LLVM_LIBC_ENTRYPOINT(thrd_create)(thrd_t *thread, thrd_start_t func,
   if (stack == MAP_FAILED)
     return llvmlibc_errno == ENOMEM ? thrd_nomem : thrd_error;
 
+  // Must be visible before the new thread runs: single threaded fast paths
+  // elsewhere in the library skip locking while this is false.
+  process_is_multithreaded = true;
+
   thread->__stack = stack;
   thread->__stack_size = ThreadParams::DefaultStackSize;
   thread->__retval = -1;
@@ -0,0 +1,28 @@
+//===-- Internal tracking of the threads of the process ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_THREADS_MULTITHREADING_H
+#define LLVM_LIBC_SRC_THREADS_MULTITHREADING_H
+
+namespace __llvm_libc {
+
+// Set by `thrd_create` before the first thread is spawned and never reset.
+// The declaration is weak so that programs which never create threads do not
+// need to link `thrd_create`, the address of the flag is then null.
+extern bool process_is_multithreaded __attribute__((weak));
+
+// Returns whether other threads may run concurrently with the caller. This
+// can only change from false to true in the calling thread, so a caller which
+// observes false can skip locking for as long as it does not create threads.
+static inline bool is_multithreaded() {
+  return &process_is_multithreaded != nullptr && process_is_multithreaded;
+}
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_THREADS_MULTITHREADING_H
@@ -0,0 +1,108 @@
+//===-- Unittests for logf ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "include/math.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/math/logf.h"
+#include "utils/FPUtil/BitPatterns.h"
+#include "utils/FPUtil/ClassificationFunctions.h"
+#include "utils/FPUtil/FloatOperations.h"
+#include "utils/FPUtil/FloatProperties.h"
+#include "utils/MPFRWrapper/MPFRUtils.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using __llvm_libc::fputil::isNegativeQuietNaN;
+using __llvm_libc::fputil::isQuietNaN;
+using __llvm_libc::fputil::valueAsBits;
+using __llvm_libc::fputil::valueFromBits;
+
+using BitPatterns = __llvm_libc::fputil::BitPatterns<float>;
+
+namespace mpfr = __llvm_libc::testing::mpfr;
+
+// 12 additional bits of precision over the base precision of a |float|
+// value.
+static constexpr mpfr::Tolerance tolerance{mpfr::Tolerance::floatPrecision, 12,
+                                           0xFFF};
+
+TEST(LogfTest, SpecialNumbers) {
+  llvmlibc_errno = 0;
+
+  EXPECT_TRUE(
+      isQuietNaN(__llvm_libc::logf(valueFromBits(BitPatterns::aQuietNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_TRUE(isNegativeQuietNaN(
+      __llvm_libc::logf(valueFromBits(BitPatterns::aNegativeQuietNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_TRUE(isQuietNaN(
+      __llvm_libc::logf(valueFromBits(BitPatterns::aSignallingNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_TRUE(isNegativeQuietNaN(
+      __llvm_libc::logf(valueFromBits(BitPatterns::aNegativeSignallingNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_EQ(BitPatterns::inf,
+            valueAsBits(__llvm_libc::logf(valueFromBits(BitPatterns::inf))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_EQ(BitPatterns::zero,
+            valueAsBits(__llvm_libc::logf(valueFromBits(BitPatterns::one))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(LogfTest, PoleError) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::negInf,
+            valueAsBits(__llvm_libc::logf(valueFromBits(BitPatterns::zero))));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::negInf, valueAsBits(__llvm_libc::logf(
+                                     valueFromBits(BitPatterns::negZero))));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+}
+
+TEST(LogfTest, DomainError) {
+  llvmlibc_errno = 0;
+  EXPECT_TRUE(
+      isQuietNaN(__llvm_libc::logf(valueFromBits(BitPatterns::negInf))));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+
+  llvmlibc_errno = 0;
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::logf(-1.0f)));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+
+  llvmlibc_errno = 0;
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::logf(valueFromBits(0x80000001U))));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+}
+
+// Subnormal inputs are normalized before the table lookup.
+TEST(LogfTest, Subnormals) {
+  for (uint32_t v = 1; v < 0x00800000U; v = v * 3 + 1) {
+    float x = valueFromBits(v);
+    ASSERT_MPFR_MATCH(mpfr::Operation::Log, x, __llvm_libc::logf(x), tolerance);
+  }
+}
+
+TEST(LogfTest, InFloatRange) {
+  constexpr uint32_t count = 1000000;
+  constexpr uint32_t step = 0x7f800000U / count;
+  for (uint32_t i = 0, v = 0; i <= count; ++i, v += step) {
+    float x = valueFromBits(v);
+    if (isnan(x) || isinf(x) || x == 0.0f)
+      continue;
+    ASSERT_MPFR_MATCH(mpfr::Operation::Log, x, __llvm_libc::logf(x), tolerance);
+  }
+}
@@ -0,0 +1,155 @@
+//===-- Unittests for powf ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "include/math.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/math/powf.h"
+#include "utils/FPUtil/BitPatterns.h"
+#include "utils/FPUtil/ClassificationFunctions.h"
+#include "utils/FPUtil/FloatOperations.h"
+#include "utils/FPUtil/FloatProperties.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using __llvm_libc::fputil::isQuietNaN;
+using __llvm_libc::fputil::valueAsBits;
+using __llvm_libc::fputil::valueFromBits;
+
+using BitPatterns = __llvm_libc::fputil::BitPatterns<float>;
+
+// The MPFR matchers only handle functions of one argument, the accuracy of
+// powf is checked by the libc-math-accuracy tool. These tests cover the
+// special cases of C11 F.10.4.4.
+
+TEST(PowfTest, NaNs) {
+  llvmlibc_errno = 0;
+  float nan = valueFromBits(BitPatterns::aQuietNaN);
+
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::powf(nan, 2.0f)));
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::powf(2.0f, nan)));
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::powf(nan, nan)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  // Except for these two cases.
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(nan, 0.0f)));
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(1.0f, nan)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(PowfTest, ZeroExponent) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(0.0f, 0.0f)));
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(-3.0f, -0.0f)));
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(
+                                  valueFromBits(BitPatterns::inf), 0.0f)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(PowfTest, ZeroBase) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(0.0f, 3.0f)));
+  EXPECT_EQ(BitPatterns::negZero,
+            valueAsBits(__llvm_libc::powf(-0.0f, 3.0f)));
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(-0.0f, 2.0f)));
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(-0.0f, 0.5f)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  // Pole errors.
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(0.0f, -3.0f)));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::negInf,
+            valueAsBits(__llvm_libc::powf(-0.0f, -3.0f)));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(-0.0f, -0.5f)));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+}
+
+TEST(PowfTest, InfiniteExponent) {
+  llvmlibc_errno = 0;
+  float inf = valueFromBits(BitPatterns::inf);
+  float negInf = valueFromBits(BitPatterns::negInf);
+
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(-1.0f, inf)));
+  EXPECT_EQ(BitPatterns::one, valueAsBits(__llvm_libc::powf(-1.0f, negInf)));
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(0.5f, inf)));
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(0.5f, negInf)));
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(-2.0f, inf)));
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(-2.0f, negInf)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(PowfTest, InfiniteBase) {
+  llvmlibc_errno = 0;
+  float inf = valueFromBits(BitPatterns::inf);
+  float negInf = valueFromBits(BitPatterns::negInf);
+
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(inf, 0.5f)));
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(inf, -0.5f)));
+  EXPECT_EQ(BitPatterns::negInf, valueAsBits(__llvm_libc::powf(negInf, 3.0f)));
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(negInf, 2.0f)));
+  EXPECT_EQ(BitPatterns::negZero,
+            valueAsBits(__llvm_libc::powf(negInf, -3.0f)));
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(negInf, -2.0f)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(PowfTest, NegativeBase) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(valueAsBits(-8.0f), valueAsBits(__llvm_libc::powf(-2.0f, 3.0f)));
+  EXPECT_EQ(valueAsBits(16.0f), valueAsBits(__llvm_libc::powf(-2.0f, 4.0f)));
+  EXPECT_EQ(valueAsBits(-0.125f),
+            valueAsBits(__llvm_libc::powf(-2.0f, -3.0f)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  // Domain error for non-integer exponents.
+  llvmlibc_errno = 0;
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::powf(-2.0f, 0.5f)));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+}
+
+TEST(PowfTest, ExactResults) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(valueAsBits(1024.0f), valueAsBits(__llvm_libc::powf(2.0f, 10.0f)));
+  EXPECT_EQ(valueAsBits(2.0f), valueAsBits(__llvm_libc::powf(4.0f, 0.5f)));
+  EXPECT_EQ(valueAsBits(0.25f), valueAsBits(__llvm_libc::powf(16.0f, -0.5f)));
+  EXPECT_EQ(valueAsBits(3.0f), valueAsBits(__llvm_libc::powf(3.0f, 1.0f)));
+  // Subnormal base.
+  EXPECT_EQ(valueAsBits(0x1p-74f),
+            valueAsBits(__llvm_libc::powf(0x1p-148f, 0.5f)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
+
+TEST(PowfTest, OverflowAndUnderflow) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::inf, valueAsBits(__llvm_libc::powf(2.0f, 128.0f)));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::negInf,
+            valueAsBits(__llvm_libc::powf(-2.0f, 129.0f)));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+
+  llvmlibc_errno = 0;
+  EXPECT_EQ(BitPatterns::zero, valueAsBits(__llvm_libc::powf(2.0f, -151.0f)));
+  EXPECT_EQ(llvmlibc_errno, ERANGE);
+
+  // The largest and smallest finite results.
+  llvmlibc_errno = 0;
+  EXPECT_EQ(valueAsBits(0x1p127f),
+            valueAsBits(__llvm_libc::powf(2.0f, 127.0f)));
+  EXPECT_EQ(valueAsBits(0x1p-126f),
+            valueAsBits(__llvm_libc::powf(2.0f, -126.0f)));
+  EXPECT_EQ(llvmlibc_errno, 0);
+}
@@ -0,0 +1,123 @@
+//===-- Unittests for tanf ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "include/math.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/math/tanf.h"
+#include "test/src/math/sdcomp26094.h"
+#include "utils/CPP/Array.h"
+#include "utils/FPUtil/BitPatterns.h"
+#include "utils/FPUtil/ClassificationFunctions.h"
+#include "utils/FPUtil/FloatOperations.h"
+#include "utils/FPUtil/FloatProperties.h"
+#include "utils/MPFRWrapper/MPFRUtils.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using __llvm_libc::fputil::isNegativeQuietNaN;
+using __llvm_libc::fputil::isQuietNaN;
+using __llvm_libc::fputil::valueAsBits;
+using __llvm_libc::fputil::valueFromBits;
+
+using BitPatterns = __llvm_libc::fputil::BitPatterns<float>;
+
+using __llvm_libc::testing::sdcomp26094Values;
+
+namespace mpfr = __llvm_libc::testing::mpfr;
+
+// 12 additional bits of precision over the base precision of a |float|
+// value.
+static constexpr mpfr::Tolerance tolerance{mpfr::Tolerance::floatPrecision, 12,
+                                           3 * 0x1000 / 4};
+
+TEST(TanfTest, SpecialNumbers) {
+  llvmlibc_errno = 0;
+
+  EXPECT_TRUE(
+      isQuietNaN(__llvm_libc::tanf(valueFromBits(BitPatterns::aQuietNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_TRUE(isNegativeQuietNaN(
+      __llvm_libc::tanf(valueFromBits(BitPatterns::aNegativeQuietNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_TRUE(isQuietNaN(
+      __llvm_libc::tanf(valueFromBits(BitPatterns::aSignallingNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_TRUE(isNegativeQuietNaN(
+      __llvm_libc::tanf(valueFromBits(BitPatterns::aNegativeSignallingNaN))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_EQ(BitPatterns::zero,
+            valueAsBits(__llvm_libc::tanf(valueFromBits(BitPatterns::zero))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  EXPECT_EQ(BitPatterns::negZero, valueAsBits(__llvm_libc::tanf(
+                                      valueFromBits(BitPatterns::negZero))));
+  EXPECT_EQ(llvmlibc_errno, 0);
+
+  llvmlibc_errno = 0;
+  EXPECT_TRUE(isQuietNaN(__llvm_libc::tanf(valueFromBits(BitPatterns::inf))));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+
+  llvmlibc_errno = 0;
+  EXPECT_TRUE(
+      isQuietNaN(__llvm_libc::tanf(valueFromBits(BitPatterns::negInf))));
+  EXPECT_EQ(llvmlibc_errno, EDOM);
+}
+
+TEST(TanfTest, InFloatRange) {
+  constexpr uint32_t count = 1000000;
+  constexpr uint32_t step = UINT32_MAX / count;
+  for (uint32_t i = 0, v = 0; i <= count; ++i, v += step) {
+    float x = valueFromBits(v);
+    if (isnan(x) || isinf(x))
+      continue;
+    ASSERT_MPFR_MATCH(mpfr::Operation::Tan, x, __llvm_libc::tanf(x), tolerance);
+  }
+}
+
+// Near odd multiples of pi/2 the result is computed as -cos(r)/sin(r) of a
+// tiny reduced argument r.
+static constexpr __llvm_libc::cpp::Array<uint32_t, 6> nearPoles{
+    0x3fc90fda, 0x3fc90fdb, 0x4096cbe4, 0x40fb53d1, 0xbfc90fdb, 0xc096cbe4,
+};
+
+TEST(TanfTest, NearPoles) {
+  for (uint32_t v : nearPoles) {
+    float x = valueFromBits(v);
+    EXPECT_MPFR_MATCH(mpfr::Operation::Tan, x, __llvm_libc::tanf(x), tolerance);
+  }
+}
+
+// For small values, tan(x) is x.
+TEST(TanfTest, SmallValues) {
+  uint32_t bits = 0x17800000;
+  float x = valueFromBits(bits);
+  float result = __llvm_libc::tanf(x);
+  EXPECT_MPFR_MATCH(mpfr::Operation::Tan, x, result, tolerance);
+  EXPECT_EQ(bits, valueAsBits(result));
+
+  bits = 0x00400000;
+  x = valueFromBits(bits);
+  result = __llvm_libc::tanf(x);
+  EXPECT_MPFR_MATCH(mpfr::Operation::Tan, x, result, tolerance);
+  EXPECT_EQ(bits, valueAsBits(result));
+}
+
+// SDCOMP-26094: check tanf in the cases for which the range reducer
+// returns values furthest beyond its nominal upper bound of pi/4.
+TEST(TanfTest, SDCOMP_26094) {
+  for (uint32_t v : sdcomp26094Values) {
+    float x = valueFromBits(v);
+    EXPECT_MPFR_MATCH(mpfr::Operation::Tan, x, __llvm_libc::tanf(x), tolerance);
+  }
+}
@@ -0,0 +1,156 @@
+//===-- Unittests for the x86 vector math functions -----------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/math.h"
+#include "src/math/log2f.h"
+#include "src/math/logf.h"
+#include "src/math/powf.h"
+#include "src/math/tanf.h"
+#include "src/math/x86/vector_math.h"
+#include "utils/FPUtil/FloatOperations.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using __llvm_libc::fputil::valueAsBits;
+using __llvm_libc::fputil::valueFromBits;
+
+// The vector functions evaluate the scalar algorithms lane by lane, they may
+// only differ from the scalar functions when the compiler contracts a
+// multiplication and an addition. The accuracy against exact results is
+// checked by the libc-math-accuracy tool.
+static uint32_t ulpDistance(float a, float b) {
+  if (isnan(a) && isnan(b))
+    return 0;
+  // Maps the floats to integers in the same order.
+  auto ordered = [](float x) -> int64_t {
+    const uint32_t bits = valueAsBits(x);
+    return bits >> 31 ? -int64_t(bits & 0x7fffffff) : int64_t(bits);
+  };
+  const int64_t d = ordered(a) - ordered(b);
+  return static_cast<uint32_t>(d < 0 ? -d : d);
+}
+
+// Inputs spread over all the floats, special values included. Every lane of a
+// vector gets a different class of inputs.
+static constexpr uint32_t kCount = 1 << 16;
+static float input(uint32_t i, uint32_t seed) {
+  return valueFromBits((i * 0x9E3779B1U) ^ seed);
+}
+
+template <typename Vector, Vector (*VectorFn)(Vector), float (*ScalarFn)(float)>
+__attribute__((always_inline)) inline uint32_t maxUnaryError() {
+  constexpr unsigned lanes = sizeof(Vector) / sizeof(float);
+  uint32_t max_error = 0;
+  for (uint32_t i = 0; i < kCount; i += lanes) {
+    Vector x;
+    for (unsigned lane = 0; lane < lanes; ++lane)
+      x[lane] = input(i + lane, 0);
+    const Vector result = VectorFn(x);
+    for (unsigned lane = 0; lane < lanes; ++lane) {
+      const uint32_t error = ulpDistance(result[lane], ScalarFn(x[lane]));
+      max_error = error > max_error ? error : max_error;
+    }
+  }
+  return max_error;
+}
+
+template <typename Vector, Vector (*VectorFn)(Vector, Vector),
+          float (*ScalarFn)(float, float)>
+__attribute__((always_inline)) inline uint32_t maxBinaryError() {
+  constexpr unsigned lanes = sizeof(Vector) / sizeof(float);
+  uint32_t max_error = 0;
+  for (uint32_t i = 0; i < kCount; i += lanes) {
+    Vector x, y;
+    for (unsigned lane = 0; lane < lanes; ++lane) {
+      // The first lane covers all the floats, the others positive bases for
+      // which the result is mostly finite.
+      x[lane] = lane == 0 ? input(i + lane, 0) : 0.001f * (i + lane);
+      y[lane] = lane % 2 ? input(i + lane, 0x5555) : (i % 97) / 8.0f - 6.0f;
+    }
+    const Vector result = VectorFn(x, y);
+    for (unsigned lane = 0; lane < lanes; ++lane) {
+      const uint32_t error =
+          ulpDistance(result[lane], ScalarFn(x[lane], y[lane]));
+      max_error = error > max_error ? error : max_error;
+    }
+  }
+  return max_error;
+}
+
+// The wrappers below are compiled for the instruction set of the vector
+// functions they call, the tests only run them when the CPU supports it.
+struct Errors {
+  uint32_t logf, log2f, powf, tanf;
+};
+
+__attribute__((target("sse4.1"))) static Errors sse4Errors() {
+  using __llvm_libc::VectorFloat4;
+  return {maxUnaryError<VectorFloat4, __llvm_libc::_ZGVbN4v_logf,
+                        __llvm_libc::logf>(),
+          maxUnaryError<VectorFloat4, __llvm_libc::_ZGVbN4v_log2f,
+                        __llvm_libc::log2f>(),
+          maxBinaryError<VectorFloat4, __llvm_libc::_ZGVbN4vv_powf,
+                         __llvm_libc::powf>(),
+          maxUnaryError<VectorFloat4, __llvm_libc::_ZGVbN4v_tanf,
+                        __llvm_libc::tanf>()};
+}
+
+__attribute__((target("avx2,fma"))) static Errors avx2Errors() {
+  using __llvm_libc::VectorFloat8;
+  return {maxUnaryError<VectorFloat8, __llvm_libc::_ZGVdN8v_logf,
+                        __llvm_libc::logf>(),
+          maxUnaryError<VectorFloat8, __llvm_libc::_ZGVdN8v_log2f,
+                        __llvm_libc::log2f>(),
+          maxBinaryError<VectorFloat8, __llvm_libc::_ZGVdN8vv_powf,
+                         __llvm_libc::powf>(),
+          maxUnaryError<VectorFloat8, __llvm_libc::_ZGVdN8v_tanf,
+                        __llvm_libc::tanf>()};
+}
+
+TEST(VectorMathTest, Sse4) {
+  if (!__builtin_cpu_supports("sse4.1"))
+    return;
+  const Errors errors = sse4Errors();
+  EXPECT_LE(errors.logf, 1U);
+  EXPECT_LE(errors.log2f, 1U);
+  EXPECT_LE(errors.powf, 1U);
+  EXPECT_LE(errors.tanf, 1U);
+}
+
+TEST(VectorMathTest, Avx2) {
+  if (!__builtin_cpu_supports("avx2") || !__builtin_cpu_supports("fma"))
+    return;
+  const Errors errors = avx2Errors();
+  EXPECT_LE(errors.logf, 1U);
+  EXPECT_LE(errors.log2f, 1U);
+  EXPECT_LE(errors.powf, 1U);
+  EXPECT_LE(errors.tanf, 1U);
+}
+
+// The lanes needing the scalar fallback must not affect the other lanes.
+__attribute__((target("sse4.1"))) static void
+logfWithSpecialLanes(float (&result)[4]) {
+  __llvm_libc::VectorFloat4 x = {-1.0f, 2.0f, valueFromBits(0x7f800000U),
+                                 valueFromBits(1U)};
+  x = __llvm_libc::_ZGVbN4v_logf(x);
+  for (unsigned lane = 0; lane < 4; ++lane)
+    result[lane] = x[lane];
+}
+
+TEST(VectorMathTest, SpecialLanes) {
+  if (!__builtin_cpu_supports("sse4.1"))
+    return;
+  float result[4];
+  logfWithSpecialLanes(result);
+  EXPECT_TRUE(isnan(result[0]));
+  EXPECT_EQ(valueAsBits(result[1]), valueAsBits(__llvm_libc::logf(2.0f)));
+  EXPECT_EQ(valueAsBits(result[2]), 0x7f800000U);
+  EXPECT_EQ(valueAsBits(result[3]),
+            valueAsBits(__llvm_libc::logf(valueFromBits(1U))));
+}
@@ -0,0 +1,69 @@
+//===-- Unittests for fputc -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/FILE.h"
+#include "src/stdio/fflush.h"
+#include "src/stdio/fputc.h"
+#include "src/stdio/setvbuf.h"
+#include "utils/UnitTest/Test.h"
+
+struct RecordingFile : __llvm_libc::FILE {
+  char data[64];
+  size_t size = 0;
+  size_t writes = 0;
+
+  RecordingFile() {
+    write = +[](__llvm_libc::FILE *file, const char *ptr, size_t count) {
+      RecordingFile *self = static_cast<RecordingFile *>(file);
+      ++self->writes;
+      for (size_t i = 0; i < count; ++i)
+        self->data[self->size++] = ptr[i];
+      self->data[self->size] = '\0';
+      return count;
+    };
+  }
+};
+
+TEST(Stdio, FPutcUnbuffered) {
+  RecordingFile f;
+  EXPECT_EQ(__llvm_libc::fputc('a', &f), int('a'));
+  EXPECT_EQ(__llvm_libc::fputc('b', &f), int('b'));
+  EXPECT_EQ(f.writes, size_t(2));
+  EXPECT_STREQ(f.data, "ab");
+}
+
+TEST(Stdio, FPutcReturnsUnsignedChar) {
+  RecordingFile f;
+  EXPECT_EQ(__llvm_libc::fputc(-1, &f), 0xFF);
+  EXPECT_EQ(__llvm_libc::fputc(0x141, &f), 0x41);
+  EXPECT_STREQ(f.data, "\xFF\x41");
+}
+
+TEST(Stdio, FPutcLineBuffered) {
+  RecordingFile f;
+  char buffer[16];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOLBF, sizeof(buffer)), 0);
+  for (const char *c = "abc"; *c; ++c)
+    EXPECT_EQ(__llvm_libc::fputc(*c, &f), int(*c));
+  EXPECT_EQ(f.writes, size_t(0));
+  EXPECT_EQ(__llvm_libc::fputc('\n', &f), int('\n'));
+  EXPECT_EQ(f.writes, size_t(1));
+  EXPECT_STREQ(f.data, "abc\n");
+}
+
+TEST(Stdio, FPutcFullyBuffered) {
+  RecordingFile f;
+  char buffer[4];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  for (const char *c = "abcde"; *c; ++c)
+    EXPECT_EQ(__llvm_libc::fputc(*c, &f), int(*c));
+  EXPECT_EQ(f.writes, size_t(1));
+  EXPECT_STREQ(f.data, "abcd");
+  ASSERT_EQ(__llvm_libc::fflush(&f), 0);
+  EXPECT_STREQ(f.data, "abcde");
+}
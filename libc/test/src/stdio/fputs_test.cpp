@@ -0,0 +1,50 @@
+//===-- Unittests for fputs -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/FILE.h"
+#include "src/stdio/fflush.h"
+#include "src/stdio/fputs.h"
+#include "src/stdio/setvbuf.h"
+#include "utils/UnitTest/Test.h"
+
+struct RecordingFile : __llvm_libc::FILE {
+  char data[64];
+  size_t size = 0;
+  size_t capacity = sizeof(data) - 1;
+
+  RecordingFile() {
+    write = +[](__llvm_libc::FILE *file, const char *ptr, size_t count) {
+      RecordingFile *self = static_cast<RecordingFile *>(file);
+      if (count > self->capacity)
+        count = self->capacity;
+      for (size_t i = 0; i < count; ++i)
+        self->data[self->size++] = ptr[i];
+      self->capacity -= count;
+      self->data[self->size] = '\0';
+      return count;
+    };
+  }
+};
+
+TEST(Stdio, FPutsWritesWholeString) {
+  RecordingFile f;
+  char buffer[8];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  EXPECT_GE(__llvm_libc::fputs("hello ", &f), 0);
+  EXPECT_GE(__llvm_libc::fputs("", &f), 0);
+  EXPECT_GE(__llvm_libc::fputs("world", &f), 0);
+  ASSERT_EQ(__llvm_libc::fflush(&f), 0);
+  EXPECT_STREQ(f.data, "hello world");
+}
+
+TEST(Stdio, FPutsReportsErrors) {
+  RecordingFile f;
+  f.capacity = 3;
+  EXPECT_EQ(__llvm_libc::fputs("hello", &f), EOF);
+  EXPECT_TRUE(f.error);
+}
@@ -0,0 +1,84 @@
+//===-- Unittests for fread -----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdio/FILE.h"
+#include "src/stdio/fread.h"
+#include "src/stdio/setvbuf.h"
+#include "utils/UnitTest/Test.h"
+
+// Serves the bytes of `content` and counts the reads from the device.
+struct StringFile : __llvm_libc::FILE {
+  const char *content;
+  size_t remaining;
+  size_t reads = 0;
+
+  explicit StringFile(const char *str) : content(str), remaining(0) {
+    while (str[remaining])
+      ++remaining;
+    read = +[](__llvm_libc::FILE *file, char *ptr, size_t count) {
+      StringFile *self = static_cast<StringFile *>(file);
+      ++self->reads;
+      if (count > self->remaining)
+        count = self->remaining;
+      for (size_t i = 0; i < count; ++i)
+        ptr[i] = *self->content++;
+      self->remaining -= count;
+      return count;
+    };
+  }
+};
+
+TEST(Stdio, FReadUnbuffered) {
+  StringFile f("0123456789");
+  char data[8] = {0};
+  EXPECT_EQ(__llvm_libc::fread(data, 1, 4, &f), size_t(4));
+  EXPECT_STREQ(data, "0123");
+  EXPECT_EQ(f.reads, size_t(1));
+}
+
+TEST(Stdio, FReadBufferedReadsAhead) {
+  StringFile f("0123456789");
+  char buffer[16];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  char data[8] = {0};
+  EXPECT_EQ(__llvm_libc::fread(data, 1, 3, &f), size_t(3));
+  EXPECT_STREQ(data, "012");
+  EXPECT_EQ(__llvm_libc::fread(data, 1, 3, &f), size_t(3));
+  EXPECT_STREQ(data, "345");
+  EXPECT_EQ(f.reads, size_t(1));
+}
+
+TEST(Stdio, FReadCountsWholeElements) {
+  StringFile f("0123456789");
+  char buffer[4];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  char data[16] = {0};
+  // Only 3 elements of 3 bytes are complete.
+  EXPECT_EQ(__llvm_libc::fread(data, 3, 4, &f), size_t(3));
+  EXPECT_STREQ(data, "0123456789");
+  EXPECT_TRUE(f.eof);
+  EXPECT_EQ(__llvm_libc::fread(data, 1, 1, &f), size_t(0));
+}
+
+TEST(Stdio, FReadWithoutReadFunction) {
+  __llvm_libc::FILE f;
+  char data[4];
+  EXPECT_EQ(__llvm_libc::fread(data, 1, 4, &f), size_t(0));
+  EXPECT_TRUE(f.error);
+}
+
+TEST(Stdio, FReadSizeOverflow) {
+  StringFile f("0123456789");
+  char data[4];
+  llvmlibc_errno = 0;
+  EXPECT_EQ(__llvm_libc::fread(data, ~size_t(0) / 2, 3, &f), size_t(0));
+  EXPECT_EQ(llvmlibc_errno, EOVERFLOW);
+  EXPECT_EQ(f.reads, size_t(0));
+}
@@ -6,8 +6,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "include/errno.h"
+#include "src/errno/llvmlibc_errno.h"
 #include "src/stdio/FILE.h"
+#include "src/stdio/fflush.h"
 #include "src/stdio/fwrite.h"
+#include "src/stdio/setvbuf.h"
 #include "utils/CPP/Array.h"
 #include "utils/UnitTest/Test.h"
 
@@ -26,3 +30,121 @@ TEST(Stdio, FWriteBasic) {
   EXPECT_EQ(fwrite("hello", 1, 6, &f), 6UL);
   EXPECT_STREQ(array, "hello");
 }
+
+// Records the bytes written to the device and the number of writes.
+struct RecordingFile : __llvm_libc::FILE {
+  char data[256];
+  size_t size = 0;
+  size_t writes = 0;
+  // The device accepts at most this many more bytes.
+  size_t capacity = sizeof(data);
+
+  RecordingFile() {
+    write = +[](__llvm_libc::FILE *file, const char *ptr, size_t count) {
+      RecordingFile *self = static_cast<RecordingFile *>(file);
+      ++self->writes;
+      if (count > self->capacity)
+        count = self->capacity;
+      for (size_t i = 0; i < count; ++i)
+        self->data[self->size++] = ptr[i];
+      self->capacity -= count;
+      self->data[self->size] = '\0';
+      return count;
+    };
+    data[0] = '\0';
+  }
+};
+
+TEST(Stdio, FWriteUnbufferedWritesThrough) {
+  RecordingFile f;
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, nullptr, _IONBF, 0), 0);
+  EXPECT_EQ(__llvm_libc::fwrite("ab", 1, 2, &f), size_t(2));
+  EXPECT_EQ(__llvm_libc::fwrite("cd", 1, 2, &f), size_t(2));
+  EXPECT_EQ(f.writes, size_t(2));
+  EXPECT_STREQ(f.data, "abcd");
+}
+
+TEST(Stdio, FWriteFullyBufferedCoalescesWrites) {
+  RecordingFile f;
+  char buffer[8];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  EXPECT_EQ(__llvm_libc::fwrite("abc", 1, 3, &f), size_t(3));
+  EXPECT_EQ(__llvm_libc::fwrite("\ndef", 1, 4, &f), size_t(4));
+  EXPECT_EQ(f.writes, size_t(0));
+  // The buffer is full, pending bytes are written first.
+  EXPECT_EQ(__llvm_libc::fwrite("gh", 1, 2, &f), size_t(2));
+  EXPECT_EQ(f.writes, size_t(1));
+  EXPECT_STREQ(f.data, "abc\ndef");
+  ASSERT_EQ(__llvm_libc::fflush(&f), 0);
+  EXPECT_EQ(f.writes, size_t(2));
+  EXPECT_STREQ(f.data, "abc\ndefgh");
+  // Nothing left to flush.
+  ASSERT_EQ(__llvm_libc::fflush(&f), 0);
+  EXPECT_EQ(f.writes, size_t(2));
+}
+
+TEST(Stdio, FWriteLargeWritesBypassBuffer) {
+  RecordingFile f;
+  char buffer[4];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  EXPECT_EQ(__llvm_libc::fwrite("ab", 1, 2, &f), size_t(2));
+  EXPECT_EQ(__llvm_libc::fwrite("0123456789", 2, 5, &f), size_t(5));
+  EXPECT_EQ(f.writes, size_t(2));
+  EXPECT_STREQ(f.data, "ab0123456789");
+}
+
+TEST(Stdio, FWriteLineBufferedFlushesOnNewline) {
+  RecordingFile f;
+  char buffer[32];
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOLBF, sizeof(buffer)), 0);
+  EXPECT_EQ(__llvm_libc::fwrite("abc", 1, 3, &f), size_t(3));
+  EXPECT_EQ(f.writes, size_t(0));
+  EXPECT_EQ(__llvm_libc::fwrite("d\ne", 1, 3, &f), size_t(3));
+  EXPECT_EQ(f.writes, size_t(1));
+  EXPECT_STREQ(f.data, "abcd\ne");
+}
+
+TEST(Stdio, FWriteDefaultBuffer) {
+  RecordingFile f;
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, nullptr, _IOFBF, 0), 0);
+  for (int i = 0; i < 100; ++i)
+    EXPECT_EQ(__llvm_libc::fwrite("x", 1, 1, &f), size_t(1));
+  EXPECT_EQ(f.writes, size_t(0));
+  ASSERT_EQ(__llvm_libc::fflush(&f), 0);
+  EXPECT_EQ(f.writes, size_t(1));
+  EXPECT_EQ(f.size, size_t(100));
+}
+
+TEST(Stdio, FWriteShortWriteSetsError) {
+  RecordingFile f;
+  char buffer[8];
+  f.capacity = 2;
+  ASSERT_EQ(__llvm_libc::setvbuf(&f, buffer, _IOFBF, sizeof(buffer)), 0);
+  EXPECT_EQ(__llvm_libc::fwrite("abcd", 1, 4, &f), size_t(4));
+  EXPECT_EQ(__llvm_libc::fflush(&f), EOF);
+  EXPECT_TRUE(f.error);
+  EXPECT_STREQ(f.data, "ab");
+  // The bytes that could not be written are kept.
+  f.capacity = 8;
+  EXPECT_EQ(__llvm_libc::fflush(&f), 0);
+  EXPECT_STREQ(f.data, "abcd");
+}
+
+TEST(Stdio, SetvbufRejectsInvalidMode) {
+  RecordingFile f;
+  EXPECT_NE(__llvm_libc::setvbuf(&f, nullptr, 42, 0), 0);
+}
+
+TEST(Stdio, FWriteSizeOverflow) {
+  RecordingFile f;
+  llvmlibc_errno = 0;
+  EXPECT_EQ(__llvm_libc::fwrite("abcd", ~size_t(0) / 2, 3, &f), 0UL);
+  EXPECT_EQ(llvmlibc_errno, EOVERFLOW);
+  EXPECT_EQ(f.writes, 0UL);
+}
+
+TEST(Stdio, FFlushAllStreamsIsUnsupported) {
+  llvmlibc_errno = 0;
+  EXPECT_EQ(__llvm_libc::fflush(nullptr), EOF);
+  EXPECT_EQ(llvmlibc_errno, EINVAL);
+}
@@ -0,0 +1,52 @@
+//===-- Unittests for aligned_alloc ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "include/stdlib.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/aligned_alloc.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/realloc.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+TEST(AlignedAllocTest, AllAlignments) {
+  // Alignments up to a page are served by slabs, larger ones are mapped.
+  for (size_t alignment = 1; alignment <= (1 << 20); alignment *= 2) {
+    for (size_t size = 1; size <= (1 << 16); size *= 7) {
+      unsigned char *ptr = static_cast<unsigned char *>(
+          __llvm_libc::aligned_alloc(alignment, size));
+      ASSERT_NE(ptr, static_cast<unsigned char *>(nullptr));
+      ASSERT_EQ(reinterpret_cast<uintptr_t>(ptr) % alignment, uintptr_t(0));
+      for (size_t i = 0; i < size; ++i)
+        ptr[i] = static_cast<unsigned char>(i);
+      __llvm_libc::free(ptr);
+    }
+  }
+}
+
+TEST(AlignedAllocTest, Realloc) {
+  // Memory from aligned_alloc can be passed to realloc.
+  unsigned char *ptr =
+      static_cast<unsigned char *>(__llvm_libc::aligned_alloc(256, 100));
+  for (size_t i = 0; i < 100; ++i)
+    ptr[i] = static_cast<unsigned char>(i);
+  ptr = static_cast<unsigned char *>(__llvm_libc::realloc(ptr, 1000));
+  ASSERT_NE(ptr, static_cast<unsigned char *>(nullptr));
+  for (size_t i = 0; i < 100; ++i)
+    ASSERT_EQ(ptr[i], static_cast<unsigned char>(i));
+  __llvm_libc::free(ptr);
+}
+
+TEST(AlignedAllocTest, InvalidAlignment) {
+  llvmlibc_errno = 0;
+  ASSERT_EQ(__llvm_libc::aligned_alloc(24, 48), static_cast<void *>(nullptr));
+  ASSERT_EQ(llvmlibc_errno, EINVAL);
+}
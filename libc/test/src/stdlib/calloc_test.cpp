@@ -0,0 +1,49 @@
+//===-- Unittests for calloc ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/errno.h"
+#include "include/stdlib.h"
+#include "src/errno/llvmlibc_errno.h"
+#include "src/stdlib/calloc.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/malloc.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+static bool is_zero(void *ptr, size_t size) {
+  unsigned char *bytes = static_cast<unsigned char *>(ptr);
+  for (size_t i = 0; i < size; ++i)
+    if (bytes[i] != 0)
+      return false;
+  return true;
+}
+
+TEST(CallocTest, ZeroesReusedMemory) {
+  for (size_t size = 1; size <= 1 << 17; size *= 3) {
+    // Dirty an object and free it so that calloc may reuse it.
+    unsigned char *dirty =
+        static_cast<unsigned char *>(__llvm_libc::malloc(size));
+    ASSERT_NE(dirty, static_cast<unsigned char *>(nullptr));
+    for (size_t i = 0; i < size; ++i)
+      dirty[i] = 0xFF;
+    __llvm_libc::free(dirty);
+
+    void *ptr = __llvm_libc::calloc(size, 1);
+    ASSERT_NE(ptr, static_cast<void *>(nullptr));
+    ASSERT_TRUE(is_zero(ptr, size));
+    __llvm_libc::free(ptr);
+  }
+}
+
+TEST(CallocTest, Overflow) {
+  llvmlibc_errno = 0;
+  ASSERT_EQ(__llvm_libc::calloc(SIZE_MAX / 2, 3), static_cast<void *>(nullptr));
+  ASSERT_EQ(llvmlibc_errno, ENOMEM);
+}
@@ -0,0 +1,149 @@
+//===-- Unittests for malloc ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/stdlib.h"
+#include "include/threads.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/malloc.h"
+#include "src/threads/thrd_create.h"
+#include "src/threads/thrd_join.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+static bool is_aligned(void *ptr, size_t alignment) {
+  return reinterpret_cast<uintptr_t>(ptr) % alignment == 0;
+}
+
+static void fill(void *ptr, size_t size, unsigned char value) {
+  unsigned char *bytes = static_cast<unsigned char *>(ptr);
+  for (size_t i = 0; i < size; ++i)
+    bytes[i] = value;
+}
+
+static bool holds(void *ptr, size_t size, unsigned char value) {
+  unsigned char *bytes = static_cast<unsigned char *>(ptr);
+  for (size_t i = 0; i < size; ++i)
+    if (bytes[i] != value)
+      return false;
+  return true;
+}
+
+TEST(MallocTest, ZeroSize) {
+  void *ptr = __llvm_libc::malloc(0);
+  ASSERT_NE(ptr, static_cast<void *>(nullptr));
+  __llvm_libc::free(ptr);
+}
+
+TEST(MallocTest, FreeNull) { __llvm_libc::free(nullptr); }
+
+TEST(MallocTest, AllSizes) {
+  // Covers every small size class and some large allocations.
+  constexpr size_t MAX_SIZE = 1 << 17;
+  for (size_t size = 1; size <= MAX_SIZE; size += size / 8 + 1) {
+    void *ptr = __llvm_libc::malloc(size);
+    ASSERT_NE(ptr, static_cast<void *>(nullptr));
+    ASSERT_TRUE(is_aligned(ptr, 16));
+    fill(ptr, size, static_cast<unsigned char>(size));
+    ASSERT_TRUE(holds(ptr, size, static_cast<unsigned char>(size)));
+    __llvm_libc::free(ptr);
+  }
+}
+
+TEST(MallocTest, DistinctLiveObjects) {
+  // Enough objects to go through several batches and slabs.
+  constexpr size_t COUNT = 4096;
+  static void *ptrs[COUNT];
+  for (size_t i = 0; i < COUNT; ++i) {
+    const size_t size = 16 + i % 200;
+    ptrs[i] = __llvm_libc::malloc(size);
+    ASSERT_NE(ptrs[i], static_cast<void *>(nullptr));
+    fill(ptrs[i], size, static_cast<unsigned char>(i));
+  }
+  for (size_t i = 0; i < COUNT; ++i) {
+    ASSERT_TRUE(holds(ptrs[i], 16 + i % 200, static_cast<unsigned char>(i)));
+    __llvm_libc::free(ptrs[i]);
+  }
+}
+
+TEST(MallocTest, ReuseAfterFree) {
+  void *first = __llvm_libc::malloc(48);
+  __llvm_libc::free(first);
+  void *second = __llvm_libc::malloc(48);
+  ASSERT_EQ(first, second);
+  __llvm_libc::free(second);
+}
+
+constexpr size_t PRODUCED = 1 << 14;
+static void *produced[PRODUCED];
+
+int consumer(void *arg) {
+  // Frees objects allocated by another thread.
+  for (size_t i = 0; i < PRODUCED; ++i) {
+    if (!holds(produced[i], 32, 0xAB))
+      return 1;
+    __llvm_libc::free(produced[i]);
+  }
+  return 0;
+}
+
+TEST(MallocTest, FreeFromAnotherThread) {
+  for (size_t i = 0; i < PRODUCED; ++i) {
+    produced[i] = __llvm_libc::malloc(32);
+    ASSERT_NE(produced[i], static_cast<void *>(nullptr));
+    fill(produced[i], 32, 0xAB);
+  }
+  thrd_t thread;
+  __llvm_libc::thrd_create(&thread, consumer, nullptr);
+  int retval = 123;
+  __llvm_libc::thrd_join(&thread, &retval);
+  ASSERT_EQ(retval, 0);
+
+  // The objects freed by the consumer are reused.
+  for (size_t i = 0; i < PRODUCED; ++i) {
+    produced[i] = __llvm_libc::malloc(32);
+    ASSERT_NE(produced[i], static_cast<void *>(nullptr));
+  }
+  for (size_t i = 0; i < PRODUCED; ++i)
+    __llvm_libc::free(produced[i]);
+}
+
+constexpr int WORKERS = 4;
+constexpr size_t ROUNDS = 20000;
+
+int worker(void *arg) {
+  const uintptr_t id = reinterpret_cast<uintptr_t>(arg);
+  void *live[8] = {nullptr};
+  for (size_t i = 0; i < ROUNDS; ++i) {
+    void *&slot = live[i % 8];
+    if (slot != nullptr) {
+      if (!holds(slot, 24, static_cast<unsigned char>(id)))
+        return 1;
+      __llvm_libc::free(slot);
+    }
+    slot = __llvm_libc::malloc(24 + i % 1000);
+    if (slot == nullptr)
+      return 1;
+    fill(slot, 24, static_cast<unsigned char>(id));
+  }
+  for (void *ptr : live)
+    __llvm_libc::free(ptr);
+  return 0;
+}
+
+TEST(MallocTest, ConcurrentThreads) {
+  thrd_t threads[WORKERS];
+  for (uintptr_t i = 0; i < WORKERS; ++i)
+    __llvm_libc::thrd_create(threads + i, worker, reinterpret_cast<void *>(i));
+  for (int i = 0; i < WORKERS; ++i) {
+    int retval = 123;
+    __llvm_libc::thrd_join(threads + i, &retval);
+    ASSERT_EQ(retval, 0);
+  }
+}
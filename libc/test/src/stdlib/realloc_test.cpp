@@ -0,0 +1,59 @@
+//===-- Unittests for realloc ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "include/stdlib.h"
+#include "src/stdlib/free.h"
+#include "src/stdlib/malloc.h"
+#include "src/stdlib/realloc.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stddef.h>
+
+TEST(ReallocTest, NullIsMalloc) {
+  void *ptr = __llvm_libc::realloc(nullptr, 10);
+  ASSERT_NE(ptr, static_cast<void *>(nullptr));
+  __llvm_libc::free(ptr);
+}
+
+TEST(ReallocTest, GrowAndShrinkKeepContents) {
+  constexpr size_t MAX_SIZE = 1 << 18;
+  unsigned char *ptr = static_cast<unsigned char *>(__llvm_libc::malloc(1));
+  ptr[0] = 0;
+  // Grow through small and large allocations, each step keeps the old bytes.
+  size_t size = 1;
+  while (size < MAX_SIZE) {
+    const size_t new_size = size * 2 + 3;
+    ptr = static_cast<unsigned char *>(__llvm_libc::realloc(ptr, new_size));
+    ASSERT_NE(ptr, static_cast<unsigned char *>(nullptr));
+    for (size_t i = 0; i < size; ++i)
+      ASSERT_EQ(ptr[i], static_cast<unsigned char>(i));
+    for (size_t i = size; i < new_size; ++i)
+      ptr[i] = static_cast<unsigned char>(i);
+    size = new_size;
+  }
+  while (size > 1) {
+    size /= 3;
+    ptr = static_cast<unsigned char *>(__llvm_libc::realloc(ptr, size + 1));
+    ASSERT_NE(ptr, static_cast<unsigned char *>(nullptr));
+    for (size_t i = 0; i <= size; ++i)
+      ASSERT_EQ(ptr[i], static_cast<unsigned char>(i));
+  }
+  __llvm_libc::free(ptr);
+}
+
+TEST(ReallocTest, SmallGrowthInPlace) {
+  // The object is rounded up to its size class, growing within it is free.
+  void *ptr = __llvm_libc::malloc(100);
+  ASSERT_EQ(__llvm_libc::realloc(ptr, 110), ptr);
+  __llvm_libc::free(ptr);
+}
+
+TEST(ReallocTest, ZeroSizeFrees) {
+  void *ptr = __llvm_libc::malloc(32);
+  ASSERT_EQ(__llvm_libc::realloc(ptr, 0), static_cast<void *>(nullptr));
+}
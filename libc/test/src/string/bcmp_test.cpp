@@ -0,0 +1,60 @@
+//===-- Unittests for bcmp ------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/bcmp.h"
+#include "utils/UnitTest/Test.h"
+#include <stddef.h>
+
+TEST(BcmpTest, CmpZeroByte) {
+  const char *lhs = "ab";
+  const char *rhs = "bc";
+  EXPECT_EQ(__llvm_libc::bcmp(lhs, rhs, 0), 0);
+}
+
+TEST(BcmpTest, LhsRhsAreTheSame) {
+  const char *lhs = "ab";
+  const char *rhs = "ab";
+  EXPECT_EQ(__llvm_libc::bcmp(lhs, rhs, 2), 0);
+}
+
+TEST(BcmpTest, LhsRhsAreDifferent) {
+  const char *lhs = "ab";
+  const char *rhs = "ac";
+  EXPECT_NE(__llvm_libc::bcmp(lhs, rhs, 2), 0);
+  EXPECT_NE(__llvm_libc::bcmp(rhs, lhs, 2), 0);
+}
+
+TEST(BcmpTest, Thorough) {
+  // Sizes and alignments cover all the size classes of the implementation.
+  char lhs[512];
+  char rhs[512];
+  for (size_t i = 0; i < sizeof(lhs); ++i)
+    lhs[i] = rhs[i] = static_cast<char>(i * 7);
+  for (size_t align = 0; align < 32; ++align) {
+    for (size_t count = 0; align + count <= 300; ++count) {
+      char *const a = lhs + align;
+      char *const b = rhs + align;
+      ASSERT_EQ(__llvm_libc::bcmp(a, b, count), 0);
+      // Bytes outside of the range are not compared.
+      if (align > 0)
+        ++b[-1];
+      ++b[count];
+      ASSERT_EQ(__llvm_libc::bcmp(a, b, count), 0);
+      if (align > 0)
+        --b[-1];
+      --b[count];
+      for (size_t mismatch = 0; mismatch < count; ++mismatch) {
+        // Flipping the high bit only exercises the sign of the difference.
+        b[mismatch] ^= 0x80;
+        ASSERT_NE(__llvm_libc::bcmp(a, b, count), 0);
+        ASSERT_NE(__llvm_libc::bcmp(b, a, count), 0);
+        b[mismatch] ^= 0x80;
+      }
+    }
+  }
+}
@@ -0,0 +1,74 @@
+//===-- Unittests for memcmp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/string/memcmp.h"
+#include "utils/UnitTest/Test.h"
+#include <stddef.h>
+
+TEST(MemcmpTest, CmpZeroByte) {
+  const char *lhs = "ab";
+  const char *rhs = "bc";
+  EXPECT_EQ(__llvm_libc::memcmp(lhs, rhs, 0), 0);
+}
+
+TEST(MemcmpTest, LhsRhsAreTheSame) {
+  const char *lhs = "ab";
+  const char *rhs = "ab";
+  EXPECT_EQ(__llvm_libc::memcmp(lhs, rhs, 2), 0);
+}
+
+TEST(MemcmpTest, LhsBeforeRhsLexically) {
+  const char *lhs = "ab";
+  const char *rhs = "ac";
+  EXPECT_LT(__llvm_libc::memcmp(lhs, rhs, 2), 0);
+}
+
+TEST(MemcmpTest, LhsAfterRhsLexically) {
+  const char *lhs = "ac";
+  const char *rhs = "ab";
+  EXPECT_GT(__llvm_libc::memcmp(lhs, rhs, 2), 0);
+}
+
+TEST(MemcmpTest, BytesAreCompareAsUnsigned) {
+  const char *lhs = "a\x80";
+  const char *rhs = "a\x7F";
+  EXPECT_GT(__llvm_libc::memcmp(lhs, rhs, 2), 0);
+  EXPECT_LT(__llvm_libc::memcmp(rhs, lhs, 2), 0);
+}
+
+TEST(MemcmpTest, Thorough) {
+  // Sizes and alignments cover all the size classes of the implementation.
+  char lhs[512];
+  char rhs[512];
+  for (size_t i = 0; i < sizeof(lhs); ++i)
+    lhs[i] = rhs[i] = static_cast<char>(i * 7);
+  for (size_t align = 0; align < 32; ++align) {
+    for (size_t count = 0; align + count <= 300; ++count) {
+      ASSERT_EQ(__llvm_libc::memcmp(lhs + align, rhs + align, count), 0);
+      // Only the first mismatch matters.
+      for (size_t mismatch = 0; mismatch < count; ++mismatch) {
+        char *const a = lhs + align;
+        char *const b = rhs + align;
+        const char saved = b[mismatch];
+        b[mismatch] = static_cast<char>(a[mismatch] + 1);
+        if (mismatch + 1 < count)
+          a[count - 1] = static_cast<char>(b[count - 1] + 1);
+        const int expected = static_cast<unsigned char>(a[mismatch]) <
+                                     static_cast<unsigned char>(b[mismatch])
+                                 ? -1
+                                 : 1;
+        const int result = __llvm_libc::memcmp(a, b, count);
+        ASSERT_EQ(result < 0 ? -1 : 1, expected);
+        const int reversed = __llvm_libc::memcmp(b, a, count);
+        ASSERT_EQ(reversed < 0 ? -1 : 1, -expected);
+        b[mismatch] = saved;
+        a[count - 1] = b[count - 1];
+      }
+    }
+  }
+}
@@ -112,3 +112,34 @@ TEST(MemRChrTest, ZeroLengthShouldReturnNullptr) {
   // This will iterate over exactly zero characters, so should return nullptr.
   ASSERT_STREQ(call_memrchr(src, 'd', 0), nullptr);
 }
+
+TEST(MemRChrTest, AllAlignmentsSizesAndPositions) {
+  unsigned char buffer[256];
+  for (size_t i = 0; i < sizeof(buffer); ++i)
+    buffer[i] = 'a';
+  for (size_t align = 0; align < 64; ++align) {
+    const unsigned char *const src = buffer + align;
+    for (size_t size = 0; size < 128; ++size) {
+      // Not found.
+      ASSERT_EQ(call_memrchr(src, 'b', size),
+                static_cast<const char *>(nullptr));
+      for (size_t pos = 0; pos < size; ++pos) {
+        buffer[align + pos] = 'b';
+        ASSERT_EQ(call_memrchr(src, 'b', size),
+                  reinterpret_cast<const char *>(src + pos));
+        buffer[align + pos] = 'a';
+      }
+      // Occurrences right before and right after the range are ignored.
+      buffer[align + size] = 'b';
+      ASSERT_EQ(call_memrchr(src, 'b', size),
+                static_cast<const char *>(nullptr));
+      buffer[align + size] = 'a';
+      if (align > 0) {
+        buffer[align - 1] = 'b';
+        ASSERT_EQ(call_memrchr(src, 'b', size),
+                  static_cast<const char *>(nullptr));
+        buffer[align - 1] = 'a';
+      }
+    }
+  }
+}
@@ -8,6 +8,7 @@
 
 #include "src/string/strchr.h"
 #include "utils/UnitTest/Test.h"
+#include <stddef.h>
 
 TEST(StrChrTest, FindsFirstCharacter) {
   const char *src = "abcde";
@@ -80,3 +81,24 @@ TEST(StrChrTest, EmptyStringShouldOnlyMatchNullTerminator) {
   ASSERT_STREQ(__llvm_libc::strchr("", '3'), nullptr);
   ASSERT_STREQ(__llvm_libc::strchr("", '*'), nullptr);
 }
+
+TEST(StrChrTest, AllAlignmentsLengthsAndPositions) {
+  char buffer[256];
+  for (size_t align = 0; align < 64; ++align) {
+    for (size_t length = 0; length < 128; ++length) {
+      for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = 'a';
+      // An occurrence after the terminator must not be found.
+      buffer[align + length] = '\0';
+      buffer[align + length + 1] = 'b';
+      char *const src = buffer + align;
+      ASSERT_EQ(__llvm_libc::strchr(src, 'b'), static_cast<char *>(nullptr));
+      ASSERT_EQ(__llvm_libc::strchr(src, '\0'), src + length);
+      for (size_t pos = 0; pos < length; ++pos) {
+        buffer[align + pos] = 'b';
+        ASSERT_EQ(__llvm_libc::strchr(src, 'b'), src + pos);
+        buffer[align + pos] = 'a';
+      }
+    }
+  }
+}
@@ -8,6 +8,7 @@
 
 #include "src/string/strcmp.h"
 #include "utils/UnitTest/Test.h"
+#include <stddef.h>
 
 TEST(StrCmpTest, EmptyStringsShouldReturnZero) {
   const char *s1 = "";
@@ -95,3 +96,29 @@ TEST(StrCmpTest, StringArgumentSwapChangesSign) {
   // 'a' - 'b' = -1.
   ASSERT_EQ(result, -1);
 }
+
+TEST(StrCmpTest, AllAlignmentsAndMismatchPositions) {
+  char left[256];
+  char right[256];
+  for (size_t left_align = 0; left_align < 32; ++left_align) {
+    for (size_t right_align = 0; right_align < 32; ++right_align) {
+      for (size_t length = 1; length < 96; ++length) {
+        for (size_t i = 0; i < sizeof(left); ++i)
+          left[i] = right[i] = 'a';
+        left[left_align + length] = '\0';
+        right[right_align + length] = '\0';
+        const char *const l = left + left_align;
+        char *const r = right + right_align;
+        ASSERT_EQ(__llvm_libc::strcmp(l, r), 0);
+        // Characters are compared as unsigned char.
+        r[length - 1] = '\xFF';
+        ASSERT_LT(__llvm_libc::strcmp(l, r), 0);
+        ASSERT_GT(__llvm_libc::strcmp(r, l), 0);
+        // A shorter string compares less.
+        r[length - 1] = '\0';
+        ASSERT_GT(__llvm_libc::strcmp(l, r), 0);
+        ASSERT_LT(__llvm_libc::strcmp(r, l), 0);
+      }
+    }
+  }
+}
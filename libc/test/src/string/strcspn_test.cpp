@@ -48,3 +48,15 @@ TEST(StrCSpnTest, DuplicatedCharactersNotPartOfComplementarySpan) {
   EXPECT_EQ(__llvm_libc::strcspn("aaaa", "aa"), size_t{0});
   EXPECT_EQ(__llvm_libc::strcspn("aaaa", "baa"), size_t{0});
 }
+
+TEST(StrCSpnTest, EveryByteValue) {
+  // Exercises the whole byte set, including characters with the high bit set.
+  char src[256];
+  for (size_t i = 0; i < 255; ++i)
+    src[i] = static_cast<char>(i + 1);
+  src[255] = '\0';
+  for (size_t i = 0; i < 255; ++i) {
+    const char segment[2] = {static_cast<char>(i + 1), '\0'};
+    EXPECT_EQ(__llvm_libc::strcspn(src, segment), i);
+  }
+}
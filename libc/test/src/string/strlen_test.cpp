@@ -8,6 +8,7 @@
 
 #include "src/string/strlen.h"
 #include "utils/UnitTest/Test.h"
+#include <stddef.h>
 
 TEST(StrLenTest, EmptyString) {
   const char *empty = "";
@@ -22,3 +23,17 @@ TEST(StrLenTest, AnyString) {
   size_t result = __llvm_libc::strlen(any);
   ASSERT_EQ((size_t)12, result);
 }
+
+TEST(StrLenTest, AllAlignmentsAndLengths) {
+  // Exercises the block scanning logic: the terminator is moved across block
+  // boundaries and the string start is moved within a block.
+  char buffer[256];
+  for (size_t align = 0; align < 64; ++align) {
+    for (size_t length = 0; length < 128; ++length) {
+      for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = 'a';
+      buffer[align + length] = '\0';
+      ASSERT_EQ(__llvm_libc::strlen(buffer + align), length);
+    }
+  }
+}
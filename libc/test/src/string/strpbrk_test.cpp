@@ -9,6 +9,7 @@
 #include "src/string/strpbrk.h"
 
 #include "utils/UnitTest/Test.h"
+#include <stddef.h>
 
 TEST(StrPBrkTest, EmptyStringShouldReturnNullptr) {
   // The search should not include the null terminator.
@@ -60,3 +61,15 @@ TEST(StrPBrkTest, FindsFirstOfRepeated) {
 TEST(StrPBrkTest, FindsFirstInBreakset) {
   EXPECT_STREQ(__llvm_libc::strpbrk("12345", "34"), "345");
 }
+
+TEST(StrPBrkTest, LongStringsAndBreaksets) {
+  char src[200];
+  for (size_t i = 0; i < sizeof(src) - 1; ++i)
+    src[i] = 'a' + (i % 16);
+  src[sizeof(src) - 1] = '\0';
+  EXPECT_STREQ(__llvm_libc::strpbrk(src, "qrstuvwxyz"), nullptr);
+  src[150] = 'z';
+  EXPECT_STREQ(__llvm_libc::strpbrk(src, "qrstuvwxyz"), src + 150);
+  src[100] = '\xFF';
+  EXPECT_STREQ(__llvm_libc::strpbrk(src, "qrstuvwxyz\xFF"), src + 100);
+}
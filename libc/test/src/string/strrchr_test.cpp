@@ -8,6 +8,7 @@
 
 #include "src/string/strrchr.h"
 #include "utils/UnitTest/Test.h"
+#include <stddef.h>
 
 TEST(StrRChrTest, FindsFirstCharacter) {
   const char *src = "abcde";
@@ -78,3 +79,27 @@ TEST(StrRChrTest, EmptyStringShouldOnlyMatchNullTerminator) {
   ASSERT_STREQ(__llvm_libc::strrchr("", '2'), nullptr);
   ASSERT_STREQ(__llvm_libc::strrchr("", '*'), nullptr);
 }
+
+TEST(StrRChrTest, AllAlignmentsLengthsAndPositions) {
+  char buffer[256];
+  for (size_t align = 0; align < 64; ++align) {
+    for (size_t length = 0; length < 128; ++length) {
+      for (size_t i = 0; i < sizeof(buffer); ++i)
+        buffer[i] = 'a';
+      // An occurrence after the terminator must not be found.
+      buffer[align + length] = '\0';
+      buffer[align + length + 1] = 'b';
+      char *const src = buffer + align;
+      ASSERT_EQ(__llvm_libc::strrchr(src, 'b'), static_cast<char *>(nullptr));
+      ASSERT_EQ(__llvm_libc::strrchr(src, '\0'), src + length);
+      for (size_t pos = 0; pos < length; ++pos) {
+        // A first occurrence that must be skipped.
+        buffer[align] = 'b';
+        buffer[align + pos] = 'b';
+        ASSERT_EQ(__llvm_libc::strrchr(src, 'b'), src + pos);
+        buffer[align] = 'a';
+        buffer[align + pos] = 'a';
+      }
+    }
+  }
+}
@@ -83,3 +83,21 @@ TEST(StrSpnTest, DuplicatedCharactersToBeSearchedForShouldStillMatch) {
   EXPECT_EQ(__llvm_libc::strspn("aaa", "aa"), size_t{3});
   EXPECT_EQ(__llvm_libc::strspn("aaaa", "aa"), size_t{4});
 }
+
+TEST(StrSpnTest, EveryByteValue) {
+  // Exercises the whole byte set, including characters with the high bit set.
+  char src[256];
+  for (size_t i = 0; i < 255; ++i)
+    src[i] = static_cast<char>(i + 1);
+  src[255] = '\0';
+  for (size_t i = 0; i < 255; ++i) {
+    // All characters but one.
+    char segment[256];
+    size_t size = 0;
+    for (size_t c = 1; c < 256; ++c)
+      if (c != i + 1)
+        segment[size++] = static_cast<char>(c);
+    segment[size] = '\0';
+    EXPECT_EQ(__llvm_libc::strspn(src, segment), i);
+  }
+}
@@ -8,6 +8,7 @@
 
 #include "src/string/strstr.h"
 #include "utils/UnitTest/Test.h"
+#include <stddef.h>
 
 TEST(StrStrTest, NeedleNotInHaystack) {
   const char *haystack = "12345";
@@ -112,3 +113,61 @@ TEST(StrStrTest, MorphedNeedle) {
   ASSERT_STREQ(__llvm_libc::strstr(haystack, "tire"), nullptr);
   ASSERT_STREQ(__llvm_libc::strstr(haystack, "timo"), nullptr);
 }
+
+TEST(StrStrTest, AllNeedleSizesAndPositions) {
+  // Covers both the short and long needle code paths.
+  char haystack[256];
+  char needle[128];
+  for (size_t i = 0; i < sizeof(needle); ++i)
+    needle[i] = 'a' + (i % 7);
+  for (size_t needle_size = 2; needle_size < 96; ++needle_size) {
+    needle[needle_size] = '\0';
+    for (size_t pos = 0; pos + needle_size < sizeof(haystack); ++pos) {
+      for (size_t i = 0; i < sizeof(haystack); ++i)
+        haystack[i] = 'x';
+      haystack[sizeof(haystack) - 1] = '\0';
+      for (size_t i = 0; i < needle_size; ++i)
+        haystack[pos + i] = needle[i];
+      ASSERT_EQ(__llvm_libc::strstr(haystack, needle), haystack + pos);
+      // The needle does not fit before the null terminator.
+      haystack[pos + needle_size - 1] = '\0';
+      ASSERT_EQ(__llvm_libc::strstr(haystack, needle),
+                static_cast<char *>(nullptr));
+    }
+    needle[needle_size] = 'a' + (needle_size % 7);
+  }
+}
+
+TEST(StrStrTest, PeriodicNeedles) {
+  // Worst case inputs for a brute force search.
+  char haystack[1024];
+  char needle[128];
+  for (size_t needle_size = 2; needle_size < sizeof(needle); ++needle_size) {
+    for (size_t i = 0; i < sizeof(haystack) - 1; ++i)
+      haystack[i] = 'a';
+    haystack[sizeof(haystack) - 1] = '\0';
+    for (size_t i = 0; i < needle_size; ++i)
+      needle[i] = 'a';
+    needle[needle_size] = '\0';
+    ASSERT_EQ(__llvm_libc::strstr(haystack, needle), haystack);
+    needle[needle_size - 1] = 'b';
+    ASSERT_EQ(__llvm_libc::strstr(haystack, needle),
+              static_cast<char *>(nullptr));
+    haystack[sizeof(haystack) - 2] = 'b';
+    ASSERT_EQ(__llvm_libc::strstr(haystack, needle),
+              haystack + sizeof(haystack) - 1 - needle_size);
+    // Needle of the form "aa...aba".
+    needle[needle_size - 1] = 'a';
+    needle[needle_size / 2] = 'b';
+    haystack[sizeof(haystack) - 2] = 'a';
+    ASSERT_EQ(__llvm_libc::strstr(haystack, needle),
+              static_cast<char *>(nullptr));
+  }
+}
+
+TEST(StrStrTest, NonAsciiCharacters) {
+  const char *haystack = "\xE9t\xE9 \xE0 l'h\xF4tel";
+  ASSERT_STREQ(__llvm_libc::strstr(haystack, "\xE0 l'"), "\xE0 l'h\xF4tel");
+  ASSERT_STREQ(__llvm_libc::strstr(haystack, "h\xF4tel"), "h\xF4tel");
+  ASSERT_STREQ(__llvm_libc::strstr(haystack, "h\xF3tel"), nullptr);
+}
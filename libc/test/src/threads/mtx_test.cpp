@@ -6,9 +6,12 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "config/linux/syscall.h" // For syscall function.
+#include "include/sys/syscall.h"  // For syscall numbers.
 #include "include/threads.h"
 #include "src/threads/mtx_init.h"
 #include "src/threads/mtx_lock.h"
+#include "src/threads/mtx_timedlock.h"
 #include "src/threads/mtx_unlock.h"
 #include "src/threads/thrd_create.h"
 #include "src/threads/thrd_join.h"
@@ -127,3 +130,115 @@ TEST(MutexTest, WaitAndStep) {
   __llvm_libc::thrd_join(&thread, &retval);
   ASSERT_EQ(retval, 0);
 }
+
+constexpr int CONTENDERS = 8;
+constexpr int INCREMENTS = 20000;
+
+mtx_t contended_lock;
+static int contended_count = 0;
+
+int incrementer(void *arg) {
+  for (int i = 0; i < INCREMENTS; ++i) {
+    __llvm_libc::mtx_lock(&contended_lock);
+    ++contended_count;
+    __llvm_libc::mtx_unlock(&contended_lock);
+  }
+  return 0;
+}
+
+TEST(MutexTest, ManyContenders) {
+  ASSERT_EQ(__llvm_libc::mtx_init(&contended_lock, mtx_plain),
+            static_cast<int>(thrd_success));
+
+  // More threads than cores exercise both the spin and the sleep paths.
+  thrd_t threads[CONTENDERS];
+  for (int i = 0; i < CONTENDERS; ++i)
+    __llvm_libc::thrd_create(threads + i, incrementer, nullptr);
+  for (int i = 0; i < CONTENDERS; ++i) {
+    int retval = 123;
+    __llvm_libc::thrd_join(threads + i, &retval);
+    ASSERT_EQ(retval, 0);
+  }
+  ASSERT_EQ(contended_count, CONTENDERS * INCREMENTS);
+}
+
+mtx_t recursive_lock;
+
+int recursive_unlocker(void *arg) {
+  // Only the owner can unlock a recursive mutex.
+  return __llvm_libc::mtx_unlock(&recursive_lock);
+}
+
+TEST(MutexTest, Recursive) {
+  ASSERT_EQ(__llvm_libc::mtx_init(&recursive_lock, mtx_plain | mtx_recursive),
+            static_cast<int>(thrd_success));
+  ASSERT_EQ(__llvm_libc::mtx_lock(&recursive_lock),
+            static_cast<int>(thrd_success));
+  ASSERT_EQ(__llvm_libc::mtx_lock(&recursive_lock),
+            static_cast<int>(thrd_success));
+
+  thrd_t thread;
+  __llvm_libc::thrd_create(&thread, recursive_unlocker, nullptr);
+  int retval = 123;
+  __llvm_libc::thrd_join(&thread, &retval);
+  ASSERT_EQ(retval, static_cast<int>(thrd_error));
+
+  ASSERT_EQ(__llvm_libc::mtx_unlock(&recursive_lock),
+            static_cast<int>(thrd_success));
+  ASSERT_EQ(__llvm_libc::mtx_unlock(&recursive_lock),
+            static_cast<int>(thrd_success));
+  ASSERT_EQ(__llvm_libc::mtx_unlock(&recursive_lock),
+            static_cast<int>(thrd_error));
+}
+
+mtx_t timed_lock;
+
+static struct timespec deadline_after(long nanoseconds) {
+  struct timespec ts;
+  __llvm_libc::syscall(SYS_clock_gettime, CLOCK_REALTIME, &ts);
+  ts.tv_nsec += nanoseconds;
+  ts.tv_sec += ts.tv_nsec / 1000000000;
+  ts.tv_nsec %= 1000000000;
+  return ts;
+}
+
+int timed_locker(void *arg) {
+  struct timespec deadline = deadline_after(10000000); // 10ms
+  return __llvm_libc::mtx_timedlock(&timed_lock, &deadline);
+}
+
+TEST(MutexTest, TimedLock) {
+  ASSERT_EQ(__llvm_libc::mtx_init(&timed_lock, mtx_timed),
+            static_cast<int>(thrd_success));
+
+  struct timespec deadline = deadline_after(10000000); // 10ms
+  ASSERT_EQ(__llvm_libc::mtx_timedlock(&timed_lock, &deadline),
+            static_cast<int>(thrd_success));
+
+  // The mutex is held by this thread so another thread has to time out.
+  thrd_t thread;
+  __llvm_libc::thrd_create(&thread, timed_locker, nullptr);
+  int retval = 123;
+  __llvm_libc::thrd_join(&thread, &retval);
+  ASSERT_EQ(retval, static_cast<int>(thrd_timedout));
+
+  ASSERT_EQ(__llvm_libc::mtx_unlock(&timed_lock),
+            static_cast<int>(thrd_success));
+
+  // Once released, the mutex can be acquired again.
+  __llvm_libc::thrd_create(&thread, timed_locker, nullptr);
+  __llvm_libc::thrd_join(&thread, &retval);
+  ASSERT_EQ(retval, static_cast<int>(thrd_success));
+}
+
+TEST(MutexTest, TimedLockInvalidTime) {
+  ASSERT_EQ(__llvm_libc::mtx_init(&timed_lock, mtx_timed),
+            static_cast<int>(thrd_success));
+  struct timespec deadline = deadline_after(0);
+  deadline.tv_nsec = 1000000000;
+  ASSERT_EQ(__llvm_libc::mtx_timedlock(&timed_lock, &deadline),
+            static_cast<int>(thrd_error));
+  deadline.tv_nsec = -1;
+  ASSERT_EQ(__llvm_libc::mtx_timedlock(&timed_lock, &deadline),
+            static_cast<int>(thrd_error));
+}
@@ -113,12 +113,21 @@ public:
     case Operation::Floor:
       mpfr_floor(value, mpfrInput.value);
       break;
+    case Operation::Log:
+      mpfr_log(value, mpfrInput.value, MPFR_RNDN);
+      break;
+    case Operation::Log2:
+      mpfr_log2(value, mpfrInput.value, MPFR_RNDN);
+      break;
     case Operation::Round:
       mpfr_round(value, mpfrInput.value);
       break;
     case Operation::Sin:
       mpfr_sin(value, mpfrInput.value, MPFR_RNDN);
       break;
+    case Operation::Tan:
+      mpfr_tan(value, mpfrInput.value, MPFR_RNDN);
+      break;
     case Operation::Trunc:
       mpfr_trunc(value, mpfrInput.value);
       break;
@@ -46,8 +46,11 @@ enum class Operation : int {
   Exp,
   Exp2,
   Floor,
+  Log,
+  Log2,
   Round,
   Sin,
+  Tan,
   Trunc
 };
 
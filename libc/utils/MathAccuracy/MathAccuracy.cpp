@@ -0,0 +1,368 @@
+//===-- Accuracy checker for the single-precision math functions ----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Measures the error in ULP of the llvm-libc single-precision math functions
+// and of their vector variants. The reference values are computed with the
+// long double functions of the system libc: their 64 bits of mantissa leave a
+// margin of 40 bits over a float result, enough to measure errors of a
+// fraction of an ULP without MPFR.
+//
+// Unary functions are evaluated on every `--step`-th float bit pattern and on
+// a few special values, `--step=1` is exhaustive. Binary functions are
+// evaluated on as many pairs of random inputs. The tool exits with a non-zero
+// status when a function exceeds its error bound.
+//
+// Usage: libc-math-accuracy [--step=N] [function...]
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/cosf.h"
+#include "src/math/exp2f.h"
+#include "src/math/expf.h"
+#include "src/math/log2f.h"
+#include "src/math/logf.h"
+#include "src/math/powf.h"
+#include "src/math/sinf.h"
+#include "src/math/tanf.h"
+#if defined(__x86_64__)
+#include "src/math/x86/vector_math.h"
+#endif
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+using EvaluateFunction = void(const float *X, const float *Y, float *Result,
+                              size_t Count);
+using ReferenceFunction = long double(long double X, long double Y);
+
+struct Function {
+  const char *Name;
+  bool Binary;
+  EvaluateFunction *Evaluate;
+  ReferenceFunction *Reference;
+  // The maximum error in ULP, in round to nearest mode.
+  double Bound;
+  // Whether the CPU can run the function, null when it always can.
+  bool (*Supported)();
+};
+
+// Inputs are processed by blocks, the size of a block is a multiple of the
+// number of lanes of all the vector functions.
+constexpr size_t kBlockSize = 4096;
+
+template <float (*Fn)(float)>
+void evaluateUnary(const float *X, const float *, float *Result,
+                   size_t Count) {
+  for (size_t I = 0; I < Count; ++I)
+    Result[I] = Fn(X[I]);
+}
+
+template <float (*Fn)(float, float)>
+void evaluateBinary(const float *X, const float *Y, float *Result,
+                    size_t Count) {
+  for (size_t I = 0; I < Count; ++I)
+    Result[I] = Fn(X[I], Y[I]);
+}
+
+#if defined(__x86_64__)
+// The wrappers of the vector functions are compiled for the instruction set
+// of the function they call, they only run after checking the CPU features.
+template <typename Vector, Vector (*Fn)(Vector)>
+__attribute__((always_inline)) inline void
+evaluateVectorUnary(const float *X, float *Result, size_t Count) {
+  for (size_t I = 0; I < Count; I += sizeof(Vector) / sizeof(float)) {
+    Vector V;
+    memcpy(&V, X + I, sizeof(Vector));
+    V = Fn(V);
+    memcpy(Result + I, &V, sizeof(Vector));
+  }
+}
+
+template <typename Vector, Vector (*Fn)(Vector, Vector)>
+__attribute__((always_inline)) inline void
+evaluateVectorBinary(const float *X, const float *Y, float *Result,
+                     size_t Count) {
+  for (size_t I = 0; I < Count; I += sizeof(Vector) / sizeof(float)) {
+    Vector V, W;
+    memcpy(&V, X + I, sizeof(Vector));
+    memcpy(&W, Y + I, sizeof(Vector));
+    V = Fn(V, W);
+    memcpy(Result + I, &V, sizeof(Vector));
+  }
+}
+
+using __llvm_libc::VectorFloat4;
+using __llvm_libc::VectorFloat8;
+
+#define SSE4_WRAPPER(Name)                                                    \
+  __attribute__((target("sse4.1"))) void Name##Sse4(                          \
+      const float *X, const float *, float *Result, size_t Count) {           \
+    evaluateVectorUnary<VectorFloat4, __llvm_libc::_ZGVbN4v_##Name>(X, Result, \
+                                                                    Count);    \
+  }
+#define AVX2_WRAPPER(Name)                                                    \
+  __attribute__((target("avx2,fma"))) void Name##Avx2(                        \
+      const float *X, const float *, float *Result, size_t Count) {           \
+    evaluateVectorUnary<VectorFloat8, __llvm_libc::_ZGVdN8v_##Name>(X, Result, \
+                                                                    Count);    \
+  }
+SSE4_WRAPPER(logf)
+SSE4_WRAPPER(log2f)
+SSE4_WRAPPER(tanf)
+AVX2_WRAPPER(logf)
+AVX2_WRAPPER(log2f)
+AVX2_WRAPPER(tanf)
+#undef SSE4_WRAPPER
+#undef AVX2_WRAPPER
+
+__attribute__((target("sse4.1"))) void powfSse4(const float *X, const float *Y,
+                                                float *Result, size_t Count) {
+  evaluateVectorBinary<VectorFloat4, __llvm_libc::_ZGVbN4vv_powf>(X, Y, Result,
+                                                                  Count);
+}
+
+__attribute__((target("avx2,fma"))) void
+powfAvx2(const float *X, const float *Y, float *Result, size_t Count) {
+  evaluateVectorBinary<VectorFloat8, __llvm_libc::_ZGVdN8vv_powf>(X, Y, Result,
+                                                                  Count);
+}
+
+bool hasSse4() { return __builtin_cpu_supports("sse4.1"); }
+bool hasAvx2() {
+  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+}
+#endif
+
+long double referenceExp(long double X, long double) { return expl(X); }
+long double referenceExp2(long double X, long double) { return exp2l(X); }
+long double referenceLog(long double X, long double) { return logl(X); }
+long double referenceLog2(long double X, long double) { return log2l(X); }
+long double referenceSin(long double X, long double) { return sinl(X); }
+long double referenceCos(long double X, long double) { return cosl(X); }
+long double referenceTan(long double X, long double) { return tanl(X); }
+long double referencePow(long double X, long double Y) { return powl(X, Y); }
+
+// The bounds are the maximum errors of the scalar functions over all the
+// inputs, rounded up. The vector variants evaluate the same algorithms.
+const Function kFunctions[] = {
+    {"expf", false, evaluateUnary<__llvm_libc::expf>, referenceExp, 0.51,
+     nullptr},
+    {"exp2f", false, evaluateUnary<__llvm_libc::exp2f>, referenceExp2, 0.51,
+     nullptr},
+    {"logf", false, evaluateUnary<__llvm_libc::logf>, referenceLog, 0.82,
+     nullptr},
+    {"log2f", false, evaluateUnary<__llvm_libc::log2f>, referenceLog2, 0.76,
+     nullptr},
+    {"sinf", false, evaluateUnary<__llvm_libc::sinf>, referenceSin, 0.57,
+     nullptr},
+    {"cosf", false, evaluateUnary<__llvm_libc::cosf>, referenceCos, 0.57,
+     nullptr},
+    {"tanf", false, evaluateUnary<__llvm_libc::tanf>, referenceTan, 0.7,
+     nullptr},
+    {"powf", true, evaluateBinary<__llvm_libc::powf>, referencePow, 0.82,
+     nullptr},
+#if defined(__x86_64__)
+    {"_ZGVbN4v_logf", false, logfSse4, referenceLog, 0.82, hasSse4},
+    {"_ZGVbN4v_log2f", false, log2fSse4, referenceLog2, 0.76, hasSse4},
+    {"_ZGVbN4v_tanf", false, tanfSse4, referenceTan, 0.7, hasSse4},
+    {"_ZGVbN4vv_powf", true, powfSse4, referencePow, 0.82, hasSse4},
+    {"_ZGVdN8v_logf", false, logfAvx2, referenceLog, 0.82, hasAvx2},
+    {"_ZGVdN8v_log2f", false, log2fAvx2, referenceLog2, 0.76, hasAvx2},
+    {"_ZGVdN8v_tanf", false, tanfAvx2, referenceTan, 0.7, hasAvx2},
+    {"_ZGVdN8vv_powf", true, powfAvx2, referencePow, 0.82, hasAvx2},
+#endif
+};
+
+float asFloat(uint32_t Bits) {
+  float Value;
+  memcpy(&Value, &Bits, sizeof(Value));
+  return Value;
+}
+
+uint32_t asBits(float Value) {
+  uint32_t Bits;
+  memcpy(&Bits, &Value, sizeof(Bits));
+  return Bits;
+}
+
+// Returns the error of `Result` in ULP of the exact value `Exact`. Results
+// that round to an infinity or are not a number must be exactly right.
+double ulpError(float Result, long double Exact) {
+  if (isnan(Exact) || isnan(Result))
+    return isnan(Exact) && isnan(Result) ? 0 : INFINITY;
+  const float Rounded = static_cast<float>(Exact);
+  if (isinf(Result) || isinf(Rounded))
+    return Result == Rounded ? 0 : INFINITY;
+  int Exponent;
+  frexpl(Exact, &Exponent);
+  // All the subnormals have the ULP of the smallest normal binade.
+  if (Exponent < -125)
+    Exponent = -125;
+  return static_cast<double>(fabsl(Result - Exact) /
+                             ldexpl(1.0L, Exponent - 24));
+}
+
+// A deterministic xorshift generator so that runs are reproducible.
+class Xorshift {
+  uint64_t State = 0x9E3779B97F4A7C15ULL;
+
+public:
+  uint64_t next() {
+    State ^= State << 13;
+    State ^= State >> 7;
+    State ^= State << 17;
+    return State;
+  }
+};
+
+// Fills the inputs of a unary function, `Next` is the next bit pattern to
+// evaluate. Returns the number of inputs.
+size_t fillUnary(float *X, uint64_t &Next, uint64_t Step) {
+  size_t Count = 0;
+  for (; Count < kBlockSize && Next <= UINT32_MAX; ++Count, Next += Step)
+    X[Count] = asFloat(static_cast<uint32_t>(Next));
+  return Count;
+}
+
+// Fills the inputs of `powf`. The exponents are chosen so that the results
+// mostly fall in the range of floats and just beyond, a quarter of the pairs
+// have a negative base and an integer exponent.
+void fillBinary(float *X, float *Y, Xorshift &Random) {
+  for (size_t I = 0; I < kBlockSize; ++I) {
+    const uint64_t Bits = Random.next();
+    float Base = asFloat(static_cast<uint32_t>(Bits % 0x7f800000U));
+    const double Log2 = fabs(log2(static_cast<double>(Base)));
+    // Uniform in [-1, 1).
+    const double Unit = static_cast<double>(Bits >> 11) * 0x1p-52 - 1.0;
+    double Exponent = Unit * 160.0 / (Log2 < 1.0 ? 1.0 : Log2);
+    if (I % 4 == 3) {
+      Base = -Base;
+      Exponent = rint(Exponent);
+    }
+    X[I] = Base;
+    Y[I] = static_cast<float>(Exponent);
+  }
+}
+
+// Special values checked in addition to the sampled inputs.
+const uint32_t kSpecialValues[] = {
+    0x00000000U, 0x80000000U, 0x00000001U, 0x80000001U, 0x00800000U,
+    0x3f800000U, 0xbf800000U, 0x40000000U, 0x7f7fffffU, 0xff7fffffU,
+    0x7f800000U, 0xff800000U, 0x7fc00000U,
+};
+constexpr size_t kNumSpecialValues =
+    sizeof(kSpecialValues) / sizeof(kSpecialValues[0]);
+
+struct Measure {
+  double MaxError = 0;
+  float WorstX = 0;
+  float WorstY = 0;
+  uint64_t Count = 0;
+};
+
+void record(Measure &M, const Function &F, const float *X, const float *Y,
+            const float *Result, size_t Count) {
+  for (size_t I = 0; I < Count; ++I) {
+    const long double Exact = F.Reference(X[I], F.Binary ? Y[I] : 0);
+    const double Error = ulpError(Result[I], Exact);
+    if (Error > M.MaxError || (Error == M.MaxError && M.Count == 0)) {
+      M.MaxError = Error;
+      M.WorstX = X[I];
+      M.WorstY = F.Binary ? Y[I] : 0;
+    }
+  }
+  M.Count += Count;
+}
+
+Measure measure(const Function &F, uint64_t Step) {
+  static float X[kBlockSize], Y[kBlockSize], Result[kBlockSize];
+  Measure M;
+
+  // The special values, every input with every other for binary functions.
+  for (size_t I = 0; I < kNumSpecialValues; ++I) {
+    for (size_t J = 0; J < kBlockSize; ++J) {
+      X[J] = asFloat(kSpecialValues[I]);
+      Y[J] = asFloat(kSpecialValues[J % kNumSpecialValues]);
+    }
+    const size_t Count = F.Binary ? kNumSpecialValues : 1;
+    F.Evaluate(X, Y, Result, kBlockSize);
+    record(M, F, X, Y, Result, Count);
+  }
+
+  if (F.Binary) {
+    Xorshift Random;
+    for (uint64_t Done = 0; Done <= UINT32_MAX / Step; Done += kBlockSize) {
+      fillBinary(X, Y, Random);
+      F.Evaluate(X, Y, Result, kBlockSize);
+      record(M, F, X, Y, Result, kBlockSize);
+    }
+    return M;
+  }
+  for (uint64_t Next = 0; Next <= UINT32_MAX;) {
+    const size_t Count = fillUnary(X, Next, Step);
+    // Vector functions evaluate whole blocks, the tail is padded.
+    for (size_t I = Count; I < kBlockSize; ++I)
+      X[I] = 1.0f;
+    F.Evaluate(X, Y, Result, kBlockSize);
+    record(M, F, X, Y, Result, Count);
+  }
+  return M;
+}
+
+bool isSelected(const char *Name, int Argc, char **Argv, int First) {
+  if (First == Argc)
+    return true;
+  for (int I = First; I < Argc; ++I)
+    if (strcmp(Argv[I], Name) == 0)
+      return true;
+  return false;
+}
+
+} // namespace
+
+int main(int Argc, char **Argv) {
+  // About four million inputs by default.
+  uint64_t Step = 1021;
+  int First = 1;
+  if (First < Argc && strncmp(Argv[First], "--step=", 7) == 0) {
+    Step = strtoull(Argv[First] + 7, nullptr, 10);
+    if (Step == 0) {
+      fprintf(stderr, "invalid step: %s\n", Argv[First] + 7);
+      return 2;
+    }
+    ++First;
+  }
+
+  bool Failed = false;
+  printf("%-16s %12s %10s  %s\n", "function", "inputs", "max ulp",
+         "worst input");
+  for (const Function &F : kFunctions) {
+    if (!isSelected(F.Name, Argc, Argv, First))
+      continue;
+    if (F.Supported && !F.Supported()) {
+      printf("%-16s skipped, not supported by the CPU\n", F.Name);
+      continue;
+    }
+    const Measure M = measure(F, Step);
+    const bool Passed = M.MaxError <= F.Bound;
+    Failed |= !Passed;
+    printf("%-16s %12llu %10.4f  %a (0x%08x)", F.Name,
+           static_cast<unsigned long long>(M.Count), M.MaxError, M.WorstX,
+           asBits(M.WorstX));
+    if (F.Binary)
+      printf(", %a (0x%08x)", M.WorstY, asBits(M.WorstY));
+    printf("%s\n", Passed ? "" : "  FAIL");
+  }
+  return Failed ? 1 : 0;
+}
@@ -166,6 +166,19 @@ inline StringRef getInstrProfCounterBiasVarName() {
   return "__llvm_profile_counter_bias";
 }
 
+/// Return the name of the thread-local variable holding the offset from the
+/// counters of the module to the counters of the current thread, with
+/// per-thread counters.
+inline StringRef getInstrProfThreadCounterBiasVarName() {
+  return "__llvm_profile_thread_counter_bias";
+}
+
+/// Return the name of the runtime function that sets up the counters of the
+/// current thread and returns their offset, with per-thread counters.
+inline StringRef getInstrProfThreadCounterBiasFuncName() {
+  return "__llvm_profile_get_thread_counter_bias";
+}
+
 /// Return the marker used to separate PGO names during serialization.
 inline StringRef getInstrProfNameSeparator() { return "\01"; }
 
@@ -68,6 +68,10 @@ private:
   // vector of counter load/store pairs to be register promoted.
   std::vector<LoadStorePair> PromotionCandidates;
 
+  // The offset to the counters of the current thread in the function being
+  // lowered, with per-thread counters.
+  Value *ThreadCounterBias = nullptr;
+
   // FIXME: These are to be removed after switching to the new memop value
   // profiling.
   // The start value of precise value profile range for memory intrinsic sizes.
@@ -87,6 +91,10 @@ private:
   /// Returns true if relocating counters at runtime is enabled.
   bool isRuntimeCounterRelocationEnabled() const;
 
+  /// Load the offset to the counters of the current thread at the entry of
+  /// \p F, calling into the runtime to set them up on first use.
+  Value *emitThreadCounterBias(Function *F);
+
   /// Returns true if profile counter update register promotion is enabled.
   bool isCounterPromotionEnabled() const;
 
@@ -33,8 +33,10 @@
 #include "llvm/IR/GlobalVariable.h"
 #include "llvm/IR/IRBuilder.h"
 #include "llvm/IR/Instruction.h"
+#include "llvm/IR/InstIterator.h"
 #include "llvm/IR/Instructions.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/IR/MDBuilder.h"
 #include "llvm/IR/Module.h"
 #include "llvm/IR/Type.h"
 #include "llvm/InitializePasses.h"
@@ -92,6 +94,14 @@ cl::opt<bool> RuntimeCounterRelocation(
     cl::desc("Enable relocating counters at runtime."),
     cl::init(false));
 
+cl::opt<bool> PerThreadCounters(
+    "instrprof-per-thread-counters",
+    cl::desc("Give each thread its own copy of the counters, allocated on "
+             "first use and added to the counters of the module by the "
+             "runtime. This avoids false sharing of the counters between "
+             "threads."),
+    cl::init(false));
+
 cl::opt<bool> ValueProfileStaticAlloc(
     "vp-static-alloc",
     cl::desc("Do static counter allocation for value profiler"),
@@ -471,6 +481,17 @@ static InstrProfIncrementInst *castToIncrementInst(Instruction *Instr) {
 bool InstrProfiling::lowerIntrinsics(Function *F) {
   bool MadeChange = false;
   PromotionCandidates.clear();
+  ThreadCounterBias = nullptr;
+  if (PerThreadCounters) {
+    // The entry block is split before the increments are lowered, so that the
+    // iteration below is not disturbed.
+    for (Instruction &I : instructions(F)) {
+      if (castToIncrementInst(&I)) {
+        ThreadCounterBias = emitThreadCounterBias(F);
+        break;
+      }
+    }
+  }
   for (BasicBlock &BB : *F) {
     for (auto I = BB.begin(), E = BB.end(); I != E;) {
       auto Instr = I++;
@@ -499,6 +520,58 @@ bool InstrProfiling::isRuntimeCounterRelocationEnabled() const {
   return TT.isOSFuchsia();
 }
 
+Value *InstrProfiling::emitThreadCounterBias(Function *F) {
+  LLVMContext &Ctx = M->getContext();
+  Type *Int64Ty = Type::getInt64Ty(Ctx);
+  BasicBlock &Entry = F->getEntryBlock();
+
+  // Static allocas must stay in the entry block: move them ahead of the split
+  // point.
+  auto IsStaticAlloca = [](Instruction &I) {
+    auto *AI = dyn_cast<AllocaInst>(&I);
+    return AI && AI->isStaticAlloca();
+  };
+  BasicBlock::iterator SplitPt = Entry.getFirstInsertionPt();
+  while (IsStaticAlloca(*SplitPt))
+    ++SplitPt;
+  for (auto I = std::next(SplitPt), E = Entry.end(); I != E;) {
+    Instruction &Inst = *I++;
+    if (IsStaticAlloca(Inst))
+      Inst.moveBefore(&*SplitPt);
+  }
+  BasicBlock *Cont = Entry.splitBasicBlock(SplitPt, "instrprof.thread.cont");
+  Entry.getTerminator()->eraseFromParent();
+
+  GlobalVariable *BiasVar =
+      M->getGlobalVariable(getInstrProfThreadCounterBiasVarName());
+  if (!BiasVar) {
+    BiasVar = new GlobalVariable(
+        *M, Int64Ty, false, GlobalValue::ExternalLinkage, nullptr,
+        getInstrProfThreadCounterBiasVarName(), nullptr,
+        GlobalVariable::InitialExecTLSModel);
+    BiasVar->setVisibility(GlobalVariable::HiddenVisibility);
+  }
+
+  // The offset is 0 until the thread first runs instrumented code.
+  IRBuilder<> Builder(&Entry);
+  LoadInst *Bias = Builder.CreateLoad(Int64Ty, BiasVar, "pgo.thread.bias");
+  BasicBlock *Alloc =
+      BasicBlock::Create(Ctx, "instrprof.thread.alloc", F, Cont);
+  Builder.CreateCondBr(Builder.CreateIsNull(Bias), Alloc, Cont,
+                       MDBuilder(Ctx).createBranchWeights(1, 1 << 20));
+
+  Builder.SetInsertPoint(Alloc);
+  FunctionCallee GetBias =
+      M->getOrInsertFunction(getInstrProfThreadCounterBiasFuncName(), Int64Ty);
+  Value *NewBias = Builder.CreateCall(GetBias);
+  Builder.CreateBr(Cont);
+
+  PHINode *Phi = PHINode::Create(Int64Ty, 2, "pgo.thread.bias", &Cont->front());
+  Phi->addIncoming(Bias, &Entry);
+  Phi->addIncoming(NewBias, Alloc);
+  return Phi;
+}
+
 bool InstrProfiling::isCounterPromotionEnabled() const {
   if (DoCounterPromotion.getNumOccurrences() > 0)
     return DoCounterPromotion;
@@ -731,7 +804,13 @@ void InstrProfiling::lowerIncrement(InstrProfIncrementInst *Inc) {
   Value *Addr = Builder.CreateConstInBoundsGEP2_64(Counters->getValueType(),
                                                    Counters, 0, Index);
 
-  if (isRuntimeCounterRelocationEnabled()) {
+  if (ThreadCounterBias) {
+    Type *Int64Ty = Type::getInt64Ty(M->getContext());
+    Type *Int64PtrTy = Type::getInt64PtrTy(M->getContext());
+    auto *Add = Builder.CreateAdd(Builder.CreatePtrToInt(Addr, Int64Ty),
+                                  ThreadCounterBias);
+    Addr = Builder.CreateIntToPtr(Add, Int64PtrTy);
+  } else if (isRuntimeCounterRelocationEnabled()) {
     Type *Int64Ty = Type::getInt64Ty(M->getContext());
     Type *Int64PtrTy = Type::getInt64PtrTy(M->getContext());
     Function *Fn = Inc->getParent()->getParent();
@@ -0,0 +1,46 @@
+; RUN: opt < %s -S -instrprof -instrprof-per-thread-counters | FileCheck %s
+
+target triple = "x86_64-unknown-linux-gnu"
+
+@__profn_foo = hidden constant [3 x i8] c"foo"
+@__profn_bar = hidden constant [3 x i8] c"bar"
+
+; CHECK: @__llvm_profile_thread_counter_bias = external hidden thread_local(initialexec) global i64
+
+; CHECK-LABEL: define void @foo
+; CHECK-NEXT: [[BIAS:%.*]] = load i64, i64* @__llvm_profile_thread_counter_bias
+; CHECK-NEXT: [[NULL:%.*]] = icmp eq i64 [[BIAS]], 0
+; CHECK-NEXT: br i1 [[NULL]], label %instrprof.thread.alloc, label %instrprof.thread.cont
+; CHECK: instrprof.thread.alloc:
+; CHECK-NEXT: [[NEWBIAS:%.*]] = call i64 @__llvm_profile_get_thread_counter_bias()
+; CHECK-NEXT: br label %instrprof.thread.cont
+; CHECK: instrprof.thread.cont:
+; CHECK-NEXT: [[PHI:%.*]] = phi i64 [ [[BIAS]], %{{.*}} ], [ [[NEWBIAS]], %instrprof.thread.alloc ]
+; CHECK-NEXT: [[ADDR:%.*]] = add i64 ptrtoint ([1 x i64]* @__profc_foo to i64), [[PHI]]
+; CHECK-NEXT: [[PTR:%.*]] = inttoptr i64 [[ADDR]] to i64*
+; CHECK-NEXT: %pgocount = load i64, i64* [[PTR]]
+; CHECK-NEXT: [[INC:%.*]] = add i64 %pgocount, 1
+; CHECK-NEXT: store i64 [[INC]], i64* [[PTR]]
+define void @foo() {
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_foo, i32 0, i32 0), i64 0, i32 1, i32 0)
+  ret void
+}
+
+; The static allocas stay in the entry block, ahead of the bias load.
+; CHECK-LABEL: define void @bar
+; CHECK-NEXT: %a = alloca i32
+; CHECK-NEXT: [[BIAS:%.*]] = load i64, i64* @__llvm_profile_thread_counter_bias
+; CHECK: instrprof.thread.cont:
+; CHECK-NEXT: [[PHI:%.*]] = phi i64
+; CHECK-NEXT: store i32 0, i32* %a
+; CHECK-NEXT: [[ADDR:%.*]] = add i64 ptrtoint ([2 x i64]* @__profc_bar to i64), [[PHI]]
+; CHECK: [[ADDR:%.*]] = add i64 ptrtoint (i64* getelementptr inbounds ([2 x i64], [2 x i64]* @__profc_bar, i64 0, i64 1) to i64), [[PHI]]
+define void @bar() {
+  %a = alloca i32
+  store i32 0, i32* %a
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 0, i32 2, i32 0)
+  call void @llvm.instrprof.increment(i8* getelementptr inbounds ([3 x i8], [3 x i8]* @__profn_bar, i32 0, i32 0), i64 0, i32 2, i32 1)
+  ret void
+}
+
+declare void @llvm.instrprof.increment(i8*, i64, i32, i32)
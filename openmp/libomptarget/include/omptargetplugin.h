@@ -36,6 +36,12 @@ int32_t __tgt_rtl_is_valid_binary(__tgt_device_image *Image);
 // function to move data from source device to destination device directly.
 int32_t __tgt_rtl_is_data_exchangable(int32_t SrcDevId, int32_t DstDevId);
 
+// Return an integer other than zero if the device shares the host address
+// space and host data should be mapped in place: libomptarget then uses the
+// host address of mapped data on the device, and neither allocates device
+// memory nor copies data for it.
+int32_t __tgt_rtl_is_zero_copy(int32_t ID);
+
 // Initialize the requires flags for the device.
 int64_t __tgt_rtl_init_requires(int64_t RequiresFlags);
 
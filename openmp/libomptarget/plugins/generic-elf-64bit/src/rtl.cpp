@@ -70,6 +70,10 @@ class RTLDeviceInfoTy {
 public:
   std::list<DynLibTy> DynLibs;
 
+  // Map host data in place instead of copying it to device buffers, as the
+  // devices of this plugin run in the host address space.
+  bool ZeroCopy = false;
+
   // Record entry point associated with device.
   void createOffloadTable(int32_t device_id, __tgt_offload_entry *begin,
                           __tgt_offload_entry *end) {
@@ -113,6 +117,11 @@ public:
     }
 #endif // OMPTARGET_DEBUG
 
+    if (char *envStr = getenv("LIBOMPTARGET_ZERO_COPY")) {
+      ZeroCopy = std::stoi(envStr);
+      DP("Parsed LIBOMPTARGET_ZERO_COPY=%d\n", ZeroCopy);
+    }
+
     FuncGblEntries.resize(num_devices);
   }
 
@@ -144,6 +153,10 @@ int32_t __tgt_rtl_is_valid_binary(__tgt_device_image *image) {
 
 int32_t __tgt_rtl_number_of_devices() { return NUMBER_OF_DEVICES; }
 
+int32_t __tgt_rtl_is_zero_copy(int32_t device_id) {
+  return DeviceInfo.ZeroCopy;
+}
+
 int32_t __tgt_rtl_init_device(int32_t device_id) { return OFFLOAD_SUCCESS; }
 
 __tgt_target_table *__tgt_rtl_load_binary(int32_t device_id,
@@ -178,6 +178,7 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
       ((lr.Flags.ExtendsBefore || lr.Flags.ExtendsAfter) && IsImplicit)) {
     auto &HT = *lr.Entry;
     IsNew = false;
+    IsHostPtr = isHostMapped(HT);
 
     if (UpdateRefCount)
       HT.incRefCount();
@@ -224,8 +225,17 @@ void *DeviceTy::getOrAllocTgtPtr(void *HstPtrBegin, void *HstPtrBase,
             DPxPTR(HstPtrBegin), Size);
   } else if (Size) {
     // If it is not contained and Size > 0, we should create a new entry for it.
+    // A zero-copy device maps the host data in place, unless the close map
+    // modifier asks for a separate copy. The entry still counts references so
+    // that nested maps of the same data share it.
     IsNew = true;
-    uintptr_t tp = (uintptr_t)allocData(Size, HstPtrBegin);
+    uintptr_t tp;
+    if (IsZeroCopy && !HasCloseModifier) {
+      IsHostPtr = true;
+      tp = (uintptr_t)HstPtrBegin;
+    } else {
+      tp = (uintptr_t)allocData(Size, HstPtrBegin);
+    }
     DP("Creating new map entry: HstBase=" DPxMOD ", HstBegin=" DPxMOD ", "
        "HstEnd=" DPxMOD ", TgtBegin=" DPxMOD "\n",
        DPxPTR(HstPtrBase), DPxPTR(HstPtrBegin),
@@ -256,6 +266,7 @@ void *DeviceTy::getTgtPtrBegin(void *HstPtrBegin, int64_t Size, bool &IsLast,
       (!MustContain && (lr.Flags.ExtendsBefore || lr.Flags.ExtendsAfter))) {
     auto &HT = *lr.Entry;
     IsLast = HT.getRefCount() == 1;
+    IsHostPtr = isHostMapped(HT);
 
     if (!IsLast && UpdateRefCount)
       HT.decRefCount();
@@ -307,9 +318,12 @@ int DeviceTy::deallocTgtPtr(void *HstPtrBegin, int64_t Size, bool ForceDelete,
     if (ForceDelete)
       HT.resetRefCount();
     if (HT.decRefCount() == 0) {
-      DP("Deleting tgt data " DPxMOD " of size %" PRId64 "\n",
-          DPxPTR(HT.TgtPtrBegin), Size);
-      deleteData((void *)HT.TgtPtrBegin);
+      // Data mapped in place belongs to the host, there is nothing to delete.
+      if (!isHostMapped(HT)) {
+        DP("Deleting tgt data " DPxMOD " of size %" PRId64 "\n",
+            DPxPTR(HT.TgtPtrBegin), Size);
+        deleteData((void *)HT.TgtPtrBegin);
+      }
       DP("Removing%s mapping with HstPtrBegin=" DPxMOD ", TgtPtrBegin=" DPxMOD
           ", Size=%" PRId64 "\n", (ForceDelete ? " (forced)" : ""),
           DPxPTR(HT.HstPtrBegin), DPxPTR(HT.TgtPtrBegin), Size);
@@ -333,6 +347,11 @@ void DeviceTy::init() {
     RTL->init_requires(RTLs->RequiresFlags);
   int32_t rc = RTL->init_device(RTLDeviceID);
   if (rc == OFFLOAD_SUCCESS) {
+    // Ask the plugin whether the device maps host data in place.
+    if (RTL->is_zero_copy && RTL->is_zero_copy(RTLDeviceID)) {
+      DP("Device %d maps host data without copies\n", DeviceID);
+      IsZeroCopy = true;
+    }
     IsInit = true;
   }
 }
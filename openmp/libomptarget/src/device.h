@@ -130,6 +130,9 @@ struct DeviceTy {
   bool IsInit;
   std::once_flag InitFlag;
   bool HasPendingGlobals;
+  // The device shares the host address space and maps host data in place:
+  // mapped data uses the host address, and is neither allocated nor copied.
+  bool IsZeroCopy;
 
   HostDataToTargetListTy HostDataToTargetMap;
   PendingCtorsDtorsPerLibrary PendingCtorsDtors;
@@ -144,15 +147,16 @@ struct DeviceTy {
 
   DeviceTy(RTLInfoTy *RTL)
       : DeviceID(-1), RTL(RTL), RTLDeviceID(-1), IsInit(false), InitFlag(),
-        HasPendingGlobals(false), HostDataToTargetMap(), PendingCtorsDtors(),
-        ShadowPtrMap(), DataMapMtx(), PendingGlobalsMtx(), ShadowMtx() {}
+        HasPendingGlobals(false), IsZeroCopy(false), HostDataToTargetMap(),
+        PendingCtorsDtors(), ShadowPtrMap(), DataMapMtx(), PendingGlobalsMtx(),
+        ShadowMtx() {}
 
   // The existence of mutexes makes DeviceTy non-copyable. We need to
   // provide a copy constructor and an assignment operator explicitly.
   DeviceTy(const DeviceTy &d)
       : DeviceID(d.DeviceID), RTL(d.RTL), RTLDeviceID(d.RTLDeviceID),
         IsInit(d.IsInit), InitFlag(), HasPendingGlobals(d.HasPendingGlobals),
-        HostDataToTargetMap(d.HostDataToTargetMap),
+        IsZeroCopy(d.IsZeroCopy), HostDataToTargetMap(d.HostDataToTargetMap),
         PendingCtorsDtors(d.PendingCtorsDtors), ShadowPtrMap(d.ShadowPtrMap),
         DataMapMtx(), PendingGlobalsMtx(), ShadowMtx(),
         LoopTripCnt(d.LoopTripCnt) {}
@@ -163,6 +167,7 @@ struct DeviceTy {
     RTLDeviceID = d.RTLDeviceID;
     IsInit = d.IsInit;
     HasPendingGlobals = d.HasPendingGlobals;
+    IsZeroCopy = d.IsZeroCopy;
     HostDataToTargetMap = d.HostDataToTargetMap;
     PendingCtorsDtors = d.PendingCtorsDtors;
     ShadowPtrMap = d.ShadowPtrMap;
@@ -231,6 +236,11 @@ struct DeviceTy {
 private:
   // Call to RTL
   void init(); // To be called only via DeviceTy::initOnce()
+
+  // Return true if the map entry uses the host data in place (zero-copy).
+  bool isHostMapped(const HostDataToTargetTy &HT) const {
+    return IsZeroCopy && HT.TgtPtrBegin == HT.HstPtrBegin;
+  }
 };
 
 /// Map between Device ID (i.e. openmp device id) and its DeviceTy.
@@ -307,7 +307,7 @@ int targetDataBegin(DeviceTy &Device, int32_t arg_num, void **args_base,
     // Address of pointer on the host and device, respectively.
     void *Pointer_HstPtrBegin, *PointerTgtPtrBegin;
     bool IsNew, Pointer_IsNew;
-    bool IsHostPtr = false;
+    bool IsHostPtr = false, Pointer_IsHostPtr = false;
     bool IsImplicit = arg_types[i] & OMP_TGT_MAPTYPE_IMPLICIT;
     // Force the creation of a device side copy of the data when:
     // a close map modifier was associated with a map that contained a to.
@@ -335,8 +335,9 @@ int targetDataBegin(DeviceTy &Device, int32_t arg_num, void **args_base,
       // PTR_AND_OBJ entry is handled below, and so the allocation might fail
       // when HasPresentModifier.
       PointerTgtPtrBegin = Device.getOrAllocTgtPtr(
-          HstPtrBase, HstPtrBase, sizeof(void *), Pointer_IsNew, IsHostPtr,
-          IsImplicit, UpdateRef, HasCloseModifier, HasPresentModifier);
+          HstPtrBase, HstPtrBase, sizeof(void *), Pointer_IsNew,
+          Pointer_IsHostPtr, IsImplicit, UpdateRef, HasCloseModifier,
+          HasPresentModifier);
       if (!PointerTgtPtrBegin) {
         DP("Call to getOrAllocTgtPtr returned null pointer (%s).\n",
            HasPresentModifier ? "'present' map type modifier"
@@ -403,11 +404,16 @@ int targetDataBegin(DeviceTy &Device, int32_t arg_num, void **args_base,
       }
     }
 
-    if (arg_types[i] & OMP_TGT_MAPTYPE_PTR_AND_OBJ && !IsHostPtr) {
-      DP("Update pointer (" DPxMOD ") -> [" DPxMOD "]\n",
-         DPxPTR(PointerTgtPtrBegin), DPxPTR(TgtPtrBegin));
+    if (arg_types[i] & OMP_TGT_MAPTYPE_PTR_AND_OBJ) {
       uint64_t Delta = (uint64_t)HstPtrBegin - (uint64_t)HstPtrBase;
       void *TgtPtrBase = (void *)((uint64_t)TgtPtrBegin - Delta);
+      // A pointer mapped in place already holds the address of a pointee
+      // mapped in place. Otherwise the pointer is written even when it is
+      // host memory, and its shadow entry restores it at the end of the map.
+      if (Pointer_IsHostPtr && TgtPtrBase == HstPtrBase)
+        continue;
+      DP("Update pointer (" DPxMOD ") -> [" DPxMOD "]\n",
+         DPxPTR(PointerTgtPtrBegin), DPxPTR(TgtPtrBegin));
       int rt = Device.submitData(PointerTgtPtrBegin, &TgtPtrBase,
                                  sizeof(void *), async_info_ptr);
       if (rt != OFFLOAD_SUCCESS) {
@@ -555,7 +561,7 @@ int targetDataEnd(DeviceTy &Device, int32_t ArgNum, void **ArgBases,
           }
         }
 
-        if ((DelEntry || Always || CopyMember) &&
+        if ((DelEntry || Always || CopyMember) && !IsHostPtr &&
             !(RTLs->RequiresFlags & OMP_REQ_UNIFIED_SHARED_MEMORY &&
               TgtPtrBegin == HstPtrBegin)) {
           DP("Moving %" PRId64 " bytes (tgt:" DPxMOD ") -> (hst:" DPxMOD ")\n",
@@ -590,7 +596,9 @@ int targetDataEnd(DeviceTy &Device, int32_t ArgNum, void **ArgBases,
           break;
 
         // If we copied the struct to the host, we need to restore the pointer.
-        if (ArgTypes[I] & OMP_TGT_MAPTYPE_FROM) {
+        // A struct mapped in place holds the device pointer itself, so that it
+        // is restored when unmapped even if it is not copied.
+        if ((ArgTypes[I] & OMP_TGT_MAPTYPE_FROM) || (IsHostPtr && DelEntry)) {
           DP("Restoring original host pointer value " DPxMOD " for host "
              "pointer " DPxMOD "\n",
              DPxPTR(Itr->second.HstPtrVal), DPxPTR(ShadowHstPtrAddr));
@@ -688,8 +696,9 @@ int target_data_update(DeviceTy &Device, int32_t arg_num,
       continue;
     }
 
-    if (RTLs->RequiresFlags & OMP_REQ_UNIFIED_SHARED_MEMORY &&
-        TgtPtrBegin == HstPtrBegin) {
+    if ((RTLs->RequiresFlags & OMP_REQ_UNIFIED_SHARED_MEMORY &&
+         TgtPtrBegin == HstPtrBegin) ||
+        IsHostPtr) {
       DP("hst data:" DPxMOD " unified and shared, becomes a noop\n",
          DPxPTR(HstPtrBegin));
       continue;
@@ -871,7 +880,8 @@ int processDataBefore(int64_t DeviceId, void *HostPtr, int32_t ArgNum,
              DPxPTR(HstPtrVal));
           continue;
         }
-        if (RTLs->RequiresFlags & OMP_REQ_UNIFIED_SHARED_MEMORY &&
+        if ((RTLs->RequiresFlags & OMP_REQ_UNIFIED_SHARED_MEMORY ||
+             Device.IsZeroCopy) &&
             TgtPtrBegin == HstPtrBegin) {
           DP("Unified memory is active, no need to map lambda captured"
              "variable (" DPxMOD ")\n",
@@ -27,6 +27,7 @@ struct __tgt_bin_desc;
 struct RTLInfoTy {
   typedef int32_t(is_valid_binary_ty)(void *);
   typedef int32_t(is_data_exchangable_ty)(int32_t, int32_t);
+  typedef int32_t(is_zero_copy_ty)(int32_t);
   typedef int32_t(number_of_devices_ty)();
   typedef int32_t(init_device_ty)(int32_t);
   typedef __tgt_target_table *(load_binary_ty)(int32_t, void *);
@@ -69,6 +70,7 @@ struct RTLInfoTy {
   // Functions implemented in the RTL.
   is_valid_binary_ty *is_valid_binary = nullptr;
   is_data_exchangable_ty *is_data_exchangable = nullptr;
+  is_zero_copy_ty *is_zero_copy = nullptr;
   number_of_devices_ty *number_of_devices = nullptr;
   init_device_ty *init_device = nullptr;
   load_binary_ty *load_binary = nullptr;
@@ -108,6 +110,7 @@ struct RTLInfoTy {
 #endif
     is_valid_binary = r.is_valid_binary;
     is_data_exchangable = r.is_data_exchangable;
+    is_zero_copy = r.is_zero_copy;
     number_of_devices = r.number_of_devices;
     init_device = r.init_device;
     load_binary = r.load_binary;
@@ -0,0 +1,110 @@
+// RUN: %libomptarget-compile-aarch64-unknown-linux-gnu && %libomptarget-run-aarch64-unknown-linux-gnu | %fcheck-aarch64-unknown-linux-gnu
+// RUN: %libomptarget-compile-aarch64-unknown-linux-gnu && env LIBOMPTARGET_ZERO_COPY=1 %libomptarget-run-aarch64-unknown-linux-gnu | %fcheck-aarch64-unknown-linux-gnu
+// RUN: %libomptarget-compile-powerpc64-ibm-linux-gnu && %libomptarget-run-powerpc64-ibm-linux-gnu | %fcheck-powerpc64-ibm-linux-gnu
+// RUN: %libomptarget-compile-powerpc64-ibm-linux-gnu && env LIBOMPTARGET_ZERO_COPY=1 %libomptarget-run-powerpc64-ibm-linux-gnu | %fcheck-powerpc64-ibm-linux-gnu
+// RUN: %libomptarget-compile-powerpc64le-ibm-linux-gnu && %libomptarget-run-powerpc64le-ibm-linux-gnu | %fcheck-powerpc64le-ibm-linux-gnu
+// RUN: %libomptarget-compile-powerpc64le-ibm-linux-gnu && env LIBOMPTARGET_ZERO_COPY=1 %libomptarget-run-powerpc64le-ibm-linux-gnu | %fcheck-powerpc64le-ibm-linux-gnu
+// RUN: %libomptarget-compile-x86_64-pc-linux-gnu && %libomptarget-run-x86_64-pc-linux-gnu | %fcheck-x86_64-pc-linux-gnu
+// RUN: %libomptarget-compile-x86_64-pc-linux-gnu && env LIBOMPTARGET_ZERO_COPY=1 %libomptarget-run-x86_64-pc-linux-gnu | %fcheck-x86_64-pc-linux-gnu
+
+/*
+  Test the mapping of data on the host devices, with and without
+  LIBOMPTARGET_ZERO_COPY=1, where the device uses the host data in place.
+  Both modes must give the same results, and keep the reference counts of
+  nested maps.
+*/
+#include <assert.h>
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define N 1024
+
+struct S {
+  int *p;
+};
+
+int c[N];
+#pragma omp declare target link(c)
+
+int main(int argc, char *argv[]) {
+  int device = omp_get_default_device();
+  int zero_copy = getenv("LIBOMPTARGET_ZERO_COPY") &&
+                  atoi(getenv("LIBOMPTARGET_ZERO_COPY"));
+  int a[N], b[N];
+  int *p = a;
+  struct S s = {b};
+
+  for (int i = 0; i < N; ++i)
+    a[i] = b[i] = i;
+
+#pragma omp target map(tofrom : a)
+  for (int i = 0; i < N; ++i)
+    a[i] += 1;
+
+  for (int i = 0; i < N; ++i)
+    assert(a[i] == i + 1);
+
+  // Nested maps share the mapping until the last one ends.
+#pragma omp target enter data map(to : a)
+#pragma omp target enter data map(to : a)
+#pragma omp target map(tofrom : a)
+  for (int i = 0; i < N; ++i)
+    a[i] += 1;
+#pragma omp target exit data map(release : a)
+  assert(omp_target_is_present(a, device));
+#pragma omp target update from(a)
+  for (int i = 0; i < N; ++i)
+    assert(a[i] == i + 2);
+#pragma omp target exit data map(from : a)
+  assert(!omp_target_is_present(a, device));
+
+  // Zero-copy uses the host address on the device.
+#pragma omp target data map(tofrom : a) use_device_ptr(p)
+  assert(!zero_copy || p == a);
+
+  // Private copies stay private.
+#pragma omp target firstprivate(a)
+  for (int i = 0; i < N; ++i)
+    a[i] = -1;
+
+  for (int i = 0; i < N; ++i)
+    assert(a[i] == i + 2);
+
+  // The pointer of the struct is attached to the mapped array.
+#pragma omp target map(tofrom : s, s.p[0 : N])
+  for (int i = 0; i < N; ++i)
+    s.p[i] *= 2;
+
+  assert(s.p == b);
+  for (int i = 0; i < N; ++i)
+    assert(b[i] == 2 * i);
+
+  // The close pointee of a struct mapped in place has a separate copy: the
+  // pointer of the struct is restored when the struct is unmapped.
+  struct S t = {a};
+#pragma omp target map(to : t) map(close, tofrom : t.p[0 : N])
+  for (int i = 0; i < N; ++i)
+    t.p[i] += 1;
+
+  assert(t.p == a);
+  for (int i = 0; i < N; ++i)
+    assert(a[i] == i + 3);
+
+  // The pointer of a link variable is a global of the device image, not host
+  // memory, and must be set to the data mapped in place.
+  for (int i = 0; i < N; ++i)
+    c[i] = i;
+#pragma omp target map(tofrom : c)
+  for (int i = 0; i < N; ++i)
+    c[i] += 3;
+
+  for (int i = 0; i < N; ++i)
+    assert(c[i] == i + 3);
+
+  printf("PASS\n");
+
+  return 0;
+}
+
+// CHECK: PASS
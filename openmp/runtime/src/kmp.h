@@ -360,6 +360,8 @@ enum sched_type : kmp_int32 {
   kmp_sch_static_balanced_chunked = 45,
   kmp_sch_guided_simd = 46, /**< guided with chunk adjustment */
   kmp_sch_runtime_simd = 47, /**< runtime with chunk adjustment */
+  kmp_sch_guided_steal = 48, /**< guided with per-thread ranges and stealing,
+                                accessible only through KMP_SCHEDULE */
 
   /* accessible only through KMP_SCHEDULE environment variable */
   kmp_sch_upper, /**< upper bound for unordered values */
@@ -948,6 +950,9 @@ typedef struct kmp_allocator_t {
   kmp_allocator_t *fb_data;
   kmp_uint64 pool_size;
   kmp_uint64 pool_used;
+  omp_alloctrait_value_t partition;
+  int pinned;
+  int map_pages; // allocate whole pages with their own NUMA policy
 } kmp_allocator_t;
 
 extern omp_allocator_handle_t __kmpc_init_allocator(int gtid,
@@ -962,6 +967,7 @@ extern void __kmpc_free(int gtid, void *ptr, omp_allocator_handle_t al);
 
 extern void __kmp_init_memkind();
 extern void __kmp_fini_memkind();
+extern void __kmp_init_mem_nodes();
 
 /* ------------------------------------------------------------------------ */
 
@@ -1788,6 +1794,8 @@ typedef enum kmp_bar_pat { /* Barrier communication patterns */
                                2, /* Hypercube-embedded tree with min branching
                                      factor 2^n */
                            bp_hierarchical_bar = 3, /* Machine hierarchy tree */
+                           bp_dist_bar = 4, /* Two-level tree with one group
+                                               of threads per package */
                            bp_last_bar /* Placeholder to mark the end */
 } kmp_bar_pat_e;
 
@@ -2059,6 +2067,7 @@ extern kmp_tasking_mode_t
     __kmp_tasking_mode; /* determines how/when to execute tasks */
 extern int __kmp_task_stealing_constraint;
 extern int __kmp_enable_task_throttling;
+extern int __kmp_task_deque_lock_free;
 extern kmp_int32 __kmp_default_device; // Set via OMP_DEFAULT_DEVICE if
 // specified, defaults to 0 otherwise
 // Set via OMP_MAX_TASK_PRIORITY if specified, defaults to 0 otherwise
@@ -2141,17 +2150,22 @@ typedef struct kmp_depend_info {
 struct kmp_depnode_list {
   kmp_depnode_t *node;
   kmp_depnode_list_t *next;
+  kmp_info_p *owner; /* thread whose pool the entry goes back to when freed */
 };
 
 // Max number of mutexinoutset dependencies per node
 #define MAX_MTX_DEPS 4
 
 typedef struct kmp_base_depnode {
-  kmp_depnode_list_t *successors; /* used under lock */
-  kmp_task_t *task; /* non-NULL if depnode is active, used under lock */
+  /* The first successor is kept in the node, so that chains of tasks do not
+     allocate lists. Both fields are set to a "done" marker when the task
+     finishes, so that no successor is linked any more (see kmp_taskdeps.h). */
+  std::atomic<kmp_depnode_t *> successor;
+  std::atomic<kmp_depnode_list_t *> successors;
+  kmp_task_t *task; /* non-NULL if depnode is active, cleared under lock */
   kmp_lock_t *mtx_locks[MAX_MTX_DEPS]; /* lock mutexinoutset dependent tasks */
   kmp_int32 mtx_num_locks; /* number of locks in mtx_locks array */
-  kmp_lock_t lock; /* guards shared fields: task, successors */
+  kmp_lock_t lock; /* guards task while OMPT reports dependences */
 #if KMP_SUPPORT_GRAPH_OUTPUT
   kmp_uint32 id;
 #endif
@@ -2177,10 +2191,11 @@ struct kmp_dephash_entry {
 
 typedef struct kmp_dephash {
   kmp_dephash_entry_t **buckets;
-  size_t size;
+  size_t size; /* power of 2 */
   size_t generation;
   kmp_uint32 nelements;
   kmp_uint32 nconflicts;
+  kmp_dephash_entry_t *last_entry; /* entry found by the last lookup */
 } kmp_dephash_t;
 
 typedef struct kmp_task_affinity_info {
@@ -2303,14 +2318,35 @@ struct kmp_taskdata { /* aligned during dynamic allocation       */
 // Make sure padding above worked
 KMP_BUILD_ASSERT(sizeof(kmp_taskdata_t) % sizeof(void *) == 0);
 
+// Buffer of a work-stealing deque. The buffers replaced when the deque grows
+// are kept until the deque is freed, since thieves may still read them.
+typedef struct kmp_ws_buffer {
+  struct kmp_ws_buffer *wb_prev; // Buffer replaced by this one
+  kmp_int64 wb_size; // Number of entries, a power of 2
+  std::atomic<kmp_taskdata_t *> wb_tasks[1]; // Actually wb_size entries
+} kmp_ws_buffer_t;
+
+// Chase-Lev work-stealing deque of the tasks pushed by a thread of the team.
+// The owner pushes and pops at the bottom without atomic read-modify-write
+// operations, except to race the thieves for the last task. The thieves take
+// the task at the top with a CAS. The indices only grow, wb_tasks is indexed
+// modulo wb_size.
+typedef struct kmp_ws_deque {
+  KMP_ALIGN_CACHE std::atomic<kmp_int64> wd_top; // Written by the thieves
+  KMP_ALIGN_CACHE std::atomic<kmp_int64> wd_bottom; // Written by the owner
+  std::atomic<kmp_ws_buffer_t *> wd_buffer;
+} kmp_ws_deque_t;
+
 // Data for task team but per thread
 typedef struct kmp_base_thread_data {
   kmp_info_p *td_thr; // Pointer back to thread info
   // Used only in __kmp_execute_tasks_template, maybe not avail until task is
   // queued?
   kmp_bootstrap_lock_t td_deque_lock; // Lock for accessing deque
-  kmp_taskdata_t *
-      *td_deque; // Deque of tasks encountered by td_thr, dynamically allocated
+  // Deque of tasks encountered by td_thr, dynamically allocated. With
+  // __kmp_task_deque_lock_free, it only holds the tasks given by other threads
+  // (see __kmp_give_task), td_thr pushes its tasks to td_ws_deque.
+  kmp_taskdata_t **td_deque;
   kmp_int32 td_deque_size; // Size of deck
   kmp_uint32 td_deque_head; // Head of deque (will wrap)
   kmp_uint32 td_deque_tail; // Tail of deque (will wrap)
@@ -2321,6 +2357,7 @@ typedef struct kmp_base_thread_data {
   kmp_task_stack_t td_susp_tied_tasks; // Stack of suspended tied tasks for task
 // scheduling constraint
 #endif // BUILD_TIED_TASK_STACK
+  kmp_ws_deque_t td_ws_deque; // Lock-free deque of the tasks of td_thr
 } kmp_base_thread_data_t;
 
 #define TASK_DEQUE_BITS 8 // Used solely to define INITIAL_TASK_DEQUE_SIZE
@@ -2550,6 +2587,11 @@ typedef struct KMP_ALIGN_CACHE kmp_base_info {
   std::atomic<bool> th_blocking;
 #endif
   kmp_cg_root_t *th_cg_roots; // list of cg_roots associated with this thread
+
+  // Pool of dependence list entries allocated by this thread
+  kmp_depnode_list_t *th_dep_list_free; // entries freed by this thread
+  std::atomic<kmp_depnode_list_t *> th_dep_list_returned; // freed by others
+  void *th_dep_list_blocks; // storage of the entries, freed when reaped
 } kmp_base_info_t;
 
 typedef union KMP_ALIGN_CACHE kmp_info {
@@ -2863,6 +2905,7 @@ extern enum library_type __kmp_library;
 extern enum sched_type __kmp_sched; /* default runtime scheduling */
 extern enum sched_type __kmp_static; /* default static scheduling method */
 extern enum sched_type __kmp_guided; /* default guided scheduling method */
+extern enum sched_type __kmp_dynamic; /* default dynamic scheduling method */
 extern enum sched_type __kmp_auto; /* default auto scheduling method */
 extern int __kmp_chunk; /* default runtime chunk size */
 
@@ -3331,6 +3374,7 @@ extern kmp_str_buf_t *__kmp_affinity_str_buf_mask(kmp_str_buf_t *buf,
                                                   kmp_affin_mask_t *mask);
 extern void __kmp_affinity_initialize(void);
 extern void __kmp_affinity_uninitialize(void);
+extern int __kmp_affinity_threads_per_pkg();
 extern void __kmp_affinity_set_init_mask(
     int gtid, int isa_root); /* set affinity according to KMP_AFFINITY */
 extern void __kmp_affinity_set_place(int gtid);
@@ -3524,6 +3568,7 @@ extern void __kmp_init_implicit_task(ident_t *loc_ref, kmp_info_t *this_thr,
                                      int set_curr_task);
 extern void __kmp_finish_implicit_task(kmp_info_t *this_thr);
 extern void __kmp_free_implicit_task(kmp_info_t *this_thr);
+extern void __kmp_free_depnode_list_pool(kmp_info_t *this_thr);
 
 extern kmp_event_t *__kmpc_task_allow_completion_event(ident_t *loc_ref,
                                                        int gtid,
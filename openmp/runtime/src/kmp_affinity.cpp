@@ -4709,6 +4709,14 @@ void __kmp_affinity_uninitialize(void) {
   KMPAffinity::destroy_api();
 }
 
+// Number of hardware threads sharing a package (and its last level cache), or
+// 0 if the topology was not detected. The flat map reports one thread per
+// package, which says nothing about the caches either.
+int __kmp_affinity_threads_per_pkg() {
+  int threads_per_pkg = nCoresPerPkg * __kmp_nThreadsPerCore;
+  return threads_per_pkg > 1 ? threads_per_pkg : 0;
+}
+
 void __kmp_affinity_set_init_mask(int gtid, int isa_root) {
   if (!KMP_AFFINITY_CAPABLE()) {
     return;
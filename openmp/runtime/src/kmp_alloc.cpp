@@ -14,6 +14,12 @@
 #include "kmp_io.h"
 #include "kmp_wrapper_malloc.h"
 
+#if KMP_OS_LINUX
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
 // Disable bget when it is not used
 #if KMP_USE_BGET
 
@@ -1335,6 +1341,187 @@ void __kmp_fini_memkind() {
 #endif
 }
 
+#if KMP_OS_LINUX
+// NUMA nodes with memory, for the partition trait of allocators: a node can
+// be used if its bit is set in __kmp_mem_nodes. The nodes above 63 are not
+// used.
+#define KMP_MAX_MEM_NODES 64
+static kmp_uint64 __kmp_mem_nodes;
+static int __kmp_num_mem_nodes;
+static size_t __kmp_mem_page_size;
+#endif
+
+void __kmp_init_mem_nodes() {
+#if KMP_OS_LINUX
+  __kmp_mem_page_size = (size_t)sysconf(_SC_PAGESIZE);
+  __kmp_mem_nodes = 0;
+  __kmp_num_mem_nodes = 0;
+  // The list of nodes has the format 0-3,5,7-8
+  FILE *f = fopen("/sys/devices/system/node/has_memory", "r");
+  if (f == NULL)
+    f = fopen("/sys/devices/system/node/online", "r");
+  if (f != NULL) {
+    int first, last, sep;
+    while (fscanf(f, "%d", &first) == 1) {
+      last = first;
+      sep = fgetc(f);
+      if (sep == '-') {
+        if (fscanf(f, "%d", &last) != 1)
+          break;
+        sep = fgetc(f);
+      }
+      for (int node = first; node <= last && node < KMP_MAX_MEM_NODES; ++node)
+        __kmp_mem_nodes |= (kmp_uint64)1 << node;
+      if (sep != ',')
+        break;
+    }
+    fclose(f);
+  }
+  if (__kmp_mem_nodes == 0)
+    __kmp_mem_nodes = 1; // no NUMA support, all memory is on node 0
+  for (int node = 0; node < KMP_MAX_MEM_NODES; ++node)
+    if (__kmp_mem_nodes & ((kmp_uint64)1 << node))
+      ++__kmp_num_mem_nodes;
+  KE_TRACE(25, ("__kmp_init_mem_nodes: %d NUMA nodes, mask %llx\n",
+                __kmp_num_mem_nodes, (unsigned long long)__kmp_mem_nodes));
+#endif
+}
+
+#if KMP_OS_LINUX
+static int __kmp_mbind(void *addr, size_t len, int mode, kmp_uint64 nodes) {
+  const int bits = 8 * sizeof(unsigned long);
+  unsigned long mask[KMP_MAX_MEM_NODES / (8 * sizeof(unsigned long))];
+  for (int i = 0; i < KMP_MAX_MEM_NODES / bits; ++i)
+    mask[i] = (unsigned long)(nodes >> (i * bits));
+  return syscall(__NR_mbind, addr, len, mode, mask, KMP_MAX_MEM_NODES + 1, 0);
+}
+
+// Sets the NUMA policy of the pages at addr for the partition trait of an
+// allocator. Returns false if the policy cannot be set.
+static bool __kmp_set_mem_partition(omp_alloctrait_value_t partition,
+                                    void *addr, size_t len) {
+  if (__kmp_num_mem_nodes < 2)
+    return true; // nothing to place
+  switch (partition) {
+  case omp_atv_nearest: {
+    unsigned cpu, node;
+    if (syscall(__NR_getcpu, &cpu, &node, NULL) != 0 ||
+        node >= KMP_MAX_MEM_NODES)
+      return false;
+    return __kmp_mbind(addr, len, MPOL_PREFERRED, (kmp_uint64)1 << node) == 0;
+  }
+  case omp_atv_blocked: {
+    // One block of pages per node, the last one may be shorter
+    size_t pages = len / __kmp_mem_page_size;
+    size_t block = (pages + __kmp_num_mem_nodes - 1) / __kmp_num_mem_nodes;
+    size_t offset = 0;
+    block *= __kmp_mem_page_size;
+    for (int node = 0; node < KMP_MAX_MEM_NODES && offset < len; ++node) {
+      if (!(__kmp_mem_nodes & ((kmp_uint64)1 << node)))
+        continue;
+      size_t size = len - offset < block ? len - offset : block;
+      if (__kmp_mbind((char *)addr + offset, size, MPOL_PREFERRED,
+                      (kmp_uint64)1 << node) != 0)
+        return false;
+      offset += size;
+    }
+    return true;
+  }
+  case omp_atv_interleaved:
+    return __kmp_mbind(addr, len, MPOL_INTERLEAVE, __kmp_mem_nodes) == 0;
+  default:
+    return true; // omp_atv_environment: the policy of the process
+  }
+}
+
+// Maps pages of memory for an allocator with a partition or pinned trait, as
+// the NUMA policy and the locking apply to whole pages. The size must be a
+// multiple of the page size.
+static void *__kmp_map_pages(kmp_allocator_t *al, size_t size) {
+  void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (ptr == MAP_FAILED)
+    return NULL;
+  // The policy must be set before the pages are touched, by mlock for one
+  if (!__kmp_set_mem_partition(al->partition, ptr, size) ||
+      (al->pinned && mlock(ptr, size) != 0)) {
+    KE_TRACE(10, ("__kmp_map_pages: cannot place %d bytes, errno %d\n",
+                  (int)size, errno));
+    munmap(ptr, size);
+    return NULL;
+  }
+  return ptr;
+}
+#endif // KMP_OS_LINUX
+
+#if USE_FAST_MEMORY == 3
+// Largest block taken from the free lists of fast memory
+#define KMP_FAST_ALLOC_MAX (64 * 128)
+#endif
+
+// Memory of the allocators that use neither memkind nor their own pages.
+// Small blocks come from the free lists of the thread, so that omp_alloc and
+// omp_free of the same sizes do not go through bget each time.
+static inline void *__kmp_alloc_thread_mem(int gtid, size_t size) {
+  kmp_info_t *th = __kmp_thread_from_gtid(gtid);
+#if USE_FAST_MEMORY == 3
+  if (size <= KMP_FAST_ALLOC_MAX)
+    return __kmp_fast_allocate(th, size);
+#endif
+  return __kmp_thread_malloc(th, size);
+}
+
+static inline void __kmp_free_thread_mem(int gtid, void *ptr, size_t size) {
+  kmp_info_t *th = __kmp_thread_from_gtid(gtid);
+#if USE_FAST_MEMORY == 3
+  if (size <= KMP_FAST_ALLOC_MAX) {
+    __kmp_fast_free(th, ptr);
+    return;
+  }
+#endif
+  __kmp_thread_free(th, ptr);
+}
+
+// Default memory, used by the pre-defined allocators and the default fallback
+static void *__kmp_alloc_default_mem(int gtid, size_t size) {
+  if (__kmp_memkind_available)
+    return kmp_mk_alloc(*mk_default, size);
+  return __kmp_alloc_thread_mem(gtid, size);
+}
+
+static void __kmp_free_default_mem(int gtid, void *ptr, size_t size) {
+  if (__kmp_memkind_available)
+    kmp_mk_free(*mk_default, ptr);
+  else
+    __kmp_free_thread_mem(gtid, ptr, size);
+}
+
+// Memory of a custom allocator, from its memkind or pages if it has any
+static void *__kmp_alloc_custom_mem(int gtid, kmp_allocator_t *al,
+                                    size_t size) {
+#if KMP_OS_LINUX
+  if (al->map_pages)
+    return __kmp_map_pages(al, size);
+#endif
+  if (__kmp_memkind_available)
+    return kmp_mk_alloc(*al->memkind, size);
+  return __kmp_alloc_thread_mem(gtid, size);
+}
+
+static void __kmp_free_custom_mem(int gtid, kmp_allocator_t *al, void *ptr,
+                                  size_t size) {
+#if KMP_OS_LINUX
+  if (al->map_pages) {
+    munmap(ptr, size);
+    return;
+  }
+#endif
+  if (__kmp_memkind_available)
+    kmp_mk_free(*al->memkind, ptr);
+  else
+    __kmp_free_thread_mem(gtid, ptr, size);
+}
+
 omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
                                              int ntraits,
                                              omp_alloctrait_t traits[]) {
@@ -1346,11 +1533,14 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
   int i;
   al = (kmp_allocator_t *)__kmp_allocate(sizeof(kmp_allocator_t)); // zeroed
   al->memspace = ms; // not used currently
+  al->partition = omp_atv_environment;
   for (i = 0; i < ntraits; ++i) {
     switch (traits[i].key) {
     case omp_atk_threadmodel:
     case omp_atk_access:
+      break;
     case omp_atk_pinned:
+      al->pinned = traits[i].value == omp_atv_true;
       break;
     case omp_atk_alignment:
       al->alignment = traits[i].value;
@@ -1369,7 +1559,12 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       al->fb_data = RCAST(kmp_allocator_t *, traits[i].value);
       break;
     case omp_atk_partition:
-      al->memkind = RCAST(void **, traits[i].value);
+      al->partition = (omp_alloctrait_value_t)traits[i].value;
+      KMP_DEBUG_ASSERT(
+          al->partition == omp_atv_environment ||
+          al->partition == omp_atv_nearest ||
+          al->partition == omp_atv_blocked ||
+          al->partition == omp_atv_interleaved);
       break;
     default:
       KMP_ASSERT2(0, "Unexpected allocator trait");
@@ -1387,7 +1582,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
   if (__kmp_memkind_available) {
     // Let's use memkind library if available
     if (ms == omp_high_bw_mem_space) {
-      if (al->memkind == (void *)omp_atv_interleaved && mk_hbw_interleave) {
+      if (al->partition == omp_atv_interleaved && mk_hbw_interleave) {
         al->memkind = mk_hbw_interleave;
       } else if (mk_hbw_preferred) {
         // AC: do not try to use MEMKIND_HBW for now, because memkind library
@@ -1402,7 +1597,7 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
         return omp_null_allocator;
       }
     } else {
-      if (al->memkind == (void *)omp_atv_interleaved && mk_interleave) {
+      if (al->partition == omp_atv_interleaved && mk_interleave) {
         al->memkind = mk_interleave;
       } else {
         al->memkind = mk_default;
@@ -1415,6 +1610,14 @@ omp_allocator_handle_t __kmpc_init_allocator(int gtid, omp_memspace_handle_t ms,
       return omp_null_allocator;
     }
   }
+#if KMP_OS_LINUX
+  // Place the memory ourselves, unless memkind already interleaves it
+  if (ms != omp_high_bw_mem_space &&
+      (al->pinned ||
+       (al->partition != omp_atv_environment &&
+        !(__kmp_memkind_available && al->memkind == mk_interleave))))
+    al->map_pages = 1;
+#endif
   return (omp_allocator_handle_t)al;
 }
 
@@ -1461,81 +1664,40 @@ void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
     align = al->alignment; // alignment requested by user
   }
   desc.size_a = size + sz_desc + align;
+#if KMP_OS_LINUX
+  if (allocator > kmp_max_mem_alloc && al->map_pages)
+    desc.size_a = (desc.size_a + __kmp_mem_page_size - 1) &
+                  ~(__kmp_mem_page_size - 1);
+#endif
 
-  if (__kmp_memkind_available) {
-    if (allocator < kmp_max_mem_alloc) {
-      // pre-defined allocator
-      if (allocator == omp_high_bw_mem_alloc && mk_hbw_preferred) {
-        ptr = kmp_mk_alloc(*mk_hbw_preferred, desc.size_a);
-      } else {
-        ptr = kmp_mk_alloc(*mk_default, desc.size_a);
-      }
-    } else if (al->pool_size > 0) {
+  if (allocator < kmp_max_mem_alloc) {
+    // pre-defined allocator
+    if (allocator == omp_high_bw_mem_alloc && mk_hbw_preferred) {
+      ptr = kmp_mk_alloc(*mk_hbw_preferred, desc.size_a);
+    } else if (allocator != omp_high_bw_mem_alloc || __kmp_memkind_available) {
+      ptr = __kmp_alloc_default_mem(gtid, desc.size_a);
+    } // else ptr == NULL, no HBW memory without memkind library
+  } else {
+    bool in_pool = true;
+    if (al->pool_size > 0) {
       // custom allocator with pool size requested
       kmp_uint64 used =
           KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, desc.size_a);
       if (used + desc.size_a > al->pool_size) {
         // not enough space, need to go fallback path
         KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
-        if (al->fb == omp_atv_default_mem_fb) {
-          al = (kmp_allocator_t *)omp_default_mem_alloc;
-          ptr = kmp_mk_alloc(*mk_default, desc.size_a);
-        } else if (al->fb == omp_atv_abort_fb) {
-          KMP_ASSERT(0); // abort fallback requested
-        } else if (al->fb == omp_atv_allocator_fb) {
-          KMP_ASSERT(al != al->fb_data);
-          al = al->fb_data;
-          return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
-        } // else ptr == NULL;
-      } else {
-        // pool has enough space
-        ptr = kmp_mk_alloc(*al->memkind, desc.size_a);
-        if (ptr == NULL) {
-          if (al->fb == omp_atv_default_mem_fb) {
-            al = (kmp_allocator_t *)omp_default_mem_alloc;
-            ptr = kmp_mk_alloc(*mk_default, desc.size_a);
-          } else if (al->fb == omp_atv_abort_fb) {
-            KMP_ASSERT(0); // abort fallback requested
-          } else if (al->fb == omp_atv_allocator_fb) {
-            KMP_ASSERT(al != al->fb_data);
-            al = al->fb_data;
-            return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
-          }
-        }
-      }
-    } else {
-      // custom allocator, pool size not requested
-      ptr = kmp_mk_alloc(*al->memkind, desc.size_a);
-      if (ptr == NULL) {
-        if (al->fb == omp_atv_default_mem_fb) {
-          al = (kmp_allocator_t *)omp_default_mem_alloc;
-          ptr = kmp_mk_alloc(*mk_default, desc.size_a);
-        } else if (al->fb == omp_atv_abort_fb) {
-          KMP_ASSERT(0); // abort fallback requested
-        } else if (al->fb == omp_atv_allocator_fb) {
-          KMP_ASSERT(al != al->fb_data);
-          al = al->fb_data;
-          return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
-        }
+        in_pool = false;
       }
     }
-  } else if (allocator < kmp_max_mem_alloc) {
-    // pre-defined allocator
-    if (allocator == omp_high_bw_mem_alloc) {
-      // ptr = NULL;
-    } else {
-      ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+    if (in_pool) {
+      ptr = __kmp_alloc_custom_mem(gtid, al, desc.size_a);
+      if (ptr == NULL && al->pool_size > 0)
+        KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
     }
-  } else if (al->pool_size > 0) {
-    // custom allocator with pool size requested
-    kmp_uint64 used =
-        KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, desc.size_a);
-    if (used + desc.size_a > al->pool_size) {
-      // not enough space, need to go fallback path
-      KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
+    if (ptr == NULL) {
       if (al->fb == omp_atv_default_mem_fb) {
         al = (kmp_allocator_t *)omp_default_mem_alloc;
-        ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
+        ptr = __kmp_alloc_default_mem(gtid, desc.size_a);
       } else if (al->fb == omp_atv_abort_fb) {
         KMP_ASSERT(0); // abort fallback requested
       } else if (al->fb == omp_atv_allocator_fb) {
@@ -1543,19 +1705,7 @@ void *__kmpc_alloc(int gtid, size_t size, omp_allocator_handle_t allocator) {
         al = al->fb_data;
         return __kmpc_alloc(gtid, size, (omp_allocator_handle_t)al);
       } // else ptr == NULL;
-    } else {
-      // pool has enough space
-      ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
-      if (ptr == NULL && al->fb == omp_atv_abort_fb) {
-        KMP_ASSERT(0); // abort fallback requested
-      } // no sense to look for another fallback because of same internal alloc
     }
-  } else {
-    // custom allocator, pool size not requested
-    ptr = __kmp_thread_malloc(__kmp_thread_from_gtid(gtid), desc.size_a);
-    if (ptr == NULL && al->fb == omp_atv_abort_fb) {
-      KMP_ASSERT(0); // abort fallback requested
-    } // no sense to look for another fallback because of same internal alloc
   }
   KE_TRACE(10, ("__kmpc_alloc: T#%d %p=alloc(%d)\n", gtid, ptr, desc.size_a));
   if (ptr == NULL)
@@ -1599,31 +1749,21 @@ void __kmpc_free(int gtid, void *ptr, const omp_allocator_handle_t allocator) {
   oal = (omp_allocator_handle_t)al; // cast to void* for comparisons
   KMP_DEBUG_ASSERT(al);
 
-  if (__kmp_memkind_available) {
-    if (oal < kmp_max_mem_alloc) {
-      // pre-defined allocator
-      if (oal == omp_high_bw_mem_alloc && mk_hbw_preferred) {
-        kmp_mk_free(*mk_hbw_preferred, desc.ptr_alloc);
-      } else {
-        kmp_mk_free(*mk_default, desc.ptr_alloc);
-      }
+  if (oal < kmp_max_mem_alloc) {
+    // pre-defined allocator
+    if (oal == omp_high_bw_mem_alloc && mk_hbw_preferred) {
+      kmp_mk_free(*mk_hbw_preferred, desc.ptr_alloc);
     } else {
-      if (al->pool_size > 0) { // custom allocator with pool size requested
-        kmp_uint64 used =
-            KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
-        (void)used; // to suppress compiler warning
-        KMP_DEBUG_ASSERT(used >= desc.size_a);
-      }
-      kmp_mk_free(*al->memkind, desc.ptr_alloc);
+      __kmp_free_default_mem(gtid, desc.ptr_alloc, desc.size_a);
     }
   } else {
-    if (oal > kmp_max_mem_alloc && al->pool_size > 0) {
+    if (al->pool_size > 0) { // custom allocator with pool size requested
       kmp_uint64 used =
           KMP_TEST_THEN_ADD64((kmp_int64 *)&al->pool_used, -desc.size_a);
       (void)used; // to suppress compiler warning
       KMP_DEBUG_ASSERT(used >= desc.size_a);
     }
-    __kmp_thread_free(__kmp_thread_from_gtid(gtid), desc.ptr_alloc);
+    __kmp_free_custom_mem(gtid, al, desc.ptr_alloc, desc.size_a);
   }
   KE_TRACE(10, ("__kmpc_free: T#%d freed %p (%p)\n", gtid, desc.ptr_alloc,
                 allocator));
@@ -1880,6 +2020,10 @@ alloc_call:
                 "alloc_size %d\n",
                 __kmp_gtid_from_thread(this_thr), alloc_size));
   alloc_ptr = bget(this_thr, (bufsize)alloc_size);
+  if (alloc_ptr == NULL) {
+    ptr = NULL;
+    goto end;
+  }
 
   // align ptr to DCACHE_LINE
   ptr = (void *)((((kmp_uintptr_t)alloc_ptr) + sizeof(kmp_mem_descr_t) +
@@ -1261,6 +1261,260 @@ static void __kmp_hierarchical_barrier_release(
                 gtid, team->t.t_id, tid, bt));
 }
 
+// Distributed barrier
+/* The team is split into groups of consecutive threads, one group per package
+   (hence per last level cache) when the machine topology is known. Every thread
+   arrives and waits on its own b_arrived and b_go flags, which sit on separate
+   cache lines, so that the only cache lines crossing packages are those of the
+   group leaders. Packages with many threads are split further, so that no
+   thread polls much more than 2*sqrt(nproc) flags. */
+static kmp_uint32 __kmp_dist_barrier_group_size(kmp_uint32 nproc) {
+  kmp_uint32 group_size = 0;
+#if KMP_AFFINITY_SUPPORTED
+  group_size = __kmp_affinity_threads_per_pkg();
+#endif
+  if (group_size == 0) { // No topology, use groups of about sqrt(nproc)
+    group_size = 2;
+    while (group_size * group_size < nproc)
+      group_size <<= 1;
+  }
+  while (group_size * group_size > 4 * nproc && !(group_size & 1))
+    group_size >>= 1;
+  return group_size;
+}
+
+static void
+__kmp_dist_barrier_gather(enum barrier_type bt, kmp_info_t *this_thr, int gtid,
+                          int tid, void (*reduce)(void *, void *)
+                                       USE_ITT_BUILD_ARG(void *itt_sync_obj)) {
+  KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(KMP_dist_gather);
+  kmp_team_t *team = this_thr->th.th_team;
+  kmp_bstate_t *thr_bar = &this_thr->th.th_bar[bt].bb;
+  kmp_info_t **other_threads = team->t.t_threads;
+  kmp_uint32 nproc = this_thr->th.th_team_nproc;
+  kmp_uint32 group_size = __kmp_dist_barrier_group_size(nproc);
+  kmp_uint32 group_tid = (kmp_uint32)tid % group_size;
+  kmp_uint64 new_state = 0;
+
+  KA_TRACE(
+      20, ("__kmp_dist_barrier_gather: T#%d(%d:%d) enter for barrier type %d\n",
+           gtid, team->t.t_id, tid, bt));
+  KMP_DEBUG_ASSERT(this_thr == other_threads[this_thr->th.th_info.ds.ds_tid]);
+
+#if USE_ITT_BUILD && USE_ITT_NOTIFY
+  // Barrier imbalance - save arrive time to the thread
+  if (__kmp_forkjoin_frames_mode == 3 || __kmp_forkjoin_frames_mode == 2) {
+    this_thr->th.th_bar_arrive_time = this_thr->th.th_bar_min_time =
+        __itt_get_timestamp();
+  }
+#endif
+  if (group_tid == 0) {
+    // Group leaders wait for the threads of their group, then the master waits
+    // for the other group leaders
+    kmp_uint32 child_tid = tid + 1;
+    kmp_uint32 last = tid + group_size;
+    kmp_uint32 skip = 1;
+    new_state = team->t.t_bar[bt].b_arrived + KMP_BARRIER_STATE_BUMP;
+    if (last > nproc)
+      last = nproc;
+    for (;;) {
+      for (; child_tid < last; child_tid += skip) {
+        kmp_info_t *child_thr = other_threads[child_tid];
+        kmp_bstate_t *child_bar = &child_thr->th.th_bar[bt].bb;
+#if KMP_CACHE_MANAGE
+        // Prefetch next thread's arrived count
+        if (child_tid + skip < last)
+          KMP_CACHE_PREFETCH(
+              &other_threads[child_tid + skip]->th.th_bar[bt].bb.b_arrived);
+#endif /* KMP_CACHE_MANAGE */
+        KA_TRACE(20,
+                 ("__kmp_dist_barrier_gather: T#%d(%d:%d) wait T#%d(%d:%u) "
+                  "arrived(%p) == %llu\n",
+                  gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
+                  team->t.t_id, child_tid, &child_bar->b_arrived, new_state));
+        // Wait for child to arrive
+        kmp_flag_64 flag(&child_bar->b_arrived, new_state);
+        flag.wait(this_thr, FALSE USE_ITT_BUILD_ARG(itt_sync_obj));
+        ANNOTATE_BARRIER_END(child_thr);
+#if USE_ITT_BUILD && USE_ITT_NOTIFY
+        // Barrier imbalance - write min of the thread time and a child time to
+        // the thread.
+        if (__kmp_forkjoin_frames_mode == 2) {
+          this_thr->th.th_bar_min_time = KMP_MIN(this_thr->th.th_bar_min_time,
+                                                 child_thr->th.th_bar_min_time);
+        }
+#endif
+        if (reduce) {
+          KA_TRACE(100,
+                   ("__kmp_dist_barrier_gather: T#%d(%d:%d) += T#%d(%d:%u)\n",
+                    gtid, team->t.t_id, tid,
+                    __kmp_gtid_from_tid(child_tid, team), team->t.t_id,
+                    child_tid));
+          ANNOTATE_REDUCE_AFTER(reduce);
+          OMPT_REDUCTION_DECL(this_thr, gtid);
+          OMPT_REDUCTION_BEGIN;
+          (*reduce)(this_thr->th.th_local.reduce_data,
+                    child_thr->th.th_local.reduce_data);
+          OMPT_REDUCTION_END;
+          ANNOTATE_REDUCE_BEFORE(reduce);
+          ANNOTATE_REDUCE_BEFORE(&team->t.t_bar);
+        }
+      }
+      if (!KMP_MASTER_TID(tid) || skip == group_size)
+        break;
+      child_tid = group_size;
+      last = nproc;
+      skip = group_size;
+    }
+  }
+
+  if (!KMP_MASTER_TID(tid)) { // Worker threads
+    kmp_int32 parent_tid = group_tid ? tid - group_tid : 0;
+
+    KA_TRACE(20,
+             ("__kmp_dist_barrier_gather: T#%d(%d:%d) releasing T#%d(%d:%d) "
+              "arrived(%p): %llu => %llu\n",
+              gtid, team->t.t_id, tid, __kmp_gtid_from_tid(parent_tid, team),
+              team->t.t_id, parent_tid, &thr_bar->b_arrived, thr_bar->b_arrived,
+              thr_bar->b_arrived + KMP_BARRIER_STATE_BUMP));
+
+    // Mark arrival to the group leader, or to the master for group leaders
+    /* After performing this write, a worker thread may not assume that the team
+       is valid any more - it could be deallocated by the master thread at any
+       time.  */
+    ANNOTATE_BARRIER_BEGIN(this_thr);
+    kmp_flag_64 flag(&thr_bar->b_arrived, other_threads[parent_tid]);
+    flag.release();
+  } else {
+    team->t.t_bar[bt].b_arrived = new_state;
+    KA_TRACE(20, ("__kmp_dist_barrier_gather: T#%d(%d:%d) set team %d "
+                  "arrived(%p) = %llu\n",
+                  gtid, team->t.t_id, tid, team->t.t_id,
+                  &team->t.t_bar[bt].b_arrived, team->t.t_bar[bt].b_arrived));
+  }
+  KA_TRACE(20,
+           ("__kmp_dist_barrier_gather: T#%d(%d:%d) exit for barrier type %d\n",
+            gtid, team->t.t_id, tid, bt));
+}
+
+static void __kmp_dist_barrier_release(
+    enum barrier_type bt, kmp_info_t *this_thr, int gtid, int tid,
+    int propagate_icvs USE_ITT_BUILD_ARG(void *itt_sync_obj)) {
+  KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(KMP_dist_release);
+  kmp_team_t *team;
+  kmp_bstate_t *thr_bar = &this_thr->th.th_bar[bt].bb;
+  kmp_uint32 nproc;
+  kmp_uint32 group_size;
+
+  if (!KMP_MASTER_TID(
+          tid)) { // Handle fork barrier workers who aren't part of a team yet
+    KA_TRACE(20, ("__kmp_dist_barrier_release: T#%d wait go(%p) == %u\n", gtid,
+                  &thr_bar->b_go, KMP_BARRIER_STATE_BUMP));
+    // Wait for the group leader, or the master, to release us
+    kmp_flag_64 flag(&thr_bar->b_go, KMP_BARRIER_STATE_BUMP);
+    flag.wait(this_thr, TRUE USE_ITT_BUILD_ARG(itt_sync_obj));
+    ANNOTATE_BARRIER_END(this_thr);
+#if USE_ITT_BUILD && USE_ITT_NOTIFY
+    if ((__itt_sync_create_ptr && itt_sync_obj == NULL) || KMP_ITT_DEBUG) {
+      // In fork barrier where we could not get the object reliably (or
+      // ITTNOTIFY is disabled)
+      itt_sync_obj = __kmp_itt_barrier_object(gtid, bs_forkjoin_barrier, 0, -1);
+      // Cancel wait on previous parallel region...
+      __kmp_itt_task_starting(itt_sync_obj);
+
+      if (bt == bs_forkjoin_barrier && TCR_4(__kmp_global.g.g_done))
+        return;
+
+      itt_sync_obj = __kmp_itt_barrier_object(gtid, bs_forkjoin_barrier);
+      if (itt_sync_obj != NULL)
+        // Call prepare as early as possible for "new" barrier
+        __kmp_itt_task_finished(itt_sync_obj);
+    } else
+#endif /* USE_ITT_BUILD && USE_ITT_NOTIFY */
+        // Early exit for reaping threads releasing forkjoin barrier
+        if (bt == bs_forkjoin_barrier && TCR_4(__kmp_global.g.g_done))
+      return;
+
+    // The worker thread may now assume that the team is valid.
+    team = __kmp_threads[gtid]->th.th_team;
+    KMP_DEBUG_ASSERT(team != NULL);
+    tid = __kmp_tid_from_gtid(gtid);
+
+    TCW_4(thr_bar->b_go, KMP_INIT_BARRIER_STATE);
+    KA_TRACE(20,
+             ("__kmp_dist_barrier_release: T#%d(%d:%d) set go(%p) = %u\n", gtid,
+              team->t.t_id, tid, &thr_bar->b_go, KMP_INIT_BARRIER_STATE));
+    KMP_MB(); // Flush all pending memory write invalidates.
+  } else {
+    team = __kmp_threads[gtid]->th.th_team;
+    KMP_DEBUG_ASSERT(team != NULL);
+    KA_TRACE(20, ("__kmp_dist_barrier_release: T#%d(%d:%d) master enter for "
+                  "barrier type %d\n",
+                  gtid, team->t.t_id, tid, bt));
+  }
+  nproc = this_thr->th.th_team_nproc;
+  group_size = __kmp_dist_barrier_group_size(nproc);
+
+  if ((kmp_uint32)tid % group_size == 0) {
+    // The master releases the other group leaders first, so that the groups
+    // are released in parallel, then every leader releases its own group
+    kmp_info_t **other_threads = team->t.t_threads;
+    kmp_uint32 child_tid = group_size;
+    kmp_uint32 last = nproc;
+    kmp_uint32 skip = group_size;
+    if (!KMP_MASTER_TID(tid) || group_size >= nproc) {
+      child_tid = tid + 1;
+      last = tid + group_size;
+      skip = 1;
+      if (last > nproc)
+        last = nproc;
+    }
+    for (;;) {
+      for (; child_tid < last; child_tid += skip) {
+        kmp_info_t *child_thr = other_threads[child_tid];
+        kmp_bstate_t *child_bar = &child_thr->th.th_bar[bt].bb;
+#if KMP_CACHE_MANAGE
+        // Prefetch next thread's go count
+        if (child_tid + skip < last)
+          KMP_CACHE_PREFETCH(
+              &other_threads[child_tid + skip]->th.th_bar[bt].bb.b_go);
+#endif /* KMP_CACHE_MANAGE */
+
+#if KMP_BARRIER_ICV_PUSH
+        {
+          KMP_TIME_DEVELOPER_PARTITIONED_BLOCK(USER_icv_copy);
+          if (propagate_icvs) {
+            __kmp_init_implicit_task(team->t.t_ident, child_thr, team,
+                                     child_tid, FALSE);
+            copy_icvs(&team->t.t_implicit_task_taskdata[child_tid].td_icvs,
+                      &team->t.t_implicit_task_taskdata[0].td_icvs);
+          }
+        }
+#endif // KMP_BARRIER_ICV_PUSH
+        KA_TRACE(
+            20,
+            ("__kmp_dist_barrier_release: T#%d(%d:%d) releasing T#%d(%d:%u)"
+             "go(%p): %u => %u\n",
+             gtid, team->t.t_id, tid, __kmp_gtid_from_tid(child_tid, team),
+             team->t.t_id, child_tid, &child_bar->b_go, child_bar->b_go,
+             child_bar->b_go + KMP_BARRIER_STATE_BUMP));
+        // Release child from barrier
+        ANNOTATE_BARRIER_BEGIN(child_thr);
+        kmp_flag_64 flag(&child_bar->b_go, child_thr);
+        flag.release();
+      }
+      if (skip == 1)
+        break;
+      child_tid = tid + 1;
+      last = group_size;
+      skip = 1;
+    }
+  }
+  KA_TRACE(
+      20, ("__kmp_dist_barrier_release: T#%d(%d:%d) exit for barrier type %d\n",
+           gtid, team->t.t_id, tid, bt));
+}
+
 // End of Barrier Algorithms
 
 // type traits for cancellable value
@@ -1406,6 +1660,11 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
             bt, this_thr, gtid, tid, reduce USE_ITT_BUILD_ARG(itt_sync_obj));
         break;
       }
+      case bp_dist_bar: {
+        __kmp_dist_barrier_gather(
+            bt, this_thr, gtid, tid, reduce USE_ITT_BUILD_ARG(itt_sync_obj));
+        break;
+      }
       case bp_tree_bar: {
         // don't set branch bits to 0; use linear
         KMP_ASSERT(__kmp_barrier_gather_branch_bits[bt]);
@@ -1518,6 +1777,11 @@ static int __kmp_barrier_template(enum barrier_type bt, int gtid, int is_split,
               bt, this_thr, gtid, tid, FALSE USE_ITT_BUILD_ARG(itt_sync_obj));
           break;
         }
+        case bp_dist_bar: {
+          __kmp_dist_barrier_release(
+              bt, this_thr, gtid, tid, FALSE USE_ITT_BUILD_ARG(itt_sync_obj));
+          break;
+        }
         case bp_tree_bar: {
           KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
           __kmp_tree_barrier_release(bt, this_thr, gtid, tid,
@@ -1648,6 +1912,11 @@ void __kmp_end_split_barrier(enum barrier_type bt, int gtid) {
                                            FALSE USE_ITT_BUILD_ARG(NULL));
         break;
       }
+      case bp_dist_bar: {
+        __kmp_dist_barrier_release(bt, this_thr, gtid, tid,
+                                   FALSE USE_ITT_BUILD_ARG(NULL));
+        break;
+      }
       case bp_tree_bar: {
         KMP_ASSERT(__kmp_barrier_release_branch_bits[bt]);
         __kmp_tree_barrier_release(bt, this_thr, gtid, tid,
@@ -1794,6 +2063,11 @@ void __kmp_join_barrier(int gtid) {
                                       NULL USE_ITT_BUILD_ARG(itt_sync_obj));
     break;
   }
+  case bp_dist_bar: {
+    __kmp_dist_barrier_gather(bs_forkjoin_barrier, this_thr, gtid, tid,
+                              NULL USE_ITT_BUILD_ARG(itt_sync_obj));
+    break;
+  }
   case bp_tree_bar: {
     KMP_ASSERT(__kmp_barrier_gather_branch_bits[bs_forkjoin_barrier]);
     __kmp_tree_barrier_gather(bs_forkjoin_barrier, this_thr, gtid, tid,
@@ -1986,6 +2260,11 @@ void __kmp_fork_barrier(int gtid, int tid) {
                                        TRUE USE_ITT_BUILD_ARG(itt_sync_obj));
     break;
   }
+  case bp_dist_bar: {
+    __kmp_dist_barrier_release(bs_forkjoin_barrier, this_thr, gtid, tid,
+                               TRUE USE_ITT_BUILD_ARG(itt_sync_obj));
+    break;
+  }
   case bp_tree_bar: {
     KMP_ASSERT(__kmp_barrier_release_branch_bits[bs_forkjoin_barrier]);
     __kmp_tree_barrier_release(bs_forkjoin_barrier, this_thr, gtid, tid,
@@ -79,9 +79,64 @@ static inline int __kmp_get_monotonicity(enum sched_type schedule,
     monotonicity = SCHEDULE_NONMONOTONIC;
   else if (SCHEDULE_HAS_MONOTONIC(schedule))
     monotonicity = SCHEDULE_MONOTONIC;
+#if KMP_STATIC_STEAL_ENABLED
+  else if (!use_hier) {
+    // Without a modifier, dynamic and guided are nonmonotonic in OpenMP 5.0,
+    // so they may steal if KMP_SCHEDULE asks for it
+    enum sched_type kind = SCHEDULE_WITHOUT_MODIFIERS(schedule);
+    if ((kind == kmp_sch_dynamic_chunked &&
+         __kmp_dynamic == kmp_sch_static_steal) ||
+        ((kind == kmp_sch_guided_chunked || kind == kmp_sch_guided_steal) &&
+         __kmp_guided == kmp_sch_guided_steal))
+      monotonicity = SCHEDULE_NONMONOTONIC;
+  }
+#endif
   return monotonicity;
 }
 
+#if KMP_STATIC_STEAL_ENABLED
+// Number of threads in a group of potential victims of the stealing
+// schedules: the threads of a package, which tids are consecutive, or all the
+// threads when the topology is not known.
+template <typename T> static inline T __kmp_steal_group_size(T nproc) {
+  T group = 0;
+#if KMP_AFFINITY_SUPPORTED
+  group = __kmp_affinity_threads_per_pkg();
+#endif
+  return (group > 0 && group < nproc) ? group : nproc;
+}
+
+// Returns the victim to try after victim for the thief tid. The victims are
+// ranked cyclically from tid, first in the group of tid, then in the other
+// groups, so that the iterations stolen are more likely in the local memory.
+template <typename T>
+static inline T __kmp_steal_next_victim(T victim, T tid, T nproc, T group) {
+  T first = tid - tid % group;
+  T last = KMP_MIN(first + group, nproc);
+  T size = last - first;
+  T rank;
+  if (victim >= first && victim < last)
+    rank = (victim + size - tid) % size;
+  else
+    rank = size + (victim + nproc - last) % nproc;
+  if (++rank == nproc)
+    rank = 0;
+  if (rank < size)
+    return first + (tid - first + rank) % size;
+  return (last + rank - size) % nproc;
+}
+
+// Number of chunks a thread takes at once from its range of a stealing
+// schedule: one for dynamic, half of the remaining chunks for guided, so that
+// the first chunk is about tc / (2 * nproc) iterations as with guided.
+template <typename UT>
+static inline UT __kmp_steal_chunks(enum sched_type schedule, UT count, UT ub) {
+  if (schedule == kmp_sch_guided_steal && count + 3 < ub)
+    return (ub - count) >> 1;
+  return 1;
+}
+#endif // KMP_STATIC_STEAL_ENABLED
+
 // Initialize a dispatch_private_info_template<T> buffer for a particular
 // type of schedule,chunk.  The loop description is found in lb (lower bound),
 // ub (upper bound), and st (stride).  nproc is the number of threads relevant
@@ -230,10 +285,14 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
 #endif
     }
 #if KMP_STATIC_STEAL_ENABLED
-    // map nonmonotonic:dynamic to static steal
+    // map nonmonotonic:dynamic to static steal, and steal for guided only if
+    // it is nonmonotonic
     if (schedule == kmp_sch_dynamic_chunked) {
       if (monotonicity == SCHEDULE_NONMONOTONIC)
         schedule = kmp_sch_static_steal;
+    } else if (schedule == kmp_sch_guided_steal) {
+      if (monotonicity == SCHEDULE_MONOTONIC)
+        schedule = kmp_sch_guided_iterative_chunked;
     }
 #endif
     /* guided analytical not safe for too many threads */
@@ -337,8 +396,18 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
     }
   }
 
+#if (KMP_STATIC_STEAL_ENABLED)
+  if (schedule == kmp_sch_guided_steal &&
+      (nproc == 1 || (2L * chunk + 1) * nproc >= tc)) {
+    // too few iterations to share out, iterative guided switches to the
+    // appropriate schedule
+    schedule = kmp_sch_guided_iterative_chunked;
+  }
+#endif
+
   switch (schedule) {
 #if (KMP_STATIC_STEAL_ENABLED)
+  case kmp_sch_guided_steal:
   case kmp_sch_static_steal: {
     T ntc, init;
 
@@ -364,7 +433,9 @@ void __kmp_dispatch_init_algorithm(ident_t *loc, int gtid,
       // proportional to the number of chunks per thread up until
       // the maximum value of nproc.
       pr->u.p.parm3 = KMP_MIN(small_chunk + extras, nproc);
-      pr->u.p.parm4 = (id + 1) % nproc; // remember neighbour tid
+      // remember neighbour tid
+      pr->u.p.parm4 =
+          __kmp_steal_next_victim(id, id, nproc, __kmp_steal_group_size(nproc));
       pr->u.p.st = st;
       if (traits_t<T>::type_size > 4) {
         // AC: TODO: check if 16-byte CAS available and use it to
@@ -924,6 +995,7 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
       case kmp_sch_guided_iterative_chunked:
       case kmp_sch_guided_analytical_chunked:
       case kmp_sch_guided_simd:
+      case kmp_sch_guided_steal:
         schedtype = 2;
         break;
       default:
@@ -969,7 +1041,8 @@ __kmp_dispatch_init(ident_t *loc, int gtid, enum sched_type schedule, T lb,
   // all parm3 will be the same, it still exists a bad case like using 0 and 1
   // rather than program life-time increment. So the dedicated variable is
   // required. The 'static_steal_counter' is used.
-  if (pr->schedule == kmp_sch_static_steal) {
+  if (pr->schedule == kmp_sch_static_steal ||
+      pr->schedule == kmp_sch_guided_steal) {
     // Other threads will inspect this variable when searching for a victim.
     // This is a flag showing that other threads may steal from this thread
     // since then.
@@ -1186,8 +1259,10 @@ int __kmp_dispatch_next_algorithm(int gtid,
 
   switch (pr->schedule) {
 #if (KMP_STATIC_STEAL_ENABLED)
+  case kmp_sch_guided_steal:
   case kmp_sch_static_steal: {
     T chunk = pr->u.p.parm1;
+    UT nchunks = 1; // number of chunks obtained
 
     KD_TRACE(100,
              ("__kmp_dispatch_next_algorithm: T#%d kmp_sch_static_steal case\n",
@@ -1196,16 +1271,28 @@ int __kmp_dispatch_next_algorithm(int gtid,
     trip = pr->u.p.tc - 1;
 
     if (traits_t<T>::type_size > 4) {
-      // use lock for 8-byte and CAS for 4-byte induction
-      // variable. TODO (optional): check and use 16-byte CAS
+      // use the THE protocol for 8-byte and CAS for 4-byte induction
+      // variable: the owner bumps count atomically and then checks ub, while
+      // a thief lowers ub atomically and then checks count, so that at least
+      // one of them sees the other. The lock serializes the thieves, and the
+      // owner only when its chunks may have been stolen.
       kmp_lock_t *lck = pr->u.p.th_steal_lock;
       KMP_DEBUG_ASSERT(lck != NULL);
       if (pr->u.p.count < (UT)pr->u.p.ub) {
-        __kmp_acquire_lock(lck, gtid);
         // try to get own chunk of iterations
-        init = (pr->u.p.count)++;
-        status = (init < (UT)pr->u.p.ub);
-        __kmp_release_lock(lck, gtid);
+        nchunks =
+            __kmp_steal_chunks<UT>(pr->schedule, pr->u.p.count, pr->u.p.ub);
+        init = test_then_add<ST>((volatile ST *)&pr->u.p.count, (ST)nchunks);
+        limit = *(volatile T *)&pr->u.p.ub;
+        status = (init + nchunks <= limit);
+        if (!status) {
+          // a thief is lowering ub, take what it leaves when it is done
+          __kmp_acquire_lock(lck, gtid);
+          limit = pr->u.p.ub;
+          if ((status = (init < limit)) != 0 && init + nchunks > limit)
+            nchunks = limit - init;
+          __kmp_release_lock(lck, gtid);
+        }
       } else {
         status = 0; // no own chunks
       }
@@ -1216,20 +1303,19 @@ int __kmp_dispatch_next_algorithm(int gtid,
         T id = pr->u.p.static_steal_counter; // loop id
         int idx = (th->th.th_dispatch->th_disp_index - 1) %
                   __kmp_dispatch_num_buffers; // current loop index
+        T group = __kmp_steal_group_size(nproc);
         // note: victim thread can potentially execute another loop
-        // TODO: algorithm of searching for a victim
-        // should be cleaned up and measured
         while ((!status) && (while_limit != ++while_index)) {
           dispatch_private_info_template<T> *victim;
           T remaining;
           T victimIdx = pr->u.p.parm4;
-          T oldVictimIdx = victimIdx ? victimIdx - 1 : nproc - 1;
+          T tries = 1;
           victim = reinterpret_cast<dispatch_private_info_template<T> *>(
               &other_threads[victimIdx]->th.th_dispatch->th_disp_buffer[idx]);
           KMP_DEBUG_ASSERT(victim);
           while ((victim == pr || id != victim->u.p.static_steal_counter) &&
-                 oldVictimIdx != victimIdx) {
-            victimIdx = (victimIdx + 1) % nproc;
+                 tries++ < nproc) {
+            victimIdx = __kmp_steal_next_victim(victimIdx, tid, nproc, group);
             victim = reinterpret_cast<dispatch_private_info_template<T> *>(
                 &other_threads[victimIdx]->th.th_dispatch->th_disp_buffer[idx]);
             KMP_DEBUG_ASSERT(victim);
@@ -1240,7 +1326,9 @@ int __kmp_dispatch_next_algorithm(int gtid,
             // because no victim passed kmp_init_dispatch yet
           }
           if (victim->u.p.count + 2 > (UT)victim->u.p.ub) {
-            pr->u.p.parm4 = (victimIdx + 1) % nproc; // shift start tid
+            // shift start tid
+            pr->u.p.parm4 =
+                __kmp_steal_next_victim(victimIdx, tid, nproc, group);
             continue; // not enough chunks to steal, goto next victim
           }
 
@@ -1248,32 +1336,36 @@ int __kmp_dispatch_next_algorithm(int gtid,
           KMP_ASSERT(lck != NULL);
           __kmp_acquire_lock(lck, gtid);
           limit = victim->u.p.ub; // keep initial ub
-          if (victim->u.p.count >= limit ||
-              (remaining = limit - victim->u.p.count) < 2) {
+          init = *(volatile UT *)&victim->u.p.count;
+          if (init >= limit || (remaining = limit - init) < 2) {
             __kmp_release_lock(lck, gtid);
-            pr->u.p.parm4 = (victimIdx + 1) % nproc; // next victim
+            // next victim
+            pr->u.p.parm4 =
+                __kmp_steal_next_victim(victimIdx, tid, nproc, group);
             continue; // not enough chunks to steal
           }
-          // stealing succeeded, reduce victim's ub by 1/4 of undone chunks or
-          // by 1
-          if (remaining > 3) {
-            // steal 1/4 of remaining
-            KMP_COUNT_DEVELOPER_VALUE(FOR_static_steal_stolen, remaining >> 2);
-            init = (victim->u.p.ub -= (remaining >> 2));
-          } else {
-            // steal 1 chunk of 2 or 3 remaining
-            KMP_COUNT_DEVELOPER_VALUE(FOR_static_steal_stolen, 1);
-            init = (victim->u.p.ub -= 1);
+          // reduce victim's ub by half of undone chunks
+          init = limit - (remaining >> 1);
+          test_then_add<ST>((volatile ST *)&victim->u.p.ub,
+                            -(ST)(remaining >> 1));
+          if (*(volatile UT *)&victim->u.p.count > init) {
+            // the victim took some of these chunks meanwhile, give them back
+            victim->u.p.ub = limit;
+            __kmp_release_lock(lck, gtid);
+            continue;
           }
+          // stealing succeeded
+          KMP_COUNT_DEVELOPER_VALUE(FOR_static_steal_stolen, remaining >> 1);
           __kmp_release_lock(lck, gtid);
 
           KMP_DEBUG_ASSERT(init + 1 <= limit);
           pr->u.p.parm4 = victimIdx; // remember victim to steal from
           status = 1;
           while_index = 0;
-          // now update own count and ub with stolen range but init chunk
+          // now update own count and ub with stolen range but init chunk(s)
+          nchunks = __kmp_steal_chunks<UT>(pr->schedule, init, limit);
           __kmp_acquire_lock(pr->u.p.th_steal_lock, gtid);
-          pr->u.p.count = init + 1;
+          pr->u.p.count = init + nchunks;
           pr->u.p.ub = limit;
           __kmp_release_lock(pr->u.p.th_steal_lock, gtid);
         } // while (search for victim)
@@ -1293,7 +1385,8 @@ int __kmp_dispatch_next_algorithm(int gtid,
         union_i4 vold, vnew;
         vold.b = *(volatile kmp_int64 *)(&pr->u.p.count);
         vnew = vold;
-        vnew.p.count++;
+        nchunks = __kmp_steal_chunks<UT>(pr->schedule, vold.p.count, vold.p.ub);
+        vnew.p.count += nchunks;
         while (!KMP_COMPARE_AND_STORE_ACQ64(
             (volatile kmp_int64 *)&pr->u.p.count,
             *VOLATILE_CAST(kmp_int64 *) & vold.b,
@@ -1301,7 +1394,9 @@ int __kmp_dispatch_next_algorithm(int gtid,
           KMP_CPU_PAUSE();
           vold.b = *(volatile kmp_int64 *)(&pr->u.p.count);
           vnew = vold;
-          vnew.p.count++;
+          nchunks =
+              __kmp_steal_chunks<UT>(pr->schedule, vold.p.count, vold.p.ub);
+          vnew.p.count += nchunks;
         }
         vnew = vold;
         init = vnew.p.count;
@@ -1315,21 +1410,20 @@ int __kmp_dispatch_next_algorithm(int gtid,
         T id = pr->u.p.static_steal_counter; // loop id
         int idx = (th->th.th_dispatch->th_disp_index - 1) %
                   __kmp_dispatch_num_buffers; // current loop index
+        T group = __kmp_steal_group_size(nproc);
         // note: victim thread can potentially execute another loop
-        // TODO: algorithm of searching for a victim
-        // should be cleaned up and measured
         while ((!status) && (while_limit != ++while_index)) {
           dispatch_private_info_template<T> *victim;
           union_i4 vold, vnew;
           kmp_int32 remaining;
           T victimIdx = pr->u.p.parm4;
-          T oldVictimIdx = victimIdx ? victimIdx - 1 : nproc - 1;
+          T tries = 1;
           victim = reinterpret_cast<dispatch_private_info_template<T> *>(
               &other_threads[victimIdx]->th.th_dispatch->th_disp_buffer[idx]);
           KMP_DEBUG_ASSERT(victim);
           while ((victim == pr || id != victim->u.p.static_steal_counter) &&
-                 oldVictimIdx != victimIdx) {
-            victimIdx = (victimIdx + 1) % nproc;
+                 tries++ < nproc) {
+            victimIdx = __kmp_steal_next_victim(victimIdx, tid, nproc, group);
             victim = reinterpret_cast<dispatch_private_info_template<T> *>(
                 &other_threads[victimIdx]->th.th_dispatch->th_disp_buffer[idx]);
             KMP_DEBUG_ASSERT(victim);
@@ -1347,14 +1441,12 @@ int __kmp_dispatch_next_algorithm(int gtid,
             KMP_DEBUG_ASSERT((vnew.p.ub - 1) * (UT)chunk <= trip);
             if (vnew.p.count >= (UT)vnew.p.ub ||
                 (remaining = vnew.p.ub - vnew.p.count) < 2) {
-              pr->u.p.parm4 = (victimIdx + 1) % nproc; // shift start victim id
+              // shift start victim id
+              pr->u.p.parm4 =
+                  __kmp_steal_next_victim(victimIdx, tid, nproc, group);
               break; // not enough chunks to steal, goto next victim
             }
-            if (remaining > 3) {
-              vnew.p.ub -= (remaining >> 2); // try to steal 1/4 of remaining
-            } else {
-              vnew.p.ub -= 1; // steal 1 chunk of 2 or 3 remaining
-            }
+            vnew.p.ub -= (remaining >> 1); // try to steal half of remaining
             KMP_DEBUG_ASSERT((vnew.p.ub - 1) * (UT)chunk <= trip);
             // TODO: Should this be acquire or release?
             if (KMP_COMPARE_AND_STORE_ACQ64(
@@ -1368,7 +1460,8 @@ int __kmp_dispatch_next_algorithm(int gtid,
               while_index = 0;
               // now update own count and ub
               init = vnew.p.ub;
-              vold.p.count = init + 1;
+              nchunks = __kmp_steal_chunks<UT>(pr->schedule, init, vold.p.ub);
+              vold.p.count = init + nchunks;
 #if KMP_ARCH_X86
               KMP_XCHG_FIXED64((volatile kmp_int64 *)(&pr->u.p.count), vold.b);
 #else
@@ -1389,7 +1482,7 @@ int __kmp_dispatch_next_algorithm(int gtid,
     } else {
       start = pr->u.p.parm2;
       init *= chunk;
-      limit = chunk + init - 1;
+      limit = chunk * nchunks + init - 1;
       incr = pr->u.p.st;
       KMP_COUNT_DEVELOPER_VALUE(FOR_static_steal_chunks, 1);
 
@@ -2070,7 +2163,8 @@ static int __kmp_dispatch_next(ident_t *loc, int gtid, kmp_int32 *p_last,
 #endif
       if ((ST)num_done == th->th.th_team_nproc - 1) {
 #if (KMP_STATIC_STEAL_ENABLED)
-        if (pr->schedule == kmp_sch_static_steal &&
+        if ((pr->schedule == kmp_sch_static_steal ||
+             pr->schedule == kmp_sch_guided_steal) &&
             traits_t<T>::type_size > 4) {
           int i;
           int idx = (th->th.th_dispatch->th_disp_index - 1) %
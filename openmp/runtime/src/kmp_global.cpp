@@ -107,8 +107,8 @@ char const *__kmp_barrier_type_name[bs_last_barrier] = {"plain", "forkjoin"
                                                         "reduction"
 #endif // KMP_FAST_REDUCTION_BARRIER
 };
-char const *__kmp_barrier_pattern_name[bp_last_bar] = {"linear", "tree",
-                                                       "hyper", "hierarchical"};
+char const *__kmp_barrier_pattern_name[bp_last_bar] = {
+    "linear", "tree", "hyper", "hierarchical", "dist"};
 
 int __kmp_allThreadsSpecified = 0;
 size_t __kmp_align_alloc = CACHE_LINE;
@@ -142,6 +142,8 @@ enum sched_type __kmp_static =
     kmp_sch_static_greedy; /* default static scheduling method */
 enum sched_type __kmp_guided =
     kmp_sch_guided_iterative_chunked; /* default guided scheduling method */
+enum sched_type __kmp_dynamic =
+    kmp_sch_dynamic_chunked; /* default dynamic scheduling method */
 enum sched_type __kmp_auto =
     kmp_sch_guided_analytical_chunked; /* default auto scheduling method */
 #if KMP_USE_HIER_SCHED
@@ -329,6 +331,7 @@ KMP_BUILD_ASSERT(sizeof(kmp_tasking_flags_t) == 4);
 
 int __kmp_task_stealing_constraint = 1; /* Constrain task stealing by default */
 int __kmp_enable_task_throttling = 1;
+int __kmp_task_deque_lock_free = 1; /* Chase-Lev task deques by default */
 
 #ifdef DEBUG_SUSPEND
 int __kmp_suspend_count = 0;
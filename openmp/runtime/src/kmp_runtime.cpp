@@ -526,7 +526,10 @@ static void __kmp_print_team_storage_map(const char *header, kmp_team_t *team,
                                "%s_%d.t_disp_buffer", header, team_id);
 }
 
-static void __kmp_init_allocator() { __kmp_init_memkind(); }
+static void __kmp_init_allocator() {
+  __kmp_init_memkind();
+  __kmp_init_mem_nodes();
+}
 static void __kmp_fini_allocator() { __kmp_fini_memkind(); }
 
 /* ------------------------------------------------------------------------ */
@@ -2839,6 +2842,7 @@ void __kmp_get_schedule(int gtid, kmp_sched_t *kind, int *chunk) {
   case kmp_sch_guided_chunked:
   case kmp_sch_guided_iterative_chunked:
   case kmp_sch_guided_analytical_chunked:
+  case kmp_sch_guided_steal:
     *kind = kmp_sched_guided;
     break;
   case kmp_sch_auto:
@@ -5932,6 +5936,7 @@ static void __kmp_reap_thread(kmp_info_t *thread, int is_root) {
   }
 
   __kmp_free_implicit_task(thread);
+  __kmp_free_depnode_list_pool(thread);
 
 // Free the fast memory for tasking
 #if USE_FAST_MEMORY
@@ -3562,6 +3562,22 @@ static void __kmp_stg_parse_schedule(char const *name, char const *value,
               /* analytical not allowed for too many threads */
               __kmp_guided = kmp_sch_guided_analytical_chunked;
               continue;
+#if KMP_STATIC_STEAL_ENABLED
+            } else if (!__kmp_strcasecmp_with_sentinel("steal", comma, ';')) {
+              __kmp_guided = kmp_sch_guided_steal;
+              continue;
+#endif
+            }
+          } else if (!__kmp_strcasecmp_with_sentinel("dynamic", value,
+                                                     sentinel)) {
+            if (!__kmp_strcasecmp_with_sentinel("chunked", comma, ';')) {
+              __kmp_dynamic = kmp_sch_dynamic_chunked;
+              continue;
+#if KMP_STATIC_STEAL_ENABLED
+            } else if (!__kmp_strcasecmp_with_sentinel("steal", comma, ';')) {
+              __kmp_dynamic = kmp_sch_static_steal;
+              continue;
+#endif
             }
           }
           KMP_WARNING(InvalidClause, name, value);
@@ -3585,10 +3601,15 @@ static void __kmp_stg_print_schedule(kmp_str_buf_t *buffer, char const *name,
   } else if (__kmp_static == kmp_sch_static_balanced) {
     __kmp_str_buf_print(buffer, "%s", "static,balanced");
   }
+  if (__kmp_dynamic == kmp_sch_static_steal) {
+    __kmp_str_buf_print(buffer, ";%s", "dynamic,steal");
+  }
   if (__kmp_guided == kmp_sch_guided_iterative_chunked) {
     __kmp_str_buf_print(buffer, ";%s'\n", "guided,iterative");
   } else if (__kmp_guided == kmp_sch_guided_analytical_chunked) {
     __kmp_str_buf_print(buffer, ";%s'\n", "guided,analytical");
+  } else if (__kmp_guided == kmp_sch_guided_steal) {
+    __kmp_str_buf_print(buffer, ";%s'\n", "guided,steal");
   }
 } // __kmp_stg_print_schedule
 
@@ -3778,6 +3799,7 @@ static void __kmp_stg_parse_omp_schedule(char const *name, char const *value,
 #endif
   K_DIAG(1, ("__kmp_static == %d\n", __kmp_static))
   K_DIAG(1, ("__kmp_guided == %d\n", __kmp_guided))
+  K_DIAG(1, ("__kmp_dynamic == %d\n", __kmp_dynamic))
   K_DIAG(1, ("__kmp_sched == %d\n", __kmp_sched))
   K_DIAG(1, ("__kmp_chunk == %d\n", __kmp_chunk))
 } // __kmp_stg_parse_omp_schedule
@@ -4621,6 +4643,21 @@ static void __kmp_stg_print_task_throttling(kmp_str_buf_t *buffer,
   __kmp_stg_print_bool(buffer, name, __kmp_enable_task_throttling);
 } // __kmp_stg_print_task_throttling
 
+// -----------------------------------------------------------------------------
+// KMP_TASK_DEQUE_LOCK_FREE
+
+static void __kmp_stg_parse_task_deque_lock_free(char const *name,
+                                                 char const *value,
+                                                 void *data) {
+  __kmp_stg_parse_bool(name, value, &__kmp_task_deque_lock_free);
+} // __kmp_stg_parse_task_deque_lock_free
+
+static void __kmp_stg_print_task_deque_lock_free(kmp_str_buf_t *buffer,
+                                                 char const *name,
+                                                 void *data) {
+  __kmp_stg_print_bool(buffer, name, __kmp_task_deque_lock_free);
+} // __kmp_stg_print_task_deque_lock_free
+
 // -----------------------------------------------------------------------------
 // OMP_DISPLAY_ENV
 
@@ -4924,6 +4961,8 @@ static kmp_setting_t __kmp_stg_table[] = {
 #endif
     {"KMP_ENABLE_TASK_THROTTLING", __kmp_stg_parse_task_throttling,
      __kmp_stg_print_task_throttling, NULL, 0, 0},
+    {"KMP_TASK_DEQUE_LOCK_FREE", __kmp_stg_parse_task_deque_lock_free,
+     __kmp_stg_print_task_deque_lock_free, NULL, 0, 0},
 
     {"OMP_DISPLAY_ENV", __kmp_stg_parse_omp_display_env,
      __kmp_stg_print_omp_display_env, NULL, 0, 0},
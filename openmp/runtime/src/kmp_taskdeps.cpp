@@ -34,7 +34,8 @@ static std::atomic<kmp_int32> kmp_node_id_seed = ATOMIC_VAR_INIT(0);
 #endif
 
 static void __kmp_init_node(kmp_depnode_t *node) {
-  node->dn.successors = NULL;
+  KMP_ATOMIC_ST_RLX(&node->dn.successor, (kmp_depnode_t *)NULL);
+  KMP_ATOMIC_ST_RLX(&node->dn.successors, (kmp_depnode_list_t *)NULL);
   node->dn.task = NULL; // will point to the right task
   // once dependences have been processed
   for (int i = 0; i < MAX_MTX_DEPS; ++i)
@@ -52,27 +53,27 @@ static inline kmp_depnode_t *__kmp_node_ref(kmp_depnode_t *node) {
   return node;
 }
 
-enum { KMP_DEPHASH_OTHER_SIZE = 97, KMP_DEPHASH_MASTER_SIZE = 997 };
+enum { KMP_DEPHASH_OTHER_SIZE = 128, KMP_DEPHASH_MASTER_SIZE = 1024 };
 
-size_t sizes[] = { 997, 2003, 4001, 8191, 16001, 32003, 64007, 131071, 270029 };
-const size_t MAX_GEN = 8;
+// Entries of the pool of dependence lists allocated at once
+enum { KMP_DEPNODE_LIST_BLOCK = 64 };
 
 static inline kmp_int32 __kmp_dephash_hash(kmp_intptr_t addr, size_t hsize) {
-  // TODO alternate to try: set = (((Addr64)(addrUsefulBits * 9.618)) %
-  // m_num_sets );
-  return ((addr >> 6) ^ (addr >> 2)) % hsize;
+  // Neighbouring addresses go to neighbouring buckets, which keeps the lookups
+  // of arrays in cache. The high bits spread the addresses of objects laid out
+  // with a large power of 2 stride, such as pages, since hsize is a power of 2.
+  return ((addr >> 2) ^ (addr >> 6) ^ (addr >> 16)) & (hsize - 1);
 }
 
+// Doubles the size of the table. The entries are moved, not copied.
 static kmp_dephash_t *__kmp_dephash_extend(kmp_info_t *thread,
                                            kmp_dephash_t *current_dephash) {
   kmp_dephash_t *h;
 
   size_t gen = current_dephash->generation + 1;
-  if (gen >= MAX_GEN)
-    return current_dephash;
-  size_t new_size = sizes[gen];
+  size_t new_size = current_dephash->size * 2;
 
-  kmp_int32 size_to_allocate =
+  size_t size_to_allocate =
       new_size * sizeof(kmp_dephash_entry_t *) + sizeof(kmp_dephash_t);
 
 #if USE_FAST_MEMORY
@@ -86,6 +87,9 @@ static kmp_dephash_t *__kmp_dephash_extend(kmp_info_t *thread,
   h->buckets = (kmp_dephash_entry **)(h + 1);
   h->generation = gen;
   h->nconflicts = 0;
+  h->last_entry = current_dephash->last_entry;
+  for (size_t i = 0; i < new_size; i++)
+    h->buckets[i] = 0;
   // insert existing elements in the new table
   for (size_t i = 0; i < current_dephash->size; i++) {
     kmp_dephash_entry_t *next, *entry;
@@ -136,6 +140,7 @@ static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
   h->generation = 0;
   h->nelements = 0;
   h->nconflicts = 0;
+  h->last_entry = NULL;
   h->buckets = (kmp_dephash_entry **)(h + 1);
 
   for (size_t i = 0; i < h_size; i++)
@@ -150,8 +155,11 @@ static kmp_dephash_t *__kmp_dephash_create(kmp_info_t *thread,
 static kmp_dephash_entry *
 __kmp_dephash_find(kmp_info_t *thread, kmp_dephash_t **hash, kmp_intptr_t addr) {
   kmp_dephash_t *h = *hash;
-  if (h->nelements != 0
-      && h->nconflicts/h->size >= 1) {
+  // Fast path for the tasks that depend on the address of the previous one,
+  // as in chains of inout dependences
+  if (h->last_entry && h->last_entry->addr == addr)
+    return h->last_entry;
+  if (h->nconflicts >= h->size) {
     *hash = __kmp_dephash_extend(thread, h);
     h = *hash;
   }
@@ -183,21 +191,41 @@ __kmp_dephash_find(kmp_info_t *thread, kmp_dephash_t **hash, kmp_intptr_t addr)
     if (entry->next_in_bucket)
       h->nconflicts++;
   }
+  h->last_entry = entry;
   return entry;
 }
 
+// Refills the empty pool of dependence lists of the thread. The entries stay
+// in the pool of the thread until it is reaped.
+kmp_depnode_list_t *__kmp_depnode_list_alloc_block(kmp_info_t *thread) {
+  void **block = (void **)__kmp_allocate(
+      sizeof(void *) + KMP_DEPNODE_LIST_BLOCK * sizeof(kmp_depnode_list_t));
+  kmp_depnode_list_t *entries = (kmp_depnode_list_t *)(block + 1);
+  *block = thread->th.th_dep_list_blocks;
+  thread->th.th_dep_list_blocks = block;
+  for (int i = 0; i < KMP_DEPNODE_LIST_BLOCK; ++i) {
+    entries[i].owner = thread;
+    entries[i].next = i + 1 < KMP_DEPNODE_LIST_BLOCK ? &entries[i + 1] : NULL;
+  }
+  return entries;
+}
+
+void __kmp_free_depnode_list_pool(kmp_info_t *thread) {
+  void **next;
+  for (void **block = (void **)thread->th.th_dep_list_blocks; block;
+       block = next) {
+    next = (void **)*block;
+    __kmp_free(block);
+  }
+  thread->th.th_dep_list_blocks = NULL;
+  thread->th.th_dep_list_free = NULL;
+  thread->th.th_dep_list_returned = NULL;
+}
+
 static kmp_depnode_list_t *__kmp_add_node(kmp_info_t *thread,
                                           kmp_depnode_list_t *list,
                                           kmp_depnode_t *node) {
-  kmp_depnode_list_t *new_head;
-
-#if USE_FAST_MEMORY
-  new_head = (kmp_depnode_list_t *)__kmp_fast_allocate(
-      thread, sizeof(kmp_depnode_list_t));
-#else
-  new_head = (kmp_depnode_list_t *)__kmp_thread_malloc(
-      thread, sizeof(kmp_depnode_list_t));
-#endif
+  kmp_depnode_list_t *new_head = __kmp_depnode_list_alloc(thread);
 
   new_head->node = __kmp_node_ref(node);
   new_head->next = list;
@@ -236,6 +264,69 @@ static inline void __kmp_track_dependence(kmp_int32 gtid, kmp_depnode_t *source,
 #endif /* OMPT_SUPPORT && OMPT_OPTIONAL */
 }
 
+// Dependences must be reported while the predecessor task cannot finish, that
+// is under the lock of its node
+static inline bool __kmp_track_dependences() {
+#ifdef KMP_SUPPORT_GRAPH_OUTPUT
+  return true;
+#elif OMPT_SUPPORT && OMPT_OPTIONAL
+  return ompt_enabled.ompt_callback_task_dependence;
+#else
+  return false;
+#endif
+}
+
+// Links node as a successor of dep, without locking dep unless dependences are
+// tracked. Returns 1 if dep had not finished yet, 0 otherwise.
+static inline kmp_int32 __kmp_depnode_add_successor(kmp_int32 gtid,
+                                                    kmp_info_t *thread,
+                                                    kmp_task_t *task,
+                                                    kmp_depnode_t *dep,
+                                                    kmp_depnode_t *node) {
+  kmp_task_t *dep_task = dep->dn.task;
+  if (!dep_task)
+    return 0;
+  bool track = __kmp_track_dependences();
+  if (track) {
+    KMP_ACQUIRE_DEPNODE(gtid, dep);
+    if (!dep->dn.task) {
+      KMP_RELEASE_DEPNODE(gtid, dep);
+      return 0;
+    }
+    __kmp_track_dependence(gtid, dep, node, task);
+  }
+  kmp_int32 linked = 0;
+  kmp_depnode_t *first = NULL;
+  __kmp_node_ref(node);
+  if (dep->dn.successor.compare_exchange_strong(first, node)) {
+    linked = 1;
+  } else if (first != KMP_DEPNODE_DONE) {
+    kmp_depnode_list_t *head = KMP_ATOMIC_LD_RLX(&dep->dn.successors);
+    if (head != KMP_DEPNODE_LIST_DONE) {
+      kmp_depnode_list_t *entry = __kmp_depnode_list_alloc(thread);
+      entry->node = node;
+      do {
+        entry->next = head;
+      } while (head != KMP_DEPNODE_LIST_DONE &&
+               !dep->dn.successors.compare_exchange_weak(head, entry));
+      if (head == KMP_DEPNODE_LIST_DONE)
+        __kmp_depnode_list_entry_free(thread, entry);
+      else
+        linked = 1;
+    }
+  }
+  if (!linked)
+    __kmp_node_deref(thread, node);
+  if (track)
+    KMP_RELEASE_DEPNODE(gtid, dep);
+  if (linked)
+    KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
+                  "%p\n",
+                  gtid, KMP_TASK_TO_TASKDATA(dep_task),
+                  KMP_TASK_TO_TASKDATA(task)));
+  return linked;
+}
+
 static inline kmp_int32
 __kmp_depnode_link_successor(kmp_int32 gtid, kmp_info_t *thread,
                              kmp_task_t *task, kmp_depnode_t *node,
@@ -244,22 +335,9 @@ __kmp_depnode_link_successor(kmp_int32 gtid, kmp_info_t *thread,
     return 0;
   kmp_int32 npredecessors = 0;
   // link node as successor of list elements
-  for (kmp_depnode_list_t *p = plist; p; p = p->next) {
-    kmp_depnode_t *dep = p->node;
-    if (dep->dn.task) {
-      KMP_ACQUIRE_DEPNODE(gtid, dep);
-      if (dep->dn.task) {
-        __kmp_track_dependence(gtid, dep, node, task);
-        dep->dn.successors = __kmp_add_node(thread, dep->dn.successors, node);
-        KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
-                      "%p\n",
-                      gtid, KMP_TASK_TO_TASKDATA(dep->dn.task),
-                      KMP_TASK_TO_TASKDATA(task)));
-        npredecessors++;
-      }
-      KMP_RELEASE_DEPNODE(gtid, dep);
-    }
-  }
+  for (kmp_depnode_list_t *p = plist; p; p = p->next)
+    npredecessors +=
+        __kmp_depnode_add_successor(gtid, thread, task, p->node, node);
   return npredecessors;
 }
 
@@ -270,22 +348,8 @@ static inline kmp_int32 __kmp_depnode_link_successor(kmp_int32 gtid,
                                                      kmp_depnode_t *sink) {
   if (!sink)
     return 0;
-  kmp_int32 npredecessors = 0;
-  if (sink->dn.task) {
-    // synchronously add source to sink' list of successors
-    KMP_ACQUIRE_DEPNODE(gtid, sink);
-    if (sink->dn.task) {
-      __kmp_track_dependence(gtid, sink, source, task);
-      sink->dn.successors = __kmp_add_node(thread, sink->dn.successors, source);
-      KA_TRACE(40, ("__kmp_process_deps: T#%d adding dependence from %p to "
-                    "%p\n",
-                    gtid, KMP_TASK_TO_TASKDATA(sink->dn.task),
-                    KMP_TASK_TO_TASKDATA(task)));
-      npredecessors++;
-    }
-    KMP_RELEASE_DEPNODE(gtid, sink);
-  }
-  return npredecessors;
+  // synchronously add source to sink' list of successors
+  return __kmp_depnode_add_successor(gtid, thread, task, sink, source);
 }
 
 template <bool filter>
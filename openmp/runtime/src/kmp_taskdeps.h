@@ -20,6 +20,42 @@
 #define KMP_ACQUIRE_DEPNODE(gtid, n) __kmp_acquire_lock(&(n)->dn.lock, (gtid))
 #define KMP_RELEASE_DEPNODE(gtid, n) __kmp_release_lock(&(n)->dn.lock, (gtid))
 
+// Successors of a finished task
+#define KMP_DEPNODE_DONE ((kmp_depnode_t *)1)
+#define KMP_DEPNODE_LIST_DONE ((kmp_depnode_list_t *)1)
+
+extern kmp_depnode_list_t *__kmp_depnode_list_alloc_block(kmp_info_t *thread);
+
+// Dependence lists are allocated from a pool of the allocating thread. The
+// entries freed by other threads go back to that pool through
+// th_dep_list_returned.
+static inline kmp_depnode_list_t *__kmp_depnode_list_alloc(kmp_info_t *thread) {
+  kmp_depnode_list_t *entry = thread->th.th_dep_list_free;
+  if (!entry) {
+    entry = thread->th.th_dep_list_returned.exchange(NULL);
+    if (!entry)
+      entry = __kmp_depnode_list_alloc_block(thread);
+  }
+  thread->th.th_dep_list_free = entry->next;
+  return entry;
+}
+
+static inline void __kmp_depnode_list_entry_free(kmp_info_t *thread,
+                                                 kmp_depnode_list_t *entry) {
+  kmp_info_t *owner = entry->owner;
+  if (owner == thread) {
+    entry->next = thread->th.th_dep_list_free;
+    thread->th.th_dep_list_free = entry;
+  } else {
+    std::atomic<kmp_depnode_list_t *> *returned =
+        &owner->th.th_dep_list_returned;
+    kmp_depnode_list_t *head = *returned;
+    do {
+      entry->next = head;
+    } while (!returned->compare_exchange_weak(head, entry));
+  }
+}
+
 static inline void __kmp_node_deref(kmp_info_t *thread, kmp_depnode_t *node) {
   if (!node)
     return;
@@ -43,11 +79,7 @@ static inline void __kmp_depnode_list_free(kmp_info_t *thread,
     next = list->next;
 
     __kmp_node_deref(thread, list->node);
-#if USE_FAST_MEMORY
-    __kmp_fast_free(thread, list);
-#else
-    __kmp_thread_free(thread, list);
-#endif
+    __kmp_depnode_list_entry_free(thread, list);
   }
 }
 
@@ -74,6 +106,10 @@ static inline void __kmp_dephash_free_entries(kmp_info_t *thread,
       h->buckets[i] = 0;
     }
   }
+  // The hash table of an implicit task is reused by the next parallel region
+  h->nelements = 0;
+  h->nconflicts = 0;
+  h->last_entry = NULL;
 }
 
 static inline void __kmp_dephash_free(kmp_info_t *thread, kmp_dephash_t *h) {
@@ -85,6 +121,26 @@ static inline void __kmp_dephash_free(kmp_info_t *thread, kmp_dephash_t *h) {
 #endif
 }
 
+static inline void __kmp_release_successor(kmp_int32 gtid,
+                                           kmp_taskdata_t *task,
+                                           kmp_depnode_t *successor) {
+  if (!successor)
+    return;
+  kmp_int32 npredecessors = KMP_ATOMIC_DEC(&successor->dn.npredecessors) - 1;
+
+  // successor task can be NULL for wait_depends or because deps are still
+  // being processed
+  if (npredecessors == 0) {
+    KMP_MB();
+    if (successor->dn.task) {
+      KA_TRACE(20, ("__kmp_release_deps: T#%d successor %p of %p scheduled "
+                    "for execution.\n",
+                    gtid, successor->dn.task, task));
+      __kmp_omp_task(gtid, successor->dn.task, false);
+    }
+  }
+}
+
 static inline void __kmp_release_deps(kmp_int32 gtid, kmp_taskdata_t *task) {
   kmp_info_t *thread = __kmp_threads[gtid];
   kmp_depnode_t *node = task->td_depnode;
@@ -108,30 +164,19 @@ static inline void __kmp_release_deps(kmp_int32 gtid, kmp_taskdata_t *task) {
       NULL; // mark this task as finished, so no new dependencies are generated
   KMP_RELEASE_DEPNODE(gtid, node);
 
+  // Close the successor lists; threads still linking a successor now see the
+  // task as finished
+  kmp_depnode_t *successor = node->dn.successor.exchange(KMP_DEPNODE_DONE);
+  __kmp_release_successor(gtid, task, successor);
+  __kmp_node_deref(thread, successor);
   kmp_depnode_list_t *next;
-  for (kmp_depnode_list_t *p = node->dn.successors; p; p = next) {
-    kmp_depnode_t *successor = p->node;
-    kmp_int32 npredecessors = KMP_ATOMIC_DEC(&successor->dn.npredecessors) - 1;
-
-    // successor task can be NULL for wait_depends or because deps are still
-    // being processed
-    if (npredecessors == 0) {
-      KMP_MB();
-      if (successor->dn.task) {
-        KA_TRACE(20, ("__kmp_release_deps: T#%d successor %p of %p scheduled "
-                      "for execution.\n",
-                      gtid, successor->dn.task, task));
-        __kmp_omp_task(gtid, successor->dn.task, false);
-      }
-    }
-
+  for (kmp_depnode_list_t *p = node->dn.successors.exchange(
+           KMP_DEPNODE_LIST_DONE);
+       p; p = next) {
+    __kmp_release_successor(gtid, task, p->node);
     next = p->next;
     __kmp_node_deref(thread, p->node);
-#if USE_FAST_MEMORY
-    __kmp_fast_free(thread, p);
-#else
-    __kmp_thread_free(thread, p);
-#endif
+    __kmp_depnode_list_entry_free(thread, p);
   }
 
   __kmp_node_deref(thread, node);
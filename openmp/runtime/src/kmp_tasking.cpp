@@ -247,12 +247,12 @@ static void __kmp_pop_task_stack(kmp_int32 gtid, kmp_info_t *thread,
 }
 #endif /* BUILD_TIED_TASK_STACK */
 
-// returns 1 if new task is allowed to execute, 0 otherwise
-// checks Task Scheduling constraint (if requested) and
-// mutexinoutset dependencies if any
-static bool __kmp_task_is_allowed(int gtid, const kmp_int32 is_constrained,
-                                  const kmp_taskdata_t *tasknew,
-                                  const kmp_taskdata_t *taskcurr) {
+// returns true if new task obeys the Task Scheduling Constraint (if
+// requested). Unlike __kmp_task_is_allowed, it has no side effect, so that
+// a stolen task can be checked before its mutexinoutset locks are tried
+static bool __kmp_task_obeys_tsc(const kmp_int32 is_constrained,
+                                 const kmp_taskdata_t *tasknew,
+                                 const kmp_taskdata_t *taskcurr) {
   if (is_constrained && (tasknew->td_flags.tiedness == TASK_TIED)) {
     // Check if the candidate obeys the Task Scheduling Constraints (TSC)
     // only descendant of all deferred tied tasks can be scheduled, checking
@@ -273,7 +273,13 @@ static bool __kmp_task_is_allowed(int gtid, const kmp_int32 is_constrained,
         return false;
     }
   }
-  // Check mutexinoutset dependencies, acquire locks
+  return true;
+}
+
+// returns true if the locks of the mutexinoutset dependencies of new task
+// (if any) are acquired, false if one of them is busy
+static bool __kmp_task_acquire_mtx_locks(int gtid,
+                                         const kmp_taskdata_t *tasknew) {
   kmp_depnode_t *node = tasknew->td_depnode;
   if (node && (node->dn.mtx_num_locks > 0)) {
     for (int i = 0; i < node->dn.mtx_num_locks; ++i) {
@@ -291,6 +297,16 @@ static bool __kmp_task_is_allowed(int gtid, const kmp_int32 is_constrained,
   return true;
 }
 
+// returns 1 if new task is allowed to execute, 0 otherwise
+// checks Task Scheduling constraint (if requested) and
+// mutexinoutset dependencies if any
+static bool __kmp_task_is_allowed(int gtid, const kmp_int32 is_constrained,
+                                  const kmp_taskdata_t *tasknew,
+                                  const kmp_taskdata_t *taskcurr) {
+  return __kmp_task_obeys_tsc(is_constrained, tasknew, taskcurr) &&
+         __kmp_task_acquire_mtx_locks(gtid, tasknew);
+}
+
 // __kmp_realloc_task_deque:
 // Re-allocates a task deque for a particular thread, copies the content from
 // the old deque and adjusts the necessary data structures relating to the
@@ -321,6 +337,110 @@ static void __kmp_realloc_task_deque(kmp_info_t *thread,
   thread_data->td.td_deque_size = new_size;
 }
 
+// __kmp_alloc_ws_buffer: allocates a buffer of size entries for a lock-free
+// deque
+static kmp_ws_buffer_t *__kmp_alloc_ws_buffer(kmp_int64 size) {
+  kmp_ws_buffer_t *buffer = (kmp_ws_buffer_t *)__kmp_allocate(
+      sizeof(kmp_ws_buffer_t) +
+      (size - 1) * sizeof(std::atomic<kmp_taskdata_t *>));
+  buffer->wb_size = size;
+  return buffer;
+}
+
+// __kmp_ws_deque_ntasks: number of tasks in the lock-free deque of a thread.
+// Only a hint when the thread is not the owner of the deque.
+static inline kmp_int32 __kmp_ws_deque_ntasks(kmp_thread_data_t *thread_data) {
+  kmp_ws_deque_t *deque = &thread_data->td.td_ws_deque;
+  kmp_int64 ntasks =
+      KMP_ATOMIC_LD_RLX(&deque->wd_bottom) - KMP_ATOMIC_LD_RLX(&deque->wd_top);
+  return ntasks > 0 ? (kmp_int32)ntasks : 0;
+}
+
+// __kmp_deque_has_tasks: whether a thread has tasks in either of its deques.
+// Only a hint when the thread is not the owner of the deques.
+static inline bool __kmp_deque_has_tasks(kmp_thread_data_t *thread_data) {
+  return TCR_4(thread_data->td.td_deque_ntasks) != 0 ||
+         __kmp_ws_deque_ntasks(thread_data) != 0;
+}
+
+// __kmp_ws_push: pushes a task at the bottom of the lock-free deque of the
+// calling thread, doubling the deque if it is full. The replaced buffer is
+// kept until the deque is freed since thieves may still be reading it.
+static void __kmp_ws_push(kmp_info_t *thread, kmp_thread_data_t *thread_data,
+                          kmp_taskdata_t *taskdata) {
+  kmp_ws_deque_t *deque = &thread_data->td.td_ws_deque;
+  kmp_int64 bottom = KMP_ATOMIC_LD_RLX(&deque->wd_bottom);
+  kmp_int64 top = KMP_ATOMIC_LD_ACQ(&deque->wd_top);
+  kmp_ws_buffer_t *buffer = KMP_ATOMIC_LD_RLX(&deque->wd_buffer);
+
+  if (bottom - top >= buffer->wb_size) {
+    kmp_ws_buffer_t *new_buffer = __kmp_alloc_ws_buffer(2 * buffer->wb_size);
+    KE_TRACE(10, ("__kmp_ws_push: T#%d growing deque[from %d to %d] for "
+                  "thread_data %p\n",
+                  __kmp_gtid_from_thread(thread), (int)buffer->wb_size,
+                  (int)new_buffer->wb_size, thread_data));
+    // Tasks stolen during the copy are copied too but never read again
+    for (kmp_int64 i = top; i < bottom; ++i)
+      KMP_ATOMIC_ST_RLX(
+          &new_buffer->wb_tasks[i & (new_buffer->wb_size - 1)],
+          KMP_ATOMIC_LD_RLX(&buffer->wb_tasks[i & (buffer->wb_size - 1)]));
+    new_buffer->wb_prev = buffer;
+    KMP_ATOMIC_ST_REL(&deque->wd_buffer, new_buffer);
+    buffer = new_buffer;
+  }
+
+  KMP_ATOMIC_ST_RLX(&buffer->wb_tasks[bottom & (buffer->wb_size - 1)],
+                    taskdata);
+  // Publish the task before the thieves can see the new bottom
+  std::atomic_thread_fence(std::memory_order_release);
+  KMP_ATOMIC_ST_RLX(&deque->wd_bottom, bottom + 1);
+}
+
+// __kmp_ws_pop: removes the task at the bottom of the lock-free deque of the
+// calling thread, if it is allowed to run. Only the last task needs a CAS to
+// race the thieves.
+static kmp_taskdata_t *__kmp_ws_pop(kmp_info_t *thread, kmp_int32 gtid,
+                                    kmp_thread_data_t *thread_data,
+                                    kmp_int32 is_constrained) {
+  kmp_ws_deque_t *deque = &thread_data->td.td_ws_deque;
+  kmp_ws_buffer_t *buffer = KMP_ATOMIC_LD_RLX(&deque->wd_buffer);
+  kmp_int64 bottom = KMP_ATOMIC_LD_RLX(&deque->wd_bottom) - 1;
+
+  // Reserve the bottom task before looking at the top: a thief either sees
+  // the new bottom, or takes the task first and the owner sees the new top.
+  KMP_ATOMIC_ST_RLX(&deque->wd_bottom, bottom);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  kmp_int64 top = KMP_ATOMIC_LD_RLX(&deque->wd_top);
+
+  if (top > bottom) { // Empty
+    KMP_ATOMIC_ST_RLX(&deque->wd_bottom, bottom + 1);
+    return NULL;
+  }
+
+  kmp_taskdata_t *taskdata =
+      KMP_ATOMIC_LD_RLX(&buffer->wb_tasks[bottom & (buffer->wb_size - 1)]);
+  if (top == bottom) {
+    // Last task, a thief may be taking it too: claim it before reading it
+    bool won = deque->wd_top.compare_exchange_strong(
+        top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    KMP_ATOMIC_ST_RLX(&deque->wd_bottom, bottom + 1);
+    if (!won)
+      return NULL;
+  }
+
+  // No thief can take the task now
+  if (!__kmp_task_is_allowed(gtid, is_constrained, taskdata,
+                             thread->th.th_current_task)) {
+    // Put the task back, the deque still holds it unless it was the last one
+    if (top == bottom)
+      __kmp_ws_push(thread, thread_data, taskdata);
+    else
+      KMP_ATOMIC_ST_RLX(&deque->wd_bottom, bottom + 1);
+    return NULL;
+  }
+  return taskdata;
+}
+
 //  __kmp_push_task: Add a task to the thread's deque
 static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
   kmp_info_t *thread = __kmp_threads[gtid];
@@ -368,6 +488,30 @@ static kmp_int32 __kmp_push_task(kmp_int32 gtid, kmp_task_t *task) {
     __kmp_alloc_task_deque(thread, thread_data);
   }
 
+  if (__kmp_task_deque_lock_free) {
+    kmp_ws_deque_t *deque = &thread_data->td.td_ws_deque;
+    // Check if deque is full, only the owner can make it grow
+    if (__kmp_enable_task_throttling &&
+        KMP_ATOMIC_LD_RLX(&deque->wd_bottom) -
+                KMP_ATOMIC_LD_RLX(&deque->wd_top) >=
+            KMP_ATOMIC_LD_RLX(&deque->wd_buffer)->wb_size &&
+        __kmp_task_is_allowed(gtid, __kmp_task_stealing_constraint, taskdata,
+                              thread->th.th_current_task)) {
+      KA_TRACE(20, ("__kmp_push_task: T#%d deque is full; returning "
+                    "TASK_NOT_PUSHED for task %p\n",
+                    gtid, taskdata));
+      return TASK_NOT_PUSHED;
+    }
+    // The deque grows to push the task which is not allowed to execute
+    __kmp_ws_push(thread, thread_data, taskdata);
+    KMP_FSYNC_RELEASING(thread->th.th_current_task); // releasing self
+    KMP_FSYNC_RELEASING(taskdata); // releasing child
+    KA_TRACE(20, ("__kmp_push_task: T#%d returning TASK_SUCCESSFULLY_PUSHED: "
+                  "task=%p ntasks=%d\n",
+                  gtid, taskdata, __kmp_ws_deque_ntasks(thread_data)));
+    return TASK_SUCCESSFULLY_PUSHED;
+  }
+
   int locked = 0;
   // Check if deque is full
   if (TCR_4(thread_data->td.td_deque_ntasks) >=
@@ -2618,6 +2762,17 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
 
   thread_data = &task_team->tt.tt_threads_data[__kmp_tid_from_gtid(gtid)];
 
+  if (__kmp_task_deque_lock_free && thread_data->td.td_deque != NULL) {
+    taskdata = __kmp_ws_pop(thread, gtid, thread_data, is_constrained);
+    if (taskdata != NULL) {
+      KA_TRACE(10, ("__kmp_remove_my_task(exit #0): T#%d task %p removed "
+                    "from lock-free deque: ntasks=%d\n",
+                    gtid, taskdata, __kmp_ws_deque_ntasks(thread_data)));
+      return KMP_TASKDATA_TO_TASK(taskdata);
+    }
+    // Fall back to the tasks given by other threads
+  }
+
   KA_TRACE(10, ("__kmp_remove_my_task(enter): T#%d ntasks=%d head=%u tail=%u\n",
                 gtid, thread_data->td.td_deque_ntasks,
                 thread_data->td.td_deque_head, thread_data->td.td_deque_tail));
@@ -2673,6 +2828,92 @@ static kmp_task_t *__kmp_remove_my_task(kmp_info_t *thread, kmp_int32 gtid,
   return task;
 }
 
+// __kmp_steal_ws_task: remove a task from the top of the lock-free deque of
+// another thread. The task is only read once taken, since the owner may run
+// and free it meanwhile, so that a task the TSC does not allow to steal is
+// kept in the deque of the calling thread. When untied tasks were
+// encountered, the following tasks are tried too, as the lock-based deque
+// does by scanning the whole deque of the victim.
+static kmp_task_t *
+__kmp_steal_ws_task(kmp_info_t *victim_thr, kmp_int32 gtid,
+                    kmp_task_team_t *task_team, kmp_thread_data_t *victim_td,
+                    std::atomic<kmp_int32> *unfinished_threads,
+                    int *thread_finished, kmp_int32 is_constrained) {
+  kmp_info_t *thread = __kmp_threads[gtid];
+  kmp_taskdata_t *current = thread->th.th_current_task;
+  kmp_thread_data_t *thread_data =
+      &task_team->tt.tt_threads_data[__kmp_tid_from_gtid(gtid)];
+  kmp_ws_deque_t *deque = &victim_td->td.td_ws_deque;
+  kmp_int64 max_moves = 0;
+
+  for (kmp_int64 moves = 0;; ++moves) {
+    kmp_int64 top = KMP_ATOMIC_LD_ACQ(&deque->wd_top);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    kmp_int64 bottom = KMP_ATOMIC_LD_ACQ(&deque->wd_bottom);
+    if (top >= bottom) // Empty
+      return NULL;
+
+    kmp_ws_buffer_t *buffer = KMP_ATOMIC_LD_ACQ(&deque->wd_buffer);
+    kmp_taskdata_t *taskdata =
+        KMP_ATOMIC_LD_RLX(&buffer->wb_tasks[top & (buffer->wb_size - 1)]);
+
+    // We need to un-mark this thread as a finished thread before the task
+    // leaves the deque, or else other threads might be prematurely released
+    // from the barrier.
+    int was_finished = *thread_finished;
+    if (was_finished) {
+      kmp_int32 count = KMP_ATOMIC_INC(unfinished_threads);
+      KA_TRACE(20, ("__kmp_steal_ws_task: T#%d inc unfinished_threads to %d: "
+                    "task_team=%p\n",
+                    gtid, count + 1, task_team));
+      *thread_finished = FALSE;
+    }
+    if (!deque->wd_top.compare_exchange_strong(top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+      // Another thief or the owner took the task first
+      if (was_finished) {
+        KMP_ATOMIC_DEC(unfinished_threads);
+        *thread_finished = TRUE;
+      }
+      KA_TRACE(10, ("__kmp_steal_ws_task(exit #1): T#%d lost the race for "
+                    "task %p of T#%d\n",
+                    gtid, taskdata, __kmp_gtid_from_thread(victim_thr)));
+      return NULL;
+    }
+
+    // The task is ours now, it can be read
+    bool allowed = __kmp_task_obeys_tsc(is_constrained, taskdata, current);
+    if (allowed && __kmp_task_acquire_mtx_locks(gtid, taskdata)) {
+      KMP_COUNT_BLOCK(TASK_stolen);
+      KA_TRACE(10, ("__kmp_steal_ws_task(exit #2): T#%d stole task %p from "
+                    "T#%d: task_team=%p ntasks=%d\n",
+                    gtid, taskdata, __kmp_gtid_from_thread(victim_thr),
+                    task_team, (int)(bottom - top - 1)));
+      return KMP_TASKDATA_TO_TASK(taskdata);
+    }
+
+    // The task cannot run now, the calling thread keeps it in its own deque
+    if (thread_data->td.td_deque == NULL)
+      __kmp_alloc_task_deque(thread, thread_data);
+    __kmp_ws_push(thread, thread_data, taskdata);
+    KA_TRACE(10, ("__kmp_steal_ws_task: T#%d moved task %p of T#%d to its "
+                  "own deque\n",
+                  gtid, taskdata, __kmp_gtid_from_thread(victim_thr)));
+    if (allowed) // Its mutexinoutset dependencies are busy
+      return NULL;
+    // Scan the tasks in the deque now, like the lock-based deque does
+    if (moves == 0 && task_team->tt.tt_untied_task_encountered)
+      max_moves = bottom - top;
+    if (moves + 1 >= max_moves) {
+      KA_TRACE(10, ("__kmp_steal_ws_task(exit #3): T#%d could not steal "
+                    "from T#%d: TSC blocks task %p\n",
+                    gtid, __kmp_gtid_from_thread(victim_thr), taskdata));
+      return NULL;
+    }
+  }
+}
+
 // __kmp_steal_task: remove a task from another thread's deque
 // Assume that calling thread has already checked existence of
 // task_team thread_data before calling this routine.
@@ -2696,6 +2937,15 @@ static kmp_task_t *__kmp_steal_task(kmp_info_t *victim_thr, kmp_int32 gtid,
   victim_tid = victim_thr->th.th_info.ds.ds_tid;
   victim_td = &threads_data[victim_tid];
 
+  if (__kmp_task_deque_lock_free && victim_td->td.td_deque != NULL) {
+    task = __kmp_steal_ws_task(victim_thr, gtid, task_team, victim_td,
+                               unfinished_threads, thread_finished,
+                               is_constrained);
+    if (task != NULL)
+      return task;
+    // Fall back to the tasks given to the victim by other threads
+  }
+
   KA_TRACE(10, ("__kmp_steal_task(enter): T#%d try to steal from T#%d: "
                 "task_team=%p ntasks=%d head=%u tail=%u\n",
                 gtid, __kmp_gtid_from_thread(victim_thr), task_team,
@@ -2960,7 +3210,7 @@ static inline int __kmp_execute_tasks_template(
       KMP_YIELD(__kmp_library == library_throughput); // Yield before next task
       // If execution of a stolen task results in more tasks being placed on our
       // run queue, reset use_own_tasks
-      if (!use_own_tasks && TCR_4(threads_data[tid].td.td_deque_ntasks) != 0) {
+      if (!use_own_tasks && __kmp_deque_has_tasks(&threads_data[tid])) {
         KA_TRACE(20, ("__kmp_execute_tasks_template: T#%d stolen task spawned "
                       "other tasks, restart\n",
                       gtid));
@@ -3176,6 +3426,13 @@ static void __kmp_alloc_task_deque(kmp_info_t *thread,
   // Allocate space for task deque, and zero the deque
   // Cannot use __kmp_thread_calloc() because threads not around for
   // kmp_reap_task_team( ).
+  if (__kmp_task_deque_lock_free) {
+    kmp_ws_deque_t *deque = &thread_data->td.td_ws_deque;
+    KMP_ATOMIC_ST_RLX(&deque->wd_top, 0);
+    KMP_ATOMIC_ST_RLX(&deque->wd_bottom, 0);
+    KMP_ATOMIC_ST_REL(&deque->wd_buffer,
+                      __kmp_alloc_ws_buffer(INITIAL_TASK_DEQUE_SIZE));
+  }
   thread_data->td.td_deque = (kmp_taskdata_t **)__kmp_allocate(
       INITIAL_TASK_DEQUE_SIZE * sizeof(kmp_taskdata_t *));
   thread_data->td.td_deque_size = INITIAL_TASK_DEQUE_SIZE;
@@ -3192,6 +3449,15 @@ static void __kmp_free_task_deque(kmp_thread_data_t *thread_data) {
     thread_data->td.td_deque = NULL;
     __kmp_release_bootstrap_lock(&thread_data->td.td_deque_lock);
   }
+  // The buffers replaced when the lock-free deque grew are freed here too
+  kmp_ws_deque_t *deque = &thread_data->td.td_ws_deque;
+  kmp_ws_buffer_t *buffer = KMP_ATOMIC_LD_RLX(&deque->wd_buffer);
+  while (buffer != NULL) {
+    kmp_ws_buffer_t *prev = buffer->wb_prev;
+    __kmp_free(buffer);
+    buffer = prev;
+  }
+  KMP_ATOMIC_ST_RLX(&deque->wd_buffer, (kmp_ws_buffer_t *)NULL);
 
 #ifdef BUILD_TIED_TASK_STACK
   // GEH: Figure out what to do here for td_susp_tied_tasks
@@ -0,0 +1,145 @@
+// RUN: %libomp-compile-and-run
+
+/*
+ * Check the allocators with the partition and pinned traits, and the reuse of
+ * small blocks freed by omp_free:
+ *   - the memory of every partition, pinned or not, can be written and read
+ *     by all threads, and has the alignment requested,
+ *   - the pool size counts the memory of partitioned allocators,
+ *   - blocks of many sizes, freed by another thread than the one that
+ *     allocated them, keep their contents.
+ */
+
+#include <omp.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define N 10000
+#define BLOCKS 1000
+
+static int errors;
+
+static void error(const char *msg, int value) {
+#pragma omp atomic
+  ++errors;
+  fprintf(stderr, "%s: %d\n", msg, value);
+}
+
+static void check_partition(omp_alloctrait_value_t partition, int pinned) {
+  omp_alloctrait_t at[4];
+  omp_allocator_handle_t a;
+  at[0].key = omp_atk_partition;
+  at[0].value = partition;
+  at[1].key = omp_atk_pinned;
+  at[1].value = pinned ? omp_atv_true : omp_atv_false;
+  at[2].key = omp_atk_alignment;
+  at[2].value = 64;
+  at[3].key = omp_atk_fallback;
+  at[3].value = omp_atv_default_mem_fb;
+  a = omp_init_allocator(omp_default_mem_space, 4, at);
+  if (a == omp_null_allocator) {
+    error("no allocator for partition", partition);
+    return;
+  }
+#pragma omp parallel num_threads(4)
+  {
+    int *p = (int *)omp_alloc(N * sizeof(int), a);
+    int i;
+    if (p == NULL || (uintptr_t)p % 64 != 0) {
+      error("wrong memory for partition", partition);
+    } else {
+      for (i = 0; i < N; ++i)
+        p[i] = i;
+      for (i = 0; i < N; ++i)
+        if (p[i] != i)
+          error("wrong contents for partition", partition);
+    }
+    omp_free(p, a);
+  }
+  omp_destroy_allocator(a);
+}
+
+// A pool smaller than two blocks of pages takes only one of them
+static void check_pool(void) {
+  omp_alloctrait_t at[3];
+  omp_allocator_handle_t a;
+  void *p, *q;
+  at[0].key = omp_atk_partition;
+  at[0].value = omp_atv_interleaved;
+  at[1].key = omp_atk_pool_size;
+  at[1].value = 3 * sysconf(_SC_PAGESIZE) / 2;
+  at[2].key = omp_atk_fallback;
+  at[2].value = omp_atv_null_fb;
+  a = omp_init_allocator(omp_default_mem_space, 3, at);
+  p = omp_alloc(100, a);
+  q = omp_alloc(100, a);
+  if (p == NULL)
+    error("no memory in pool", 0);
+  if (q != NULL) {
+    error("pool overcommitted", 0);
+    omp_free(q, a);
+  }
+  omp_free(p, a);
+  p = omp_alloc(100, a);
+  if (p == NULL)
+    error("pool not released", 0);
+  omp_free(p, a);
+  omp_destroy_allocator(a);
+}
+
+// Each thread frees the blocks allocated by the previous thread
+static void check_small(void) {
+  static int *blocks[4][BLOCKS];
+#pragma omp parallel num_threads(4)
+  {
+    int me = omp_get_thread_num();
+    int nth = omp_get_num_threads();
+    int prev = (me + nth - 1) % nth;
+    int round, i, j;
+    for (round = 0; round < 10; ++round) {
+      for (i = 0; i < BLOCKS; ++i) {
+        int n = 1 + (i * 37 + round) % 600;
+        int *p = (int *)omp_alloc((n + 1) * sizeof(int), omp_default_mem_alloc);
+        if (p == NULL) {
+          error("no small block", n);
+          continue;
+        }
+        p[0] = n;
+        for (j = 1; j <= n; ++j)
+          p[j] = me + j;
+        blocks[me][i] = p;
+      }
+#pragma omp barrier
+      for (i = 0; i < BLOCKS; ++i) {
+        int *p = blocks[prev][i];
+        if (p == NULL)
+          continue;
+        for (j = 1; j <= p[0]; ++j)
+          if (p[j] != prev + j) {
+            error("wrong contents of small block", p[0]);
+            break;
+          }
+        omp_free(p, omp_default_mem_alloc);
+        blocks[prev][i] = NULL;
+      }
+#pragma omp barrier
+    }
+  }
+}
+
+int main() {
+  omp_alloctrait_value_t partitions[] = {omp_atv_environment, omp_atv_nearest,
+                                         omp_atv_blocked, omp_atv_interleaved};
+  int i;
+  for (i = 0; i < 4; ++i) {
+    check_partition(partitions[i], 0);
+    check_partition(partitions[i], 1);
+  }
+  check_pool();
+  check_small();
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors != 0;
+}
@@ -0,0 +1,124 @@
+// RUN: %libomp-compile && env KMP_PLAIN_BARRIER_PATTERN=dist,dist KMP_FORKJOIN_BARRIER_PATTERN=dist,dist KMP_REDUCTION_BARRIER_PATTERN=dist,dist %libomp-run
+// RUN: %libomp-compile && env KMP_PLAIN_BARRIER_PATTERN=dist,dist KMP_FORKJOIN_BARRIER_PATTERN=dist,dist KMP_BLOCKTIME=0 %libomp-run
+// RUN: %libomp-compile && env KMP_PLAIN_BARRIER_PATTERN=dist,hyper KMP_FORKJOIN_BARRIER_PATTERN=hyper,dist %libomp-run
+
+/*
+ * Check the barriers with every team size up to the number of threads, so
+ * that the last group of the distributed barrier is sometimes incomplete, and
+ * in nested teams.
+ * Run with an argument, the test also prints the overhead of a barrier and of
+ * a parallel region, measured as in the EPCC syncbench: the time of a delay
+ * loop with the construct minus the time of the same loop without it, divided
+ * by the number of repetitions. Compare the runtime settings:
+ * KMP_PLAIN_BARRIER_PATTERN, KMP_FORKJOIN_BARRIER_PATTERN.
+ */
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define BARRIERS 200
+#define BENCH_REPS 2000
+#define BENCH_DELAY 100
+#define MAX_THREADS 512
+
+static volatile int phase[MAX_THREADS];
+
+static int check_barriers(int nthreads) {
+  int errors = 0;
+#pragma omp parallel num_threads(nthreads) reduction(+ : errors)
+  {
+    int me = omp_get_thread_num();
+    int n = omp_get_num_threads();
+    int i, j;
+    for (i = 1; i <= BARRIERS; ++i) {
+      phase[me] = i;
+#pragma omp barrier
+      // Every thread must have reached the phase before anyone leaves it
+      for (j = 0; j < n; ++j)
+        if (phase[j] != i)
+          ++errors;
+#pragma omp barrier
+    }
+  }
+  return errors;
+}
+
+static int check_nested(int nthreads) {
+  int errors = 0;
+  omp_set_max_active_levels(2);
+#pragma omp parallel num_threads(2) reduction(+ : errors)
+  {
+    int outer = omp_get_thread_num();
+    int count = 0;
+#pragma omp parallel num_threads(nthreads) reduction(+ : count)
+    {
+      count = 1;
+#pragma omp barrier
+    }
+    if (count != nthreads) {
+      fprintf(stderr, "nested team %d: %d threads out of %d\n", outer, count,
+              nthreads);
+      ++errors;
+    }
+  }
+  omp_set_max_active_levels(1);
+  return errors;
+}
+
+static void delay(int length) {
+  volatile int a = 0;
+  int i;
+  for (i = 0; i < length; ++i)
+    a += i;
+}
+
+static void bench(int nthreads) {
+  double reference, with_barrier, with_parallel;
+  int i;
+
+  reference = omp_get_wtime();
+#pragma omp parallel num_threads(nthreads) private(i)
+  for (i = 0; i < BENCH_REPS; ++i)
+    delay(BENCH_DELAY);
+  reference = omp_get_wtime() - reference;
+
+  with_barrier = omp_get_wtime();
+#pragma omp parallel num_threads(nthreads) private(i)
+  for (i = 0; i < BENCH_REPS; ++i) {
+    delay(BENCH_DELAY);
+#pragma omp barrier
+  }
+  with_barrier = omp_get_wtime() - with_barrier;
+
+  with_parallel = omp_get_wtime();
+  for (i = 0; i < BENCH_REPS; ++i) {
+#pragma omp parallel num_threads(nthreads)
+    delay(BENCH_DELAY);
+  }
+  with_parallel = omp_get_wtime() - with_parallel;
+
+  printf("%4d threads: barrier %8.3f us, parallel %8.3f us\n", nthreads,
+         (with_barrier - reference) * 1e6 / BENCH_REPS,
+         (with_parallel - reference) * 1e6 / BENCH_REPS);
+}
+
+int main(int argc, char **argv) {
+  int max_threads = omp_get_max_threads();
+  int errors = 0;
+  int n;
+
+  if (max_threads > MAX_THREADS)
+    max_threads = MAX_THREADS;
+  omp_set_dynamic(0);
+  for (n = 1; n <= max_threads; ++n)
+    errors += check_barriers(n);
+  errors += check_nested(max_threads);
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+
+  if (argc > 1)
+    for (n = 1; n <= max_threads; n *= 2)
+      bench(n);
+  return errors != 0;
+}
@@ -0,0 +1,129 @@
+// RUN: %libomp-compile-and-run
+
+/*
+ * Build task graphs that stress the tracking of dependences:
+ *   - a chain of tasks with an inout dependence on the same address,
+ *   - many short chains on distinct addresses, which grow the hash table of
+ *     the dependences far beyond its initial size,
+ *   - stages of one writer followed by readers, for fan-out and fan-in of
+ *     width 1 to 64.
+ * Every task checks that the tasks it depends on already ran.
+ * Run with an argument, the test also prints the time of each graph.
+ */
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define CHAIN_TASKS 100000
+#define ADDRESSES 50000
+#define ADDRESS_TASKS 4
+#define STAGE_TASKS 50000
+
+static int chain(void) {
+  int x = 0;
+  int errors = 0;
+  int i;
+#pragma omp parallel
+#pragma omp single
+  for (i = 0; i < CHAIN_TASKS; ++i) {
+#pragma omp task depend(inout : x) firstprivate(i) shared(x, errors)
+    {
+      if (x != i) {
+#pragma omp atomic
+        ++errors;
+      }
+      x = i + 1;
+    }
+  }
+  if (x != CHAIN_TASKS)
+    ++errors;
+  return errors;
+}
+
+static int addresses(void) {
+  int *values = (int *)calloc(ADDRESSES, sizeof(int));
+  int errors = 0;
+  int i, j;
+#pragma omp parallel private(i, j)
+#pragma omp single
+  for (j = 0; j < ADDRESS_TASKS; ++j) {
+    for (i = 0; i < ADDRESSES; ++i) {
+      int *value = &values[i];
+#pragma omp task depend(inout : value[0]) firstprivate(value, j)               \
+    shared(errors)
+      {
+        if (*value != j) {
+#pragma omp atomic
+          ++errors;
+        }
+        *value = j + 1;
+      }
+    }
+  }
+  for (i = 0; i < ADDRESSES; ++i)
+    if (values[i] != ADDRESS_TASKS)
+      ++errors;
+  free(values);
+  return errors;
+}
+
+// A writer, then width readers of the value written, for every stage
+static int stages(int width) {
+  int nstages = STAGE_TASKS / (width + 1);
+  int *readers = (int *)calloc(nstages, sizeof(int));
+  int x = -1;
+  int errors = 0;
+  int s, r;
+#pragma omp parallel private(s, r)
+#pragma omp single
+  for (s = 0; s < nstages; ++s) {
+#pragma omp task depend(inout : x) firstprivate(s)                             \
+    shared(x, readers, width, errors)
+    {
+      if (x != s - 1 || (s > 0 && readers[s - 1] != width)) {
+#pragma omp atomic
+        ++errors;
+      }
+      x = s;
+    }
+    for (r = 0; r < width; ++r) {
+#pragma omp task depend(in : x) firstprivate(s) shared(x, readers, errors)
+      {
+        if (x != s) {
+#pragma omp atomic
+          ++errors;
+        }
+#pragma omp atomic
+        ++readers[s];
+      }
+    }
+  }
+  if (x != nstages - 1 || readers[nstages - 1] != width)
+    ++errors;
+  free(readers);
+  return errors;
+}
+
+int main(int argc, char **argv) {
+  int errors = 0;
+  int width;
+  double time = omp_get_wtime();
+  errors += chain();
+  if (argc > 1)
+    printf("chain          %8.3f ms\n", (omp_get_wtime() - time) * 1e3);
+  time = omp_get_wtime();
+  errors += addresses();
+  if (argc > 1)
+    printf("addresses      %8.3f ms\n", (omp_get_wtime() - time) * 1e3);
+  for (width = 1; width <= 64; width *= 4) {
+    time = omp_get_wtime();
+    errors += stages(width);
+    if (argc > 1)
+      printf("stages of %-4d %8.3f ms\n", width,
+             (omp_get_wtime() - time) * 1e3);
+  }
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors != 0;
+}
@@ -0,0 +1,45 @@
+// RUN: %libomp-compile-and-run
+
+/*
+ * The hash table of the dependences of an implicit task is emptied at the end
+ * of a parallel region and reused by the next one: check that the dependences
+ * on the same address are still ordered in consecutive parallel regions.
+ */
+
+#include <omp.h>
+#include <stdio.h>
+
+#define REGIONS 10
+#define TASKS 100
+
+int main() {
+  int x = 0;
+  int errors = 0;
+  int r, i;
+  for (r = 0; r < REGIONS; ++r) {
+#pragma omp parallel private(i)
+#pragma omp master
+    for (i = 0; i < TASKS; ++i) {
+#pragma omp task depend(inout : x) firstprivate(r, i) shared(x, errors)
+      {
+        if (x != r * TASKS + i) {
+#pragma omp atomic
+          ++errors;
+        }
+        x = r * TASKS + i + 1;
+      }
+#pragma omp task depend(in : x) firstprivate(r, i) shared(x, errors)
+      {
+        if (x != r * TASKS + i + 1) {
+#pragma omp atomic
+          ++errors;
+        }
+      }
+    }
+  }
+  if (x != REGIONS * TASKS)
+    ++errors;
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors != 0;
+}
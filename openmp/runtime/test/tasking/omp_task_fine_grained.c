@@ -0,0 +1,132 @@
+// RUN: %libomp-compile && env KMP_TASK_DEQUE_LOCK_FREE=1 %libomp-run
+// RUN: %libomp-compile && env KMP_TASK_DEQUE_LOCK_FREE=0 %libomp-run
+// RUN: %libomp-compile && env KMP_TASK_DEQUE_LOCK_FREE=1 OMP_CANCELLATION=true %libomp-run
+// RUN: %libomp-compile && env KMP_ENABLE_TASK_THROTTLING=0 %libomp-run
+
+/*
+ * Stress the task deques with tasks that do almost no work, so that the time
+ * is spent pushing, popping and stealing tasks:
+ *   - a binary tree of tied tasks, where every task waits for its children,
+ *   - the same tree with untied tasks,
+ *   - a flat loop of tasks created by a single thread and stolen by the others,
+ *     which fills the deque of the producer beyond its initial size,
+ *   - a taskgroup cancelled by one of its tasks.
+ * Run with an argument, the test also prints the time of each part, to compare
+ * the runtime settings: KMP_TASK_DEQUE_LOCK_FREE, KMP_ENABLE_TASK_THROTTLING.
+ */
+
+#include <omp.h>
+#include <stdio.h>
+
+#define TREE_DEPTH 18
+#define FLAT_TASKS 200000
+#define CANCEL_TASKS 100000
+
+static int tree_tied(int depth) {
+  int left = 0, right = 0;
+  if (depth == 0)
+    return 1;
+#pragma omp task shared(left)
+  left = tree_tied(depth - 1);
+#pragma omp task shared(right)
+  right = tree_tied(depth - 1);
+#pragma omp taskwait
+  return left + right;
+}
+
+static int tree_untied(int depth) {
+  int left = 0, right = 0;
+  if (depth == 0)
+    return 1;
+#pragma omp task shared(left) untied
+  left = tree_untied(depth - 1);
+#pragma omp task shared(right) untied
+  right = tree_untied(depth - 1);
+#pragma omp taskwait
+  return left + right;
+}
+
+static int flat(void) {
+  int count = 0;
+  int i;
+#pragma omp parallel
+#pragma omp single
+  for (i = 0; i < FLAT_TASKS; ++i) {
+#pragma omp task shared(count)
+    {
+#pragma omp atomic
+      ++count;
+    }
+  }
+  return count == FLAT_TASKS;
+}
+
+static int cancel(void) {
+  int count = 0, late = 0;
+  int i;
+#pragma omp parallel
+#pragma omp single
+#pragma omp taskgroup
+  for (i = 0; i < CANCEL_TASKS; ++i) {
+#pragma omp task shared(count, late)
+    {
+      if (i > CANCEL_TASKS / 2) {
+#pragma omp atomic
+        ++late;
+      }
+      if (i == CANCEL_TASKS / 2) {
+#pragma omp cancel taskgroup
+      }
+#pragma omp atomic
+      ++count;
+    }
+    // The tasks created after the cancelling task completed must not run
+    if (i == CANCEL_TASKS / 2) {
+#pragma omp taskwait
+    }
+  }
+  // Without OMP_CANCELLATION, all the tasks run
+  if (omp_get_cancellation())
+    return count < CANCEL_TASKS && late == 0;
+  return count == CANCEL_TASKS;
+}
+
+static int tree(int untied) {
+  int result = 0;
+#pragma omp parallel
+#pragma omp single
+  result = untied ? tree_untied(TREE_DEPTH) : tree_tied(TREE_DEPTH);
+  return result == 1 << TREE_DEPTH;
+}
+
+int main(int argc, char **argv) {
+  const char *names[] = {"tied tree", "untied tree", "flat", "cancel"};
+  int failed = 0;
+  int part;
+  for (part = 0; part < 4; ++part) {
+    double time = omp_get_wtime();
+    int ok;
+    switch (part) {
+    case 0:
+      ok = tree(0);
+      break;
+    case 1:
+      ok = tree(1);
+      break;
+    case 2:
+      ok = flat();
+      break;
+    default:
+      ok = cancel();
+      break;
+    }
+    time = omp_get_wtime() - time;
+    if (!ok) {
+      fprintf(stderr, "%s: wrong result\n", names[part]);
+      failed = 1;
+    }
+    if (argc > 1)
+      printf("%-12s %8.3f ms\n", names[part], time * 1e3);
+  }
+  return failed;
+}
@@ -0,0 +1,169 @@
+// RUN: %libomp-compile && env KMP_SCHEDULE="dynamic,steal;guided,steal" %libomp-run
+// RUN: %libomp-compile && env KMP_SCHEDULE="dynamic,steal;guided,steal" OMP_SCHEDULE=guided,3 %libomp-run
+// RUN: %libomp-compile && env KMP_SCHEDULE="dynamic,chunked;guided,iterative" %libomp-run
+// RUN: %libomp-compile && env OMP_SCHEDULE=nonmonotonic:dynamic,1 %libomp-run
+
+/*
+ * Check the dynamic and guided schedules, which steal iterations from other
+ * threads with KMP_SCHEDULE=dynamic,steal;guided,steal:
+ *   - every iteration runs exactly once, for loops of signed and unsigned,
+ *     32 and 64-bit induction variables, with any stride and chunk size, and
+ *     for every team size,
+ *   - the chunks have the size requested, except the one with the last
+ *     iteration,
+ *   - the chunks of a thread are increasing with the monotonic modifier and
+ *     with the ordered clause.
+ */
+
+#include <omp.h>
+#include <stdio.h>
+
+#define ITERS 10007
+#define MAX_THREADS 64
+
+static int errors;
+static int count[ITERS];
+
+static void error(const char *loop, int nthreads, int chunk) {
+#pragma omp atomic
+  ++errors;
+  fprintf(stderr, "%s: %d threads, chunk %d: wrong iterations\n", loop,
+          nthreads, chunk);
+}
+
+static void check_count(const char *loop, int nthreads, int chunk) {
+  int i;
+  for (i = 0; i < ITERS; ++i) {
+    if (count[i] != 1) {
+      error(loop, nthreads, chunk);
+      break;
+    }
+  }
+  for (i = 0; i < ITERS; ++i)
+    count[i] = 0;
+}
+
+// Checks the size of a chunk of n iterations starting at iteration i, which
+// must have at least chunk iterations unless it ends the loop
+static void check_chunk(const char *loop, int nthreads, int chunk, int i,
+                        int n, int last) {
+  if (n < chunk && i + n != last)
+    error(loop, nthreads, chunk);
+}
+
+static void loops(int nthreads, int chunk) {
+  int i;
+  long long l;
+  unsigned u;
+#pragma omp parallel num_threads(nthreads)
+  {
+#pragma omp for schedule(dynamic, chunk)
+    for (i = 0; i < ITERS; ++i) {
+#pragma omp atomic
+      ++count[i];
+    }
+#pragma omp single
+    check_count("dynamic int", nthreads, chunk);
+#pragma omp for schedule(dynamic, chunk)
+    for (l = 3LL * ITERS - 1; l >= 0; l -= 3) {
+#pragma omp atomic
+      ++count[l / 3];
+    }
+#pragma omp single
+    check_count("dynamic long long", nthreads, chunk);
+#pragma omp for schedule(guided, chunk)
+    for (u = 7; u < ITERS + 7u; ++u) {
+#pragma omp atomic
+      ++count[u - 7];
+    }
+#pragma omp single
+    check_count("guided unsigned", nthreads, chunk);
+#pragma omp for schedule(guided, chunk)
+    for (l = -2LL * ITERS; l < 0; l += 2) {
+#pragma omp atomic
+      ++count[(l + 2LL * ITERS) / 2];
+    }
+#pragma omp single
+    check_count("guided long long", nthreads, chunk);
+#pragma omp for schedule(runtime)
+    for (i = ITERS - 1; i >= 0; --i) {
+#pragma omp atomic
+      ++count[i];
+    }
+#pragma omp single
+    check_count("runtime", nthreads, chunk);
+  }
+}
+
+// Checks the chunk sizes, and that each thread gets increasing chunks where
+// the schedule is monotonic
+static void chunks(int nthreads, int chunk) {
+  int next[MAX_THREADS];
+  int i;
+  for (i = 0; i < nthreads; ++i)
+    next[i] = -1;
+#pragma omp parallel num_threads(nthreads)
+  {
+    int me = omp_get_thread_num();
+    int start = -1, n = 0, prev = -1;
+#pragma omp for schedule(guided, chunk) nowait
+    for (i = 0; i < ITERS; ++i) {
+      if (i != start + n) { // new chunk
+        if (n)
+          check_chunk("guided", nthreads, chunk, start, n, ITERS);
+        start = i;
+        n = 0;
+      }
+      ++n;
+      ++count[i];
+    }
+    if (n)
+      check_chunk("guided", nthreads, chunk, start, n, ITERS);
+#pragma omp barrier
+#pragma omp single
+    check_count("guided", nthreads, chunk);
+#pragma omp for schedule(monotonic : dynamic, chunk)
+    for (i = 0; i < ITERS; ++i) {
+      if (i < prev)
+        error("monotonic dynamic", nthreads, chunk);
+      prev = i;
+    }
+    prev = -1;
+#pragma omp for schedule(monotonic : guided, chunk)
+    for (i = 0; i < ITERS; ++i) {
+      if (i < prev)
+        error("monotonic guided", nthreads, chunk);
+      prev = i;
+    }
+#pragma omp for schedule(guided, chunk) ordered
+    for (i = 0; i < ITERS; ++i) {
+#pragma omp ordered
+      {
+        if (i <= next[me] || count[i]++)
+          error("ordered guided", nthreads, chunk);
+        next[me] = i;
+      }
+    }
+#pragma omp single
+    check_count("ordered guided", nthreads, chunk);
+  }
+}
+
+int main() {
+  int max_threads = omp_get_max_threads();
+  int nthreads, c;
+  int chunk_sizes[] = {1, 2, 7, 64, 5000};
+
+  if (max_threads > MAX_THREADS)
+    max_threads = MAX_THREADS;
+  omp_set_dynamic(0);
+  for (nthreads = 1; nthreads <= max_threads; ++nthreads) {
+    for (c = 0; c < 5; ++c) {
+      loops(nthreads, chunk_sizes[c]);
+      chunks(nthreads, chunk_sizes[c]);
+    }
+  }
+  if (errors)
+    fprintf(stderr, "%d errors\n", errors);
+  return errors != 0;
+}
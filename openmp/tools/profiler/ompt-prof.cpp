@@ -0,0 +1,777 @@
+/*
+ * ompt-prof.cpp -- OMPT profiler, per-region and per-task statistics
+ */
+
+//===----------------------------------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// The profiler times the OpenMP events of every thread into histograms that
+// only the thread itself updates, so that recording an event takes no lock.
+// Only the record of a task completed by another thread than its creator is
+// returned to the creator with a CAS. The histograms of all threads are merged
+// when the runtime shuts down, and a summary is written:
+//   - for each kind of event (parallel region, fork latency, worksharing
+//     construct, barrier wait, task execution, ...), the count, total and
+//     percentiles of its durations,
+//   - for each construct of the program, identified by its return address, the
+//     time spent and the imbalance between threads.
+
+#ifndef __STDC_FORMAT_MACROS
+#define __STDC_FORMAT_MACROS
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <dlfcn.h>
+#include <inttypes.h>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "omp-tools.h"
+
+class ProfFlags {
+public:
+  int enabled;
+  int verbose;
+  int threads;
+  int top;
+  std::string output;
+
+  ProfFlags(const char *env) : enabled(1), verbose(0), threads(0), top(20) {
+    if (env) {
+      std::vector<std::string> tokens;
+      std::string token;
+      std::string str(env);
+      std::istringstream iss(str);
+      while (std::getline(iss, token, ' '))
+        tokens.push_back(token);
+
+      for (std::vector<std::string>::iterator it = tokens.begin();
+           it != tokens.end(); ++it) {
+        if (it->empty())
+          continue;
+        if (sscanf(it->c_str(), "enable=%d", &enabled))
+          continue;
+        if (sscanf(it->c_str(), "verbose=%d", &verbose))
+          continue;
+        if (sscanf(it->c_str(), "threads=%d", &threads))
+          continue;
+        if (sscanf(it->c_str(), "top=%d", &top))
+          continue;
+        if (it->compare(0, 7, "output=") == 0) {
+          output = it->substr(7);
+          continue;
+        }
+        std::cerr << "Illegal values for OMPPROF_OPTIONS variable: " << *it
+                  << std::endl;
+      }
+    }
+  }
+};
+
+static ProfFlags *prof_flags;
+
+static uint64_t now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static uint64_t StartTime;
+
+/// Histogram of durations in nanoseconds. Every power of two is split in
+/// SubBuckets buckets, which bounds the error of a percentile to 25%.
+struct Histogram {
+  static const unsigned SubBits = 2;
+  static const unsigned SubBuckets = 1 << SubBits;
+  static const unsigned NumBuckets = (64 - SubBits + 1) * SubBuckets;
+
+  uint64_t Count = 0;
+  uint64_t Total = 0;
+  uint64_t Max = 0;
+  uint64_t Buckets[NumBuckets] = {};
+
+  static unsigned bucket(uint64_t Ns) {
+    if (Ns < SubBuckets)
+      return Ns;
+    unsigned Log = 63 - __builtin_clzll(Ns);
+    return (Log - SubBits + 1) * SubBuckets +
+           ((Ns >> (Log - SubBits)) & (SubBuckets - 1));
+  }
+
+  // Largest duration that falls in bucket B
+  static uint64_t bucketMax(unsigned B) {
+    if (B < SubBuckets)
+      return B;
+    unsigned Log = B / SubBuckets + SubBits - 1;
+    uint64_t Lower = (uint64_t)(SubBuckets + B % SubBuckets) << (Log - SubBits);
+    return Lower + ((uint64_t)1 << (Log - SubBits)) - 1;
+  }
+
+  void add(uint64_t Ns) {
+    ++Count;
+    Total += Ns;
+    if (Ns > Max)
+      Max = Ns;
+    ++Buckets[bucket(Ns)];
+  }
+
+  void merge(const Histogram &H) {
+    Count += H.Count;
+    Total += H.Total;
+    if (H.Max > Max)
+      Max = H.Max;
+    for (unsigned B = 0; B < NumBuckets; ++B)
+      Buckets[B] += H.Buckets[B];
+  }
+
+  uint64_t percentile(double P) const {
+    uint64_t Rank = (uint64_t)(P * Count);
+    uint64_t Seen = 0;
+    for (unsigned B = 0; B < NumBuckets; ++B) {
+      Seen += Buckets[B];
+      if (Seen > Rank)
+        return std::min(bucketMax(B), Max);
+    }
+    return Max;
+  }
+};
+
+/// Kinds of events with a histogram of their durations.
+enum EventKind {
+  EventParallel,   // parallel region, on the master thread
+  EventFork,       // from the fork to the start of a worker's implicit task
+  EventWorkshare,  // loop, sections, single, distribute or taskloop
+  EventBarrier,    // wait in a barrier, without the tasks run in it
+  EventTaskwait,   // wait in a taskwait, without the tasks run in it
+  EventTaskgroup,  // wait at the end of a taskgroup
+  EventTask,       // execution of an explicit task
+  EventTaskDelay,  // from the creation to the start of an explicit task
+  NumEvents
+};
+
+static const char *EventNames[NumEvents] = {
+    "parallel region", "fork latency",   "worksharing",    "barrier wait",
+    "taskwait wait",   "taskgroup wait", "task execution", "task delay"};
+
+/// Kinds of constructs in the per-construct statistics.
+enum ConstructKind {
+  ConstructParallel,
+  ConstructLoop,
+  ConstructSections,
+  ConstructSingle,
+  ConstructDistribute,
+  ConstructTaskloop,
+  ConstructBarrier,
+  ConstructImplicitBarrier,
+  ConstructTaskwait,
+  ConstructTaskgroup,
+  ConstructTask,
+  NumConstructs
+};
+
+static const char *ConstructNames[NumConstructs] = {
+    "parallel", "loop",    "sections", "single",    "distribute", "taskloop",
+    "barrier",  "barrier", "taskwait", "taskgroup", "task"};
+
+struct ConstructKey {
+  const void *Codeptr;
+  ConstructKind Kind;
+  bool operator==(const ConstructKey &K) const {
+    return Codeptr == K.Codeptr && Kind == K.Kind;
+  }
+};
+
+struct ConstructKeyHash {
+  size_t operator()(const ConstructKey &K) const {
+    return std::hash<uintptr_t>()((uintptr_t)K.Codeptr ^ K.Kind);
+  }
+};
+
+/// Time spent by a thread in a construct. Busy is the time of the thread in
+/// the implicit tasks of a parallel region, without the waits in barriers; the
+/// imbalance of the other constructs is computed from Time.
+struct ConstructStats {
+  uint64_t Count = 0;
+  uint64_t Time = 0;
+  uint64_t Max = 0;
+  uint64_t Busy = 0;
+
+  void add(uint64_t Ns) {
+    ++Count;
+    Time += Ns;
+    if (Ns > Max)
+      Max = Ns;
+  }
+};
+
+typedef std::unordered_map<ConstructKey, ConstructStats, ConstructKeyHash>
+    ConstructMap;
+
+struct ThreadStats;
+
+/// Parallel region being executed, stored in parallel_data. The records are
+/// recycled by the master thread, which begins and ends the region.
+struct RegionRecord {
+  uint64_t Start;
+  const void *Codeptr;
+  RegionRecord *Next;
+};
+
+/// Explicit task, stored in task_data. The records are recycled into the pool
+/// of the thread which allocated them: the owner pops them without
+/// synchronization, other threads push them back with a compare-and-swap.
+struct TaskRecord {
+  uint64_t Created;
+  uint64_t Exec;
+  const void *Codeptr;
+  ThreadStats *Owner;
+  TaskRecord *Next;
+  bool Started;
+};
+
+struct ImplicitRecord {
+  RegionRecord *Region;
+  uint64_t Start;
+  uint64_t Idle;
+  int WorkDepth;
+  bool Busy;
+};
+
+struct WaitRecord {
+  uint64_t Start;
+  uint64_t TaskTime;
+  EventKind Event;
+  ConstructKind Kind;
+  const void *Codeptr;
+  bool Skip;
+};
+
+struct WorkRecord {
+  uint64_t Start;
+  ConstructKind Kind;
+  const void *Codeptr;
+};
+
+/// Statistics of a thread, only updated by the thread itself.
+struct ThreadStats {
+  static const int MaxDepth = 16;
+
+  int Id;
+  ThreadStats *Next;
+  Histogram Events[NumEvents];
+  ConstructMap Constructs;
+  ConstructKey LastKey = {nullptr, NumConstructs};
+  ConstructStats *LastStats = nullptr;
+
+  // Time of explicit tasks and of idle waits executed by the thread
+  uint64_t TaskTime = 0;
+  uint64_t IdleTime = 0;
+  uint64_t SegmentStart = 0;
+
+  // Stacks of the implicit tasks, waits and worksharing constructs which the
+  // thread is in; the events deeper than MaxDepth are not recorded.
+  int ImplicitDepth = 0;
+  ImplicitRecord Implicits[MaxDepth];
+  int WaitDepth = 0;
+  WaitRecord Waits[MaxDepth];
+  int WorkDepth = 0;
+  WorkRecord Works[MaxDepth];
+
+  RegionRecord *FreeRegions = nullptr;
+  TaskRecord *FreeTasks = nullptr;
+  std::atomic<TaskRecord *> ReturnedTasks;
+
+  ThreadStats(int Id) : Id(Id), Next(nullptr), ReturnedTasks(nullptr) {}
+
+  ImplicitRecord *implicit() {
+    if (ImplicitDepth == 0 || ImplicitDepth > MaxDepth)
+      return nullptr;
+    return &Implicits[ImplicitDepth - 1];
+  }
+
+  ConstructStats &construct(const void *Codeptr, ConstructKind Kind) {
+    ConstructKey Key = {Codeptr, Kind};
+    if (!(Key == LastKey)) {
+      LastKey = Key;
+      LastStats = &Constructs[Key];
+    }
+    return *LastStats;
+  }
+
+  RegionRecord *allocRegion() {
+    RegionRecord *R = FreeRegions;
+    if (R)
+      FreeRegions = R->Next;
+    else
+      R = new RegionRecord;
+    return R;
+  }
+
+  void freeRegion(RegionRecord *R) {
+    R->Next = FreeRegions;
+    FreeRegions = R;
+  }
+
+  TaskRecord *allocTask() {
+    if (!FreeTasks)
+      FreeTasks = ReturnedTasks.exchange(nullptr, std::memory_order_acquire);
+    if (!FreeTasks) {
+      const int N = 64;
+      TaskRecord *Block = new TaskRecord[N];
+      for (int I = 0; I < N; ++I) {
+        Block[I].Owner = this;
+        Block[I].Next = I + 1 < N ? &Block[I + 1] : nullptr;
+      }
+      FreeTasks = Block;
+    }
+    TaskRecord *T = FreeTasks;
+    FreeTasks = T->Next;
+    return T;
+  }
+};
+
+static void freeTask(TaskRecord *T) {
+  std::atomic<TaskRecord *> &Head = T->Owner->ReturnedTasks;
+  T->Next = Head.load(std::memory_order_relaxed);
+  while (!Head.compare_exchange_weak(T->Next, T, std::memory_order_release,
+                                     std::memory_order_relaxed))
+    ;
+}
+
+static std::atomic<ThreadStats *> AllThreads(nullptr);
+static std::atomic<int> NumThreads(0);
+static __thread ThreadStats *MyStats;
+
+static ThreadStats *getStats() {
+  ThreadStats *S = MyStats;
+  if (S)
+    return S;
+  S = new ThreadStats(NumThreads++);
+  S->Next = AllThreads.load(std::memory_order_relaxed);
+  while (!AllThreads.compare_exchange_weak(S->Next, S,
+                                           std::memory_order_release,
+                                           std::memory_order_relaxed))
+    ;
+  MyStats = S;
+  return S;
+}
+
+static ConstructKind workConstruct(ompt_work_t wstype) {
+  switch (wstype) {
+  case ompt_work_loop:
+    return ConstructLoop;
+  case ompt_work_sections:
+    return ConstructSections;
+  case ompt_work_distribute:
+    return ConstructDistribute;
+  case ompt_work_taskloop:
+    return ConstructTaskloop;
+  default:
+    return ConstructSingle;
+  }
+}
+
+static void ompt_prof_thread_begin(ompt_thread_t thread_type,
+                                   ompt_data_t *thread_data) {
+  getStats();
+}
+
+static void ompt_prof_parallel_begin(ompt_data_t *parent_task_data,
+                                     const ompt_frame_t *parent_task_frame,
+                                     ompt_data_t *parallel_data,
+                                     uint32_t requested_team_size, int flag,
+                                     const void *codeptr_ra) {
+  RegionRecord *R = getStats()->allocRegion();
+  R->Codeptr = codeptr_ra;
+  R->Start = now();
+  parallel_data->ptr = R;
+}
+
+static void ompt_prof_parallel_end(ompt_data_t *parallel_data,
+                                   ompt_data_t *task_data, int flag,
+                                   const void *codeptr_ra) {
+  RegionRecord *R = (RegionRecord *)parallel_data->ptr;
+  if (!R)
+    return;
+  ThreadStats *S = getStats();
+  uint64_t Time = now() - R->Start;
+  S->Events[EventParallel].add(Time);
+  S->construct(R->Codeptr, ConstructParallel).add(Time);
+  parallel_data->ptr = nullptr;
+  S->freeRegion(R);
+}
+
+// The busy time of the thread in the region ends where the thread reaches the
+// barrier at the end of the region.
+static void endBusy(ThreadStats *S, ImplicitRecord *I, uint64_t Time) {
+  if (!I->Busy)
+    return;
+  I->Busy = false;
+  uint64_t Busy = Time - I->Start - (S->IdleTime - I->Idle);
+  S->construct(I->Region->Codeptr, ConstructParallel).Busy += Busy;
+}
+
+static void ompt_prof_implicit_task(ompt_scope_endpoint_t endpoint,
+                                    ompt_data_t *parallel_data,
+                                    ompt_data_t *task_data,
+                                    unsigned int team_size,
+                                    unsigned int thread_num, int type) {
+  if (type & ompt_task_initial)
+    return;
+  ThreadStats *S = getStats();
+  uint64_t Time = now();
+  if (endpoint == ompt_scope_begin) {
+    if (S->ImplicitDepth++ >= ThreadStats::MaxDepth)
+      return;
+    RegionRecord *R = (RegionRecord *)parallel_data->ptr;
+    ImplicitRecord &I = S->Implicits[S->ImplicitDepth - 1];
+    I.Region = R;
+    I.Start = Time;
+    I.Idle = S->IdleTime;
+    I.WorkDepth = S->WorkDepth;
+    I.Busy = R != nullptr;
+    if (R && thread_num != 0)
+      S->Events[EventFork].add(Time - R->Start);
+  } else {
+    if (S->ImplicitDepth == 0)
+      return;
+    if (ImplicitRecord *I = S->implicit()) {
+      endBusy(S, I, Time);
+      S->WorkDepth = I->WorkDepth;
+    }
+    --S->ImplicitDepth;
+  }
+}
+
+static void ompt_prof_sync_region_wait(ompt_sync_region_t kind,
+                                       ompt_scope_endpoint_t endpoint,
+                                       ompt_data_t *parallel_data,
+                                       ompt_data_t *task_data,
+                                       const void *codeptr_ra) {
+  ThreadStats *S = getStats();
+  uint64_t Time = now();
+  if (endpoint == ompt_scope_begin) {
+    if (S->WaitDepth++ >= ThreadStats::MaxDepth)
+      return;
+    WaitRecord &W = S->Waits[S->WaitDepth - 1];
+    W.Start = Time;
+    W.TaskTime = S->TaskTime;
+    W.Codeptr = codeptr_ra;
+    W.Skip = false;
+    switch (kind) {
+    case ompt_sync_region_taskwait:
+      W.Event = EventTaskwait;
+      W.Kind = ConstructTaskwait;
+      break;
+    case ompt_sync_region_taskgroup:
+      W.Event = EventTaskgroup;
+      W.Kind = ConstructTaskgroup;
+      break;
+    case ompt_sync_region_barrier_implicit:
+      W.Event = EventBarrier;
+      W.Kind = ConstructImplicitBarrier;
+      // The barrier at the end of a parallel region. The wait of the workers
+      // only ends when they are released for the next parallel region, so it
+      // is not counted.
+      if (ImplicitRecord *I = S->implicit()) {
+        if (I->Busy && (!codeptr_ra || codeptr_ra == I->Region->Codeptr)) {
+          endBusy(S, I, Time);
+          W.Skip = codeptr_ra == nullptr;
+        }
+      }
+      break;
+    default:
+      W.Event = EventBarrier;
+      W.Kind = ConstructBarrier;
+      break;
+    }
+  } else {
+    if (S->WaitDepth == 0)
+      return;
+    if (S->WaitDepth-- > ThreadStats::MaxDepth)
+      return;
+    WaitRecord &W = S->Waits[S->WaitDepth];
+    if (W.Skip)
+      return;
+    uint64_t Wait = Time - W.Start - (S->TaskTime - W.TaskTime);
+    S->IdleTime += Wait;
+    S->Events[W.Event].add(Wait);
+    S->construct(W.Codeptr, W.Kind).add(Wait);
+  }
+}
+
+static void ompt_prof_work(ompt_work_t wstype, ompt_scope_endpoint_t endpoint,
+                           ompt_data_t *parallel_data, ompt_data_t *task_data,
+                           uint64_t count, const void *codeptr_ra) {
+  ThreadStats *S = getStats();
+  uint64_t Time = now();
+  if (endpoint == ompt_scope_begin) {
+    if (S->WorkDepth++ >= ThreadStats::MaxDepth)
+      return;
+    WorkRecord &W = S->Works[S->WorkDepth - 1];
+    W.Start = Time;
+    W.Kind = workConstruct(wstype);
+    W.Codeptr = codeptr_ra;
+  } else {
+    // The GNU interface has no end of a single construct: drop the constructs
+    // that were not ended above the one that ends.
+    ConstructKind Kind = workConstruct(wstype);
+    int Depth = std::min(S->WorkDepth, (int)ThreadStats::MaxDepth);
+    while (Depth > 0 && S->Works[Depth - 1].Kind != Kind)
+      --Depth;
+    if (Depth == 0) {
+      if (S->WorkDepth > ThreadStats::MaxDepth)
+        --S->WorkDepth;
+      return;
+    }
+    S->WorkDepth = Depth - 1;
+    WorkRecord &W = S->Works[S->WorkDepth];
+    S->Events[EventWorkshare].add(Time - W.Start);
+    S->construct(W.Codeptr, W.Kind).add(Time - W.Start);
+  }
+}
+
+static void ompt_prof_task_create(ompt_data_t *parent_task_data,
+                                  const ompt_frame_t *parent_frame,
+                                  ompt_data_t *new_task_data, int type,
+                                  int has_dependences,
+                                  const void *codeptr_ra) {
+  if (!(type & ompt_task_explicit))
+    return;
+  TaskRecord *T = getStats()->allocTask();
+  T->Created = now();
+  T->Exec = 0;
+  T->Codeptr = codeptr_ra;
+  T->Started = false;
+  new_task_data->ptr = T;
+}
+
+static void ompt_prof_task_schedule(ompt_data_t *first_task_data,
+                                    ompt_task_status_t prior_task_status,
+                                    ompt_data_t *second_task_data) {
+  // A fulfill event may come from another thread than the one running the
+  // task, and does not switch tasks.
+  if (prior_task_status == ompt_task_early_fulfill ||
+      prior_task_status == ompt_task_late_fulfill)
+    return;
+  ThreadStats *S = getStats();
+  uint64_t Time = now();
+  TaskRecord *Prior = (TaskRecord *)first_task_data->ptr;
+  if (Prior) {
+    uint64_t Segment = Time - S->SegmentStart;
+    Prior->Exec += Segment;
+    S->TaskTime += Segment;
+    if (prior_task_status == ompt_task_complete ||
+        prior_task_status == ompt_task_cancel ||
+        prior_task_status == ompt_task_detach) {
+      S->Events[EventTask].add(Prior->Exec);
+      S->construct(Prior->Codeptr, ConstructTask).add(Prior->Exec);
+      first_task_data->ptr = nullptr;
+      freeTask(Prior);
+    }
+  }
+  TaskRecord *Next = second_task_data ? (TaskRecord *)second_task_data->ptr
+                                      : nullptr;
+  if (Next && !Next->Started) {
+    Next->Started = true;
+    S->Events[EventTaskDelay].add(Time - Next->Created);
+  }
+  S->SegmentStart = Time;
+}
+
+// Name of the code at Codeptr: function+offset, or file+offset without symbols
+static std::string codeName(const void *Codeptr) {
+  char Buf[64];
+  if (!Codeptr)
+    return "(unknown)";
+  Dl_info Info;
+  if (dladdr(Codeptr, &Info)) {
+    if (Info.dli_sname) {
+      snprintf(Buf, sizeof(Buf), "+0x%" PRIxPTR,
+               (uintptr_t)Codeptr - (uintptr_t)Info.dli_saddr);
+      return std::string(Info.dli_sname) + Buf;
+    }
+    if (Info.dli_fname) {
+      const char *Base = strrchr(Info.dli_fname, '/');
+      snprintf(Buf, sizeof(Buf), "+0x%" PRIxPTR,
+               (uintptr_t)Codeptr - (uintptr_t)Info.dli_fbase);
+      return std::string(Base ? Base + 1 : Info.dli_fname) + Buf;
+    }
+  }
+  snprintf(Buf, sizeof(Buf), "%p", Codeptr);
+  return Buf;
+}
+
+struct ConstructSummary {
+  ConstructKey Key;
+  ConstructStats Stats;
+  int Threads = 0;
+  uint64_t MaxThreadTime = 0;
+  uint64_t SumThreadTime = 0;
+};
+
+static void printSummary(FILE *Out) {
+  std::vector<ThreadStats *> Threads;
+  for (ThreadStats *S = AllThreads.load(std::memory_order_acquire); S;
+       S = S->Next)
+    Threads.push_back(S);
+  std::sort(Threads.begin(), Threads.end(),
+            [](ThreadStats *A, ThreadStats *B) { return A->Id < B->Id; });
+
+  Histogram Events[NumEvents];
+  std::unordered_map<ConstructKey, ConstructSummary, ConstructKeyHash> Merged;
+  for (ThreadStats *S : Threads) {
+    for (int E = 0; E < NumEvents; ++E)
+      Events[E].merge(S->Events[E]);
+    for (auto &C : S->Constructs) {
+      ConstructSummary &M = Merged[C.first];
+      M.Key = C.first;
+      M.Stats.Count += C.second.Count;
+      M.Stats.Time += C.second.Time;
+      M.Stats.Max = std::max(M.Stats.Max, C.second.Max);
+      uint64_t ThreadTime =
+          C.first.Kind == ConstructParallel ? C.second.Busy : C.second.Time;
+      ++M.Threads;
+      M.MaxThreadTime = std::max(M.MaxThreadTime, ThreadTime);
+      M.SumThreadTime += ThreadTime;
+    }
+  }
+
+  fprintf(Out, "OMPT profiler: %d threads, %.3f s\n", (int)Threads.size(),
+          (now() - StartTime) * 1e-9);
+  fprintf(Out, "%-16s %10s %12s %10s %10s %10s %10s %10s\n", "event", "count",
+          "total ms", "mean us", "p50 us", "p90 us", "p99 us", "max us");
+  for (int E = 0; E < NumEvents; ++E) {
+    const Histogram &H = Events[E];
+    if (!H.Count)
+      continue;
+    fprintf(Out, "%-16s %10" PRIu64 " %12.3f %10.2f %10.2f %10.2f %10.2f "
+                 "%10.2f\n",
+            EventNames[E], H.Count, H.Total * 1e-6, H.Total * 1e-3 / H.Count,
+            H.percentile(0.5) * 1e-3, H.percentile(0.9) * 1e-3,
+            H.percentile(0.99) * 1e-3, H.Max * 1e-3);
+  }
+
+  std::vector<ConstructSummary *> Constructs;
+  for (auto &M : Merged)
+    if (M.second.Stats.Count)
+      Constructs.push_back(&M.second);
+  std::sort(Constructs.begin(), Constructs.end(),
+            [](ConstructSummary *A, ConstructSummary *B) {
+              return A->Stats.Time > B->Stats.Time;
+            });
+  if (prof_flags->top >= 0 && (int)Constructs.size() > prof_flags->top)
+    Constructs.resize(prof_flags->top);
+  if (!Constructs.empty())
+    fprintf(Out, "%-32s %-10s %10s %12s %10s %10s %7s %9s\n", "construct",
+            "kind", "count", "total ms", "mean us", "max us", "threads",
+            "imbalance");
+  // The imbalance is the time of the busiest thread over the mean time of the
+  // threads: 1 when the threads are balanced.
+  for (ConstructSummary *C : Constructs) {
+    double Imbalance = C->SumThreadTime ? (double)C->MaxThreadTime *
+                                              C->Threads / C->SumThreadTime
+                                        : 1;
+    fprintf(Out, "%-32s %-10s %10" PRIu64 " %12.3f %10.2f %10.2f %7d %9.2f\n",
+            codeName(C->Key.Codeptr).c_str(), ConstructNames[C->Key.Kind],
+            C->Stats.Count, C->Stats.Time * 1e-6,
+            C->Stats.Time * 1e-3 / C->Stats.Count, C->Stats.Max * 1e-3,
+            C->Threads, Imbalance);
+  }
+
+  if (prof_flags->threads) {
+    fprintf(Out, "%-8s %12s %12s %12s %10s\n", "thread", "busy ms",
+            "wait ms", "task ms", "tasks");
+    for (ThreadStats *S : Threads) {
+      uint64_t Busy = 0;
+      for (auto &C : S->Constructs)
+        Busy += C.second.Busy;
+      fprintf(Out, "%-8d %12.3f %12.3f %12.3f %10" PRIu64 "\n", S->Id,
+              Busy * 1e-6, S->IdleTime * 1e-6, S->TaskTime * 1e-6,
+              S->Events[EventTask].Count);
+    }
+  }
+}
+
+#define SET_CALLBACK_T(event, type)                                            \
+  do {                                                                         \
+    ompt_callback_##type##_t prof_##event = &ompt_prof_##event;                \
+    if (ompt_set_callback(ompt_callback_##event,                               \
+                          (ompt_callback_t)prof_##event) == ompt_set_never &&  \
+        prof_flags->verbose)                                                   \
+      fprintf(stderr, "OMPT profiler: callback '" #event                       \
+                      "' is not supported\n");                                 \
+  } while (0)
+
+#define SET_CALLBACK(event) SET_CALLBACK_T(event, event)
+
+static int ompt_prof_initialize(ompt_function_lookup_t lookup, int device_num,
+                                ompt_data_t *tool_data) {
+  ompt_set_callback_t ompt_set_callback =
+      (ompt_set_callback_t)lookup("ompt_set_callback");
+  if (ompt_set_callback == NULL) {
+    std::cerr << "Could not set callback, exiting..." << std::endl;
+    std::exit(1);
+  }
+
+  StartTime = now();
+
+  SET_CALLBACK(thread_begin);
+  SET_CALLBACK(parallel_begin);
+  SET_CALLBACK(parallel_end);
+  SET_CALLBACK(implicit_task);
+  SET_CALLBACK_T(sync_region_wait, sync_region);
+  SET_CALLBACK(work);
+  SET_CALLBACK(task_create);
+  SET_CALLBACK(task_schedule);
+  return 1; // success
+}
+
+static void ompt_prof_finalize(ompt_data_t *tool_data) {
+  FILE *Out = stderr;
+  if (!prof_flags->output.empty()) {
+    Out = fopen(prof_flags->output.c_str(), "w");
+    if (!Out) {
+      fprintf(stderr, "OMPT profiler: cannot open %s, writing to stderr\n",
+              prof_flags->output.c_str());
+      Out = stderr;
+    }
+  }
+  printSummary(Out);
+  if (Out != stderr)
+    fclose(Out);
+
+  delete prof_flags;
+  prof_flags = nullptr;
+}
+
+extern "C" ompt_start_tool_result_t *
+ompt_start_tool(unsigned int omp_version, const char *runtime_version) {
+  const char *options = getenv("OMPPROF_OPTIONS");
+  prof_flags = new ProfFlags(options);
+  if (!prof_flags->enabled) {
+    if (prof_flags->verbose)
+      std::cout << "OMPT profiler disabled, stopping operation" << std::endl;
+    delete prof_flags;
+    return NULL;
+  }
+
+  static ompt_start_tool_result_t ompt_start_tool_result = {
+      &ompt_prof_initialize, &ompt_prof_finalize, {0}};
+  if (prof_flags->verbose)
+    std::cout << "OMPT profiler loaded into " << runtime_version << std::endl;
+  return &ompt_start_tool_result;
+}
@@ -0,0 +1,50 @@
+// RUN: %libomp-compile && env OMP_TOOL_LIBRARIES=%libompprof \
+// RUN: OMPPROF_OPTIONS="threads=1" %libomp-run 2>&1 | FileCheck %s
+// REQUIRES: linux
+
+#include <omp.h>
+#include <stdio.h>
+
+#define REGIONS 10
+#define TASKS 8
+
+int tasks;
+
+int main(void) {
+  long sum = 0;
+  int r, i;
+  for (r = 0; r < REGIONS; ++r) {
+#pragma omp parallel num_threads(2) reduction(+ : sum)
+    {
+#pragma omp for schedule(dynamic)
+      for (i = 0; i < 100; ++i)
+        sum += i;
+#pragma omp single
+      {
+        for (i = 0; i < TASKS; ++i) {
+#pragma omp task
+          {
+#pragma omp atomic
+            ++tasks;
+          }
+        }
+#pragma omp taskwait
+      }
+    }
+  }
+  printf("sum = %ld, tasks = %d\n", sum, tasks);
+  // The summary is written to stderr at exit, after this line
+  fflush(stdout);
+  return 0;
+}
+
+// CHECK: sum = 49500, tasks = 80
+// CHECK: OMPT profiler: 2 threads
+// CHECK: event count total ms mean us p50 us p90 us p99 us max us
+// CHECK: parallel region 10
+// CHECK: task execution 80
+// CHECK: construct kind count total ms mean us max us threads imbalance
+// CHECK-DAG: parallel 10
+// CHECK-DAG: loop 20
+// CHECK-DAG: task 80
+// CHECK: thread busy ms wait ms task ms tasks